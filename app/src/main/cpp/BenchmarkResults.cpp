@@ -0,0 +1,487 @@
+#include "BenchmarkResults.h"
+#include "LogicalDevice.h"
+#include "PhysicalDevice.h"
+#include "QueueTopology.h"
+#include "Trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <tuple>
+#include <unistd.h>
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "Results files are read and written in host byte order, which must be little endian"
+#endif
+
+namespace
+{
+    /**
+     * Fewer samples per side than this cannot show a significant difference at the usual levels.
+     */
+    constexpr size_t MinimumSamples = 3;
+
+    constexpr VkDeviceSize CopySize = 16 << 20;
+    constexpr uint32_t CopyCount = 4;
+    constexpr uint32_t SubmitCount = 100;
+
+    struct FileHeader
+    {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t sampleSize;
+    };
+
+    /**
+     * A command pool with one empty command buffer and a fence, destroyed through the device's dispatch table.
+     */
+    struct SubmitResources
+    {
+        const LogicalDevice* device = nullptr;
+        VkCommandPool commandPool = VK_NULL_HANDLE;
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+        VkFence fence = VK_NULL_HANDLE;
+
+        SubmitResources() = default;
+        SubmitResources(const SubmitResources& other) = delete;
+        SubmitResources& operator=(const SubmitResources& other) = delete;
+
+        ~SubmitResources()
+        {
+            if (this->device == nullptr)
+            {
+                return;
+            }
+
+            VkDevice handle = this->device->getHandle();
+            const VulkanLoader::DeviceDispatch& vk = this->device->getDispatch();
+            vk.vkDeviceWaitIdle(handle);
+
+            if (this->fence != VK_NULL_HANDLE)
+            {
+                vk.vkDestroyFence(handle, this->fence, nullptr);
+            }
+
+            if (this->commandPool != VK_NULL_HANDLE)
+            {
+                vk.vkDestroyCommandPool(handle, this->commandPool, nullptr);
+            }
+        }
+    };
+
+    double getMedian(std::vector<double> values)
+    {
+        std::sort(values.begin(), values.end());
+        const size_t middle = values.size() / 2;
+        return values.size() % 2 != 0 ? values[middle] : (values[middle - 1] + values[middle]) / 2.0;
+    }
+
+    double getNormalCdf(double x)
+    {
+        return 0.5 * std::erfc(-x / std::sqrt(2.0));
+    }
+
+    /**
+     * Measures the round trip of submitting an empty command buffer and waiting for its fence.
+     * @return the median round trip in microseconds, or a negative value if the device could not be used.
+     */
+    double measureSubmitLatency(VkPhysicalDevice device, uint32_t familyIndex)
+    {
+        LogicalDevice logicalDevice(device, familyIndex);
+        if (logicalDevice.getHandle() == VK_NULL_HANDLE)
+        {
+            return -1.0;
+        }
+
+        VkDevice handle = logicalDevice.getHandle();
+        const VulkanLoader::DeviceDispatch& vk = logicalDevice.getDispatch();
+        SubmitResources resources;
+        resources.device = &logicalDevice;
+
+        VkCommandPoolCreateInfo poolInfo = {};
+        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.queueFamilyIndex = familyIndex;
+        if (vk.vkCreateCommandPool(handle, &poolInfo, nullptr, &resources.commandPool) != VK_SUCCESS)
+        {
+            resources.commandPool = VK_NULL_HANDLE;
+            return -1.0;
+        }
+
+        VkCommandBufferAllocateInfo allocateInfo = {};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocateInfo.commandPool = resources.commandPool;
+        allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocateInfo.commandBufferCount = 1;
+
+        VkCommandBufferBeginInfo beginInfo = {};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+
+        VkFenceCreateInfo fenceInfo = {};
+        fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+        if (vk.vkAllocateCommandBuffers(handle, &allocateInfo, &resources.commandBuffer) != VK_SUCCESS ||
+            vk.vkBeginCommandBuffer(resources.commandBuffer, &beginInfo) != VK_SUCCESS ||
+            vk.vkEndCommandBuffer(resources.commandBuffer) != VK_SUCCESS ||
+            vk.vkCreateFence(handle, &fenceInfo, nullptr, &resources.fence) != VK_SUCCESS)
+        {
+            return -1.0;
+        }
+
+        VkSubmitInfo submitInfo = {};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &resources.commandBuffer;
+
+        // The first submits pay for lazy driver setup; keep them out of the median.
+        std::vector<double> latencies;
+        latencies.reserve(SubmitCount);
+        for (uint32_t i = 0; i < SubmitCount + SubmitCount / 10; i++)
+        {
+            auto begin = std::chrono::steady_clock::now();
+            if (vk.vkQueueSubmit(logicalDevice.getQueue(), 1, &submitInfo, resources.fence) != VK_SUCCESS ||
+                vk.vkWaitForFences(handle, 1, &resources.fence, VK_TRUE, UINT64_MAX) != VK_SUCCESS)
+            {
+                return -1.0;
+            }
+            auto end = std::chrono::steady_clock::now();
+            vk.vkResetFences(handle, 1, &resources.fence);
+
+            if (i >= SubmitCount / 10)
+            {
+                latencies.push_back(std::chrono::duration<double, std::micro>(end - begin).count());
+            }
+        }
+
+        return getMedian(latencies);
+    }
+
+    BenchmarkResults::Sample makeSample(const VkPhysicalDeviceProperties& properties, const char* benchmarkId, uint32_t flags,
+                                        uint64_t timestamp, double value)
+    {
+        BenchmarkResults::Sample sample = {};
+        sample.vendorId = properties.vendorID;
+        sample.deviceId = properties.deviceID;
+        sample.driverVersion = properties.driverVersion;
+        sample.flags = flags;
+        sample.timestamp = timestamp;
+        sample.value = value;
+        strncpy(sample.benchmarkId, benchmarkId, BenchmarkResults::BenchmarkIdSize - 1);
+        return sample;
+    }
+}
+
+namespace BenchmarkResults
+{
+    /**
+     * Runs the built-in regression benchmarks <code>runs</code> times: buffer copy bandwidth on the transfer family
+     * ("copy.bandwidth", GB/s) and the empty submit round trip on the compute family ("submit.latency", microseconds).
+     * Every run is one sample, so the comparison sees the run to run spread.
+     * @param device The <code>VkPhysicalDevice</code>.
+     * @param runs The number of samples per benchmark.
+     * @return the samples; benchmarks that failed to run are left out.
+     */
+    std::vector<Sample> collect(VkPhysicalDevice device, uint32_t runs)
+    {
+        VKINFO_TRACE_FUNCTION();
+
+        std::vector<Sample> samples;
+        const VkPhysicalDeviceProperties properties = PhysicalDevice::getDeviceProperties(device);
+        QueueFamilyIndicies indices = QueueTopology::solve(QueueTopology::classify(device));
+        const uint64_t timestamp = (uint64_t)std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+        for (uint32_t run = 0; run < runs; run++)
+        {
+            if (indices.transferFamily.has_value())
+            {
+                QueueTopology::CopyThroughput throughput = QueueTopology::measureCopyThroughput(device, indices.transferFamily.value(), CopySize, CopyCount);
+                if (throughput.measured)
+                {
+                    samples.push_back(makeSample(properties, "copy.bandwidth", HigherIsBetter, timestamp, throughput.gigabytesPerSecond));
+                }
+            }
+
+            if (indices.computeFamily.has_value())
+            {
+                const double latency = measureSubmitLatency(device, indices.computeFamily.value());
+                if (latency >= 0.0)
+                {
+                    samples.push_back(makeSample(properties, "submit.latency", 0, timestamp, latency));
+                }
+            }
+        }
+
+        return samples;
+    }
+
+    /**
+     * Tests whether <code>candidate</code> is worse than <code>baseline</code> with a one-sided Mann-Whitney U test
+     * (normal approximation with tie correction and continuity correction). The test only looks at ranks, so a
+     * single outlier run cannot fake or hide a regression.
+     * @param higherIsBetter Whether larger values are better (bandwidth) or worse (latency).
+     * @param alpha The significance level, e.g. 0.05.
+     * @param minimumChange The smallest relative change of the median to flag, e.g. 0.02 for 2%.
+     * @return the comparison; invalid if either side has fewer than three samples.
+     */
+    Comparison compare(const std::vector<double>& baseline, const std::vector<double>& candidate, bool higherIsBetter,
+                       double alpha, double minimumChange)
+    {
+        Comparison comparison = {};
+        comparison.baselineCount = baseline.size();
+        comparison.candidateCount = candidate.size();
+        if (baseline.size() < MinimumSamples || candidate.size() < MinimumSamples)
+        {
+            return comparison;
+        }
+
+        comparison.valid = true;
+        comparison.baselineMedian = getMedian(baseline);
+        comparison.candidateMedian = getMedian(candidate);
+        if (comparison.baselineMedian != 0.0)
+        {
+            comparison.change = (comparison.candidateMedian - comparison.baselineMedian) / std::fabs(comparison.baselineMedian);
+        }
+
+        // Rank the pooled samples, giving tied values their average rank.
+        std::vector<std::pair<double, bool>> pooled;
+        pooled.reserve(baseline.size() + candidate.size());
+        for (double value : baseline)
+        {
+            pooled.emplace_back(value, false);
+        }
+        for (double value : candidate)
+        {
+            pooled.emplace_back(value, true);
+        }
+        std::sort(pooled.begin(), pooled.end());
+
+        const double n1 = (double)candidate.size();
+        const double n2 = (double)baseline.size();
+        const double n = n1 + n2;
+        double candidateRankSum = 0.0;
+        double tieCorrection = 0.0;
+        for (size_t first = 0; first < pooled.size();)
+        {
+            size_t last = first;
+            while (last + 1 < pooled.size() && pooled[last + 1].first == pooled[first].first)
+            {
+                last++;
+            }
+
+            const double rank = (first + last) / 2.0 + 1.0;
+            for (size_t i = first; i <= last; i++)
+            {
+                candidateRankSum += pooled[i].second ? rank : 0.0;
+            }
+
+            const double ties = (double)(last - first + 1);
+            tieCorrection += ties * ties * ties - ties;
+            first = last + 1;
+        }
+
+        comparison.u = candidateRankSum - n1 * (n1 + 1.0) / 2.0;
+        const double mean = n1 * n2 / 2.0;
+        const double variance = n1 * n2 / 12.0 * ((n + 1.0) - tieCorrection / (n * (n - 1.0)));
+        if (variance <= 0.0)
+        {
+            return comparison;
+        }
+
+        // Worse means the candidate ranks low when higher is better and high when lower is better.
+        const double sigma = std::sqrt(variance);
+        comparison.pValue = higherIsBetter ? getNormalCdf((comparison.u - mean + 0.5) / sigma)
+                                           : getNormalCdf(-(comparison.u - mean - 0.5) / sigma);
+
+        const bool worse = higherIsBetter ? comparison.change < 0.0 : comparison.change > 0.0;
+        comparison.regression = worse && comparison.pValue < alpha && std::fabs(comparison.change) >= minimumChange;
+        return comparison;
+    }
+
+    /**
+     * Compares, per device and benchmark, each driver version against the one recorded before it.
+     * @param samples The samples of any number of devices, drivers and benchmarks, in any order.
+     * @return one report per pair of consecutive driver versions, ordered by device, benchmark and time.
+     */
+    std::vector<Report> analyze(const std::vector<Sample>& samples, double alpha, double minimumChange)
+    {
+        VKINFO_TRACE_FUNCTION();
+
+        struct DriverSamples
+        {
+            uint64_t firstTimestamp = UINT64_MAX;
+            bool higherIsBetter = false;
+            std::vector<double> values;
+        };
+
+        typedef std::tuple<uint32_t, uint32_t, std::string> SeriesKey;
+        std::map<SeriesKey, std::map<uint32_t, DriverSamples>> series;
+        for (const Sample& sample : samples)
+        {
+            std::string benchmarkId(sample.benchmarkId, strnlen(sample.benchmarkId, BenchmarkIdSize));
+            DriverSamples& driver = series[SeriesKey(sample.vendorId, sample.deviceId, benchmarkId)][sample.driverVersion];
+            driver.firstTimestamp = std::min(driver.firstTimestamp, sample.timestamp);
+            driver.higherIsBetter = (sample.flags & HigherIsBetter) != 0;
+            driver.values.push_back(sample.value);
+        }
+
+        std::vector<Report> reports;
+        for (const auto& entry : series)
+        {
+            std::vector<std::pair<uint64_t, uint32_t>> order;
+            for (const auto& driver : entry.second)
+            {
+                order.emplace_back(driver.second.firstTimestamp, driver.first);
+            }
+            std::sort(order.begin(), order.end());
+
+            for (size_t i = 1; i < order.size(); i++)
+            {
+                const DriverSamples& baseline = entry.second.at(order[i - 1].second);
+                const DriverSamples& candidate = entry.second.at(order[i].second);
+
+                Report report = {};
+                report.vendorId = std::get<0>(entry.first);
+                report.deviceId = std::get<1>(entry.first);
+                report.benchmarkId = std::get<2>(entry.first);
+                report.baselineDriverVersion = order[i - 1].second;
+                report.candidateDriverVersion = order[i].second;
+                report.comparison = compare(baseline.values, candidate.values, candidate.higherIsBetter, alpha, minimumChange);
+                reports.push_back(report);
+            }
+        }
+
+        return reports;
+    }
+
+    /**
+     * Appends samples to a results file, creating it with a header if it does not exist. A partial sample at the end,
+     * left by an interrupted write, is cut off first so the appended samples stay aligned.
+     * @return false if the file could not be written or is not a results file of this version.
+     */
+    bool writeFile(const std::string& path, const Sample* samples, size_t count)
+    {
+        VKINFO_TRACE_FUNCTION();
+
+        FILE* file = fopen(path.c_str(), "a+b");
+        if (file == nullptr)
+        {
+            return false;
+        }
+
+        FileHeader header = {FileMagic, FormatVersion, (uint16_t)sizeof(Sample)};
+
+        fseek(file, 0, SEEK_END);
+        const long size = ftell(file);
+        bool ok = true;
+        if (size == 0)
+        {
+            ok = fwrite(&header, sizeof(header), 1, file) == 1;
+        }
+        else
+        {
+            FileHeader existing = {};
+            fseek(file, 0, SEEK_SET);
+            ok = fread(&existing, sizeof(existing), 1, file) == 1 &&
+                 existing.magic == header.magic &&
+                 existing.version == header.version &&
+                 existing.sampleSize == header.sampleSize;
+
+            const long partialSize = (size - (long)sizeof(header)) % (long)sizeof(Sample);
+            if (ok && partialSize != 0)
+            {
+                ok = ftruncate(fileno(file), size - partialSize) == 0;
+            }
+            fseek(file, 0, SEEK_END);
+        }
+
+        ok = ok && fwrite(samples, sizeof(Sample), count, file) == count;
+        return fclose(file) == 0 && ok;
+    }
+
+    /**
+     * Reads every sample of a results file.
+     * @param samples (OUT param) The samples are appended to this.
+     * @return false if the file could not be opened, is not a results file of this version or is truncated. Samples
+     * before the truncation point are still appended.
+     */
+    bool readFile(const std::string& path, std::vector<Sample>& samples)
+    {
+        VKINFO_TRACE_FUNCTION();
+
+        FILE* file = fopen(path.c_str(), "rb");
+        if (file == nullptr)
+        {
+            return false;
+        }
+
+        FileHeader header = {};
+        if (fread(&header, sizeof(header), 1, file) != 1 ||
+            header.magic != FileMagic ||
+            header.version != FormatVersion ||
+            header.sampleSize != sizeof(Sample))
+        {
+            fclose(file);
+            return false;
+        }
+
+        fseek(file, 0, SEEK_END);
+        long size = ftell(file) - (long)sizeof(header);
+        fseek(file, sizeof(header), SEEK_SET);
+
+        const size_t count = (size_t)size / sizeof(Sample);
+        const size_t first = samples.size();
+        samples.resize(first + count);
+        const size_t read = fread(samples.data() + first, sizeof(Sample), count, file);
+        samples.resize(first + read);
+
+        fclose(file);
+        return read == count && (size_t)size % sizeof(Sample) == 0;
+    }
+
+    /**
+     * Writes a header and samples to an open stream, e.g. a pipe, in the layout of a results file.
+     * @param stream The stream, left open.
+     * @return false if the stream could not be written.
+     */
+    bool writeStream(FILE* stream, const Sample* samples, size_t count)
+    {
+        FileHeader header = {FileMagic, FormatVersion, (uint16_t)sizeof(Sample)};
+        return fwrite(&header, sizeof(header), 1, stream) == 1 &&
+               fwrite(samples, sizeof(Sample), count, stream) == count;
+    }
+
+    /**
+     * Reads a header and samples from an open stream up to its end, without seeking.
+     * @param stream The stream, left open.
+     * @param samples (OUT param) The samples are appended to this.
+     * @return false if the stream is not a results stream of this version or ends within a sample.
+     */
+    bool readStream(FILE* stream, std::vector<Sample>& samples)
+    {
+        FileHeader header = {};
+        if (fread(&header, sizeof(header), 1, stream) != 1 ||
+            header.magic != FileMagic ||
+            header.version != FormatVersion ||
+            header.sampleSize != sizeof(Sample))
+        {
+            return false;
+        }
+
+        while (true)
+        {
+            Sample sample = {};
+            const size_t read = fread(&sample, 1, sizeof(sample), stream);
+            if (read == 0)
+            {
+                return true;
+            }
+            else if (read != sizeof(sample))
+            {
+                return false;
+            }
+
+            samples.push_back(sample);
+        }
+    }
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "VulkanLoader.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/**
+ * Local store of benchmark results and a regression check across driver versions. Every sample is keyed by the
+ * device (vendorID, deviceID), its driverVersion and a benchmark id. For each device and benchmark, the samples of
+ * every driver version are compared against those of the driver version recorded before it with a one-sided
+ * Mann-Whitney U test. A change is flagged as a regression when it is significant and larger than a minimum relative
+ * change.
+ *
+ * A results file is a small header followed by fixed layout <code>Sample</code> records. <code>writeFile</code> appends
+ * to an existing file, so runs from different machines or sessions are merged by writing them to the same file; the
+ * files themselves cannot be concatenated, as the second header would be read as a sample.
+ */
+namespace BenchmarkResults
+{
+    constexpr uint32_t FileMagic = 0x52424b56; // "VKBR"
+    constexpr uint16_t FormatVersion = 1;
+    constexpr size_t BenchmarkIdSize = 48;
+
+    enum SampleFlags : uint32_t
+    {
+        HigherIsBetter = 1 << 0
+    };
+
+    /**
+     * One measurement. <code>timestamp</code> is in seconds since the Unix epoch and orders the driver versions.
+     */
+    struct Sample
+    {
+        uint32_t vendorId;
+        uint32_t deviceId;
+        uint32_t driverVersion;
+        uint32_t flags;
+        uint64_t timestamp;
+        double value;
+        char benchmarkId[BenchmarkIdSize];
+    };
+
+    static_assert(sizeof(Sample) == 80, "Sample is stored as is");
+
+    /**
+     * Outcome of comparing a candidate driver's samples against a baseline driver's.
+     */
+    struct Comparison
+    {
+        bool valid = false;
+        size_t baselineCount = 0;
+        size_t candidateCount = 0;
+        double baselineMedian = 0.0;
+        double candidateMedian = 0.0;
+        double change = 0.0;
+        double u = 0.0;
+        double pValue = 1.0;
+        bool regression = false;
+    };
+
+    /**
+     * A comparison between two consecutive driver versions of one device and benchmark.
+     */
+    struct Report
+    {
+        uint32_t vendorId = 0;
+        uint32_t deviceId = 0;
+        std::string benchmarkId;
+        uint32_t baselineDriverVersion = 0;
+        uint32_t candidateDriverVersion = 0;
+        Comparison comparison;
+    };
+
+    std::vector<Sample> collect(VkPhysicalDevice device, uint32_t runs);
+    Comparison compare(const std::vector<double>& baseline, const std::vector<double>& candidate, bool higherIsBetter,
+                       double alpha, double minimumChange);
+    std::vector<Report> analyze(const std::vector<Sample>& samples, double alpha, double minimumChange);
+
+    bool writeFile(const std::string& path, const Sample* samples, size_t count);
+    bool readFile(const std::string& path, std::vector<Sample>& samples);
+    bool writeStream(FILE* stream, const Sample* samples, size_t count);
+    bool readStream(FILE* stream, std::vector<Sample>& samples);
+}
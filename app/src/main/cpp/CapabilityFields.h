@@ -0,0 +1,279 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+/**
+ * Every scalar capability a snapshot records, as X-macro lists of <code>X(name, kind, member)</code>.
+ * <code>kind</code> is one of <code>U32</code>, <code>I32</code>, <code>U64</code>, <code>F32</code>, <code>Bool</code>;
+ * <code>member</code> is an lvalue on a <code>VkPhysicalDeviceProperties properties</code> or
+ * <code>VkPhysicalDeviceFeatures features</code> in scope.
+ * The order is the on-disk field order of the snapshot format: append new fields at the end of the last list and
+ * bump <code>CapabilitySnapshot::FormatVersion</code>.
+ */
+
+/**
+ * <code>VkPhysicalDeviceProperties</code> identification fields.
+ */
+#define VKINFO_CAPABILITY_PROPERTY_FIELDS(X) \
+    X(apiVersion, U32, properties.apiVersion) \
+    X(driverVersion, U32, properties.driverVersion) \
+    X(vendorID, U32, properties.vendorID) \
+    X(deviceID, U32, properties.deviceID) \
+    X(deviceType, U32, properties.deviceType)
+
+/**
+ * <code>VkPhysicalDeviceLimits</code>. Array members are split into one field per element.
+ */
+#define VKINFO_CAPABILITY_LIMIT_FIELDS(X) \
+    X(maxImageDimension1D, U32, properties.limits.maxImageDimension1D) \
+    X(maxImageDimension2D, U32, properties.limits.maxImageDimension2D) \
+    X(maxImageDimension3D, U32, properties.limits.maxImageDimension3D) \
+    X(maxImageDimensionCube, U32, properties.limits.maxImageDimensionCube) \
+    X(maxImageArrayLayers, U32, properties.limits.maxImageArrayLayers) \
+    X(maxTexelBufferElements, U32, properties.limits.maxTexelBufferElements) \
+    X(maxUniformBufferRange, U32, properties.limits.maxUniformBufferRange) \
+    X(maxStorageBufferRange, U32, properties.limits.maxStorageBufferRange) \
+    X(maxPushConstantsSize, U32, properties.limits.maxPushConstantsSize) \
+    X(maxMemoryAllocationCount, U32, properties.limits.maxMemoryAllocationCount) \
+    X(maxSamplerAllocationCount, U32, properties.limits.maxSamplerAllocationCount) \
+    X(bufferImageGranularity, U64, properties.limits.bufferImageGranularity) \
+    X(sparseAddressSpaceSize, U64, properties.limits.sparseAddressSpaceSize) \
+    X(maxBoundDescriptorSets, U32, properties.limits.maxBoundDescriptorSets) \
+    X(maxPerStageDescriptorSamplers, U32, properties.limits.maxPerStageDescriptorSamplers) \
+    X(maxPerStageDescriptorUniformBuffers, U32, properties.limits.maxPerStageDescriptorUniformBuffers) \
+    X(maxPerStageDescriptorStorageBuffers, U32, properties.limits.maxPerStageDescriptorStorageBuffers) \
+    X(maxPerStageDescriptorSampledImages, U32, properties.limits.maxPerStageDescriptorSampledImages) \
+    X(maxPerStageDescriptorStorageImages, U32, properties.limits.maxPerStageDescriptorStorageImages) \
+    X(maxPerStageDescriptorInputAttachments, U32, properties.limits.maxPerStageDescriptorInputAttachments) \
+    X(maxPerStageResources, U32, properties.limits.maxPerStageResources) \
+    X(maxDescriptorSetSamplers, U32, properties.limits.maxDescriptorSetSamplers) \
+    X(maxDescriptorSetUniformBuffers, U32, properties.limits.maxDescriptorSetUniformBuffers) \
+    X(maxDescriptorSetUniformBuffersDynamic, U32, properties.limits.maxDescriptorSetUniformBuffersDynamic) \
+    X(maxDescriptorSetStorageBuffers, U32, properties.limits.maxDescriptorSetStorageBuffers) \
+    X(maxDescriptorSetStorageBuffersDynamic, U32, properties.limits.maxDescriptorSetStorageBuffersDynamic) \
+    X(maxDescriptorSetSampledImages, U32, properties.limits.maxDescriptorSetSampledImages) \
+    X(maxDescriptorSetStorageImages, U32, properties.limits.maxDescriptorSetStorageImages) \
+    X(maxDescriptorSetInputAttachments, U32, properties.limits.maxDescriptorSetInputAttachments) \
+    X(maxVertexInputAttributes, U32, properties.limits.maxVertexInputAttributes) \
+    X(maxVertexInputBindings, U32, properties.limits.maxVertexInputBindings) \
+    X(maxVertexInputAttributeOffset, U32, properties.limits.maxVertexInputAttributeOffset) \
+    X(maxVertexInputBindingStride, U32, properties.limits.maxVertexInputBindingStride) \
+    X(maxVertexOutputComponents, U32, properties.limits.maxVertexOutputComponents) \
+    X(maxTessellationGenerationLevel, U32, properties.limits.maxTessellationGenerationLevel) \
+    X(maxTessellationPatchSize, U32, properties.limits.maxTessellationPatchSize) \
+    X(maxTessellationControlPerVertexInputComponents, U32, properties.limits.maxTessellationControlPerVertexInputComponents) \
+    X(maxTessellationControlPerVertexOutputComponents, U32, properties.limits.maxTessellationControlPerVertexOutputComponents) \
+    X(maxTessellationControlPerPatchOutputComponents, U32, properties.limits.maxTessellationControlPerPatchOutputComponents) \
+    X(maxTessellationControlTotalOutputComponents, U32, properties.limits.maxTessellationControlTotalOutputComponents) \
+    X(maxTessellationEvaluationInputComponents, U32, properties.limits.maxTessellationEvaluationInputComponents) \
+    X(maxTessellationEvaluationOutputComponents, U32, properties.limits.maxTessellationEvaluationOutputComponents) \
+    X(maxGeometryShaderInvocations, U32, properties.limits.maxGeometryShaderInvocations) \
+    X(maxGeometryInputComponents, U32, properties.limits.maxGeometryInputComponents) \
+    X(maxGeometryOutputComponents, U32, properties.limits.maxGeometryOutputComponents) \
+    X(maxGeometryOutputVertices, U32, properties.limits.maxGeometryOutputVertices) \
+    X(maxGeometryTotalOutputComponents, U32, properties.limits.maxGeometryTotalOutputComponents) \
+    X(maxFragmentInputComponents, U32, properties.limits.maxFragmentInputComponents) \
+    X(maxFragmentOutputAttachments, U32, properties.limits.maxFragmentOutputAttachments) \
+    X(maxFragmentDualSrcAttachments, U32, properties.limits.maxFragmentDualSrcAttachments) \
+    X(maxFragmentCombinedOutputResources, U32, properties.limits.maxFragmentCombinedOutputResources) \
+    X(maxComputeSharedMemorySize, U32, properties.limits.maxComputeSharedMemorySize) \
+    X(maxComputeWorkGroupCount0, U32, properties.limits.maxComputeWorkGroupCount[0]) \
+    X(maxComputeWorkGroupCount1, U32, properties.limits.maxComputeWorkGroupCount[1]) \
+    X(maxComputeWorkGroupCount2, U32, properties.limits.maxComputeWorkGroupCount[2]) \
+    X(maxComputeWorkGroupInvocations, U32, properties.limits.maxComputeWorkGroupInvocations) \
+    X(maxComputeWorkGroupSize0, U32, properties.limits.maxComputeWorkGroupSize[0]) \
+    X(maxComputeWorkGroupSize1, U32, properties.limits.maxComputeWorkGroupSize[1]) \
+    X(maxComputeWorkGroupSize2, U32, properties.limits.maxComputeWorkGroupSize[2]) \
+    X(subPixelPrecisionBits, U32, properties.limits.subPixelPrecisionBits) \
+    X(subTexelPrecisionBits, U32, properties.limits.subTexelPrecisionBits) \
+    X(mipmapPrecisionBits, U32, properties.limits.mipmapPrecisionBits) \
+    X(maxDrawIndexedIndexValue, U32, properties.limits.maxDrawIndexedIndexValue) \
+    X(maxDrawIndirectCount, U32, properties.limits.maxDrawIndirectCount) \
+    X(maxSamplerLodBias, F32, properties.limits.maxSamplerLodBias) \
+    X(maxSamplerAnisotropy, F32, properties.limits.maxSamplerAnisotropy) \
+    X(maxViewports, U32, properties.limits.maxViewports) \
+    X(maxViewportDimensions0, U32, properties.limits.maxViewportDimensions[0]) \
+    X(maxViewportDimensions1, U32, properties.limits.maxViewportDimensions[1]) \
+    X(viewportBoundsRange0, F32, properties.limits.viewportBoundsRange[0]) \
+    X(viewportBoundsRange1, F32, properties.limits.viewportBoundsRange[1]) \
+    X(viewportSubPixelBits, U32, properties.limits.viewportSubPixelBits) \
+    X(minMemoryMapAlignment, U64, properties.limits.minMemoryMapAlignment) \
+    X(minTexelBufferOffsetAlignment, U64, properties.limits.minTexelBufferOffsetAlignment) \
+    X(minUniformBufferOffsetAlignment, U64, properties.limits.minUniformBufferOffsetAlignment) \
+    X(minStorageBufferOffsetAlignment, U64, properties.limits.minStorageBufferOffsetAlignment) \
+    X(minTexelOffset, I32, properties.limits.minTexelOffset) \
+    X(maxTexelOffset, U32, properties.limits.maxTexelOffset) \
+    X(minTexelGatherOffset, I32, properties.limits.minTexelGatherOffset) \
+    X(maxTexelGatherOffset, U32, properties.limits.maxTexelGatherOffset) \
+    X(minInterpolationOffset, F32, properties.limits.minInterpolationOffset) \
+    X(maxInterpolationOffset, F32, properties.limits.maxInterpolationOffset) \
+    X(subPixelInterpolationOffsetBits, U32, properties.limits.subPixelInterpolationOffsetBits) \
+    X(maxFramebufferWidth, U32, properties.limits.maxFramebufferWidth) \
+    X(maxFramebufferHeight, U32, properties.limits.maxFramebufferHeight) \
+    X(maxFramebufferLayers, U32, properties.limits.maxFramebufferLayers) \
+    X(framebufferColorSampleCounts, U32, properties.limits.framebufferColorSampleCounts) \
+    X(framebufferDepthSampleCounts, U32, properties.limits.framebufferDepthSampleCounts) \
+    X(framebufferStencilSampleCounts, U32, properties.limits.framebufferStencilSampleCounts) \
+    X(framebufferNoAttachmentsSampleCounts, U32, properties.limits.framebufferNoAttachmentsSampleCounts) \
+    X(maxColorAttachments, U32, properties.limits.maxColorAttachments) \
+    X(sampledImageColorSampleCounts, U32, properties.limits.sampledImageColorSampleCounts) \
+    X(sampledImageIntegerSampleCounts, U32, properties.limits.sampledImageIntegerSampleCounts) \
+    X(sampledImageDepthSampleCounts, U32, properties.limits.sampledImageDepthSampleCounts) \
+    X(sampledImageStencilSampleCounts, U32, properties.limits.sampledImageStencilSampleCounts) \
+    X(storageImageSampleCounts, U32, properties.limits.storageImageSampleCounts) \
+    X(maxSampleMaskWords, U32, properties.limits.maxSampleMaskWords) \
+    X(timestampComputeAndGraphics, Bool, properties.limits.timestampComputeAndGraphics) \
+    X(timestampPeriod, F32, properties.limits.timestampPeriod) \
+    X(maxClipDistances, U32, properties.limits.maxClipDistances) \
+    X(maxCullDistances, U32, properties.limits.maxCullDistances) \
+    X(maxCombinedClipAndCullDistances, U32, properties.limits.maxCombinedClipAndCullDistances) \
+    X(discreteQueuePriorities, U32, properties.limits.discreteQueuePriorities) \
+    X(pointSizeRange0, F32, properties.limits.pointSizeRange[0]) \
+    X(pointSizeRange1, F32, properties.limits.pointSizeRange[1]) \
+    X(lineWidthRange0, F32, properties.limits.lineWidthRange[0]) \
+    X(lineWidthRange1, F32, properties.limits.lineWidthRange[1]) \
+    X(pointSizeGranularity, F32, properties.limits.pointSizeGranularity) \
+    X(lineWidthGranularity, F32, properties.limits.lineWidthGranularity) \
+    X(strictLines, Bool, properties.limits.strictLines) \
+    X(standardSampleLocations, Bool, properties.limits.standardSampleLocations) \
+    X(optimalBufferCopyOffsetAlignment, U64, properties.limits.optimalBufferCopyOffsetAlignment) \
+    X(optimalBufferCopyRowPitchAlignment, U64, properties.limits.optimalBufferCopyRowPitchAlignment) \
+    X(nonCoherentAtomSize, U64, properties.limits.nonCoherentAtomSize)
+
+/**
+ * <code>VkPhysicalDeviceSparseProperties</code>.
+ */
+#define VKINFO_CAPABILITY_SPARSE_FIELDS(X) \
+    X(residencyStandard2DBlockShape, Bool, properties.sparseProperties.residencyStandard2DBlockShape) \
+    X(residencyStandard2DMultisampleBlockShape, Bool, properties.sparseProperties.residencyStandard2DMultisampleBlockShape) \
+    X(residencyStandard3DBlockShape, Bool, properties.sparseProperties.residencyStandard3DBlockShape) \
+    X(residencyAlignedMipSize, Bool, properties.sparseProperties.residencyAlignedMipSize) \
+    X(residencyNonResidentStrict, Bool, properties.sparseProperties.residencyNonResidentStrict)
+
+/**
+ * <code>VkPhysicalDeviceFeatures</code>.
+ */
+#define VKINFO_CAPABILITY_FEATURE_FIELDS(X) \
+    X(robustBufferAccess, Bool, features.robustBufferAccess) \
+    X(fullDrawIndexUint32, Bool, features.fullDrawIndexUint32) \
+    X(imageCubeArray, Bool, features.imageCubeArray) \
+    X(independentBlend, Bool, features.independentBlend) \
+    X(geometryShader, Bool, features.geometryShader) \
+    X(tessellationShader, Bool, features.tessellationShader) \
+    X(sampleRateShading, Bool, features.sampleRateShading) \
+    X(dualSrcBlend, Bool, features.dualSrcBlend) \
+    X(logicOp, Bool, features.logicOp) \
+    X(multiDrawIndirect, Bool, features.multiDrawIndirect) \
+    X(drawIndirectFirstInstance, Bool, features.drawIndirectFirstInstance) \
+    X(depthClamp, Bool, features.depthClamp) \
+    X(depthBiasClamp, Bool, features.depthBiasClamp) \
+    X(fillModeNonSolid, Bool, features.fillModeNonSolid) \
+    X(depthBounds, Bool, features.depthBounds) \
+    X(wideLines, Bool, features.wideLines) \
+    X(largePoints, Bool, features.largePoints) \
+    X(alphaToOne, Bool, features.alphaToOne) \
+    X(multiViewport, Bool, features.multiViewport) \
+    X(samplerAnisotropy, Bool, features.samplerAnisotropy) \
+    X(textureCompressionETC2, Bool, features.textureCompressionETC2) \
+    X(textureCompressionASTC_LDR, Bool, features.textureCompressionASTC_LDR) \
+    X(textureCompressionBC, Bool, features.textureCompressionBC) \
+    X(occlusionQueryPrecise, Bool, features.occlusionQueryPrecise) \
+    X(pipelineStatisticsQuery, Bool, features.pipelineStatisticsQuery) \
+    X(vertexPipelineStoresAndAtomics, Bool, features.vertexPipelineStoresAndAtomics) \
+    X(fragmentStoresAndAtomics, Bool, features.fragmentStoresAndAtomics) \
+    X(shaderTessellationAndGeometryPointSize, Bool, features.shaderTessellationAndGeometryPointSize) \
+    X(shaderImageGatherExtended, Bool, features.shaderImageGatherExtended) \
+    X(shaderStorageImageExtendedFormats, Bool, features.shaderStorageImageExtendedFormats) \
+    X(shaderStorageImageMultisample, Bool, features.shaderStorageImageMultisample) \
+    X(shaderStorageImageReadWithoutFormat, Bool, features.shaderStorageImageReadWithoutFormat) \
+    X(shaderStorageImageWriteWithoutFormat, Bool, features.shaderStorageImageWriteWithoutFormat) \
+    X(shaderUniformBufferArrayDynamicIndexing, Bool, features.shaderUniformBufferArrayDynamicIndexing) \
+    X(shaderSampledImageArrayDynamicIndexing, Bool, features.shaderSampledImageArrayDynamicIndexing) \
+    X(shaderStorageBufferArrayDynamicIndexing, Bool, features.shaderStorageBufferArrayDynamicIndexing) \
+    X(shaderStorageImageArrayDynamicIndexing, Bool, features.shaderStorageImageArrayDynamicIndexing) \
+    X(shaderClipDistance, Bool, features.shaderClipDistance) \
+    X(shaderCullDistance, Bool, features.shaderCullDistance) \
+    X(shaderFloat64, Bool, features.shaderFloat64) \
+    X(shaderInt64, Bool, features.shaderInt64) \
+    X(shaderInt16, Bool, features.shaderInt16) \
+    X(shaderResourceResidency, Bool, features.shaderResourceResidency) \
+    X(shaderResourceMinLod, Bool, features.shaderResourceMinLod) \
+    X(sparseBinding, Bool, features.sparseBinding) \
+    X(sparseResidencyBuffer, Bool, features.sparseResidencyBuffer) \
+    X(sparseResidencyImage2D, Bool, features.sparseResidencyImage2D) \
+    X(sparseResidencyImage3D, Bool, features.sparseResidencyImage3D) \
+    X(sparseResidency2Samples, Bool, features.sparseResidency2Samples) \
+    X(sparseResidency4Samples, Bool, features.sparseResidency4Samples) \
+    X(sparseResidency8Samples, Bool, features.sparseResidency8Samples) \
+    X(sparseResidency16Samples, Bool, features.sparseResidency16Samples) \
+    X(sparseResidencyAliased, Bool, features.sparseResidencyAliased) \
+    X(variableMultisampleRate, Bool, features.variableMultisampleRate) \
+    X(inheritedQueries, Bool, features.inheritedQueries)
+#define VKINFO_CAPABILITY_FIELDS(X) \
+    VKINFO_CAPABILITY_PROPERTY_FIELDS(X) \
+    VKINFO_CAPABILITY_LIMIT_FIELDS(X) \
+    VKINFO_CAPABILITY_SPARSE_FIELDS(X) \
+    VKINFO_CAPABILITY_FEATURE_FIELDS(X)
+
+namespace CapabilityFields
+{
+    enum class Kind : uint8_t
+    {
+        U32,
+        I32,
+        U64,
+        F32,
+        Bool
+    };
+
+    /**
+     * Field indices, in snapshot order.
+     */
+    enum Index : uint32_t
+    {
+#define VKINFO_CAPABILITY_INDEX(name, kind, member) name,
+        VKINFO_CAPABILITY_FIELDS(VKINFO_CAPABILITY_INDEX)
+#undef VKINFO_CAPABILITY_INDEX
+        Count
+    };
+
+    struct Field
+    {
+        const char* name;
+        Kind kind;
+    };
+
+    const Field& get(uint32_t index);
+    int32_t find(const char* name);
+    const char* getKindName(Kind kind);
+
+    /**
+     * Every field is stored as a 64-bit slot. 32-bit values are zero extended, signed values keep their two's
+     * complement bits and floats their IEEE bits, so a slot round trips exactly.
+     */
+    inline uint64_t packU32(uint32_t value) { return value; }
+    inline uint64_t packI32(int32_t value) { return (uint32_t)value; }
+    inline uint64_t packU64(uint64_t value) { return value; }
+    inline uint64_t packBool(uint32_t value) { return value != 0 ? 1 : 0; }
+    inline uint64_t packF32(float value)
+    {
+        uint32_t bits = 0;
+        memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    inline uint32_t unpackU32(uint64_t slot) { return (uint32_t)slot; }
+    inline int32_t unpackI32(uint64_t slot) { return (int32_t)(uint32_t)slot; }
+    inline uint64_t unpackU64(uint64_t slot) { return slot; }
+    inline uint32_t unpackBool(uint64_t slot) { return slot != 0 ? 1 : 0; }
+    inline float unpackF32(uint64_t slot)
+    {
+        uint32_t bits = (uint32_t)slot;
+        float value = 0.0f;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    double toDouble(Kind kind, uint64_t slot);
+}
@@ -0,0 +1,335 @@
+#include "CapabilitySnapshot.h"
+#include "PhysicalDevice.h"
+#include "Trace.h"
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <type_traits>
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "Snapshot files are read and written in host byte order, which must be little endian"
+#endif
+
+namespace
+{
+    const CapabilityFields::Field Fields[] =
+    {
+#define VKINFO_CAPABILITY_FIELD(name, kind, member) {#name, CapabilityFields::Kind::kind},
+        VKINFO_CAPABILITY_FIELDS(VKINFO_CAPABILITY_FIELD)
+#undef VKINFO_CAPABILITY_FIELD
+    };
+
+    static_assert(sizeof(Fields) / sizeof(Fields[0]) == CapabilityFields::Count, "Field table out of sync");
+
+    struct FileHeader
+    {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t fieldCount;
+    };
+}
+
+namespace CapabilityFields
+{
+    /**
+     * Gets the name and kind of a field.
+     * @param index A field index below <code>Count</code>.
+     */
+    const Field& get(uint32_t index)
+    {
+        return Fields[index];
+    }
+
+    /**
+     * Looks up a field by name.
+     * @param name The member name, with array elements numbered (e.g. <code>maxComputeWorkGroupSize0</code>).
+     * @return the field index, or -1 if there is no such field.
+     */
+    int32_t find(const char* name)
+    {
+        for (uint32_t i = 0; i < Count; i++)
+        {
+            if (strcmp(Fields[i].name, name) == 0)
+            {
+                return (int32_t)i;
+            }
+        }
+
+        return -1;
+    }
+
+    const char* getKindName(Kind kind)
+    {
+        switch (kind)
+        {
+            case Kind::U32:
+                return "u32";
+            case Kind::I32:
+                return "i32";
+            case Kind::U64:
+                return "u64";
+            case Kind::F32:
+                return "f32";
+            case Kind::Bool:
+                return "bool";
+        }
+
+        return "unknown";
+    }
+
+    /**
+     * Converts a slot to a double for display and aggregation. 64-bit values above 2^53 lose precision.
+     */
+    double toDouble(Kind kind, uint64_t slot)
+    {
+        switch (kind)
+        {
+            case Kind::U32:
+                return (double)unpackU32(slot);
+            case Kind::I32:
+                return (double)unpackI32(slot);
+            case Kind::U64:
+                return (double)unpackU64(slot);
+            case Kind::F32:
+                return (double)unpackF32(slot);
+            case Kind::Bool:
+                return (double)unpackBool(slot);
+        }
+
+        return 0.0;
+    }
+}
+
+namespace CapabilitySnapshot
+{
+    /**
+     * Packs the properties and features of a device into a record.
+     * @param properties The device properties, including limits and sparse properties.
+     * @param features The device features.
+     * @return the record.
+     */
+    Record fromProperties(const VkPhysicalDeviceProperties& properties, const VkPhysicalDeviceFeatures& features)
+    {
+        Record record = {};
+#define VKINFO_CAPABILITY_PACK(name, kind, member) record.values[CapabilityFields::name] = CapabilityFields::pack##kind(member);
+        VKINFO_CAPABILITY_FIELDS(VKINFO_CAPABILITY_PACK)
+#undef VKINFO_CAPABILITY_PACK
+        return record;
+    }
+
+    /**
+     * Unpacks a record. Members a snapshot does not cover (device name, pipeline cache UUID) are left untouched.
+     * @param record The record.
+     * @param properties (OUT param) Receives the properties, limits and sparse properties.
+     * @param features (OUT param) Receives the features.
+     */
+    void toProperties(const Record& record, VkPhysicalDeviceProperties& properties, VkPhysicalDeviceFeatures& features)
+    {
+#define VKINFO_CAPABILITY_UNPACK(name, kind, member) \
+        member = (std::remove_reference<decltype(member)>::type)CapabilityFields::unpack##kind(record.values[CapabilityFields::name]);
+        VKINFO_CAPABILITY_FIELDS(VKINFO_CAPABILITY_UNPACK)
+#undef VKINFO_CAPABILITY_UNPACK
+    }
+
+    /**
+     * Captures the snapshot record of a physical device.
+     * @param device The <code>VkPhysicalDevice</code>.
+     * @return the record.
+     */
+    Record capture(VkPhysicalDevice device)
+    {
+        VKINFO_TRACE_FUNCTION();
+
+        return fromProperties(PhysicalDevice::getDeviceProperties(device), PhysicalDevice::getDeviceFeatures(device));
+    }
+
+    /**
+     * Brings a record into canonical form, so records describing the same capabilities are byte-identical and hash
+     * alike: 32-bit slots have their upper half cleared, booleans are 0 or 1, negative zero becomes zero and every
+     * NaN becomes the same quiet NaN.
+     * @param record The record, possibly read from an untrusted or older writer.
+     * @return the canonical record.
+     */
+    Record canonicalize(const Record& record)
+    {
+        Record canonical;
+        for (uint32_t field = 0; field < CapabilityFields::Count; field++)
+        {
+            const uint64_t slot = record.values[field];
+            switch (CapabilityFields::get(field).kind)
+            {
+                case CapabilityFields::Kind::U32:
+                case CapabilityFields::Kind::I32:
+                    canonical.values[field] = (uint32_t)slot;
+                    break;
+                case CapabilityFields::Kind::U64:
+                    canonical.values[field] = slot;
+                    break;
+                case CapabilityFields::Kind::Bool:
+                    canonical.values[field] = slot != 0 ? 1 : 0;
+                    break;
+                case CapabilityFields::Kind::F32:
+                {
+                    float value = CapabilityFields::unpackF32(slot);
+                    if (std::isnan(value))
+                    {
+                        value = std::numeric_limits<float>::quiet_NaN();
+                    }
+                    else if (value == 0.0f)
+                    {
+                        value = 0.0f;
+                    }
+                    canonical.values[field] = CapabilityFields::packF32(value);
+                    break;
+                }
+            }
+        }
+
+        return canonical;
+    }
+
+    /**
+     * Writes records to a snapshot file.
+     * @param path The file to write.
+     * @param records The records.
+     * @param count The number of records.
+     * @param append Whether to add to an existing file instead of replacing it. The header is written only if the
+     * file is empty or new.
+     * @return false if the file could not be written, or if appending to a file with a different format.
+     */
+    bool writeFile(const std::string& path, const Record* records, size_t count, bool append)
+    {
+        VKINFO_TRACE_FUNCTION();
+
+        FILE* file = fopen(path.c_str(), append ? "a+b" : "wb");
+        if (file == nullptr)
+        {
+            return false;
+        }
+
+        FileHeader header = {FileMagic, FormatVersion, (uint16_t)CapabilityFields::Count};
+
+        fseek(file, 0, SEEK_END);
+        bool ok = true;
+        if (ftell(file) == 0)
+        {
+            ok = fwrite(&header, sizeof(header), 1, file) == 1;
+        }
+        else
+        {
+            FileHeader existing = {};
+            fseek(file, 0, SEEK_SET);
+            ok = fread(&existing, sizeof(existing), 1, file) == 1 &&
+                 existing.magic == header.magic &&
+                 existing.version == header.version &&
+                 existing.fieldCount == header.fieldCount;
+            fseek(file, 0, SEEK_END);
+        }
+
+        ok = ok && fwrite(records, sizeof(Record), count, file) == count;
+        return fclose(file) == 0 && ok;
+    }
+
+    /**
+     * Reads every record of a snapshot file. Files written with fewer fields (an older format version) are accepted;
+     * the fields they lack read as zero.
+     * @param path The file to read.
+     * @param records (OUT param) The records are appended to this.
+     * @return false if the file could not be opened, is not a snapshot file, is from a newer format version or is
+     * truncated. Records before the truncation point are still appended.
+     */
+    bool readFile(const std::string& path, std::vector<Record>& records)
+    {
+        VKINFO_TRACE_FUNCTION();
+
+        FILE* file = fopen(path.c_str(), "rb");
+        if (file == nullptr)
+        {
+            return false;
+        }
+
+        FileHeader header = {};
+        if (fread(&header, sizeof(header), 1, file) != 1 ||
+            header.magic != FileMagic ||
+            header.version > FormatVersion ||
+            header.fieldCount > CapabilityFields::Count)
+        {
+            fclose(file);
+            return false;
+        }
+
+        fseek(file, 0, SEEK_END);
+        long size = ftell(file) - (long)sizeof(header);
+        fseek(file, sizeof(header), SEEK_SET);
+
+        const size_t recordSize = header.fieldCount * sizeof(uint64_t);
+        const size_t recordCount = recordSize > 0 ? (size_t)size / recordSize : 0;
+        const size_t first = records.size();
+        records.resize(first + recordCount, Record{});
+
+        size_t read = 0;
+        if (header.fieldCount == CapabilityFields::Count)
+        {
+            read = fread(records.data() + first, sizeof(Record), recordCount, file);
+        }
+        else
+        {
+            while (read < recordCount && fread(records[first + read].values, recordSize, 1, file) == 1)
+            {
+                read++;
+            }
+        }
+
+        records.resize(first + read);
+        fclose(file);
+        return read == recordCount && (size_t)size == recordCount * recordSize;
+    }
+
+    /**
+     * Writes a header and records to an open stream, e.g. a pipe, in the layout of a snapshot file.
+     * @param stream The stream, left open.
+     * @return false if the stream could not be written.
+     */
+    bool writeStream(FILE* stream, const Record* records, size_t count)
+    {
+        FileHeader header = {FileMagic, FormatVersion, (uint16_t)CapabilityFields::Count};
+        return fwrite(&header, sizeof(header), 1, stream) == 1 &&
+               fwrite(records, sizeof(Record), count, stream) == count;
+    }
+
+    /**
+     * Reads a header and records from an open stream up to its end. Unlike <code>readFile</code> this never seeks, so
+     * it works on pipes. Older format versions are accepted as in <code>readFile</code>.
+     * @param stream The stream, left open.
+     * @param records (OUT param) The records are appended to this.
+     * @return false if the stream is not a snapshot, is from a newer format version or ends within a record.
+     */
+    bool readStream(FILE* stream, std::vector<Record>& records)
+    {
+        FileHeader header = {};
+        if (fread(&header, sizeof(header), 1, stream) != 1 ||
+            header.magic != FileMagic ||
+            header.version > FormatVersion ||
+            header.fieldCount > CapabilityFields::Count)
+        {
+            return false;
+        }
+
+        const size_t recordSize = header.fieldCount * sizeof(uint64_t);
+        while (true)
+        {
+            Record record = {};
+            const size_t read = fread(record.values, 1, recordSize, stream);
+            if (read == 0 || recordSize == 0)
+            {
+                return true;
+            }
+            else if (read != recordSize)
+            {
+                return false;
+            }
+
+            records.push_back(record);
+        }
+    }
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "CapabilityFields.h"
+#include "VulkanLoader.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/**
+ * Fixed layout binary record of one device's properties, limits, sparse properties and features, for collecting
+ * capabilities across a fleet. A snapshot file is a small header followed by records of
+ * <code>CapabilityFields::Count</code> little endian 64-bit slots each.
+ */
+namespace CapabilitySnapshot
+{
+    constexpr uint32_t FileMagic = 0x53434b56; // "VKCS"
+    constexpr uint16_t FormatVersion = 1;
+
+    struct Record
+    {
+        uint64_t values[CapabilityFields::Count];
+    };
+
+    Record fromProperties(const VkPhysicalDeviceProperties& properties, const VkPhysicalDeviceFeatures& features);
+    void toProperties(const Record& record, VkPhysicalDeviceProperties& properties, VkPhysicalDeviceFeatures& features);
+    Record capture(VkPhysicalDevice device);
+    Record canonicalize(const Record& record);
+
+    bool writeFile(const std::string& path, const Record* records, size_t count, bool append);
+    bool readFile(const std::string& path, std::vector<Record>& records);
+    bool writeStream(FILE* stream, const Record* records, size_t count);
+    bool readStream(FILE* stream, std::vector<Record>& records);
+}
@@ -0,0 +1,1504 @@
+#include "BenchmarkResults.h"
+#include "CapabilitySnapshot.h"
+#include "CommandRecordingBenchmark.h"
+#include "DescriptorBenchmark.h"
+#include "DeviceCreationProfiler.h"
+#include "EnumerationSnapshot.h"
+#include "HostAllocator.h"
+#include "IcdBatch.h"
+#include "Instance.h"
+#include "InstancePool.h"
+#include "LogicalDevice.h"
+#include "MemoryBudgetSampler.h"
+#include "MemoryTypeSelector.h"
+#include "PhysicalDevice.h"
+#include "PipelineLayoutChecker.h"
+#include "QueueTopology.h"
+#include "TextureBenchmark.h"
+#include "ThrottlingDetector.h"
+#include "TimestampCalibration.h"
+#include "Trace.h"
+#include "TransientAttachmentBenchmark.h"
+#include "UploadBenchmark.h"
+#include "VulkanLoader.h"
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <thread>
+
+/**
+ * Prints the command line usage.
+ * @param programName The name the program was invoked as.
+ */
+void printUsage(const char* programName)
+{
+    printf("Usage: %s [options]\n", programName);
+    printf("  --trace <file.json>          Write the recorded trace scopes as Chrome trace JSON.\n");
+    printf("  --snapshot <file>            Append a capability snapshot of every device to <file> (see vkinfo-fleet).\n");
+    printf("  --bench-loader [iterations]  Time loader startup and compare trampoline and dispatch table calls.\n");
+    printf("  --queues [copy MiB]          Classify queue families and measure vkCmdCopyBuffer throughput on each.\n");
+    printf("  --memory-types [copy MiB]    Measure copy bandwidth per memory type and print the ranked type choices.\n");
+    printf("  --check-layouts <file>       Check pipeline layout descriptions against every device's limits.\n");
+    printf("  --host-memory [arena]        Report the driver's host allocations per instance and device operation.\n");
+    printf("  --calibrate [seconds]        Correlate GPU timestamps with CLOCK_MONOTONIC and measure drift.\n");
+    printf("  --memory-budget [seconds]    Sample VK_EXT_memory_budget usage and budget per heap every 100 ms.\n");
+    printf("  --throttle [minutes]         Run a compute workload back to back and report sustained throughput.\n");
+    printf("  --device-cost [iterations]   Time vkCreateDevice and a reference dispatch per enabled feature and extension.\n");
+    printf("  --record-scaling [threads]   Record large command buffers from 1..N threads and report scaling.\n");
+    printf("  --descriptors                Measure descriptor allocation and update throughput per batch size.\n");
+    printf("  --uploads [max MiB]          Compare staging, direct and host-pointer-import uploads per size.\n");
+    printf("  --textures                   Compare linear and optimal image uploads and sampling rates per format.\n");
+    printf("  --transient [passes]         Compare transient attachments in lazily allocated and device local memory.\n");
+    printf("  --results <file> [runs]      Run the regression benchmarks [runs] times per device and append to <file>.\n");
+    printf("  --regressions <file> [alpha] Compare the results in <file> across driver versions; exits 2 on a regression.\n");
+    printf("  --icd-batch <manifest>...    Profile each ICD manifest in its own worker process and merge the reports.\n");
+    printf("                               Writes to --snapshot <file> and --results <file> [runs] if given.\n");
+    printf("  --help                       Print this message without touching Vulkan.\n");
+}
+
+/**
+ * Gets the time elapsed since <code>begin</code>.
+ * @param begin The start time.
+ * @return the elapsed time in nanoseconds.
+ */
+double elapsedNs(std::chrono::steady_clock::time_point begin)
+{
+    return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count();
+}
+
+/**
+ * Measures the startup cost of binding the Vulkan loader and the per call cost of a device level call made through
+ * the loader trampoline versus the device's dispatch table.
+ * @param iterations The number of calls to time for each path.
+ * @return the process exit code.
+ */
+int benchLoader(uint32_t iterations)
+{
+    auto begin = std::chrono::steady_clock::now();
+    Instance instance("Vulkan Info CLI", "No engine", {}, {});
+    double instanceNs = elapsedNs(begin);
+
+    printf("Loader: %s\n", VulkanLoader::isDynamic() ? "dynamic (dlopen on first use)" : "linked");
+    printf("Loader initialize: %.1f us\n", (double)VulkanLoader::getInitializeNs() / 1000.0);
+    printf("First Instance (including initialize): %.1f us\n", instanceNs / 1000.0);
+
+    std::vector<VkPhysicalDevice> devices = instance.getPhysicalDevices();
+    if (devices.empty())
+    {
+        fprintf(stderr, "No physical devices.\n");
+        return 1;
+    }
+
+    begin = std::chrono::steady_clock::now();
+    LogicalDevice device(devices[0]);
+    double deviceNs = elapsedNs(begin);
+    if (device.getHandle() == VK_NULL_HANDLE)
+    {
+        fprintf(stderr, "Failed to create a logical device.\n");
+        return 1;
+    }
+
+    printf("LogicalDevice (including dispatch table): %.1f us\n", deviceNs / 1000.0);
+
+    VkDevice handle = device.getHandle();
+    uint32_t familyIndex = device.getQueueFamilyIndex();
+    const VulkanLoader::DeviceDispatch& dispatch = device.getDispatch();
+    VkQueue queue = VK_NULL_HANDLE;
+
+    begin = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        vkGetDeviceQueue(handle, familyIndex, 0, &queue);
+    }
+    double trampolineNs = elapsedNs(begin) / iterations;
+
+    begin = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        dispatch.vkGetDeviceQueue(handle, familyIndex, 0, &queue);
+    }
+    double dispatchNs = elapsedNs(begin) / iterations;
+
+    printf("vkGetDeviceQueue through the loader trampoline: %.2f ns/call\n", trampolineNs);
+    printf("vkGetDeviceQueue through the dispatch table: %.2f ns/call\n", dispatchNs);
+    return 0;
+}
+
+/**
+ * Prints the instance and physical device info gathered by the native core.
+ * @param instance The <code>Instance</code> to query.
+ */
+void printVkInfo(const Instance& instance)
+{
+    VKINFO_TRACE_FUNCTION();
+
+    printf("Application name: %s\n", instance.getAppName().c_str());
+    printf("Engine name: %s\n", instance.getEngineName().c_str());
+    printf("Number of available extensions: %u\n", instance.getNumAvailableExtensions());
+    printf("Number of available layers: %u\n", instance.getNumAvailableLayers());
+
+    const EnumerationSnapshot& snapshot = EnumerationSnapshot::get();
+    for (uint32_t i = 0; i < snapshot.getLayerCount(); i++)
+    {
+        printf("  %s (%u extensions)\n", snapshot.getLayers()[i].layerName, snapshot.getLayerExtensionCount(i));
+    }
+
+    printf("Number of devices: %u\n", instance.getNumberPhysicalDevices());
+
+    std::vector<VkPhysicalDevice> devices = instance.getPhysicalDevices();
+    for (size_t i = 0; i < devices.size(); i++)
+    {
+        VkPhysicalDeviceProperties properties = PhysicalDevice::getDeviceProperties(devices[i]);
+        VkPhysicalDeviceMemoryProperties memoryProperties = PhysicalDevice::getMemoryProperties(devices[i]);
+
+        printf("\nDevice %zu: %s\n", i, properties.deviceName);
+        printf("  API version: %u.%u.%u.%u\n",
+               VK_API_VERSION_VARIANT(properties.apiVersion),
+               VK_API_VERSION_MAJOR(properties.apiVersion),
+               VK_API_VERSION_MINOR(properties.apiVersion),
+               VK_API_VERSION_PATCH(properties.apiVersion));
+        printf("  Driver version: 0x%x\n", properties.driverVersion);
+        printf("  Vendor ID: 0x%x\n", properties.vendorID);
+        printf("  Device ID: 0x%x\n", properties.deviceID);
+        printf("  Memory types: %u\n", memoryProperties.memoryTypeCount);
+        printf("  Memory heaps: %u\n", memoryProperties.memoryHeapCount);
+    }
+}
+
+/**
+ * Prints the queue family classification and the chosen assignment of every physical device, then measures
+ * <code>vkCmdCopyBuffer</code> throughput on each transfer capable family.
+ * @param copyMiB The size of each copy in MiB.
+ * @return the process exit code.
+ */
+int printQueueTopology(uint32_t copyMiB)
+{
+    std::shared_ptr<Instance> instance = InstancePool::acquire("Vulkan Info CLI", "No engine", {}, {});
+    if (instance == nullptr)
+    {
+        fprintf(stderr, "Failed to create a Vulkan instance.\n");
+        return 1;
+    }
+
+    std::vector<VkPhysicalDevice> devices = instance->getPhysicalDevices();
+    for (size_t i = 0; i < devices.size(); i++)
+    {
+        VkPhysicalDeviceProperties properties = PhysicalDevice::getDeviceProperties(devices[i]);
+        std::vector<QueueTopology::FamilyInfo> families = QueueTopology::classify(devices[i]);
+
+        printf("Device %zu: %s\n", i, properties.deviceName);
+        printf("  family  queues  G C T  dedicated  timestamp bits  granularity\n");
+        for (const QueueTopology::FamilyInfo& family : families)
+        {
+            printf("  %6u  %6u  %c %c %c  %-9s  %14u  %ux%ux%u\n",
+                   family.index,
+                   family.queueCount,
+                   family.graphics ? 'x' : '-',
+                   family.compute ? 'x' : '-',
+                   family.transfer ? 'x' : '-',
+                   family.dedicatedTransfer ? "transfer" : (family.dedicatedCompute ? "compute" : ""),
+                   family.timestampValidBits,
+                   family.minImageTransferGranularity.width,
+                   family.minImageTransferGranularity.height,
+                   family.minImageTransferGranularity.depth);
+        }
+
+        QueueFamilyIndicies indices = QueueTopology::solve(families);
+        printf("  Assignment: graphics %d, compute %d, transfer %d\n",
+               indices.graphicsFamily.has_value() ? (int)indices.graphicsFamily.value() : -1,
+               indices.computeFamily.has_value() ? (int)indices.computeFamily.value() : -1,
+               indices.transferFamily.has_value() ? (int)indices.transferFamily.value() : -1);
+
+        for (uint32_t familyIndex : QueueTopology::getTransferCandidates(families))
+        {
+            QueueTopology::CopyThroughput throughput = QueueTopology::measureCopyThroughput(devices[i], familyIndex, (VkDeviceSize)copyMiB << 20, 8);
+            if (throughput.measured)
+            {
+                printf("  Family %u vkCmdCopyBuffer: %.2f GB/s (%llu bytes in %.3f ms)\n",
+                       familyIndex,
+                       throughput.gigabytesPerSecond,
+                       (unsigned long long)throughput.bytesCopied,
+                       throughput.seconds * 1000.0);
+            }
+            else
+            {
+                printf("  Family %u vkCmdCopyBuffer: measurement failed\n", familyIndex);
+            }
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Formats memory property flags as a short string, e.g. <code>DL|HV|HC</code>.
+ */
+std::string getMemoryFlagsString(VkMemoryPropertyFlags flags)
+{
+    const char* names[] = {"DL", "HV", "HC", "HCa", "LA", "P"};
+    std::string text;
+    for (uint32_t bit = 0; bit < sizeof(names) / sizeof(names[0]); bit++)
+    {
+        if (flags & (1u << bit))
+        {
+            text += text.empty() ? names[bit] : std::string("|") + names[bit];
+        }
+    }
+
+    return text.empty() ? "-" : text;
+}
+
+/**
+ * Measures the copy bandwidth of every memory type of every physical device, then prints the type the selector
+ * ranks first for common allocation patterns and how long a lookup takes.
+ * @param copyMiB The size of each copy in MiB.
+ * @return the process exit code.
+ */
+int printMemoryTypes(uint32_t copyMiB)
+{
+    std::shared_ptr<Instance> instance = InstancePool::acquire("Vulkan Info CLI", "No engine", {}, {});
+    if (instance == nullptr)
+    {
+        fprintf(stderr, "Failed to create a Vulkan instance.\n");
+        return 1;
+    }
+
+    struct Usage
+    {
+        const char* name;
+        VkMemoryPropertyFlags required;
+        VkMemoryPropertyFlags preferred;
+    };
+
+    const Usage usages[] =
+    {
+        {"GPU only", 0, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT},
+        {"Upload", VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, 0},
+        {"Dynamic", VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT},
+        {"Readback", VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, VK_MEMORY_PROPERTY_HOST_CACHED_BIT},
+        {"Transient", 0, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT},
+    };
+
+    std::vector<VkPhysicalDevice> devices = instance->getPhysicalDevices();
+    for (size_t i = 0; i < devices.size(); i++)
+    {
+        VkPhysicalDeviceProperties properties = PhysicalDevice::getDeviceProperties(devices[i]);
+        QueueFamilyIndicies indices = QueueTopology::solve(QueueTopology::classify(devices[i]));
+        uint32_t familyIndex = indices.transferFamily.has_value() ? indices.transferFamily.value() : 0;
+
+        std::vector<double> bandwidth = MemoryTypeSelector::measureBandwidth(devices[i], familyIndex, (VkDeviceSize)copyMiB << 20, 8);
+        MemoryTypeSelector selector(PhysicalDevice::getMemoryProperties(devices[i]), bandwidth);
+        const VkPhysicalDeviceMemoryProperties& memoryProperties = selector.getMemoryProperties();
+
+        printf("Device %zu: %s\n", i, properties.deviceName);
+        printf("  type  heap  heap MiB  copy GB/s  flags\n");
+        for (uint32_t type = 0; type < memoryProperties.memoryTypeCount; type++)
+        {
+            const VkMemoryType& memoryType = memoryProperties.memoryTypes[type];
+            printf("  %4u  %4u  %8llu  %9.2f  %s\n",
+                   type,
+                   memoryType.heapIndex,
+                   (unsigned long long)(memoryProperties.memoryHeaps[memoryType.heapIndex].size >> 20),
+                   bandwidth[type],
+                   getMemoryFlagsString(memoryType.propertyFlags).c_str());
+        }
+
+        for (const Usage& usage : usages)
+        {
+            printf("  %-10s", usage.name);
+            for (uint32_t type : selector.getRanking(usage.required, usage.preferred))
+            {
+                printf(" %u", type);
+            }
+            printf("\n");
+        }
+
+        // Vary the allowed types so the lookups cannot be folded away.
+        const uint32_t lookupCount = 10000000;
+        uint32_t checksum = 0;
+        auto begin = std::chrono::steady_clock::now();
+        for (uint32_t lookup = 0; lookup < lookupCount; lookup++)
+        {
+            const Usage& usage = usages[lookup % (sizeof(usages) / sizeof(usages[0]))];
+            checksum += selector.find(~(lookup & 0x3u), usage.required, usage.preferred);
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        printf("  Lookup: %.2f ns (checksum %u)\n", seconds * 1e9 / lookupCount, checksum);
+    }
+
+    return 0;
+}
+
+/**
+ * Checks the pipeline layouts described in a file against the limits of every physical device and prints each
+ * exceeded limit.
+ * @param path The layout description file (see PipelineLayoutChecker.h).
+ * @return the process exit code: 0 if every layout fits every device, 2 if some do not.
+ */
+int checkLayouts(const std::string& path)
+{
+    std::vector<PipelineLayoutChecker::Layout> layouts;
+    size_t errorLine = 0;
+    if (!PipelineLayoutChecker::readLayouts(path, layouts, errorLine))
+    {
+        fprintf(stderr, errorLine > 0 ? "%s:%zu: malformed layout.\n" : "Failed to read %s.\n", path.c_str(), errorLine);
+        return 1;
+    }
+
+    std::shared_ptr<Instance> instance = InstancePool::acquire("Vulkan Info CLI", "No engine", {}, {});
+    if (instance == nullptr)
+    {
+        fprintf(stderr, "Failed to create a Vulkan instance.\n");
+        return 1;
+    }
+
+    PipelineLayoutChecker checker;
+    std::vector<VkPhysicalDevice> devices = instance->getPhysicalDevices();
+    std::vector<VkPhysicalDeviceProperties> properties;
+    std::vector<uint32_t> deviceRows;
+    for (VkPhysicalDevice device : devices)
+    {
+        properties.push_back(PhysicalDevice::getDeviceProperties(device));
+        deviceRows.push_back(checker.addDevice(properties.back().limits));
+    }
+
+    std::vector<uint32_t> violations = checker.check(layouts);
+    uint32_t failures = 0;
+    for (size_t layout = 0; layout < layouts.size(); layout++)
+    {
+        for (size_t i = 0; i < devices.size(); i++)
+        {
+            const uint32_t mask = violations[layout * checker.getRowCount() + deviceRows[i]];
+            for (uint32_t limit = 0; limit < PipelineLayoutChecker::LimitCount; limit++)
+            {
+                if (mask & (1u << limit))
+                {
+                    printf("%s: device %zu (%s): %s %u > %u\n",
+                           layouts[layout].name.c_str(),
+                           i,
+                           properties[i].deviceName,
+                           PipelineLayoutChecker::getLimitName(limit),
+                           layouts[layout].demand[limit],
+                           checker.getLimit(deviceRows[i], limit));
+                }
+            }
+            failures += mask != 0 ? 1 : 0;
+        }
+    }
+
+    printf("%zu layouts, %zu devices: %u layout/device pairs exceed a limit\n", layouts.size(), devices.size(), failures);
+    return failures == 0 ? 0 : 2;
+}
+
+/**
+ * Prints what the driver allocated through the allocator since <code>before</code> was taken, then starts the next
+ * measurement: the returned totals are the new baseline and the peak is marked again.
+ * @param operation The name of the measured operation.
+ * @return the totals to pass for the next operation.
+ */
+HostAllocator::Totals printHostMemoryCost(const char* operation, HostAllocator& allocator, const HostAllocator::Totals& before)
+{
+    HostAllocator::Totals after = allocator.getTotals();
+    printf("  %-36s %6llu allocs %6llu frees %10llu bytes  peak %10llu  live %+lld\n",
+           operation,
+           (unsigned long long)(after.allocationCount - before.allocationCount),
+           (unsigned long long)(after.freeCount - before.freeCount),
+           (unsigned long long)(after.allocatedBytes - before.allocatedBytes),
+           (unsigned long long)(allocator.getPeakSinceMark() - before.liveBytes),
+           (long long)after.liveBytes - (long long)before.liveBytes);
+
+    allocator.markPeak();
+    return after;
+}
+
+/**
+ * Creates an instance and a device on every physical device with a <code>HostAllocator</code> and reports the
+ * driver's host memory cost of each step, then the totals per allocation scope.
+ * @param arena Whether to use the arena mode instead of the tracking mode.
+ * @return the process exit code.
+ */
+int printHostMemory(bool arena)
+{
+    std::shared_ptr<HostAllocator> allocator = std::make_shared<HostAllocator>(arena ? HostAllocator::Mode::Arena : HostAllocator::Mode::Tracking);
+    HostAllocator::Totals mark = allocator->getTotals();
+    allocator->markPeak();
+
+    printf("Host allocations through VkAllocationCallbacks (%s mode):\n", arena ? "arena" : "tracking");
+
+    std::unique_ptr<Instance> instance(new Instance("Vulkan Info CLI", "No engine", {}, {}, VK_API_VERSION_1_0, allocator));
+    mark = printHostMemoryCost("vkCreateInstance", *allocator, mark);
+    if (instance->getHandle() == VK_NULL_HANDLE)
+    {
+        fprintf(stderr, "Failed to create a Vulkan instance.\n");
+        return 1;
+    }
+
+    std::vector<VkPhysicalDevice> devices = instance->getPhysicalDevices();
+    mark = printHostMemoryCost("vkEnumeratePhysicalDevices", *allocator, mark);
+
+    for (size_t i = 0; i < devices.size(); i++)
+    {
+        VkPhysicalDeviceProperties properties = PhysicalDevice::getDeviceProperties(devices[i]);
+        QueueFamilyIndicies indices = QueueTopology::solve(QueueTopology::classify(devices[i]));
+        uint32_t familyIndex = indices.graphicsFamily.has_value() ? indices.graphicsFamily.value() : 0;
+        mark = printHostMemoryCost((std::string("Device ") + std::to_string(i) + " queries").c_str(), *allocator, mark);
+
+        std::unique_ptr<LogicalDevice> device(new LogicalDevice(devices[i], familyIndex, {}, allocator));
+        mark = printHostMemoryCost((std::string("vkCreateDevice (") + properties.deviceName + ")").c_str(), *allocator, mark);
+
+        device.reset();
+        mark = printHostMemoryCost("vkDestroyDevice", *allocator, mark);
+    }
+
+    instance.reset();
+    mark = printHostMemoryCost("vkDestroyInstance", *allocator, mark);
+
+    printf("Per scope:\n");
+    for (uint32_t scope = 0; scope < HostAllocator::ScopeCount; scope++)
+    {
+        HostAllocator::Totals totals = allocator->getTotals((VkSystemAllocationScope)scope);
+        printf("  %-9s %6llu allocs %10llu bytes  peak %10llu  live %llu  internal %llu\n",
+               HostAllocator::getScopeName((VkSystemAllocationScope)scope),
+               (unsigned long long)totals.allocationCount,
+               (unsigned long long)totals.allocatedBytes,
+               (unsigned long long)totals.peakBytes,
+               (unsigned long long)totals.liveBytes,
+               (unsigned long long)totals.internalBytes);
+    }
+
+    if (arena)
+    {
+        printf("Arena reserved: %zu bytes\n", allocator->getArenaReservedBytes());
+    }
+
+    return 0;
+}
+
+/**
+ * Runs the GPU/host timestamp calibration on every physical device and prints the offset, drift and resolution.
+ * @param windowSeconds How long to sample each device for.
+ * @return the process exit code.
+ */
+int printTimestampCalibration(double windowSeconds)
+{
+    std::shared_ptr<Instance> instance = InstancePool::acquire("Vulkan Info CLI", "No engine", {}, {});
+    if (instance == nullptr)
+    {
+        fprintf(stderr, "Failed to create a Vulkan instance.\n");
+        return 1;
+    }
+
+    std::vector<VkPhysicalDevice> devices = instance->getPhysicalDevices();
+    for (size_t i = 0; i < devices.size(); i++)
+    {
+        VkPhysicalDeviceProperties properties = PhysicalDevice::getDeviceProperties(devices[i]);
+        TimestampCalibration::Result result = TimestampCalibration::calibrate(instance->getHandle(), devices[i], windowSeconds, 100);
+
+        printf("Device %zu: %s\n", i, properties.deviceName);
+        printf("  timestampPeriod: %.3f ns, timestampComputeAndGraphics: %s\n",
+               result.timestampPeriod,
+               result.timestampComputeAndGraphics ? "true" : "false");
+        if (!result.valid)
+        {
+            printf("  Calibration failed or timestamps are not supported.\n");
+            continue;
+        }
+
+        printf("  Method: %s (queue family %u, %u valid bits)\n",
+               TimestampCalibration::getMethodName(result.method),
+               result.queueFamilyIndex,
+               result.timestampValidBits);
+        printf("  Measured resolution: %.3f ns\n", result.measuredResolutionNs);
+        printf("  Samples: %u over %.3f s\n", result.sampleCount, result.windowNs / 1e9);
+        printf("  Offset (host - GPU): %.0f ns\n", result.offsetNs);
+        printf("  Drift: %.3f ppm (%.3f us per minute), effective period %.6f ns\n",
+               result.driftPpm,
+               result.driftPpm * 60.0,
+               result.effectivePeriodNs);
+        printf("  Fit residual: %.0f ns RMS, mean pair uncertainty: %.0f ns\n", result.residualNs, result.pairUncertaintyNs);
+    }
+
+    return 0;
+}
+
+/**
+ * Samples the memory budget of the first physical device and prints the latest usage and budget of every heap once
+ * a second, draining the sampler the same way the Android monitor does.
+ * @param seconds How long to sample for.
+ * @return the process exit code.
+ */
+int printMemoryBudget(uint32_t seconds)
+{
+    std::unique_ptr<MemoryBudgetSampler> sampler = MemoryBudgetSampler::create("Vulkan Info CLI", "No engine", 0);
+    if (sampler == nullptr)
+    {
+        fprintf(stderr, "VK_EXT_memory_budget is not supported.\n");
+        return 1;
+    }
+
+    sampler->start(100);
+
+    std::vector<MemoryBudgetSampler::Sample> batch(MemoryBudgetSampler::RingCapacity);
+    std::vector<MemoryBudgetSampler::Sample> latest(sampler->getHeapCount());
+    uint64_t drainedCount = 0;
+    for (uint32_t second = 1; second <= seconds; second++)
+    {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+
+        size_t count = sampler->drain(batch.data(), batch.size());
+        for (size_t i = 0; i < count; i++)
+        {
+            if (batch[i].heapIndex < latest.size())
+            {
+                latest[batch[i].heapIndex] = batch[i];
+            }
+        }
+        drainedCount += count;
+
+        printf("t=%us", second);
+        for (size_t heap = 0; heap < latest.size(); heap++)
+        {
+            printf("  heap %zu: %.1f / %.1f MiB", heap, latest[heap].usage / (1024.0 * 1024.0), latest[heap].budget / (1024.0 * 1024.0));
+        }
+        printf("\n");
+    }
+
+    sampler->stop();
+    drainedCount += sampler->drain(batch.data(), batch.size());
+    printf("Ticks: %llu, samples drained: %llu, dropped: %llu\n",
+           (unsigned long long)sampler->getTickCount(),
+           (unsigned long long)drainedCount,
+           (unsigned long long)sampler->getDroppedCount());
+
+    return 0;
+}
+
+/**
+ * Set from SIGINT so a long <code>--throttle</code> run can be stopped and still print what it measured.
+ */
+std::atomic<bool> throttleCancelRequested(false);
+
+/**
+ * Runs the sustained compute workload on every physical device and prints the throughput of every second, the peak,
+ * the steady state and the throttling onset. Ctrl+C ends the current run early.
+ * @param minutes How long to run each device for.
+ * @return the process exit code.
+ */
+int printThrottling(double minutes)
+{
+    std::shared_ptr<Instance> instance = InstancePool::acquire("Vulkan Info CLI", "No engine", {}, {});
+    if (instance == nullptr)
+    {
+        fprintf(stderr, "Failed to create a Vulkan instance.\n");
+        return 1;
+    }
+
+    std::signal(SIGINT, [](int) { throttleCancelRequested.store(true); });
+
+    uint32_t durationSeconds = (uint32_t)(minutes * 60.0 + 0.5);
+    std::vector<VkPhysicalDevice> devices = instance->getPhysicalDevices();
+    for (size_t i = 0; i < devices.size(); i++)
+    {
+        VkPhysicalDeviceProperties properties = PhysicalDevice::getDeviceProperties(devices[i]);
+        printf("Device %zu: %s, running for %u s\n", i, properties.deviceName, durationSeconds > 0 ? durationSeconds : 1);
+        fflush(stdout);
+
+        throttleCancelRequested.store(false);
+        ThrottlingDetector::Result result = ThrottlingDetector::run(devices[i], durationSeconds > 0 ? durationSeconds : 1, &throttleCancelRequested);
+        if (!result.valid)
+        {
+            printf("  Sustained run failed.\n");
+            continue;
+        }
+
+        printf("  Queue family %u, %u dispatches (%.1f MFLOP) per batch\n",
+               result.queueFamilyIndex,
+               result.dispatchesPerBatch,
+               result.flopsPerBatch / 1e6);
+        for (uint32_t second = 0; second < result.completedSeconds; second++)
+        {
+            printf("  t=%4us %9.2f GFLOP/s\n", second, result.gflopsPerSecond[second]);
+        }
+
+        printf("  Peak: %.2f GFLOP/s at t=%us\n", result.peakGflops, result.peakSecond);
+        printf("  Steady state: %.2f GFLOP/s (%.1f%% of peak)\n", result.steadyStateGflops, result.steadyStateRatio * 100.0);
+        if (result.onsetSecond >= 0)
+        {
+            printf("  Throttling onset: t=%ds\n", result.onsetSecond);
+        }
+        else
+        {
+            printf("  No throttling detected.\n");
+        }
+    }
+
+    std::signal(SIGINT, SIG_DFL);
+    return 0;
+}
+
+/**
+ * Prints one configuration of the device creation profile.
+ * @param measurement The configuration.
+ */
+void printDeviceCost(const DeviceCreationProfiler::Measurement& measurement)
+{
+    if (!measurement.created)
+    {
+        printf("  %-48s creation failed\n", measurement.name.c_str());
+        return;
+    }
+
+    printf("  %-48s %10.1f %+10.1f", measurement.name.c_str(), measurement.createMicroseconds, measurement.createDelta);
+    if (measurement.dispatchMicroseconds > 0.0)
+    {
+        printf(" %10.1f %+10.1f\n", measurement.dispatchMicroseconds, measurement.dispatchDelta);
+    }
+    else
+    {
+        printf(" %10s %10s\n", "-", "-");
+    }
+}
+
+/**
+ * Profiles device creation on every physical device: the median <code>vkCreateDevice</code> time and the reference
+ * batch time with nothing enabled, then the change when a single supported feature or extension is enabled.
+ * @param iterations How many devices to create per configuration.
+ * @return the process exit code.
+ */
+int printDeviceCreationCost(uint32_t iterations)
+{
+    std::shared_ptr<Instance> instance = InstancePool::acquire("Vulkan Info CLI", "No engine", {}, {});
+    if (instance == nullptr)
+    {
+        fprintf(stderr, "Failed to create a Vulkan instance.\n");
+        return 1;
+    }
+
+    std::vector<VkPhysicalDevice> devices = instance->getPhysicalDevices();
+    for (size_t i = 0; i < devices.size(); i++)
+    {
+        VkPhysicalDeviceProperties properties = PhysicalDevice::getDeviceProperties(devices[i]);
+        printf("Device %zu: %s\n", i, properties.deviceName);
+        fflush(stdout);
+
+        DeviceCreationProfiler::Result result = DeviceCreationProfiler::run(devices[i], iterations);
+        if (!result.valid)
+        {
+            printf("  Profiling failed.\n");
+            continue;
+        }
+
+        printf("  Queue family %u, %u devices per configuration, %u dispatches per reference batch\n",
+               result.queueFamilyIndex,
+               result.iterations,
+               result.dispatchesPerBatch);
+        printf("  Baseline batch drift over the run: %.1f us\n", result.dispatchDrift);
+        printf("  %-48s %10s %10s %10s %10s\n", "Configuration", "Create us", "Delta", "Batch us", "Delta");
+        printDeviceCost(result.baseline);
+
+        for (const DeviceCreationProfiler::Measurement& measurement : result.features)
+        {
+            printDeviceCost(measurement);
+        }
+
+        for (const DeviceCreationProfiler::Measurement& measurement : result.extensions)
+        {
+            printDeviceCost(measurement);
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Records the same command buffers with a growing number of threads on every physical device and prints the
+ * recording throughput and scaling efficiency of each thread count.
+ * @param maxThreads The largest thread count.
+ * @return the process exit code.
+ */
+int printRecordingScaling(uint32_t maxThreads)
+{
+    std::shared_ptr<Instance> instance = InstancePool::acquire("Vulkan Info CLI", "No engine", {}, {});
+    if (instance == nullptr)
+    {
+        fprintf(stderr, "Failed to create a Vulkan instance.\n");
+        return 1;
+    }
+
+    std::vector<VkPhysicalDevice> devices = instance->getPhysicalDevices();
+    for (size_t i = 0; i < devices.size(); i++)
+    {
+        VkPhysicalDeviceProperties properties = PhysicalDevice::getDeviceProperties(devices[i]);
+        printf("Device %zu: %s\n", i, properties.deviceName);
+        fflush(stdout);
+
+        CommandRecordingBenchmark::Result result = CommandRecordingBenchmark::run(devices[i], maxThreads);
+        if (!result.valid)
+        {
+            printf("  Recording benchmark failed.\n");
+            continue;
+        }
+
+        printf("  Queue family %u, %u command buffers of %u dispatches, %llu commands per round\n",
+               result.queueFamilyIndex,
+               result.commandBufferCount,
+               result.dispatchesPerCommandBuffer,
+               (unsigned long long)result.commandsPerRound);
+        printf("  %7s %10s %14s %8s %10s %7s\n", "Threads", "Round ms", "Mcommands/s", "Speedup", "Efficiency", "Steals");
+        for (const CommandRecordingBenchmark::ThreadCountResult& threads : result.threadCounts)
+        {
+            printf("  %7u %10.2f %14.2f %7.2fx %9.1f%% %7llu\n",
+                   threads.threadCount,
+                   threads.seconds * 1e3,
+                   threads.commandsPerSecond / 1e6,
+                   threads.speedup,
+                   threads.efficiency * 100.0,
+                   (unsigned long long)threads.steals);
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Runs the descriptor benchmark on every physical device and prints each operation's rate per batch size.
+ * The instance is created for Vulkan 1.1 when the loader allows it, so update templates and descriptor indexing can
+ * be measured.
+ * @return the process exit code.
+ */
+int printDescriptorRates()
+{
+    std::shared_ptr<Instance> instance = InstancePool::acquire("Vulkan Info CLI", "No engine", {}, {}, VK_API_VERSION_1_1);
+    if (instance == nullptr)
+    {
+        instance = InstancePool::acquire("Vulkan Info CLI", "No engine", {}, {});
+    }
+
+    if (instance == nullptr)
+    {
+        fprintf(stderr, "Failed to create a Vulkan instance.\n");
+        return 1;
+    }
+
+    std::vector<VkPhysicalDevice> devices = instance->getPhysicalDevices();
+    for (size_t i = 0; i < devices.size(); i++)
+    {
+        VkPhysicalDeviceProperties properties = PhysicalDevice::getDeviceProperties(devices[i]);
+        printf("Device %zu: %s\n", i, properties.deviceName);
+        fflush(stdout);
+
+        DescriptorBenchmark::Result result = DescriptorBenchmark::run(*instance, devices[i]);
+        if (!result.valid)
+        {
+            printf("  Descriptor benchmark failed.\n");
+            continue;
+        }
+
+        printf("  Storage buffer descriptors per set: %u, update-after-bind: ", result.maxDescriptorCount);
+        if (result.updateAfterBindSupported)
+        {
+            printf("%u\n", result.maxUpdateAfterBindDescriptorCount);
+        }
+        else
+        {
+            printf("not supported\n");
+        }
+        printf("  Update templates: %s\n", result.templatesSupported ? "supported" : "not supported");
+
+        for (const DescriptorBenchmark::Series& series : result.series)
+        {
+            printf("  %s (million %s)\n", series.name.c_str(), series.unit.c_str());
+            for (const DescriptorBenchmark::Rate& rate : series.rates)
+            {
+                printf("    batch %6u: %12.3f\n", rate.batchSize, rate.opsPerSecond / 1e6);
+            }
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Runs the upload benchmark on every physical device and prints throughput and CPU time per upload method and size.
+ * @param maxMiB The largest upload in MiB.
+ * @return the process exit code.
+ */
+int printUploads(uint32_t maxMiB)
+{
+    std::shared_ptr<Instance> instance = InstancePool::acquire("Vulkan Info CLI", "No engine", {}, {}, VK_API_VERSION_1_1);
+    if (instance == nullptr)
+    {
+        instance = InstancePool::acquire("Vulkan Info CLI", "No engine", {}, {});
+    }
+
+    if (instance == nullptr)
+    {
+        fprintf(stderr, "Failed to create a Vulkan instance.\n");
+        return 1;
+    }
+
+    std::vector<VkPhysicalDevice> devices = instance->getPhysicalDevices();
+    for (size_t i = 0; i < devices.size(); i++)
+    {
+        VkPhysicalDeviceProperties properties = PhysicalDevice::getDeviceProperties(devices[i]);
+        printf("Device %zu: %s\n", i, properties.deviceName);
+        fflush(stdout);
+
+        UploadBenchmark::Result result = UploadBenchmark::run(*instance, devices[i], (VkDeviceSize)maxMiB << 20);
+        if (!result.valid)
+        {
+            printf("  Upload benchmark failed.\n");
+            continue;
+        }
+
+        printf("  Queue family: %u\n", result.queueFamilyIndex);
+        for (const UploadBenchmark::Method& method : result.methods)
+        {
+            if (!method.supported)
+            {
+                printf("  %s: not supported\n", method.name.c_str());
+                continue;
+            }
+
+            printf("  %s (memory type %u)\n", method.name.c_str(), method.memoryTypeIndex);
+            for (const UploadBenchmark::Measurement& measurement : method.sizes)
+            {
+                printf("    %8llu KiB: %8.2f GB/s, %9.3f CPU ms/upload\n",
+                       (unsigned long long)(measurement.size >> 10), measurement.gigabytesPerSecond, measurement.cpuMillisecondsPerUpload);
+            }
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Runs the texture benchmark on every physical device and prints, per format, its format features, upload throughput
+ * per tiling and sampling rate per anisotropy limit.
+ * @return the process exit code.
+ */
+int printTextures()
+{
+    std::shared_ptr<Instance> instance = InstancePool::acquire("Vulkan Info CLI", "No engine", {}, {});
+    if (instance == nullptr)
+    {
+        fprintf(stderr, "Failed to create a Vulkan instance.\n");
+        return 1;
+    }
+
+    std::vector<VkPhysicalDevice> devices = instance->getPhysicalDevices();
+    for (size_t i = 0; i < devices.size(); i++)
+    {
+        VkPhysicalDeviceProperties properties = PhysicalDevice::getDeviceProperties(devices[i]);
+        printf("Device %zu: %s\n", i, properties.deviceName);
+        fflush(stdout);
+
+        TextureBenchmark::Result result = TextureBenchmark::run(devices[i]);
+        if (!result.valid)
+        {
+            printf("  Texture benchmark failed.\n");
+            continue;
+        }
+
+        printf("  Queue family: %u, %ux%u images, sampler anisotropy: ", result.queueFamilyIndex, TextureBenchmark::ImageExtent, TextureBenchmark::ImageExtent);
+        if (result.anisotropySupported)
+        {
+            printf("up to %.0fx\n", result.maxSamplerAnisotropy);
+        }
+        else
+        {
+            printf("not supported\n");
+        }
+
+        for (const TextureBenchmark::FormatResult& format : result.formats)
+        {
+            printf("  %s (linear features 0x%08x, optimal features 0x%08x)\n", format.name,
+                   format.properties.linearTilingFeatures, format.properties.optimalTilingFeatures);
+            if (!format.linearSupported && !format.optimalSupported)
+            {
+                printf("    not sampleable\n");
+                continue;
+            }
+
+            if (format.linearSupported)
+            {
+                printf("    Linear:  upload %8.2f GB/s, sampling %8.2f Gsamples/s\n",
+                       format.linearUploadGigabytesPerSecond, format.linearSampling.gigasamplesPerSecond);
+            }
+
+            if (format.optimalSupported)
+            {
+                printf("    Optimal: upload %8.2f GB/s\n", format.optimalUploadGigabytesPerSecond);
+                for (const TextureBenchmark::Sampling& sampling : format.optimalSampling)
+                {
+                    printf("      %4.0fx anisotropy: %8.2f Gsamples/s\n", sampling.maxAnisotropy, sampling.gigasamplesPerSecond);
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Runs the transient attachment benchmark on every physical device and prints, per memory placement, how much memory
+ * the transient attachments allocate, how much of it is committed and the time per render pass.
+ * @param passCount The number of render passes per submission.
+ * @return the process exit code.
+ */
+int printTransientAttachments(uint32_t passCount)
+{
+    std::shared_ptr<Instance> instance = InstancePool::acquire("Vulkan Info CLI", "No engine", {}, {});
+    if (instance == nullptr)
+    {
+        fprintf(stderr, "Failed to create a Vulkan instance.\n");
+        return 1;
+    }
+
+    std::vector<VkPhysicalDevice> devices = instance->getPhysicalDevices();
+    for (size_t i = 0; i < devices.size(); i++)
+    {
+        VkPhysicalDeviceProperties properties = PhysicalDevice::getDeviceProperties(devices[i]);
+        printf("Device %zu: %s\n", i, properties.deviceName);
+        fflush(stdout);
+
+        TransientAttachmentBenchmark::Result result = TransientAttachmentBenchmark::run(devices[i], passCount);
+        if (!result.valid)
+        {
+            printf("  Transient attachment benchmark failed.\n");
+            continue;
+        }
+
+        printf("  Queue family: %u, %ux%u, %ux samples, depth format %d, %u passes\n", result.queueFamilyIndex,
+               TransientAttachmentBenchmark::Width, TransientAttachmentBenchmark::Height, (uint32_t)result.samples, (int)result.depthFormat, passCount);
+        for (const TransientAttachmentBenchmark::Measurement& measurement : result.measurements)
+        {
+            if (!measurement.supported)
+            {
+                printf("  %-17s not supported\n", measurement.name);
+                continue;
+            }
+
+            printf("  %-17s type %u: %8.2f MiB allocated, %8.2f MiB committed, %8.3f ms/pass\n", measurement.name, measurement.memoryTypeIndex,
+                   measurement.allocatedBytes / (1024.0 * 1024.0), measurement.committedBytes / (1024.0 * 1024.0), measurement.millisecondsPerPass);
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Runs the regression benchmarks on every physical device and appends the samples to a results file.
+ * @param path The results file.
+ * @param runs The number of samples per benchmark and device.
+ * @return the process exit code.
+ */
+int recordResults(const std::string& path, uint32_t runs)
+{
+    std::shared_ptr<Instance> instance = InstancePool::acquire("Vulkan Info CLI", "No engine", {}, {});
+    if (instance == nullptr)
+    {
+        fprintf(stderr, "Failed to create a Vulkan instance.\n");
+        return 1;
+    }
+
+    std::vector<BenchmarkResults::Sample> samples;
+    std::vector<VkPhysicalDevice> devices = instance->getPhysicalDevices();
+    for (size_t i = 0; i < devices.size(); i++)
+    {
+        VkPhysicalDeviceProperties properties = PhysicalDevice::getDeviceProperties(devices[i]);
+        printf("Device %zu: %s, driver 0x%08x\n", i, properties.deviceName, properties.driverVersion);
+        fflush(stdout);
+
+        std::vector<BenchmarkResults::Sample> deviceSamples = BenchmarkResults::collect(devices[i], runs);
+        printf("  %zu samples\n", deviceSamples.size());
+        samples.insert(samples.end(), deviceSamples.begin(), deviceSamples.end());
+    }
+
+    if (!BenchmarkResults::writeFile(path, samples.data(), samples.size()))
+    {
+        fprintf(stderr, "Failed to write %s.\n", path.c_str());
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * Compares the samples of each driver version in a results file against the driver version recorded before it and
+ * prints the medians, the relative change and the one-sided p-value per device and benchmark.
+ * @param path The results file.
+ * @param alpha The significance level.
+ * @return the process exit code: 2 if any comparison is a regression.
+ */
+int printRegressions(const std::string& path, double alpha)
+{
+    // Changes below 2% are within the usual run to run noise of a busy desktop, however significant.
+    const double minimumChange = 0.02;
+
+    std::vector<BenchmarkResults::Sample> samples;
+    if (!BenchmarkResults::readFile(path, samples))
+    {
+        fprintf(stderr, "Failed to read all of %s, comparing the %zu samples read.\n", path.c_str(), samples.size());
+        if (samples.empty())
+        {
+            return 1;
+        }
+    }
+
+    std::vector<BenchmarkResults::Report> reports = BenchmarkResults::analyze(samples, alpha, minimumChange);
+    printf("%zu samples, %zu comparisons, alpha %.3f, minimum change %.0f%%\n", samples.size(), reports.size(), alpha, minimumChange * 100.0);
+
+    bool regressed = false;
+    for (const BenchmarkResults::Report& report : reports)
+    {
+        const BenchmarkResults::Comparison& comparison = report.comparison;
+        printf("%04x:%04x %-20s driver 0x%08x -> 0x%08x: ", report.vendorId, report.deviceId, report.benchmarkId.c_str(),
+               report.baselineDriverVersion, report.candidateDriverVersion);
+        if (!comparison.valid)
+        {
+            printf("too few samples (%zu vs %zu)\n", comparison.baselineCount, comparison.candidateCount);
+            continue;
+        }
+
+        printf("median %.3f -> %.3f (%+.1f%%), p %.4f%s\n", comparison.baselineMedian, comparison.candidateMedian,
+               comparison.change * 100.0, comparison.pValue, comparison.regression ? "  REGRESSION" : "");
+        regressed = regressed || comparison.regression;
+    }
+
+    return regressed ? 2 : 0;
+}
+
+/**
+ * Profiles every ICD manifest in its own worker process, at most one worker per core, and prints one merged report:
+ * how each worker ended, the devices and benchmark medians per ICD and the capabilities that differ between them.
+ * @param manifestPaths The ICD manifest files.
+ * @param runs The samples per benchmark and device.
+ * @param snapshotPath If not empty, the merged capability snapshots are appended to this file.
+ * @param resultsPath If not empty, the merged benchmark samples are appended to this file.
+ * @return the process exit code: 1 if any worker did not complete.
+ */
+int printIcdBatch(const std::vector<std::string>& manifestPaths, uint32_t runs, const std::string& snapshotPath, const std::string& resultsPath)
+{
+    // Long enough for the benchmarks on a software rasterizer, short enough that a hung driver does not stall the lab.
+    const double timeoutSeconds = 600.0;
+    const uint32_t maxWorkers = std::thread::hardware_concurrency();
+
+    std::vector<IcdBatch::Worker> workers = IcdBatch::run(manifestPaths, maxWorkers, runs, timeoutSeconds);
+
+    bool allCompleted = true;
+    std::vector<CapabilitySnapshot::Record> records;
+    std::vector<BenchmarkResults::Sample> samples;
+    for (size_t i = 0; i < workers.size(); i++)
+    {
+        const IcdBatch::Worker& worker = workers[i];
+        printf("ICD %zu: %s\n", i, worker.manifestPath.c_str());
+        printf("  %s", IcdBatch::getStatusName(worker.status));
+        if (worker.status == IcdBatch::Status::Crashed)
+        {
+            printf(" (signal %d, %s)", worker.signal, strsignal(worker.signal));
+        }
+        else if (worker.status == IcdBatch::Status::Failed)
+        {
+            printf(" (exit code %d%s)", worker.exitCode, worker.streamValid ? "" : ", malformed stream");
+        }
+        printf(" after %.1f s, %zu devices, %zu samples\n", worker.seconds, worker.records.size(), worker.samples.size());
+
+        for (const CapabilitySnapshot::Record& record : worker.records)
+        {
+            const uint32_t vendorId = (uint32_t)record.values[CapabilityFields::vendorID];
+            const uint32_t deviceId = (uint32_t)record.values[CapabilityFields::deviceID];
+            const uint32_t driverVersion = (uint32_t)record.values[CapabilityFields::driverVersion];
+            const uint32_t apiVersion = (uint32_t)record.values[CapabilityFields::apiVersion];
+            printf("  Device %04x:%04x, driver 0x%08x, API %u.%u.%u\n", vendorId, deviceId, driverVersion,
+                   VK_API_VERSION_MAJOR(apiVersion), VK_API_VERSION_MINOR(apiVersion), VK_API_VERSION_PATCH(apiVersion));
+
+            std::map<std::string, std::vector<double>> values;
+            for (const BenchmarkResults::Sample& sample : worker.samples)
+            {
+                if (sample.vendorId == vendorId && sample.deviceId == deviceId && sample.driverVersion == driverVersion)
+                {
+                    values[std::string(sample.benchmarkId, strnlen(sample.benchmarkId, BenchmarkResults::BenchmarkIdSize))].push_back(sample.value);
+                }
+            }
+
+            for (auto& benchmark : values)
+            {
+                std::sort(benchmark.second.begin(), benchmark.second.end());
+                printf("    %-20s median %10.3f over %zu runs\n", benchmark.first.c_str(), benchmark.second[benchmark.second.size() / 2], benchmark.second.size());
+            }
+        }
+
+        allCompleted = allCompleted && worker.status == IcdBatch::Status::Completed;
+        records.insert(records.end(), worker.records.begin(), worker.records.end());
+        samples.insert(samples.end(), worker.samples.begin(), worker.samples.end());
+    }
+
+    if (records.size() > 1)
+    {
+        printf("\nCapabilities that differ between the %zu devices:\n", records.size());
+        uint32_t differingCount = 0;
+        for (uint32_t field = 0; field < CapabilityFields::Count; field++)
+        {
+            bool differs = false;
+            for (const CapabilitySnapshot::Record& record : records)
+            {
+                differs = differs || record.values[field] != records[0].values[field];
+            }
+
+            if (!differs)
+            {
+                continue;
+            }
+
+            const CapabilityFields::Field& info = CapabilityFields::get(field);
+            printf("  %-45s", info.name);
+            for (const CapabilitySnapshot::Record& record : records)
+            {
+                printf(" %14g", CapabilityFields::toDouble(info.kind, record.values[field]));
+            }
+            printf("\n");
+            differingCount++;
+        }
+
+        if (differingCount == 0)
+        {
+            printf("  none\n");
+        }
+    }
+
+    if (!snapshotPath.empty() && !CapabilitySnapshot::writeFile(snapshotPath, records.data(), records.size(), true))
+    {
+        fprintf(stderr, "Failed to write %s.\n", snapshotPath.c_str());
+        return 1;
+    }
+
+    if (!resultsPath.empty() && !BenchmarkResults::writeFile(resultsPath, samples.data(), samples.size()))
+    {
+        fprintf(stderr, "Failed to write %s.\n", resultsPath.c_str());
+        return 1;
+    }
+
+    return allCompleted ? 0 : 1;
+}
+
+int main(int argc, char** argv)
+{
+    std::string tracePath;
+    std::string snapshotPath;
+    bool benchLoaderMode = false;
+    uint32_t benchIterations = 1000000;
+    bool queuesMode = false;
+    uint32_t copyMiB = 64;
+    bool memoryTypesMode = false;
+    std::string layoutsPath;
+    bool hostMemoryMode = false;
+    bool hostMemoryArena = false;
+    bool calibrateMode = false;
+    double calibrateSeconds = 10.0;
+    bool memoryBudgetMode = false;
+    uint32_t memoryBudgetSeconds = 10;
+    bool throttleMode = false;
+    double throttleMinutes = 5.0;
+    bool deviceCostMode = false;
+    uint32_t deviceCostIterations = 20;
+    bool recordScalingMode = false;
+    bool descriptorsMode = false;
+    bool uploadsMode = false;
+    uint32_t uploadMiB = 64;
+    bool texturesMode = false;
+    bool transientMode = false;
+    uint32_t transientPasses = 100;
+    std::string resultsPath;
+    uint32_t resultsRuns = 10;
+    std::string regressionsPath;
+    double regressionsAlpha = 0.05;
+    std::vector<std::string> icdManifests;
+    uint32_t recordThreads = std::thread::hardware_concurrency();
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+        {
+            tracePath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--snapshot") == 0 && i + 1 < argc)
+        {
+            snapshotPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--bench-loader") == 0)
+        {
+            benchLoaderMode = true;
+            if (i + 1 < argc && argv[i + 1][0] != '-')
+            {
+                benchIterations = (uint32_t)strtoul(argv[++i], nullptr, 10);
+            }
+        }
+        else if (strcmp(argv[i], "--queues") == 0)
+        {
+            queuesMode = true;
+            if (i + 1 < argc && argv[i + 1][0] != '-')
+            {
+                copyMiB = (uint32_t)strtoul(argv[++i], nullptr, 10);
+            }
+        }
+        else if (strcmp(argv[i], "--memory-types") == 0)
+        {
+            memoryTypesMode = true;
+            if (i + 1 < argc && argv[i + 1][0] != '-')
+            {
+                copyMiB = (uint32_t)strtoul(argv[++i], nullptr, 10);
+            }
+        }
+        else if (strcmp(argv[i], "--check-layouts") == 0 && i + 1 < argc)
+        {
+            layoutsPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--host-memory") == 0)
+        {
+            hostMemoryMode = true;
+            if (i + 1 < argc && strcmp(argv[i + 1], "arena") == 0)
+            {
+                hostMemoryArena = true;
+                i++;
+            }
+        }
+        else if (strcmp(argv[i], "--calibrate") == 0)
+        {
+            calibrateMode = true;
+            if (i + 1 < argc && argv[i + 1][0] != '-')
+            {
+                calibrateSeconds = strtod(argv[++i], nullptr);
+            }
+        }
+        else if (strcmp(argv[i], "--memory-budget") == 0)
+        {
+            memoryBudgetMode = true;
+            if (i + 1 < argc && argv[i + 1][0] != '-')
+            {
+                memoryBudgetSeconds = (uint32_t)strtoul(argv[++i], nullptr, 10);
+            }
+        }
+        else if (strcmp(argv[i], "--throttle") == 0)
+        {
+            throttleMode = true;
+            if (i + 1 < argc && argv[i + 1][0] != '-')
+            {
+                throttleMinutes = strtod(argv[++i], nullptr);
+            }
+        }
+        else if (strcmp(argv[i], "--device-cost") == 0)
+        {
+            deviceCostMode = true;
+            if (i + 1 < argc && argv[i + 1][0] != '-')
+            {
+                deviceCostIterations = (uint32_t)strtoul(argv[++i], nullptr, 10);
+            }
+        }
+        else if (strcmp(argv[i], "--record-scaling") == 0)
+        {
+            recordScalingMode = true;
+            if (i + 1 < argc && argv[i + 1][0] != '-')
+            {
+                recordThreads = (uint32_t)strtoul(argv[++i], nullptr, 10);
+            }
+        }
+        else if (strcmp(argv[i], "--descriptors") == 0)
+        {
+            descriptorsMode = true;
+        }
+        else if (strcmp(argv[i], "--uploads") == 0)
+        {
+            uploadsMode = true;
+            if (i + 1 < argc && argv[i + 1][0] != '-')
+            {
+                uploadMiB = (uint32_t)strtoul(argv[++i], nullptr, 10);
+            }
+        }
+        else if (strcmp(argv[i], "--textures") == 0)
+        {
+            texturesMode = true;
+        }
+        else if (strcmp(argv[i], "--transient") == 0)
+        {
+            transientMode = true;
+            if (i + 1 < argc && argv[i + 1][0] != '-')
+            {
+                transientPasses = (uint32_t)strtoul(argv[++i], nullptr, 10);
+            }
+        }
+        else if (strcmp(argv[i], "--results") == 0 && i + 1 < argc)
+        {
+            resultsPath = argv[++i];
+            if (i + 1 < argc && argv[i + 1][0] != '-')
+            {
+                resultsRuns = (uint32_t)strtoul(argv[++i], nullptr, 10);
+            }
+        }
+        else if (strcmp(argv[i], "--regressions") == 0 && i + 1 < argc)
+        {
+            regressionsPath = argv[++i];
+            if (i + 1 < argc && argv[i + 1][0] != '-')
+            {
+                regressionsAlpha = strtod(argv[++i], nullptr);
+            }
+        }
+        else if (strcmp(argv[i], "--icd-batch") == 0 && i + 1 < argc)
+        {
+            while (i + 1 < argc && argv[i + 1][0] != '-')
+            {
+                icdManifests.push_back(argv[++i]);
+            }
+        }
+        else if (strcmp(argv[i], "--help") == 0)
+        {
+            printUsage(argv[0]);
+            return 0;
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (benchLoaderMode)
+    {
+        return benchLoader(benchIterations > 0 ? benchIterations : 1);
+    }
+
+    if (queuesMode)
+    {
+        return printQueueTopology(copyMiB > 0 ? copyMiB : 1);
+    }
+
+    if (memoryTypesMode)
+    {
+        return printMemoryTypes(copyMiB > 0 ? copyMiB : 1);
+    }
+
+    if (!layoutsPath.empty())
+    {
+        return checkLayouts(layoutsPath);
+    }
+
+    if (hostMemoryMode)
+    {
+        return printHostMemory(hostMemoryArena);
+    }
+
+    if (calibrateMode)
+    {
+        return printTimestampCalibration(calibrateSeconds > 0.0 ? calibrateSeconds : 1.0);
+    }
+
+    if (memoryBudgetMode)
+    {
+        return printMemoryBudget(memoryBudgetSeconds > 0 ? memoryBudgetSeconds : 1);
+    }
+
+    if (throttleMode)
+    {
+        return printThrottling(throttleMinutes > 0.0 ? throttleMinutes : 1.0);
+    }
+
+    if (deviceCostMode)
+    {
+        return printDeviceCreationCost(deviceCostIterations > 0 ? deviceCostIterations : 1);
+    }
+
+    if (recordScalingMode)
+    {
+        return printRecordingScaling(recordThreads > 0 ? recordThreads : 1);
+    }
+
+    if (descriptorsMode)
+    {
+        return printDescriptorRates();
+    }
+
+    if (uploadsMode)
+    {
+        return printUploads(uploadMiB > 0 ? uploadMiB : 1);
+    }
+
+    if (texturesMode)
+    {
+        return printTextures();
+    }
+
+    if (transientMode)
+    {
+        return printTransientAttachments(transientPasses > 0 ? transientPasses : 1);
+    }
+
+    // Before anything creates an instance in this process: the workers are forked from it.
+    if (!icdManifests.empty())
+    {
+        return printIcdBatch(icdManifests, resultsRuns > 0 ? resultsRuns : 1, snapshotPath, resultsPath);
+    }
+
+    if (!resultsPath.empty())
+    {
+        return recordResults(resultsPath, resultsRuns > 0 ? resultsRuns : 1);
+    }
+
+    if (!regressionsPath.empty())
+    {
+        return printRegressions(regressionsPath, regressionsAlpha > 0.0 ? regressionsAlpha : 0.05);
+    }
+
+    {
+        VKINFO_TRACE_SCOPE("main");
+
+        std::shared_ptr<Instance> instance = InstancePool::acquire("Vulkan Info CLI", "No engine", {}, {});
+        if (instance == nullptr)
+        {
+            fprintf(stderr, "Failed to create a Vulkan instance.\n");
+            return 1;
+        }
+
+        printVkInfo(*instance);
+
+        if (!snapshotPath.empty())
+        {
+            std::vector<CapabilitySnapshot::Record> records;
+            for (VkPhysicalDevice device : instance->getPhysicalDevices())
+            {
+                records.push_back(CapabilitySnapshot::capture(device));
+            }
+
+            if (!CapabilitySnapshot::writeFile(snapshotPath, records.data(), records.size(), true))
+            {
+                fprintf(stderr, "Failed to write %s.\n", snapshotPath.c_str());
+            }
+        }
+        printf("\nLoader enumeration calls (manifest scans): %u, snapshot size: %zu bytes\n",
+               EnumerationSnapshot::getLoaderScanCount(),
+               EnumerationSnapshot::get().getSizeInBytes());
+
+        // Destroy the pooled instance here rather than during static destruction, so it still shows in the trace.
+        instance.reset();
+        InstancePool::trim();
+    }
+
+    if (!tracePath.empty())
+    {
+#if VKINFO_ENABLE_TRACING
+        if (!Trace::writeChromeTrace(tracePath))
+        {
+            fprintf(stderr, "Failed to write trace to %s\n", tracePath.c_str());
+            return 1;
+        }
+#else
+        fprintf(stderr, "Tracing is compiled out. Reconfigure with -DVKINFO_TRACING=ON.\n");
+#endif
+    }
+
+    return 0;
+}
@@ -0,0 +1,227 @@
+#include "CommandRecordingBenchmark.h"
+#include "ComputeWorkload.h"
+#include "JobSystem.h"
+#include "LogicalDevice.h"
+#include "QueueTopology.h"
+#include "Trace.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
+namespace
+{
+    /**
+     * Enough command buffers per round that every thread count up to 16 gets several jobs to balance.
+     */
+    constexpr uint32_t CommandBufferCount = 64;
+    constexpr uint32_t DispatchesPerCommandBuffer = 4096;
+
+    /**
+     * Commands recorded per command buffer: the pipeline and descriptor set binds, then a barrier and a dispatch per
+     * dispatch (see <code>ComputeWorkload::recordDispatches</code>).
+     */
+    constexpr uint64_t CommandsPerCommandBuffer = 2 + 2 * (uint64_t)DispatchesPerCommandBuffer;
+
+    /**
+     * Per-thread recording state, on its own cache line. Only the worker it belongs to touches it during a round.
+     */
+    struct alignas(64) WorkerState
+    {
+        VkCommandPool commandPool = VK_NULL_HANDLE;
+        std::vector<VkCommandBuffer> commandBuffers;
+        uint32_t usedCount = 0;
+    };
+
+    /**
+     * The command pools of one thread count, destroyed through the device's dispatch table.
+     */
+    struct WorkerPools
+    {
+        const LogicalDevice* device = nullptr;
+        std::vector<WorkerState> workers;
+
+        ~WorkerPools()
+        {
+            for (const WorkerState& worker : this->workers)
+            {
+                if (worker.commandPool != VK_NULL_HANDLE)
+                {
+                    this->device->getDispatch().vkDestroyCommandPool(this->device->getHandle(), worker.commandPool, nullptr);
+                }
+            }
+        }
+    };
+
+    /**
+     * Creates a command pool per worker, each with enough command buffers for one worker to record the whole round.
+     */
+    bool createPools(const LogicalDevice& device, uint32_t workerCount, WorkerPools& pools)
+    {
+        VkDevice handle = device.getHandle();
+        const VulkanLoader::DeviceDispatch& vk = device.getDispatch();
+
+        pools.device = &device;
+        pools.workers.resize(workerCount);
+        for (WorkerState& worker : pools.workers)
+        {
+            VkCommandPoolCreateInfo poolInfo = {};
+            poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+            poolInfo.queueFamilyIndex = device.getQueueFamilyIndex();
+            if (vk.vkCreateCommandPool(handle, &poolInfo, nullptr, &worker.commandPool) != VK_SUCCESS)
+            {
+                worker.commandPool = VK_NULL_HANDLE;
+                return false;
+            }
+
+            worker.commandBuffers.resize(CommandBufferCount);
+            VkCommandBufferAllocateInfo allocateInfo = {};
+            allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocateInfo.commandPool = worker.commandPool;
+            allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocateInfo.commandBufferCount = CommandBufferCount;
+            if (vk.vkAllocateCommandBuffers(handle, &allocateInfo, worker.commandBuffers.data()) != VK_SUCCESS)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * Records every command buffer of a round once on <code>threadCount</code> threads.
+     * @param rounds How many timed rounds to run after one warm-up round.
+     * @param result (OUT param) Receives the median round time and the steals.
+     * @return false if recording failed.
+     */
+    bool measureThreadCount(const LogicalDevice& device, const ComputeWorkload::Resources& workload, uint32_t threadCount, uint32_t rounds, CommandRecordingBenchmark::ThreadCountResult& result)
+    {
+        VKINFO_TRACE_FUNCTION();
+
+        const VulkanLoader::DeviceDispatch& vk = device.getDispatch();
+
+        WorkerPools pools;
+        if (!createPools(device, threadCount, pools))
+        {
+            return false;
+        }
+
+        std::atomic<bool> failed(false);
+        JobSystem jobSystem(threadCount);
+        std::vector<JobSystem::Job> jobs(CommandBufferCount, [&](uint32_t worker)
+        {
+            WorkerState& state = pools.workers[worker];
+            VkCommandBuffer commandBuffer = state.commandBuffers[state.usedCount++];
+
+            VkCommandBufferBeginInfo beginInfo = {};
+            beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+            if (vk.vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+            {
+                failed.store(true, std::memory_order_relaxed);
+                return;
+            }
+
+            ComputeWorkload::recordDispatches(vk, commandBuffer, workload, DispatchesPerCommandBuffer, false);
+            if (vk.vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+            {
+                failed.store(true, std::memory_order_relaxed);
+            }
+        });
+
+        std::vector<double> seconds;
+        for (uint32_t round = 0; round <= rounds; round++)
+        {
+            // Resetting the pools is not part of recording, so it happens outside the timed region.
+            for (WorkerState& state : pools.workers)
+            {
+                if (vk.vkResetCommandPool(device.getHandle(), state.commandPool, 0) != VK_SUCCESS)
+                {
+                    return false;
+                }
+                state.usedCount = 0;
+            }
+
+            auto begin = std::chrono::steady_clock::now();
+            jobSystem.run(jobs);
+            double roundSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+            if (failed.load(std::memory_order_relaxed))
+            {
+                return false;
+            }
+
+            // Round 0 warms up the pools and the threads.
+            if (round > 0)
+            {
+                seconds.push_back(roundSeconds);
+            }
+        }
+
+        std::nth_element(seconds.begin(), seconds.begin() + seconds.size() / 2, seconds.end());
+        result.threadCount = threadCount;
+        result.seconds = seconds[seconds.size() / 2];
+        result.steals = jobSystem.getStealCount();
+        return true;
+    }
+}
+
+namespace CommandRecordingBenchmark
+{
+    /**
+     * Records the same command buffers with 1, 2, 4, ... threads up to <code>maxThreads</code>, and
+     * <code>maxThreads</code> itself. The command buffers are never submitted; only the CPU cost of recording is
+     * measured.
+     * @param device The <code>VkPhysicalDevice</code>.
+     * @param maxThreads The largest thread count to measure.
+     * @param rounds How many rounds to time per thread count. The median round counts.
+     * @return the results. <code>valid</code> is false if the device has no compute queue or recording failed.
+     */
+    Result run(VkPhysicalDevice device, uint32_t maxThreads, uint32_t rounds)
+    {
+        VKINFO_TRACE_FUNCTION();
+
+        Result result = {};
+        result.commandBufferCount = CommandBufferCount;
+        result.dispatchesPerCommandBuffer = DispatchesPerCommandBuffer;
+        result.commandsPerRound = CommandsPerCommandBuffer * CommandBufferCount;
+
+        QueueFamilyIndicies indices = QueueTopology::solve(QueueTopology::classify(device));
+        if (!indices.computeFamily.has_value() || maxThreads == 0 || rounds == 0)
+        {
+            return result;
+        }
+        result.queueFamilyIndex = indices.computeFamily.value();
+
+        LogicalDevice logicalDevice(device, result.queueFamilyIndex);
+        ComputeWorkload::Resources workload;
+        if (logicalDevice.getHandle() == VK_NULL_HANDLE || !ComputeWorkload::create(logicalDevice, device, workload))
+        {
+            return result;
+        }
+
+        std::vector<uint32_t> threadCounts;
+        for (uint32_t threadCount = 1; threadCount < maxThreads; threadCount *= 2)
+        {
+            threadCounts.push_back(threadCount);
+        }
+        threadCounts.push_back(maxThreads);
+
+        for (uint32_t threadCount : threadCounts)
+        {
+            ThreadCountResult threadResult;
+            if (!measureThreadCount(logicalDevice, workload, threadCount, rounds, threadResult))
+            {
+                return result;
+            }
+
+            threadResult.commandsPerSecond = (double)result.commandsPerRound / threadResult.seconds;
+            threadResult.speedup = result.threadCounts.empty() ? 1.0 : result.threadCounts[0].seconds / threadResult.seconds;
+            threadResult.efficiency = threadResult.speedup / threadCount;
+            result.threadCounts.push_back(threadResult);
+        }
+
+        result.valid = true;
+        return result;
+    }
+}
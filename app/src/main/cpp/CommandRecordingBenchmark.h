@@ -0,0 +1,37 @@
+#pragma once
+
+#include "VulkanLoader.h"
+#include <vector>
+
+/**
+ * Measures whether command buffer recording scales across cores. A fixed set of large command buffers is recorded
+ * by 1 to N threads of a work-stealing <code>JobSystem</code>, each thread allocating from its own
+ * <code>VkCommandPool</code> as the spec requires for concurrent recording.
+ */
+namespace CommandRecordingBenchmark
+{
+    /**
+     * One thread count. Speedup and efficiency are relative to a single thread.
+     */
+    struct ThreadCountResult
+    {
+        uint32_t threadCount = 0;
+        double seconds = 0.0;
+        double commandsPerSecond = 0.0;
+        double speedup = 0.0;
+        double efficiency = 0.0;
+        uint64_t steals = 0;
+    };
+
+    struct Result
+    {
+        bool valid = false;
+        uint32_t queueFamilyIndex = 0;
+        uint32_t commandBufferCount = 0;
+        uint32_t dispatchesPerCommandBuffer = 0;
+        uint64_t commandsPerRound = 0;
+        std::vector<ThreadCountResult> threadCounts;
+    };
+
+    Result run(VkPhysicalDevice device, uint32_t maxThreads, uint32_t rounds = 5);
+}
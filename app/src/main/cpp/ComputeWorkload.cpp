@@ -0,0 +1,307 @@
+#include "ComputeWorkload.h"
+#include "MemoryTypeSelector.h"
+#include "PhysicalDevice.h"
+
+namespace
+{
+    /**
+     * Hand assembled SPIR-V 1.0 for:
+     * <pre>
+     * #version 450
+     * layout(local_size_x = 64) in;
+     * layout(binding = 0) buffer Data { float values[]; };
+     * void main()
+     * {
+     *     float x = values[gl_GlobalInvocationID.x];
+     *     for (uint n = 0; n < 1024; n++)
+     *     {
+     *         x = x * 0.999 + 0.5;
+     *     }
+     *     values[gl_GlobalInvocationID.x] = x;
+     * }
+     * </pre>
+     * The chain converges to 500 and never goes denormal, so its cost stays constant for the whole run.
+     */
+    const uint32_t ShaderCode[] =
+    {
+        0x07230203, 0x00010000, 0x00000000, 0x00000024, 0x00000000, 0x00020011,
+        0x00000001, 0x0003000e, 0x00000000, 0x00000001, 0x0006000f, 0x00000005,
+        0x00000001, 0x6e69616d, 0x00000000, 0x00000002, 0x00060010, 0x00000001,
+        0x00000011, 0x00000040, 0x00000001, 0x00000001, 0x00040047, 0x00000002,
+        0x0000000b, 0x0000001c, 0x00040047, 0x00000003, 0x00000006, 0x00000004,
+        0x00050048, 0x00000004, 0x00000000, 0x00000023, 0x00000000, 0x00030047,
+        0x00000004, 0x00000003, 0x00040047, 0x00000005, 0x00000022, 0x00000000,
+        0x00040047, 0x00000005, 0x00000021, 0x00000000, 0x00020013, 0x00000006,
+        0x00030021, 0x00000007, 0x00000006, 0x00040015, 0x00000008, 0x00000020,
+        0x00000000, 0x00030016, 0x00000009, 0x00000020, 0x00020014, 0x0000000a,
+        0x00040017, 0x0000000b, 0x00000008, 0x00000003, 0x00040020, 0x0000000c,
+        0x00000001, 0x0000000b, 0x00040020, 0x0000000d, 0x00000001, 0x00000008,
+        0x0003001d, 0x00000003, 0x00000009, 0x0003001e, 0x00000004, 0x00000003,
+        0x00040020, 0x0000000e, 0x00000002, 0x00000004, 0x00040020, 0x0000000f,
+        0x00000002, 0x00000009, 0x0004002b, 0x00000008, 0x00000010, 0x00000000,
+        0x0004002b, 0x00000008, 0x00000011, 0x00000001, 0x0004002b, 0x00000008,
+        0x00000012, 0x00000400, 0x0004002b, 0x00000009, 0x00000013, 0x3f7fbe77,
+        0x0004002b, 0x00000009, 0x00000014, 0x3f000000, 0x0004003b, 0x0000000c,
+        0x00000002, 0x00000001, 0x0004003b, 0x0000000e, 0x00000005, 0x00000002,
+        0x00050036, 0x00000006, 0x00000001, 0x00000000, 0x00000007, 0x000200f8,
+        0x00000015, 0x00050041, 0x0000000d, 0x00000016, 0x00000002, 0x00000010,
+        0x0004003d, 0x00000008, 0x00000017, 0x00000016, 0x00060041, 0x0000000f,
+        0x00000018, 0x00000005, 0x00000010, 0x00000017, 0x0004003d, 0x00000009,
+        0x00000019, 0x00000018, 0x000200f9, 0x0000001a, 0x000200f8, 0x0000001a,
+        0x000700f5, 0x00000008, 0x0000001b, 0x00000010, 0x00000015, 0x0000001c,
+        0x0000001d, 0x000700f5, 0x00000009, 0x0000001e, 0x00000019, 0x00000015,
+        0x0000001f, 0x0000001d, 0x000500b0, 0x0000000a, 0x00000020, 0x0000001b,
+        0x00000012, 0x000400f6, 0x00000021, 0x0000001d, 0x00000000, 0x000400fa,
+        0x00000020, 0x00000022, 0x00000021, 0x000200f8, 0x00000022, 0x00050085,
+        0x00000009, 0x00000023, 0x0000001e, 0x00000013, 0x00050081, 0x00000009,
+        0x0000001f, 0x00000023, 0x00000014, 0x000200f9, 0x0000001d, 0x000200f8,
+        0x0000001d, 0x00050080, 0x00000008, 0x0000001c, 0x0000001b, 0x00000011,
+        0x000200f9, 0x0000001a, 0x000200f8, 0x00000021, 0x0003003e, 0x00000018,
+        0x0000001e, 0x000100fd, 0x00010038
+    };
+
+    /**
+     * Creates the storage buffer the shader works on and binds freshly allocated memory to it.
+     */
+    bool createStorageBuffer(const LogicalDevice& device, VkPhysicalDevice physicalDevice, ComputeWorkload::Resources& resources)
+    {
+        const VulkanLoader::DeviceDispatch& vk = device.getDispatch();
+
+        VkBufferCreateInfo bufferInfo = {};
+        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferInfo.size = (VkDeviceSize)ComputeWorkload::WorkgroupSize * ComputeWorkload::WorkgroupCount * sizeof(float);
+        bufferInfo.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+        if (vk.vkCreateBuffer(device.getHandle(), &bufferInfo, nullptr, &resources.buffer) != VK_SUCCESS)
+        {
+            resources.buffer = VK_NULL_HANDLE;
+            return false;
+        }
+
+        VkMemoryRequirements requirements = {};
+        vk.vkGetBufferMemoryRequirements(device.getHandle(), resources.buffer, &requirements);
+
+        VkMemoryAllocateInfo allocateInfo = {};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocateInfo.allocationSize = requirements.size;
+        allocateInfo.memoryTypeIndex = MemoryTypeSelector(PhysicalDevice::getMemoryProperties(physicalDevice)).find(requirements.memoryTypeBits, 0, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        if (allocateInfo.memoryTypeIndex == UINT32_MAX)
+        {
+            return false;
+        }
+
+        if (vk.vkAllocateMemory(device.getHandle(), &allocateInfo, nullptr, &resources.memory) != VK_SUCCESS)
+        {
+            resources.memory = VK_NULL_HANDLE;
+            return false;
+        }
+
+        return vk.vkBindBufferMemory(device.getHandle(), resources.buffer, resources.memory, 0) == VK_SUCCESS;
+    }
+
+    /**
+     * Creates the compute pipeline and a descriptor set pointing it at the storage buffer.
+     */
+    bool createPipeline(const LogicalDevice& device, ComputeWorkload::Resources& resources)
+    {
+        VkDevice handle = device.getHandle();
+        const VulkanLoader::DeviceDispatch& vk = device.getDispatch();
+
+        VkShaderModuleCreateInfo moduleInfo = {};
+        moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+        moduleInfo.codeSize = sizeof(ShaderCode);
+        moduleInfo.pCode = ShaderCode;
+        if (vk.vkCreateShaderModule(handle, &moduleInfo, nullptr, &resources.shaderModule) != VK_SUCCESS)
+        {
+            resources.shaderModule = VK_NULL_HANDLE;
+            return false;
+        }
+
+        VkDescriptorSetLayoutBinding binding = {};
+        binding.binding = 0;
+        binding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        binding.descriptorCount = 1;
+        binding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+        VkDescriptorSetLayoutCreateInfo setLayoutInfo = {};
+        setLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        setLayoutInfo.bindingCount = 1;
+        setLayoutInfo.pBindings = &binding;
+        if (vk.vkCreateDescriptorSetLayout(handle, &setLayoutInfo, nullptr, &resources.setLayout) != VK_SUCCESS)
+        {
+            resources.setLayout = VK_NULL_HANDLE;
+            return false;
+        }
+
+        VkPipelineLayoutCreateInfo pipelineLayoutInfo = {};
+        pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipelineLayoutInfo.setLayoutCount = 1;
+        pipelineLayoutInfo.pSetLayouts = &resources.setLayout;
+        if (vk.vkCreatePipelineLayout(handle, &pipelineLayoutInfo, nullptr, &resources.pipelineLayout) != VK_SUCCESS)
+        {
+            resources.pipelineLayout = VK_NULL_HANDLE;
+            return false;
+        }
+
+        VkComputePipelineCreateInfo pipelineInfo = {};
+        pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+        pipelineInfo.stage.module = resources.shaderModule;
+        pipelineInfo.stage.pName = "main";
+        pipelineInfo.layout = resources.pipelineLayout;
+        if (vk.vkCreateComputePipelines(handle, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &resources.pipeline) != VK_SUCCESS)
+        {
+            resources.pipeline = VK_NULL_HANDLE;
+            return false;
+        }
+
+        VkDescriptorPoolSize poolSize = {};
+        poolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        poolSize.descriptorCount = 1;
+
+        VkDescriptorPoolCreateInfo poolInfo = {};
+        poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        poolInfo.maxSets = 1;
+        poolInfo.poolSizeCount = 1;
+        poolInfo.pPoolSizes = &poolSize;
+        if (vk.vkCreateDescriptorPool(handle, &poolInfo, nullptr, &resources.descriptorPool) != VK_SUCCESS)
+        {
+            resources.descriptorPool = VK_NULL_HANDLE;
+            return false;
+        }
+
+        VkDescriptorSetAllocateInfo setInfo = {};
+        setInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        setInfo.descriptorPool = resources.descriptorPool;
+        setInfo.descriptorSetCount = 1;
+        setInfo.pSetLayouts = &resources.setLayout;
+        if (vk.vkAllocateDescriptorSets(handle, &setInfo, &resources.descriptorSet) != VK_SUCCESS)
+        {
+            return false;
+        }
+
+        VkDescriptorBufferInfo bufferInfo = {};
+        bufferInfo.buffer = resources.buffer;
+        bufferInfo.range = VK_WHOLE_SIZE;
+
+        VkWriteDescriptorSet write = {};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = resources.descriptorSet;
+        write.dstBinding = 0;
+        write.descriptorCount = 1;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        write.pBufferInfo = &bufferInfo;
+        vk.vkUpdateDescriptorSets(handle, 1, &write, 0, nullptr);
+
+        return true;
+    }
+}
+
+namespace ComputeWorkload
+{
+    /**
+     * Destroys the objects that were created. Waits for the device to go idle first, since dispatches may still be
+     * in flight if a run was cut short.
+     */
+    Resources::~Resources()
+    {
+        if (this->device == nullptr)
+        {
+            return;
+        }
+
+        VkDevice handle = this->device->getHandle();
+        const VulkanLoader::DeviceDispatch& vk = this->device->getDispatch();
+        vk.vkDeviceWaitIdle(handle);
+
+        if (this->descriptorPool != VK_NULL_HANDLE)
+        {
+            vk.vkDestroyDescriptorPool(handle, this->descriptorPool, nullptr);
+        }
+
+        if (this->pipeline != VK_NULL_HANDLE)
+        {
+            vk.vkDestroyPipeline(handle, this->pipeline, nullptr);
+        }
+
+        if (this->pipelineLayout != VK_NULL_HANDLE)
+        {
+            vk.vkDestroyPipelineLayout(handle, this->pipelineLayout, nullptr);
+        }
+
+        if (this->setLayout != VK_NULL_HANDLE)
+        {
+            vk.vkDestroyDescriptorSetLayout(handle, this->setLayout, nullptr);
+        }
+
+        if (this->shaderModule != VK_NULL_HANDLE)
+        {
+            vk.vkDestroyShaderModule(handle, this->shaderModule, nullptr);
+        }
+
+        if (this->buffer != VK_NULL_HANDLE)
+        {
+            vk.vkDestroyBuffer(handle, this->buffer, nullptr);
+        }
+
+        if (this->memory != VK_NULL_HANDLE)
+        {
+            vk.vkFreeMemory(handle, this->memory, nullptr);
+        }
+    }
+
+    /**
+     * Creates the storage buffer, the compute pipeline and a descriptor set pointing the pipeline at the buffer.
+     * @param device The logical device.
+     * @param physicalDevice The <code>VkPhysicalDevice</code> the device was created on.
+     * @param resources (OUT param) Receives the objects. Whatever was created is destroyed with it, also on failure.
+     * @return false if an object could not be created.
+     */
+    bool create(const LogicalDevice& device, VkPhysicalDevice physicalDevice, Resources& resources)
+    {
+        resources.device = &device;
+        return createStorageBuffer(device, physicalDevice, resources) && createPipeline(device, resources);
+    }
+
+    /**
+     * Records <code>dispatchCount</code> dispatches of the benchmark shader, each behind a barrier on the previous
+     * write to the buffer. The first barrier also orders the dispatches after work submitted before them. The command
+     * buffer must be in the recording state.
+     * @param vk The device's dispatch table.
+     * @param commandBuffer The command buffer to record into.
+     * @param resources The workload.
+     * @param dispatchCount The number of dispatches.
+     * @param initialize Whether to fill the buffer with 1.0 first.
+     */
+    void recordDispatches(const VulkanLoader::DeviceDispatch& vk, VkCommandBuffer commandBuffer, const Resources& resources, uint32_t dispatchCount, bool initialize)
+    {
+        VkMemoryBarrier barrier = {};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        VkPipelineStageFlags sourceStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+        if (initialize)
+        {
+            // 0x3f800000 is 1.0f.
+            vk.vkCmdFillBuffer(commandBuffer, resources.buffer, 0, VK_WHOLE_SIZE, 0x3f800000);
+
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            sourceStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+        }
+
+        vk.vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, resources.pipeline);
+        vk.vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, resources.pipelineLayout, 0, 1, &resources.descriptorSet, 0, nullptr);
+
+        for (uint32_t i = 0; i < dispatchCount; i++)
+        {
+            vk.vkCmdPipelineBarrier(commandBuffer, sourceStage, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+            vk.vkCmdDispatch(commandBuffer, WorkgroupCount, 1, 1);
+
+            barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+            sourceStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+        }
+    }
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "LogicalDevice.h"
+#include "VulkanLoader.h"
+
+/**
+ * The compute benchmark shader shared by the GPU benchmarks: a fixed multiply-add chain run by one invocation per
+ * float of a storage buffer, with the device objects it needs.
+ */
+namespace ComputeWorkload
+{
+    constexpr uint32_t WorkgroupSize = 64;
+    constexpr uint32_t WorkgroupCount = 256;
+    constexpr uint32_t ShaderIterations = 1024;
+    constexpr uint64_t FlopsPerDispatch = (uint64_t)WorkgroupSize * WorkgroupCount * ShaderIterations * 2;
+
+    /**
+     * Device objects of the workload, destroyed through the device's dispatch table.
+     */
+    struct Resources
+    {
+        const LogicalDevice* device = nullptr;
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        VkShaderModule shaderModule = VK_NULL_HANDLE;
+        VkDescriptorSetLayout setLayout = VK_NULL_HANDLE;
+        VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+        VkPipeline pipeline = VK_NULL_HANDLE;
+        VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+        VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+
+        Resources() = default;
+        Resources(const Resources& other) = delete;
+        Resources& operator=(const Resources& other) = delete;
+        ~Resources();
+    };
+
+    bool create(const LogicalDevice& device, VkPhysicalDevice physicalDevice, Resources& resources);
+    void recordDispatches(const VulkanLoader::DeviceDispatch& vk, VkCommandBuffer commandBuffer, const Resources& resources, uint32_t dispatchCount, bool initialize);
+}
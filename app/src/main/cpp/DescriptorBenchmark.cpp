@@ -0,0 +1,467 @@
+#include "DescriptorBenchmark.h"
+#include "LogicalDevice.h"
+#include "MemoryTypeSelector.h"
+#include "PhysicalDevice.h"
+#include "QueueTopology.h"
+#include "Trace.h"
+#include <algorithm>
+#include <chrono>
+
+namespace
+{
+    constexpr uint32_t MaxSetsPerAllocation = 4096;
+
+    /**
+     * Caps the descriptor array sweep on drivers reporting effectively unlimited descriptors.
+     */
+    constexpr uint32_t MaxDescriptorsPerSet = 1 << 16;
+    constexpr uint32_t BatchGrowth = 4;
+
+    /**
+     * The storage buffer every descriptor points at, destroyed through the device's dispatch table.
+     */
+    struct StorageBuffer
+    {
+        const LogicalDevice* device = nullptr;
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+
+        ~StorageBuffer()
+        {
+            if (this->device == nullptr)
+            {
+                return;
+            }
+
+            const VulkanLoader::DeviceDispatch& vk = this->device->getDispatch();
+            if (this->buffer != VK_NULL_HANDLE)
+            {
+                vk.vkDestroyBuffer(this->device->getHandle(), this->buffer, nullptr);
+            }
+
+            if (this->memory != VK_NULL_HANDLE)
+            {
+                vk.vkFreeMemory(this->device->getHandle(), this->memory, nullptr);
+            }
+        }
+    };
+
+    /**
+     * The layout, pool and optional update template of one measurement.
+     */
+    struct SetObjects
+    {
+        const LogicalDevice* device = nullptr;
+        VkDescriptorSetLayout setLayout = VK_NULL_HANDLE;
+        VkDescriptorPool pool = VK_NULL_HANDLE;
+        VkDescriptorUpdateTemplate updateTemplate = VK_NULL_HANDLE;
+
+        ~SetObjects()
+        {
+            if (this->device == nullptr)
+            {
+                return;
+            }
+
+            VkDevice handle = this->device->getHandle();
+            const VulkanLoader::DeviceDispatch& vk = this->device->getDispatch();
+            if (this->updateTemplate != VK_NULL_HANDLE)
+            {
+                vk.vkDestroyDescriptorUpdateTemplate(handle, this->updateTemplate, nullptr);
+            }
+
+            if (this->pool != VK_NULL_HANDLE)
+            {
+                vk.vkDestroyDescriptorPool(handle, this->pool, nullptr);
+            }
+
+            if (this->setLayout != VK_NULL_HANDLE)
+            {
+                vk.vkDestroyDescriptorSetLayout(handle, this->setLayout, nullptr);
+            }
+        }
+    };
+
+    bool createStorageBuffer(const LogicalDevice& device, VkPhysicalDevice physicalDevice, StorageBuffer& storage)
+    {
+        const VulkanLoader::DeviceDispatch& vk = device.getDispatch();
+        storage.device = &device;
+
+        VkBufferCreateInfo bufferInfo = {};
+        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferInfo.size = 256;
+        bufferInfo.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        if (vk.vkCreateBuffer(device.getHandle(), &bufferInfo, nullptr, &storage.buffer) != VK_SUCCESS)
+        {
+            storage.buffer = VK_NULL_HANDLE;
+            return false;
+        }
+
+        VkMemoryRequirements requirements = {};
+        vk.vkGetBufferMemoryRequirements(device.getHandle(), storage.buffer, &requirements);
+
+        VkMemoryAllocateInfo allocateInfo = {};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocateInfo.allocationSize = requirements.size;
+        allocateInfo.memoryTypeIndex = MemoryTypeSelector(PhysicalDevice::getMemoryProperties(physicalDevice)).find(requirements.memoryTypeBits, 0, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        if (allocateInfo.memoryTypeIndex == UINT32_MAX ||
+            vk.vkAllocateMemory(device.getHandle(), &allocateInfo, nullptr, &storage.memory) != VK_SUCCESS)
+        {
+            storage.memory = VK_NULL_HANDLE;
+            return false;
+        }
+
+        return vk.vkBindBufferMemory(device.getHandle(), storage.buffer, storage.memory, 0) == VK_SUCCESS;
+    }
+
+    /**
+     * Creates a layout with one compute storage buffer binding of <code>descriptorCount</code> descriptors and a pool
+     * for <code>setCount</code> such sets.
+     * @param updateAfterBind Whether the binding can be updated after it is bound, which needs an update-after-bind
+     * pool and layout.
+     * @param withTemplate Whether to also create an update template writing the whole binding from an array of
+     * <code>VkDescriptorBufferInfo</code>.
+     */
+    bool createSetObjects(const LogicalDevice& device, uint32_t descriptorCount, uint32_t setCount, bool updateAfterBind, bool withTemplate, SetObjects& objects)
+    {
+        VkDevice handle = device.getHandle();
+        const VulkanLoader::DeviceDispatch& vk = device.getDispatch();
+        objects.device = &device;
+
+        VkDescriptorSetLayoutBinding binding = {};
+        binding.binding = 0;
+        binding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        binding.descriptorCount = descriptorCount;
+        binding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+        VkDescriptorBindingFlags bindingFlags = VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT;
+        VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo = {};
+        bindingFlagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+        bindingFlagsInfo.bindingCount = 1;
+        bindingFlagsInfo.pBindingFlags = &bindingFlags;
+
+        VkDescriptorSetLayoutCreateInfo layoutInfo = {};
+        layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        layoutInfo.pNext = updateAfterBind ? &bindingFlagsInfo : nullptr;
+        layoutInfo.flags = updateAfterBind ? VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT : 0;
+        layoutInfo.bindingCount = 1;
+        layoutInfo.pBindings = &binding;
+        if (vk.vkCreateDescriptorSetLayout(handle, &layoutInfo, nullptr, &objects.setLayout) != VK_SUCCESS)
+        {
+            objects.setLayout = VK_NULL_HANDLE;
+            return false;
+        }
+
+        VkDescriptorPoolSize poolSize = {};
+        poolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        poolSize.descriptorCount = descriptorCount * setCount;
+
+        VkDescriptorPoolCreateInfo poolInfo = {};
+        poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        poolInfo.flags = updateAfterBind ? VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT : 0;
+        poolInfo.maxSets = setCount;
+        poolInfo.poolSizeCount = 1;
+        poolInfo.pPoolSizes = &poolSize;
+        if (vk.vkCreateDescriptorPool(handle, &poolInfo, nullptr, &objects.pool) != VK_SUCCESS)
+        {
+            objects.pool = VK_NULL_HANDLE;
+            return false;
+        }
+
+        if (!withTemplate)
+        {
+            return true;
+        }
+
+        VkDescriptorUpdateTemplateEntry entry = {};
+        entry.dstBinding = 0;
+        entry.dstArrayElement = 0;
+        entry.descriptorCount = descriptorCount;
+        entry.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        entry.offset = 0;
+        entry.stride = sizeof(VkDescriptorBufferInfo);
+
+        VkDescriptorUpdateTemplateCreateInfo templateInfo = {};
+        templateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO;
+        templateInfo.descriptorUpdateEntryCount = 1;
+        templateInfo.pDescriptorUpdateEntries = &entry;
+        templateInfo.templateType = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET;
+        templateInfo.descriptorSetLayout = objects.setLayout;
+        if (vk.vkCreateDescriptorUpdateTemplate(handle, &templateInfo, nullptr, &objects.updateTemplate) != VK_SUCCESS)
+        {
+            objects.updateTemplate = VK_NULL_HANDLE;
+            return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * Gets the batch sizes to sweep: powers of <code>BatchGrowth</code> below <code>limit</code>, then the limit.
+     */
+    std::vector<uint32_t> getBatchSizes(uint32_t limit)
+    {
+        std::vector<uint32_t> sizes;
+        for (uint64_t size = 1; size < limit; size *= BatchGrowth)
+        {
+            sizes.push_back((uint32_t)size);
+        }
+
+        if (limit > 0)
+        {
+            sizes.push_back(limit);
+        }
+
+        return sizes;
+    }
+
+    /**
+     * Repeats an operation for about <code>seconds</code> after one untimed call. The clock is read after every
+     * chunk of calls, and chunks double until one takes a sixteenth of the window, so reading it costs next to
+     * nothing even for the cheapest operations.
+     * @param opsPerCall What one call counts as.
+     * @param operation Returns false on failure.
+     * @return the operations per second, or 0 on failure.
+     */
+    template <typename Operation>
+    double measureRate(double seconds, uint64_t opsPerCall, Operation operation)
+    {
+        if (!operation())
+        {
+            return 0.0;
+        }
+
+        uint64_t calls = 0;
+        uint64_t chunk = 1;
+        double elapsed = 0.0;
+        auto begin = std::chrono::steady_clock::now();
+        while (elapsed < seconds)
+        {
+            auto chunkBegin = std::chrono::steady_clock::now();
+            for (uint64_t i = 0; i < chunk; i++)
+            {
+                if (!operation())
+                {
+                    return 0.0;
+                }
+            }
+            calls += chunk;
+
+            auto now = std::chrono::steady_clock::now();
+            elapsed = std::chrono::duration<double>(now - begin).count();
+            if (std::chrono::duration<double>(now - chunkBegin).count() < seconds / 16)
+            {
+                chunk *= 2;
+            }
+        }
+
+        return (double)(calls * opsPerCall) / elapsed;
+    }
+
+    /**
+     * Measures allocating batches of sets in one <code>vkAllocateDescriptorSets</code> call and resetting the pool
+     * after each batch, in sets per second.
+     */
+    DescriptorBenchmark::Series measureAllocateReset(const LogicalDevice& device, double seconds)
+    {
+        VKINFO_TRACE_FUNCTION();
+
+        const VulkanLoader::DeviceDispatch& vk = device.getDispatch();
+        DescriptorBenchmark::Series series = {"Allocate + reset pool", "sets/s", {}};
+
+        for (uint32_t setCount : getBatchSizes(MaxSetsPerAllocation))
+        {
+            SetObjects objects;
+            if (!createSetObjects(device, 1, setCount, false, false, objects))
+            {
+                break;
+            }
+
+            std::vector<VkDescriptorSetLayout> layouts(setCount, objects.setLayout);
+            std::vector<VkDescriptorSet> sets(setCount);
+            VkDescriptorSetAllocateInfo allocateInfo = {};
+            allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+            allocateInfo.descriptorPool = objects.pool;
+            allocateInfo.descriptorSetCount = setCount;
+            allocateInfo.pSetLayouts = layouts.data();
+
+            double rate = measureRate(seconds, setCount, [&]()
+            {
+                return vk.vkAllocateDescriptorSets(device.getHandle(), &allocateInfo, sets.data()) == VK_SUCCESS &&
+                       vk.vkResetDescriptorPool(device.getHandle(), objects.pool, 0) == VK_SUCCESS;
+            });
+            series.rates.push_back({setCount, rate});
+        }
+
+        return series;
+    }
+
+    /**
+     * Measures rewriting every descriptor of a set, once with a <code>VkWriteDescriptorSet</code> covering the binding
+     * and once with an update template if <code>withTemplate</code>, in descriptors per second.
+     * @param series (OUT param) Receives the write rates at index 0 and the template rates at index 1.
+     */
+    void measureUpdates(const LogicalDevice& device, VkBuffer buffer, uint32_t limit, bool updateAfterBind, bool withTemplate, double seconds, DescriptorBenchmark::Series* series)
+    {
+        VKINFO_TRACE_FUNCTION();
+
+        VkDevice handle = device.getHandle();
+        const VulkanLoader::DeviceDispatch& vk = device.getDispatch();
+
+        for (uint32_t descriptorCount : getBatchSizes(limit))
+        {
+            SetObjects objects;
+            if (!createSetObjects(device, descriptorCount, 1, updateAfterBind, withTemplate, objects))
+            {
+                break;
+            }
+
+            VkDescriptorSet set = VK_NULL_HANDLE;
+            VkDescriptorSetAllocateInfo allocateInfo = {};
+            allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+            allocateInfo.descriptorPool = objects.pool;
+            allocateInfo.descriptorSetCount = 1;
+            allocateInfo.pSetLayouts = &objects.setLayout;
+            if (vk.vkAllocateDescriptorSets(handle, &allocateInfo, &set) != VK_SUCCESS)
+            {
+                break;
+            }
+
+            std::vector<VkDescriptorBufferInfo> bufferInfos(descriptorCount, {buffer, 0, VK_WHOLE_SIZE});
+
+            VkWriteDescriptorSet write = {};
+            write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            write.dstSet = set;
+            write.dstBinding = 0;
+            write.descriptorCount = descriptorCount;
+            write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            write.pBufferInfo = bufferInfos.data();
+
+            series[0].rates.push_back({descriptorCount, measureRate(seconds, descriptorCount, [&]()
+            {
+                vk.vkUpdateDescriptorSets(handle, 1, &write, 0, nullptr);
+                return true;
+            })});
+
+            if (withTemplate)
+            {
+                series[1].rates.push_back({descriptorCount, measureRate(seconds, descriptorCount, [&]()
+                {
+                    vk.vkUpdateDescriptorSetWithTemplate(handle, set, objects.updateTemplate, bufferInfos.data());
+                    return true;
+                })});
+            }
+        }
+    }
+}
+
+namespace DescriptorBenchmark
+{
+    /**
+     * Runs every descriptor measurement the device supports. Update templates need Vulkan 1.1 on both the instance
+     * and the device; update-after-bind needs <code>descriptorBindingStorageBufferUpdateAfterBind</code> from
+     * Vulkan 1.2 or <code>VK_EXT_descriptor_indexing</code>, queried through the 1.1 feature query. Both versions are
+     * the lower of the instance's and the device's.
+     * @param instance The instance the device was enumerated from. Its API version decides which queries are allowed.
+     * @param device The <code>VkPhysicalDevice</code>.
+     * @param secondsPerMeasurement How long to repeat each operation at each batch size.
+     * @return the series. <code>valid</code> is false if no device could be created.
+     */
+    Result run(const Instance& instance, VkPhysicalDevice device, double secondsPerMeasurement)
+    {
+        VKINFO_TRACE_FUNCTION();
+
+        Result result = {};
+        QueueFamilyIndicies indices = QueueTopology::solve(QueueTopology::classify(device));
+        if (!indices.computeFamily.has_value())
+        {
+            return result;
+        }
+
+        VkPhysicalDeviceProperties properties = PhysicalDevice::getDeviceProperties(device);
+        const VkPhysicalDeviceLimits& limits = properties.limits;
+        result.maxDescriptorCount = std::min({limits.maxPerStageDescriptorStorageBuffers, limits.maxDescriptorSetStorageBuffers, limits.maxPerStageResources, MaxDescriptorsPerSet});
+
+        // The device only offers its own version's core features up to the version the instance was created for.
+        const uint32_t apiVersion = std::min(instance.getApiVersion(), properties.apiVersion);
+        const bool vulkan11 = apiVersion >= VK_API_VERSION_1_1;
+        const bool indexingExtension = apiVersion < VK_API_VERSION_1_2;
+        std::vector<const char*> extensions;
+
+        VkPhysicalDeviceDescriptorIndexingFeatures enabledIndexing = {};
+        enabledIndexing.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
+        enabledIndexing.descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+
+        if (vulkan11 && (!indexingExtension || PhysicalDevice::isExtensionSupported(device, VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME)))
+        {
+            PFN_vkGetPhysicalDeviceFeatures2 getFeatures2 = (PFN_vkGetPhysicalDeviceFeatures2)vkGetInstanceProcAddr(instance.getHandle(), "vkGetPhysicalDeviceFeatures2");
+            PFN_vkGetPhysicalDeviceProperties2 getProperties2 = (PFN_vkGetPhysicalDeviceProperties2)vkGetInstanceProcAddr(instance.getHandle(), "vkGetPhysicalDeviceProperties2");
+            if (getFeatures2 != nullptr && getProperties2 != nullptr)
+            {
+                VkPhysicalDeviceDescriptorIndexingFeatures indexingFeatures = {};
+                indexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
+                VkPhysicalDeviceFeatures2 features2 = {};
+                features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+                features2.pNext = &indexingFeatures;
+                getFeatures2(device, &features2);
+
+                VkPhysicalDeviceDescriptorIndexingProperties indexingProperties = {};
+                indexingProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES;
+                VkPhysicalDeviceProperties2 properties2 = {};
+                properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+                properties2.pNext = &indexingProperties;
+                getProperties2(device, &properties2);
+
+                result.updateAfterBindSupported = indexingFeatures.descriptorBindingStorageBufferUpdateAfterBind == VK_TRUE;
+                result.maxUpdateAfterBindDescriptorCount = std::min({indexingProperties.maxPerStageDescriptorUpdateAfterBindStorageBuffers,
+                                                                     indexingProperties.maxDescriptorSetUpdateAfterBindStorageBuffers,
+                                                                     indexingProperties.maxPerStageUpdateAfterBindResources,
+                                                                     MaxDescriptorsPerSet});
+            }
+        }
+
+        if (result.updateAfterBindSupported && indexingExtension)
+        {
+            // VK_KHR_maintenance3, which descriptor indexing depends on, is core in 1.1.
+            extensions.push_back(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+        }
+
+        LogicalDevice logicalDevice(device, indices.computeFamily.value(), extensions, nullptr, nullptr, result.updateAfterBindSupported ? &enabledIndexing : nullptr);
+        StorageBuffer storage;
+        if (logicalDevice.getHandle() == VK_NULL_HANDLE || !createStorageBuffer(logicalDevice, device, storage))
+        {
+            return result;
+        }
+
+        const VulkanLoader::DeviceDispatch& vk = logicalDevice.getDispatch();
+        result.templatesSupported = vulkan11 &&
+                                    vk.vkCreateDescriptorUpdateTemplate != nullptr &&
+                                    vk.vkDestroyDescriptorUpdateTemplate != nullptr &&
+                                    vk.vkUpdateDescriptorSetWithTemplate != nullptr;
+
+        result.series.push_back(measureAllocateReset(logicalDevice, secondsPerMeasurement));
+
+        Series updates[2] = {{"vkUpdateDescriptorSets", "descriptors/s", {}}, {"Update template", "descriptors/s", {}}};
+        measureUpdates(logicalDevice, storage.buffer, result.maxDescriptorCount, false, result.templatesSupported, secondsPerMeasurement, updates);
+        result.series.push_back(updates[0]);
+        if (result.templatesSupported)
+        {
+            result.series.push_back(updates[1]);
+        }
+
+        if (result.updateAfterBindSupported)
+        {
+            Series afterBind[2] = {{"Update-after-bind writes", "descriptors/s", {}}, {"Update-after-bind template", "descriptors/s", {}}};
+            measureUpdates(logicalDevice, storage.buffer, result.maxUpdateAfterBindDescriptorCount, true, result.templatesSupported, secondsPerMeasurement, afterBind);
+            result.series.push_back(afterBind[0]);
+            if (result.templatesSupported)
+            {
+                result.series.push_back(afterBind[1]);
+            }
+        }
+
+        result.valid = true;
+        return result;
+    }
+}
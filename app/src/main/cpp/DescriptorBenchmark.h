@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Instance.h"
+#include "VulkanLoader.h"
+#include <string>
+#include <vector>
+
+/**
+ * Measures what descriptors cost to use: allocating sets from a pool and resetting it, writing descriptors with
+ * <code>vkUpdateDescriptorSets</code> versus descriptor update templates, and the same writes to update-after-bind
+ * sets where descriptor indexing is supported. Batch sizes grow up to the device's storage buffer descriptor limits.
+ */
+namespace DescriptorBenchmark
+{
+    /**
+     * The rate at one batch size.
+     */
+    struct Rate
+    {
+        uint32_t batchSize = 0;
+        double opsPerSecond = 0.0;
+    };
+
+    /**
+     * One operation swept over batch sizes. <code>unit</code> names what is counted.
+     */
+    struct Series
+    {
+        std::string name;
+        std::string unit;
+        std::vector<Rate> rates;
+    };
+
+    struct Result
+    {
+        bool valid = false;
+        bool templatesSupported = false;
+        bool updateAfterBindSupported = false;
+        uint32_t maxDescriptorCount = 0;
+        uint32_t maxUpdateAfterBindDescriptorCount = 0;
+        std::vector<Series> series;
+    };
+
+    Result run(const Instance& instance, VkPhysicalDevice device, double secondsPerMeasurement = 0.05);
+}
@@ -0,0 +1,223 @@
+#include "DeviceCreationProfiler.h"
+#include "CapabilityFields.h"
+#include "LogicalDevice.h"
+#include "PhysicalDevice.h"
+#include "QueueTopology.h"
+#include "ThrottlingDetector.h"
+#include "Trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+
+namespace
+{
+    /**
+     * The name and offset of a <code>VkBool32</code> member of <code>VkPhysicalDeviceFeatures</code>.
+     */
+    struct FeatureField
+    {
+        const char* name;
+        size_t offset;
+    };
+
+    const FeatureField FeatureFields[] =
+    {
+#define VKINFO_FEATURE_FIELD(name, kind, member) {#name, offsetof(VkPhysicalDeviceFeatures, name)},
+        VKINFO_CAPABILITY_FEATURE_FIELDS(VKINFO_FEATURE_FIELD)
+#undef VKINFO_FEATURE_FIELD
+    };
+
+    /**
+     * Must be enabled whenever it is supported, so every configuration, the baseline included, enables it.
+     */
+    const char* const PortabilitySubsetExtension = "VK_KHR_portability_subset";
+
+    /**
+     * A device to create: the baseline with at most one feature or extension added.
+     */
+    struct Configuration
+    {
+        VkPhysicalDeviceFeatures features = {};
+        std::vector<const char*> extensions;
+        DeviceCreationProfiler::Measurement* measurement = nullptr;
+    };
+
+    VkBool32& getFeature(VkPhysicalDeviceFeatures& features, const FeatureField& field)
+    {
+        return *(VkBool32*)((uint8_t*)&features + field.offset);
+    }
+
+    double median(std::vector<double>& values)
+    {
+        if (values.empty())
+        {
+            return 0.0;
+        }
+
+        std::nth_element(values.begin(), values.begin() + values.size() / 2, values.end());
+        return values[values.size() / 2];
+    }
+}
+
+namespace DeviceCreationProfiler
+{
+    /**
+     * Creates a device with nothing enabled, then one device per supported feature and per device extension with
+     * only that one enabled. Creation is timed <code>iterations</code> times per configuration, going round all
+     * configurations in turn so slow drift of the driver or the clock spreads evenly over them. The reference batch
+     * is the <code>ThrottlingDetector</code> shader, timed once per configuration on the compute queue; the baseline
+     * is timed first and last, and the drift between the two bounds the noise of the dispatch deltas.
+     * @param device The <code>VkPhysicalDevice</code>.
+     * @param iterations How many devices to create per configuration.
+     * @param batchCount How many reference batches to time per configuration.
+     * @return the measurements. <code>valid</code> is false if the device has no compute queue or the baseline
+     * device could not be created. Extensions that cannot be enabled on their own (e.g. that need another extension)
+     * have <code>created</code> false.
+     */
+    Result run(VkPhysicalDevice device, uint32_t iterations, uint32_t batchCount)
+    {
+        VKINFO_TRACE_FUNCTION();
+
+        Result result = {};
+        result.iterations = iterations;
+
+        QueueFamilyIndicies indices = QueueTopology::solve(QueueTopology::classify(device));
+        if (!indices.computeFamily.has_value() || iterations == 0)
+        {
+            return result;
+        }
+        result.queueFamilyIndex = indices.computeFamily.value();
+
+        std::vector<const char*> requiredExtensions;
+        std::vector<VkExtensionProperties> extensionProperties = PhysicalDevice::getExtensionProperties(device);
+        for (const VkExtensionProperties& extension : extensionProperties)
+        {
+            if (strcmp(extension.extensionName, PortabilitySubsetExtension) == 0)
+            {
+                requiredExtensions.push_back(extension.extensionName);
+                continue;
+            }
+
+            Measurement measurement;
+            measurement.name = extension.extensionName;
+            measurement.extension = true;
+            result.extensions.push_back(measurement);
+        }
+
+        VkPhysicalDeviceFeatures supported = PhysicalDevice::getDeviceFeatures(device);
+        for (const FeatureField& field : FeatureFields)
+        {
+            if (getFeature(supported, field) == VK_TRUE)
+            {
+                Measurement measurement;
+                measurement.name = field.name;
+                result.features.push_back(measurement);
+            }
+        }
+
+        // The measurements are all in place, so the configurations can point at them.
+        result.baseline.name = "baseline";
+        std::vector<Configuration> configurations(1 + result.features.size() + result.extensions.size());
+        configurations[0].measurement = &result.baseline;
+        for (size_t i = 0; i < configurations.size(); i++)
+        {
+            configurations[i].extensions = requiredExtensions;
+        }
+
+        size_t next = 1;
+        for (Measurement& measurement : result.features)
+        {
+            for (const FeatureField& field : FeatureFields)
+            {
+                if (measurement.name == field.name)
+                {
+                    getFeature(configurations[next].features, field) = VK_TRUE;
+                }
+            }
+            configurations[next++].measurement = &measurement;
+        }
+
+        for (Measurement& measurement : result.extensions)
+        {
+            configurations[next].extensions.push_back(measurement.name.c_str());
+            configurations[next++].measurement = &measurement;
+        }
+
+        std::vector<std::vector<double>> createSeconds(configurations.size());
+        for (uint32_t iteration = 0; iteration < iterations; iteration++)
+        {
+            for (size_t i = 0; i < configurations.size(); i++)
+            {
+                auto begin = std::chrono::steady_clock::now();
+                LogicalDevice logicalDevice(device, result.queueFamilyIndex, configurations[i].extensions, nullptr, &configurations[i].features);
+                double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+                if (logicalDevice.getHandle() != VK_NULL_HANDLE)
+                {
+                    createSeconds[i].push_back(seconds);
+                }
+            }
+        }
+
+        for (size_t i = 0; i < configurations.size(); i++)
+        {
+            Measurement& measurement = *configurations[i].measurement;
+            measurement.created = createSeconds[i].size() == iterations;
+            measurement.createMicroseconds = median(createSeconds[i]) * 1e6;
+        }
+
+        if (!result.baseline.created)
+        {
+            return result;
+        }
+
+        double firstBaseline = 0.0;
+        for (size_t i = 0; i <= configurations.size(); i++)
+        {
+            // Index configurations.size() is the baseline again, closing the run.
+            const Configuration& configuration = configurations[i % configurations.size()];
+            if (!configuration.measurement->created)
+            {
+                continue;
+            }
+
+            LogicalDevice logicalDevice(device, result.queueFamilyIndex, configuration.extensions, nullptr, &configuration.features);
+            double seconds = ThrottlingDetector::timeBatches(logicalDevice, device, result.dispatchesPerBatch, batchCount);
+            if (i == 0)
+            {
+                firstBaseline = seconds;
+            }
+            configuration.measurement->dispatchMicroseconds = seconds * 1e6;
+        }
+
+        if (firstBaseline == 0.0 || result.baseline.dispatchMicroseconds == 0.0)
+        {
+            result.baseline.dispatchMicroseconds = 0.0;
+        }
+        else
+        {
+            result.dispatchDrift = std::fabs(result.baseline.dispatchMicroseconds - firstBaseline * 1e6);
+            result.baseline.dispatchMicroseconds = (result.baseline.dispatchMicroseconds + firstBaseline * 1e6) / 2.0;
+        }
+
+        for (size_t i = 1; i < configurations.size(); i++)
+        {
+            Measurement& measurement = *configurations[i].measurement;
+            if (!measurement.created)
+            {
+                continue;
+            }
+
+            measurement.createDelta = measurement.createMicroseconds - result.baseline.createMicroseconds;
+            if (measurement.dispatchMicroseconds > 0.0 && result.baseline.dispatchMicroseconds > 0.0)
+            {
+                measurement.dispatchDelta = measurement.dispatchMicroseconds - result.baseline.dispatchMicroseconds;
+            }
+        }
+
+        result.valid = true;
+        return result;
+    }
+}
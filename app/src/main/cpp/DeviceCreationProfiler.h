@@ -0,0 +1,46 @@
+#pragma once
+
+#include "VulkanLoader.h"
+#include <string>
+#include <vector>
+
+/**
+ * Measures what enabling a single device feature or extension costs: the time <code>vkCreateDevice</code> takes and
+ * the time of a reference compute batch on the resulting device, each compared against a device created with
+ * nothing enabled.
+ */
+namespace DeviceCreationProfiler
+{
+    /**
+     * One device configuration. Times are medians in microseconds; deltas are relative to the baseline.
+     */
+    struct Measurement
+    {
+        std::string name;
+        bool extension = false;
+        bool created = false;
+        double createMicroseconds = 0.0;
+        double createDelta = 0.0;
+        double dispatchMicroseconds = 0.0;
+        double dispatchDelta = 0.0;
+    };
+
+    struct Result
+    {
+        bool valid = false;
+        uint32_t queueFamilyIndex = 0;
+        uint32_t iterations = 0;
+        uint32_t dispatchesPerBatch = 0;
+        Measurement baseline;
+
+        /**
+         * How far the baseline batch time moved between the start and the end of the run, in microseconds.
+         * Dispatch deltas smaller than this are noise.
+         */
+        double dispatchDrift = 0.0;
+        std::vector<Measurement> features;
+        std::vector<Measurement> extensions;
+    };
+
+    Result run(VkPhysicalDevice device, uint32_t iterations, uint32_t batchCount = 5);
+}
@@ -0,0 +1,237 @@
+#include "EnumerationSnapshot.h"
+#include "Trace.h"
+#include <atomic>
+#include <cstring>
+#include <vector>
+
+// The snapshot packs these back to back in a uint32_t array.
+static_assert(alignof(VkLayerProperties) <= alignof(uint32_t) && sizeof(VkLayerProperties) % sizeof(uint32_t) == 0, "VkLayerProperties must pack into uint32_t storage");
+static_assert(alignof(VkExtensionProperties) <= alignof(uint32_t) && sizeof(VkExtensionProperties) % sizeof(uint32_t) == 0, "VkExtensionProperties must pack into uint32_t storage");
+
+namespace
+{
+    /**
+     * First guess for the number of items an enumeration returns. Big enough that the loader is usually only asked
+     * once instead of once for the count and once for the data.
+     */
+    constexpr uint32_t InitialEnumerationCapacity = 64;
+
+    std::atomic<uint32_t> loaderScanCount{0};
+
+    /**
+     * Runs a two-call style enumeration, but starts with a guessed capacity so the common case is a single call.
+     * Grows and retries on <code>VK_INCOMPLETE</code>.
+     */
+    template<typename T, typename Enumerate>
+    std::vector<T> enumerate(Enumerate enumerateFunction)
+    {
+        std::vector<T> items(InitialEnumerationCapacity);
+        for (;;)
+        {
+            uint32_t count = (uint32_t)items.size();
+            VkResult result = enumerateFunction(&count, items.data());
+            loaderScanCount.fetch_add(1, std::memory_order_relaxed);
+
+            if (result == VK_SUCCESS)
+            {
+                items.resize(count);
+                return items;
+            }
+
+            if (result != VK_INCOMPLETE)
+            {
+                return {};
+            }
+
+            items.resize(items.size() * 2);
+        }
+    }
+
+    size_t toWords(size_t bytes)
+    {
+        return bytes / sizeof(uint32_t);
+    }
+}
+
+/**
+ * Gets the process-wide snapshot, enumerating on the first call.
+ * @return the snapshot. Empty if the Vulkan loader is not available.
+ */
+const EnumerationSnapshot& EnumerationSnapshot::get()
+{
+    static const EnumerationSnapshot snapshot;
+    return snapshot;
+}
+
+/**
+ * Gets how many times the loader has been asked to enumerate layers or extensions in this process. Each of those
+ * calls makes the loader scan its layer manifests.
+ * @return the number of enumeration calls.
+ */
+uint32_t EnumerationSnapshot::getLoaderScanCount()
+{
+    return loaderScanCount.load(std::memory_order_relaxed);
+}
+
+/**
+ * Enumerates everything and packs it into one allocation laid out as
+ * [layer extension offsets (layerCount + 1)][layers][instance extensions][extensions of every layer].
+ */
+EnumerationSnapshot::EnumerationSnapshot()
+{
+    VKINFO_TRACE_SCOPE("EnumerationSnapshot");
+
+    if (!VulkanLoader::initialize())
+    {
+        return;
+    }
+
+    std::vector<VkLayerProperties> layerList = enumerate<VkLayerProperties>([](uint32_t* count, VkLayerProperties* properties)
+    {
+        return VKINFO_TRACE_VK(vkEnumerateInstanceLayerProperties, (count, properties));
+    });
+
+    std::vector<VkExtensionProperties> instanceExtensionList = enumerate<VkExtensionProperties>([](uint32_t* count, VkExtensionProperties* properties)
+    {
+        return VKINFO_TRACE_VK(vkEnumerateInstanceExtensionProperties, (nullptr, count, properties));
+    });
+
+    std::vector<std::vector<VkExtensionProperties>> layerExtensionLists(layerList.size());
+    size_t totalLayerExtensions = 0;
+    for (size_t i = 0; i < layerList.size(); i++)
+    {
+        const char* layerName = layerList[i].layerName;
+        layerExtensionLists[i] = enumerate<VkExtensionProperties>([layerName](uint32_t* count, VkExtensionProperties* properties)
+        {
+            return VKINFO_TRACE_VK(vkEnumerateInstanceExtensionProperties, (layerName, count, properties));
+        });
+        totalLayerExtensions += layerExtensionLists[i].size();
+    }
+
+    this->layerCount = (uint32_t)layerList.size();
+    this->instanceExtensionCount = (uint32_t)instanceExtensionList.size();
+
+    size_t offsetsWords = this->layerCount + 1;
+    size_t layersWords = toWords(sizeof(VkLayerProperties) * this->layerCount);
+    size_t instanceExtensionsWords = toWords(sizeof(VkExtensionProperties) * this->instanceExtensionCount);
+    size_t layerExtensionsWords = toWords(sizeof(VkExtensionProperties) * totalLayerExtensions);
+    size_t totalWords = offsetsWords + layersWords + instanceExtensionsWords + layerExtensionsWords;
+
+    this->storage = std::make_unique<uint32_t[]>(totalWords);
+    this->sizeInBytes = totalWords * sizeof(uint32_t);
+
+    uint32_t* offsets = this->storage.get();
+    VkLayerProperties* layersOut = reinterpret_cast<VkLayerProperties*>(offsets + offsetsWords);
+    VkExtensionProperties* instanceExtensionsOut = reinterpret_cast<VkExtensionProperties*>(offsets + offsetsWords + layersWords);
+    VkExtensionProperties* layerExtensionsOut = reinterpret_cast<VkExtensionProperties*>(offsets + offsetsWords + layersWords + instanceExtensionsWords);
+
+    memcpy(layersOut, layerList.data(), sizeof(VkLayerProperties) * this->layerCount);
+    memcpy(instanceExtensionsOut, instanceExtensionList.data(), sizeof(VkExtensionProperties) * this->instanceExtensionCount);
+
+    uint32_t offset = 0;
+    for (uint32_t i = 0; i < this->layerCount; i++)
+    {
+        offsets[i] = offset;
+        memcpy(layerExtensionsOut + offset, layerExtensionLists[i].data(), sizeof(VkExtensionProperties) * layerExtensionLists[i].size());
+        offset += (uint32_t)layerExtensionLists[i].size();
+    }
+    offsets[this->layerCount] = offset;
+
+    this->layerExtensionOffsets = offsets;
+    this->layers = layersOut;
+    this->instanceExtensions = instanceExtensionsOut;
+    this->layerExtensions = layerExtensionsOut;
+}
+
+/**
+ * Gets the number of available instance layers.
+ * @return the number of layers.
+ */
+uint32_t EnumerationSnapshot::getLayerCount() const
+{
+    return this->layerCount;
+}
+
+/**
+ * Gets the available instance layers.
+ * @return <code>getLayerCount</code> layer properties.
+ */
+const VkLayerProperties* EnumerationSnapshot::getLayers() const
+{
+    return this->layers;
+}
+
+/**
+ * Gets the number of instance extensions provided by the implementation and implicit layers.
+ * @return the number of extensions.
+ */
+uint32_t EnumerationSnapshot::getInstanceExtensionCount() const
+{
+    return this->instanceExtensionCount;
+}
+
+/**
+ * Gets the instance extensions provided by the implementation and implicit layers.
+ * @return <code>getInstanceExtensionCount</code> extension properties.
+ */
+const VkExtensionProperties* EnumerationSnapshot::getInstanceExtensions() const
+{
+    return this->instanceExtensions;
+}
+
+/**
+ * Gets the number of instance extensions a layer provides.
+ * @param layerIndex Index into <code>getLayers</code>.
+ * @return the number of extensions, or 0 if <code>layerIndex</code> is out of range.
+ */
+uint32_t EnumerationSnapshot::getLayerExtensionCount(uint32_t layerIndex) const
+{
+    if (layerIndex >= this->layerCount)
+    {
+        return 0;
+    }
+
+    return this->layerExtensionOffsets[layerIndex + 1] - this->layerExtensionOffsets[layerIndex];
+}
+
+/**
+ * Gets the instance extensions a layer provides.
+ * @param layerIndex Index into <code>getLayers</code>.
+ * @return <code>getLayerExtensionCount(layerIndex)</code> extension properties, or nullptr if out of range.
+ */
+const VkExtensionProperties* EnumerationSnapshot::getLayerExtensions(uint32_t layerIndex) const
+{
+    if (layerIndex >= this->layerCount)
+    {
+        return nullptr;
+    }
+
+    return this->layerExtensions + this->layerExtensionOffsets[layerIndex];
+}
+
+/**
+ * Looks up an instance extension by name.
+ * @param extensionName The extension name.
+ * @return the extension properties, or nullptr if the extension is not available.
+ */
+const VkExtensionProperties* EnumerationSnapshot::findInstanceExtension(const char* extensionName) const
+{
+    for (uint32_t i = 0; i < this->instanceExtensionCount; i++)
+    {
+        if (strcmp(this->instanceExtensions[i].extensionName, extensionName) == 0)
+        {
+            return &this->instanceExtensions[i];
+        }
+    }
+
+    return nullptr;
+}
+
+/**
+ * Gets the size of the snapshot's single allocation.
+ * @return the size in bytes.
+ */
+size_t EnumerationSnapshot::getSizeInBytes() const
+{
+    return this->sizeInBytes;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "VulkanLoader.h"
+#include <cstddef>
+#include <memory>
+
+/**
+ * One-shot snapshot of the instance layers, each layer's extensions and the instance extensions.
+ * Built once per process on first use and stored in a single contiguous allocation, so every accessor reads the same
+ * data instead of asking the loader to rescan its manifests.
+ */
+class EnumerationSnapshot
+{
+public:
+    static const EnumerationSnapshot& get();
+    static uint32_t getLoaderScanCount();
+
+    EnumerationSnapshot(const EnumerationSnapshot& other) = delete;
+    EnumerationSnapshot& operator=(const EnumerationSnapshot& other) = delete;
+
+    uint32_t getLayerCount() const;
+    const VkLayerProperties* getLayers() const;
+    uint32_t getInstanceExtensionCount() const;
+    const VkExtensionProperties* getInstanceExtensions() const;
+    uint32_t getLayerExtensionCount(uint32_t layerIndex) const;
+    const VkExtensionProperties* getLayerExtensions(uint32_t layerIndex) const;
+    const VkExtensionProperties* findInstanceExtension(const char* extensionName) const;
+    size_t getSizeInBytes() const;
+
+private:
+    EnumerationSnapshot();
+
+    std::unique_ptr<uint32_t[]> storage;
+    size_t sizeInBytes = 0;
+    uint32_t layerCount = 0;
+    uint32_t instanceExtensionCount = 0;
+    const uint32_t* layerExtensionOffsets = nullptr;
+    const VkLayerProperties* layers = nullptr;
+    const VkExtensionProperties* instanceExtensions = nullptr;
+    const VkExtensionProperties* layerExtensions = nullptr;
+};
@@ -0,0 +1,787 @@
+#include "CapabilitySnapshot.h"
+#include "FleetStore.h"
+#include "PipelineLayoutChecker.h"
+#include "SnapshotDelta.h"
+#include "SnapshotStore.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+/**
+ * Prints the command line usage.
+ * @param programName The name the program was invoked as.
+ */
+void printUsage(const char* programName)
+{
+    printf("Usage: %s [options] [snapshot files...]\n", programName);
+    printf("  --synthesize <rows> <file>   Write <rows> synthetic snapshots to <file> and exit.\n");
+    printf("  --store <file>               Add the snapshots to the deduplicating store <file> instead of querying them.\n");
+    printf("  --bench-store <rows> <file>  Benchmark ingesting <rows> synthetic snapshots into a new store <file>.\n");
+    printf("  --check-layouts <file>       Report how many of the devices each pipeline layout in <file> does not fit.\n");
+    printf("  --test-delta                 Round-trip the delta encoding over every field and the snapshots, then exit.\n");
+    printf("  --test-layouts               Check the layout checker's descriptor accounting on fixed cases, then exit.\n");
+    printf("  --test-store <file>          Check that a store cut off mid-append reopens aligned, using <file>, then exit.\n");
+    printf("  --where <field><op><value>   Keep rows matching the predicate (op: < <= > >= == !=). Repeatable, ANDed.\n");
+    printf("  --stats <field>              Print count, min, max and mean of a field over the matching rows.\n");
+    printf("  --group-by <field>           Print how many matching rows have each value of a field.\n");
+    printf("  --fields                     List the field names and kinds.\n");
+    printf("  --help                       Print this message.\n");
+}
+
+/**
+ * Generates a synthetic fleet: a few hundred device models with plausible limits and features, drawn with a skewed
+ * distribution so a handful of models make up most rows, as in a real install base.
+ * @param rows How many records to generate.
+ * @param seed The random seed. The same seed always gives the same fleet.
+ * @return the records.
+ */
+std::vector<CapabilitySnapshot::Record> synthesize(size_t rows, uint64_t seed)
+{
+    std::mt19937_64 random(seed);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+    const uint32_t vendorIds[] = {0x13B5, 0x5143, 0x1010, 0x144D, 0x10DE, 0x8086, 0x1002};
+    const uint32_t apiVersions[] = {VK_MAKE_API_VERSION(0, 1, 0, 61), VK_MAKE_API_VERSION(0, 1, 1, 128), VK_MAKE_API_VERSION(0, 1, 2, 195), VK_MAKE_API_VERSION(0, 1, 3, 250)};
+    const uint32_t sharedMemorySizes[] = {16384, 32768, 49152, 65536};
+
+    std::vector<CapabilitySnapshot::Record> models(400);
+    for (CapabilitySnapshot::Record& model : models)
+    {
+        for (uint32_t field = 0; field < CapabilityFields::Count; field++)
+        {
+            switch (CapabilityFields::get(field).kind)
+            {
+                case CapabilityFields::Kind::U32:
+                case CapabilityFields::Kind::U64:
+                    model.values[field] = 1ull << (4 + random() % 13);
+                    break;
+                case CapabilityFields::Kind::I32:
+                    model.values[field] = CapabilityFields::packI32(-(int32_t)(1u << (3 + random() % 4)));
+                    break;
+                case CapabilityFields::Kind::F32:
+                    model.values[field] = CapabilityFields::packF32((float)(1u << (random() % 9)));
+                    break;
+                case CapabilityFields::Kind::Bool:
+                    model.values[field] = unit(random) < 0.7 ? 1 : 0;
+                    break;
+            }
+        }
+
+        model.values[CapabilityFields::vendorID] = vendorIds[random() % (sizeof(vendorIds) / sizeof(vendorIds[0]))];
+        model.values[CapabilityFields::deviceID] = random() % 0x10000;
+        model.values[CapabilityFields::deviceType] = unit(random) < 0.9 ? VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU : VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU;
+        model.values[CapabilityFields::apiVersion] = apiVersions[random() % (sizeof(apiVersions) / sizeof(apiVersions[0]))];
+        model.values[CapabilityFields::maxComputeSharedMemorySize] = sharedMemorySizes[random() % (sizeof(sharedMemorySizes) / sizeof(sharedMemorySizes[0]))];
+        model.values[CapabilityFields::timestampPeriod] = CapabilityFields::packF32(unit(random) < 0.5 ? 1.0f : 52.083f);
+    }
+
+    std::vector<CapabilitySnapshot::Record> records(rows);
+    for (CapabilitySnapshot::Record& record : records)
+    {
+        double skew = unit(random);
+        record = models[(size_t)(skew * skew * skew * (double)models.size())];
+
+        // Devices of one model still differ by driver update.
+        record.values[CapabilityFields::driverVersion] = VK_MAKE_API_VERSION(0, 512, 400 + random() % 4, 0);
+    }
+
+    return records;
+}
+
+/**
+ * Prints a field value in the most readable form for its kind.
+ */
+void printValue(CapabilityFields::Kind kind, uint64_t slot)
+{
+    switch (kind)
+    {
+        case CapabilityFields::Kind::F32:
+            printf("%g", CapabilityFields::unpackF32(slot));
+            break;
+        case CapabilityFields::Kind::I32:
+            printf("%d", CapabilityFields::unpackI32(slot));
+            break;
+        case CapabilityFields::Kind::Bool:
+            printf("%s", slot != 0 ? "true" : "false");
+            break;
+        default:
+            printf("%llu (0x%llx)", (unsigned long long)slot, (unsigned long long)slot);
+            break;
+    }
+}
+
+/**
+ * Ingests records into a snapshot store and prints the throughput and how many of them were new.
+ * @param label What the pass is, for the output.
+ * @return false if a write failed.
+ */
+bool ingestIntoStore(SnapshotStore& store, const std::vector<CapabilitySnapshot::Record>& records, const char* label)
+{
+    const size_t objectsBefore = store.getObjectCount();
+    auto begin = std::chrono::steady_clock::now();
+    for (const CapabilitySnapshot::Record& record : records)
+    {
+        if (!store.ingest(record))
+        {
+            fprintf(stderr, "Failed to write to the store.\n");
+            return false;
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    printf("%s: %zu snapshots in %.3f s (%.2f M snapshots/s, %.0f MB/s), %zu new\n",
+           label,
+           records.size(),
+           seconds,
+           seconds > 0.0 ? (double)records.size() / seconds / 1e6 : 0.0,
+           seconds > 0.0 ? (double)(records.size() * sizeof(CapabilitySnapshot::Record)) / seconds / 1e6 : 0.0,
+           store.getObjectCount() - objectsBefore);
+    return true;
+}
+
+/**
+ * Prints how much space the store saves over keeping every snapshot in full.
+ */
+void printStoreSavings(const SnapshotStore& store)
+{
+    const uint64_t fullBytes = store.getReferenceCount() * sizeof(CapabilitySnapshot::Record);
+    const uint64_t storedBytes = store.getStoredBytes();
+    printf("Store: %zu distinct of %llu snapshots, %.2f MB instead of %.2f MB (%.2f%% saved, %.1fx)\n",
+           store.getObjectCount(),
+           (unsigned long long)store.getReferenceCount(),
+           (double)storedBytes / 1e6,
+           (double)fullBytes / 1e6,
+           fullBytes > 0 ? 100.0 * (1.0 - (double)storedBytes / (double)fullBytes) : 0.0,
+           storedBytes > 0 ? (double)fullBytes / (double)storedBytes : 0.0);
+}
+
+/**
+ * Benchmarks the deduplicating store on a synthetic corpus: a cold pass into an empty store, then the same corpus
+ * again after reopening it, where every snapshot is already known.
+ * @param rows The corpus size.
+ * @param path The store to create. Existing store files are replaced.
+ * @return the process exit code.
+ */
+int benchStore(size_t rows, const std::string& path)
+{
+    std::vector<CapabilitySnapshot::Record> records = synthesize(rows, 1);
+    remove(path.c_str());
+    remove((path + ".refs").c_str());
+
+    SnapshotStore store;
+    if (!store.open(path))
+    {
+        fprintf(stderr, "Failed to create the store %s.\n", path.c_str());
+        return 1;
+    }
+
+    if (!ingestIntoStore(store, records, "Cold ingest") || !store.close())
+    {
+        return 1;
+    }
+
+    auto openBegin = std::chrono::steady_clock::now();
+    if (!store.open(path))
+    {
+        fprintf(stderr, "Failed to reopen the store %s.\n", path.c_str());
+        return 1;
+    }
+    double openSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - openBegin).count();
+    printf("Reopen: loaded %zu hashes in %.3f ms\n", store.getObjectCount(), openSeconds * 1e3);
+
+    if (!ingestIntoStore(store, records, "Warm ingest"))
+    {
+        return 1;
+    }
+
+    printStoreSavings(store);
+    return store.close() ? 0 : 1;
+}
+
+/**
+ * Cuts bytes off the end of a file, as a crash in the middle of an append would.
+ * @return false if the file could not be read or truncated.
+ */
+bool chopFile(const std::string& path, long bytes)
+{
+    FILE* file = fopen(path.c_str(), "r+b");
+    if (file == nullptr)
+    {
+        return false;
+    }
+
+    fseek(file, 0, SEEK_END);
+    const long size = ftell(file);
+    const bool ok = size > bytes && ftruncate(fileno(file), size - bytes) == 0;
+    fclose(file);
+    return ok;
+}
+
+/**
+ * Tests that a store whose files end in a partial entry reopens with only the complete entries and that records
+ * ingested afterwards stay aligned: after a second reopen every record must be found again.
+ * @param path The store to create. Existing store files are replaced.
+ * @return the process exit code.
+ */
+int testStore(const std::string& path)
+{
+    std::vector<CapabilitySnapshot::Record> records = synthesize(1000, 1);
+    std::vector<CapabilitySnapshot::Record> distinct = synthesize(1000, 2);
+    remove(path.c_str());
+    remove((path + ".refs").c_str());
+
+    SnapshotStore store;
+    if (!store.open(path) || !ingestIntoStore(store, records, "Before the cut"))
+    {
+        fprintf(stderr, "Failed to create the store %s.\n", path.c_str());
+        return 1;
+    }
+    const size_t objectCount = store.getObjectCount();
+    const uint64_t referenceCount = store.getReferenceCount();
+
+    if (!store.close() || !chopFile(path, 5) || !chopFile(path + ".refs", 3))
+    {
+        fprintf(stderr, "Failed to cut the store %s.\n", path.c_str());
+        return 1;
+    }
+
+    uint32_t failures = 0;
+    if (!store.open(path))
+    {
+        fprintf(stderr, "Failed to reopen the store %s.\n", path.c_str());
+        return 1;
+    }
+
+    if (store.getObjectCount() != objectCount - 1 || store.getReferenceCount() != referenceCount - 1)
+    {
+        printf("FAIL: reopened with %zu objects and %llu references, expected %zu and %llu\n",
+               store.getObjectCount(),
+               (unsigned long long)store.getReferenceCount(),
+               objectCount - 1,
+               (unsigned long long)(referenceCount - 1));
+        failures++;
+    }
+
+    std::vector<MurmurHash3::Hash128> hashes;
+    for (const std::vector<CapabilitySnapshot::Record>* pass : {&records, &distinct})
+    {
+        for (const CapabilitySnapshot::Record& record : *pass)
+        {
+            hashes.emplace_back();
+            if (!store.ingest(record, &hashes.back()))
+            {
+                fprintf(stderr, "Failed to write to the store.\n");
+                return 1;
+            }
+        }
+    }
+
+    const size_t finalObjectCount = store.getObjectCount();
+    const uint64_t finalReferenceCount = store.getReferenceCount();
+    if (!store.close() || !store.open(path))
+    {
+        fprintf(stderr, "Failed to reopen the store %s.\n", path.c_str());
+        return 1;
+    }
+
+    if (store.getObjectCount() != finalObjectCount || store.getReferenceCount() != finalReferenceCount)
+    {
+        printf("FAIL: reopened with %zu objects and %llu references after appending, expected %zu and %llu\n",
+               store.getObjectCount(),
+               (unsigned long long)store.getReferenceCount(),
+               finalObjectCount,
+               (unsigned long long)finalReferenceCount);
+        failures++;
+    }
+
+    for (const MurmurHash3::Hash128& hash : hashes)
+    {
+        if (!store.contains(hash))
+        {
+            failures++;
+        }
+    }
+
+    store.close();
+    remove(path.c_str());
+    remove((path + ".refs").c_str());
+
+    printf("%s (%u failures)\n", failures == 0 ? "PASS" : "FAIL", failures);
+    return failures == 0 ? 0 : 1;
+}
+
+/**
+ * Encodes a record against the reference, decodes it again and compares the result with the canonical record.
+ * @param size (OUT param) The encoded size.
+ * @return whether the record survived the round trip.
+ */
+bool roundTripDelta(const SnapshotDelta::Reference& reference, const CapabilitySnapshot::Record& record, size_t& size)
+{
+    uint8_t buffer[SnapshotDelta::MaxEncodedSize];
+    size = SnapshotDelta::encode(reference, record, buffer, sizeof(buffer));
+
+    CapabilitySnapshot::Record decoded;
+    if (size == 0 || SnapshotDelta::decode(reference, buffer, size, decoded) != size)
+    {
+        return false;
+    }
+
+    CapabilitySnapshot::Record expected = CapabilitySnapshot::canonicalize(record);
+    return memcmp(&expected, &decoded, sizeof(expected)) == 0;
+}
+
+/**
+ * Tests the delta encoding: every field is set in turn to the edge values of its kind, a record with every field
+ * changed must fit <code>MaxEncodedSize</code>, truncated encodings must be rejected, and the records, if any, must
+ * round-trip against the first of them as reference. Prints the average encoded size.
+ * @param records The snapshots to round-trip. The synthetic corpus is used if empty.
+ * @return the process exit code.
+ */
+int testDelta(std::vector<CapabilitySnapshot::Record> records)
+{
+    if (records.empty())
+    {
+        records = synthesize(100000, 1);
+    }
+
+    const SnapshotDelta::Reference reference = SnapshotDelta::makeReference(records[0]);
+    const uint64_t edgeValues[] = {0, 1, 2, 0x7f, 0x80, 0x7fffffff, 0x80000000, 0xffffffff, 0x100000000ull, ~0ull,
+                                   CapabilityFields::packF32(-0.0f), CapabilityFields::packF32(-1.5f), 0x7fc00001, 0xff800000};
+    uint32_t failures = 0;
+    size_t size = 0;
+
+    CapabilitySnapshot::Record allChanged = reference.record;
+    for (uint32_t field = 0; field < CapabilityFields::Count; field++)
+    {
+        for (uint64_t value : edgeValues)
+        {
+            CapabilitySnapshot::Record record = reference.record;
+            record.values[field] = value;
+            if (!roundTripDelta(reference, record, size))
+            {
+                printf("FAIL: %s = 0x%llx\n", CapabilityFields::get(field).name, (unsigned long long)value);
+                failures++;
+            }
+        }
+
+        allChanged.values[field] = CapabilityFields::get(field).kind == CapabilityFields::Kind::Bool ? !reference.record.values[field] : ~reference.record.values[field];
+    }
+
+    if (!roundTripDelta(reference, allChanged, size))
+    {
+        printf("FAIL: every field changed\n");
+        failures++;
+    }
+    printf("Every field changed: %zu bytes (bound %zu)\n", size, SnapshotDelta::MaxEncodedSize);
+
+    uint8_t buffer[SnapshotDelta::MaxEncodedSize];
+    size = SnapshotDelta::encode(reference, allChanged, buffer, sizeof(buffer));
+    CapabilitySnapshot::Record decoded;
+    for (size_t truncated = 0; truncated < size; truncated++)
+    {
+        if (SnapshotDelta::decode(reference, buffer, truncated, decoded) != 0)
+        {
+            printf("FAIL: accepted an encoding truncated to %zu bytes\n", truncated);
+            failures++;
+        }
+    }
+
+    uint64_t totalSize = 0;
+    auto begin = std::chrono::steady_clock::now();
+    for (const CapabilitySnapshot::Record& record : records)
+    {
+        if (!roundTripDelta(reference, record, size))
+        {
+            failures++;
+        }
+        totalSize += size;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    printf("Snapshots: %zu round-tripped in %.3f s, %.1f bytes on average instead of %zu\n",
+           records.size(),
+           seconds,
+           (double)totalSize / (double)records.size(),
+           sizeof(CapabilitySnapshot::Record));
+    printf("%s (%u failures)\n", failures == 0 ? "PASS" : "FAIL", failures);
+    return failures == 0 ? 0 : 1;
+}
+
+/**
+ * Tests the layout checker's descriptor accounting against a device with 16 samplers and 64 sampled images per stage
+ * and per layout: combined image samplers must count against both limits, per stage and summed over the sets.
+ * @return the process exit code.
+ */
+int testLayouts()
+{
+    struct Case
+    {
+        const char* text;
+        uint32_t expected;
+    };
+
+    const uint32_t perStageSamplers = 1u << PipelineLayoutChecker::maxPerStageDescriptorSamplers;
+    const uint32_t perSetSamplers = 1u << PipelineLayoutChecker::maxDescriptorSetSamplers;
+    const Case cases[] =
+    {
+        {"combined_fits 0:0:combined:16:f", 0},
+        {"combined_over 0:0:combined:20:f", perStageSamplers | perSetSamplers},
+        {"combined_sets 0:0:combined:10:f 1:0:combined:10:v", perSetSamplers},
+        {"mixed_samplers 0:0:sampler:8:f 0:1:combined:10:f", perStageSamplers | perSetSamplers},
+        {"sampled_only 0:0:sampled:40:f", 0},
+    };
+
+    VkPhysicalDeviceLimits limits = {};
+#define VKINFO_LAYOUT_LIMIT_MAX(member) limits.member = 1024;
+    VKINFO_LAYOUT_LIMITS(VKINFO_LAYOUT_LIMIT_MAX)
+#undef VKINFO_LAYOUT_LIMIT_MAX
+    limits.maxPerStageDescriptorSamplers = 16;
+    limits.maxDescriptorSetSamplers = 16;
+    limits.maxPerStageDescriptorSampledImages = 64;
+    limits.maxDescriptorSetSampledImages = 64;
+
+    PipelineLayoutChecker checker;
+    checker.addDevice(limits);
+
+    std::vector<PipelineLayoutChecker::Layout> layouts;
+    uint32_t failures = 0;
+    for (const Case& testCase : cases)
+    {
+        layouts.emplace_back();
+        if (!PipelineLayoutChecker::parseLayout(testCase.text, layouts.back()))
+        {
+            printf("FAIL: could not parse '%s'\n", testCase.text);
+            return 1;
+        }
+    }
+
+    std::vector<uint32_t> violations = checker.check(layouts);
+    for (size_t i = 0; i < layouts.size(); i++)
+    {
+        if (violations[i] != cases[i].expected)
+        {
+            printf("FAIL: %s exceeds 0x%x, expected 0x%x\n", layouts[i].name.c_str(), violations[i], cases[i].expected);
+            failures++;
+        }
+    }
+
+    printf("%s (%u failures)\n", failures == 0 ? "PASS" : "FAIL", failures);
+    return failures == 0 ? 0 : 1;
+}
+
+/**
+ * Checks pipeline layouts against the limits of every snapshot and prints, per layout, how many devices it does not
+ * fit and which limits it exceeds on how many.
+ * @param path The layout description file (see PipelineLayoutChecker.h).
+ * @param records The snapshots.
+ * @return the process exit code: 0 if every layout fits every device, 2 if some do not.
+ */
+int checkLayouts(const std::string& path, const std::vector<CapabilitySnapshot::Record>& records)
+{
+    std::vector<PipelineLayoutChecker::Layout> layouts;
+    size_t errorLine = 0;
+    if (!PipelineLayoutChecker::readLayouts(path, layouts, errorLine))
+    {
+        fprintf(stderr, errorLine > 0 ? "%s:%zu: malformed layout.\n" : "Failed to read %s.\n", path.c_str(), errorLine);
+        return 1;
+    }
+
+    PipelineLayoutChecker checker;
+    for (const CapabilitySnapshot::Record& record : records)
+    {
+        VkPhysicalDeviceProperties properties = {};
+        VkPhysicalDeviceFeatures features = {};
+        CapabilitySnapshot::toProperties(record, properties, features);
+        checker.addDevice(properties.limits);
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    std::vector<uint32_t> violations = checker.check(layouts);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    const size_t rowCount = checker.getRowCount();
+    size_t failingLayouts = 0;
+    for (size_t layout = 0; layout < layouts.size(); layout++)
+    {
+        uint64_t failing = 0;
+        uint64_t perLimit[PipelineLayoutChecker::LimitCount] = {};
+        for (size_t row = 0; row < rowCount; row++)
+        {
+            const uint32_t mask = violations[layout * rowCount + row];
+            failing += mask != 0 ? checker.getRowWeight(row) : 0;
+            for (uint32_t limit = 0; limit < PipelineLayoutChecker::LimitCount; limit++)
+            {
+                perLimit[limit] += (mask >> limit) & 1u ? checker.getRowWeight(row) : 0;
+            }
+        }
+
+        if (failing == 0)
+        {
+            continue;
+        }
+
+        failingLayouts++;
+        printf("%s: does not fit %llu of %zu devices (%.2f%%)\n",
+               layouts[layout].name.c_str(),
+               (unsigned long long)failing,
+               records.size(),
+               100.0 * (double)failing / (double)records.size());
+        for (uint32_t limit = 0; limit < PipelineLayoutChecker::LimitCount; limit++)
+        {
+            if (perLimit[limit] > 0)
+            {
+                printf("  %s %u: exceeded on %llu\n",
+                       PipelineLayoutChecker::getLimitName(limit),
+                       layouts[layout].demand[limit],
+                       (unsigned long long)perLimit[limit]);
+            }
+        }
+    }
+
+    printf("%zu of %zu layouts do not fit every device; %zu layouts x %zu distinct limit sets checked in %.3f ms\n",
+           failingLayouts,
+           layouts.size(),
+           layouts.size(),
+           rowCount,
+           seconds * 1e3);
+    return failingLayouts == 0 ? 0 : 2;
+}
+
+/**
+ * Looks up a field name given on the command line, printing an error if it is unknown.
+ * @return the field index, or -1.
+ */
+int32_t findField(const char* name)
+{
+    int32_t field = CapabilityFields::find(name);
+    if (field < 0)
+    {
+        fprintf(stderr, "Unknown field '%s'. Use --fields to list them.\n", name);
+    }
+
+    return field;
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<std::string> inputs;
+    std::vector<FleetStore::Predicate> predicates;
+    std::vector<int32_t> statsFields;
+    std::vector<int32_t> groupFields;
+    const char* storePath = nullptr;
+    bool deltaTest = false;
+    const char* layoutsPath = nullptr;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--synthesize") == 0 && i + 2 < argc)
+        {
+            size_t rows = (size_t)strtoull(argv[i + 1], nullptr, 10);
+            std::vector<CapabilitySnapshot::Record> records = synthesize(rows, 1);
+            if (!CapabilitySnapshot::writeFile(argv[i + 2], records.data(), records.size(), false))
+            {
+                fprintf(stderr, "Failed to write %s.\n", argv[i + 2]);
+                return 1;
+            }
+
+            printf("Wrote %zu synthetic snapshots to %s.\n", records.size(), argv[i + 2]);
+            return 0;
+        }
+        else if (strcmp(argv[i], "--bench-store") == 0 && i + 2 < argc)
+        {
+            return benchStore((size_t)strtoull(argv[i + 1], nullptr, 10), argv[i + 2]);
+        }
+        else if (strcmp(argv[i], "--store") == 0 && i + 1 < argc)
+        {
+            storePath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--check-layouts") == 0 && i + 1 < argc)
+        {
+            layoutsPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--test-delta") == 0)
+        {
+            deltaTest = true;
+        }
+        else if (strcmp(argv[i], "--test-layouts") == 0)
+        {
+            return testLayouts();
+        }
+        else if (strcmp(argv[i], "--test-store") == 0 && i + 1 < argc)
+        {
+            return testStore(argv[i + 1]);
+        }
+        else if (strcmp(argv[i], "--where") == 0 && i + 1 < argc)
+        {
+            FleetStore::Predicate predicate;
+            if (!FleetStore::parsePredicate(argv[++i], predicate))
+            {
+                fprintf(stderr, "Invalid predicate '%s'.\n", argv[i]);
+                return 1;
+            }
+            predicates.push_back(predicate);
+        }
+        else if (strcmp(argv[i], "--stats") == 0 && i + 1 < argc)
+        {
+            statsFields.push_back(findField(argv[++i]));
+            if (statsFields.back() < 0)
+            {
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--group-by") == 0 && i + 1 < argc)
+        {
+            groupFields.push_back(findField(argv[++i]));
+            if (groupFields.back() < 0)
+            {
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--fields") == 0)
+        {
+            for (uint32_t field = 0; field < CapabilityFields::Count; field++)
+            {
+                printf("%-48s %s\n", CapabilityFields::get(field).name, CapabilityFields::getKindName(CapabilityFields::get(field).kind));
+            }
+            return 0;
+        }
+        else if (strcmp(argv[i], "--help") == 0)
+        {
+            printUsage(argv[0]);
+            return 0;
+        }
+        else if (argv[i][0] != '-')
+        {
+            inputs.push_back(argv[i]);
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (inputs.empty() && !deltaTest)
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    if (deltaTest)
+    {
+        std::vector<CapabilitySnapshot::Record> records;
+        for (const std::string& input : inputs)
+        {
+            if (!CapabilitySnapshot::readFile(input, records))
+            {
+                fprintf(stderr, "Failed to read %s.\n", input.c_str());
+                return 1;
+            }
+        }
+
+        return testDelta(std::move(records));
+    }
+
+    if (layoutsPath != nullptr)
+    {
+        std::vector<CapabilitySnapshot::Record> records;
+        for (const std::string& input : inputs)
+        {
+            if (!CapabilitySnapshot::readFile(input, records))
+            {
+                fprintf(stderr, "Failed to read %s.\n", input.c_str());
+                return 1;
+            }
+        }
+
+        return checkLayouts(layoutsPath, records);
+    }
+
+    if (storePath != nullptr)
+    {
+        SnapshotStore store;
+        if (!store.open(storePath))
+        {
+            fprintf(stderr, "Failed to open the store %s.\n", storePath);
+            return 1;
+        }
+
+        for (const std::string& input : inputs)
+        {
+            std::vector<CapabilitySnapshot::Record> records;
+            if (!CapabilitySnapshot::readFile(input, records))
+            {
+                fprintf(stderr, "Failed to read %s.\n", input.c_str());
+                return 1;
+            }
+
+            if (!ingestIntoStore(store, records, input.c_str()))
+            {
+                return 1;
+            }
+        }
+
+        printStoreSavings(store);
+        return store.close() ? 0 : 1;
+    }
+
+    FleetStore store;
+    auto ingestBegin = std::chrono::steady_clock::now();
+    for (const std::string& input : inputs)
+    {
+        std::vector<CapabilitySnapshot::Record> records;
+        if (!CapabilitySnapshot::readFile(input, records))
+        {
+            fprintf(stderr, "Failed to read %s.\n", input.c_str());
+            return 1;
+        }
+        store.append(records.data(), records.size());
+    }
+    double ingestSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - ingestBegin).count();
+    printf("Ingested %zu rows in %.3f s\n", store.getRowCount(), ingestSeconds);
+
+    auto scanBegin = std::chrono::steady_clock::now();
+    FleetStore::Selection selection = store.filter(predicates);
+    double scanSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - scanBegin).count();
+
+    uint64_t matching = FleetStore::count(selection);
+    printf("Matching: %llu of %zu rows (%.3f%%)\n",
+           (unsigned long long)matching,
+           store.getRowCount(),
+           store.getRowCount() > 0 ? 100.0 * (double)matching / (double)store.getRowCount() : 0.0);
+    printf("Scan: %zu predicate(s) in %.3f ms (%.0f M rows/s per predicate)\n",
+           predicates.size(),
+           scanSeconds * 1e3,
+           predicates.empty() || scanSeconds <= 0.0 ? 0.0 : (double)store.getRowCount() * (double)predicates.size() / scanSeconds / 1e6);
+
+    for (int32_t field : statsFields)
+    {
+        FleetStore::Stats stats = store.aggregate(selection, (uint32_t)field);
+        printf("%s: count %llu, min %g, max %g, mean %g\n",
+               CapabilityFields::get((uint32_t)field).name,
+               (unsigned long long)stats.count,
+               stats.min,
+               stats.max,
+               stats.mean);
+    }
+
+    for (int32_t field : groupFields)
+    {
+        const CapabilityFields::Field& info = CapabilityFields::get((uint32_t)field);
+        printf("%s:\n", info.name);
+        for (const std::pair<uint64_t, uint64_t>& group : store.groupCount(selection, (uint32_t)field))
+        {
+            printf("  ");
+            printValue(info.kind, group.first);
+            printf(": %llu (%.2f%%)\n", (unsigned long long)group.second, matching > 0 ? 100.0 * (double)group.second / (double)matching : 0.0);
+        }
+    }
+
+    return 0;
+}
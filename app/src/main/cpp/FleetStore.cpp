@@ -0,0 +1,537 @@
+#include "FleetStore.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <unordered_map>
+
+namespace
+{
+    /**
+     * 256-bit GCC/Clang vector extension types. They lower to AVX2 with <code>-mavx2</code>, to pairs of SSE2 or NEON
+     * registers otherwise, so the same scan code runs on the x86 build hosts and on ARM.
+     */
+    typedef uint32_t U32x8 __attribute__((vector_size(32)));
+    typedef int32_t I32x8 __attribute__((vector_size(32)));
+    typedef float F32x8 __attribute__((vector_size(32)));
+    typedef uint64_t U64x4 __attribute__((vector_size(32)));
+
+    constexpr size_t RowsPerWord = 64;
+
+    size_t getWordCount(size_t rows)
+    {
+        return (rows + RowsPerWord - 1) / RowsPerWord;
+    }
+
+    /**
+     * Tests the rows of one column against <code>[low, high]</code> and ANDs the result into the selection.
+     * Words already empty in the selection are skipped, so each further predicate of a conjunction gets cheaper.
+     * @param negate Whether to keep the rows outside the range instead.
+     */
+    template <typename Vector, typename Scalar>
+    void scanRange(const Scalar* column, Scalar low, Scalar high, bool negate, uint64_t* selection, size_t wordCount)
+    {
+        constexpr size_t Lanes = sizeof(Vector) / sizeof(Scalar);
+        static_assert(RowsPerWord % Lanes == 0, "A selection word must hold whole vectors");
+
+        const Vector lowVector = Vector{} + low;
+        const Vector highVector = Vector{} + high;
+
+        for (size_t word = 0; word < wordCount; word++)
+        {
+            if (selection[word] == 0)
+            {
+                continue;
+            }
+
+            const Scalar* block = column + word * RowsPerWord;
+            uint64_t bits = 0;
+            for (size_t i = 0; i < RowsPerWord; i += Lanes)
+            {
+                Vector values;
+                memcpy(&values, block + i, sizeof(values));
+                auto inRange = (values >= lowVector) & (values <= highVector);
+                for (size_t lane = 0; lane < Lanes; lane++)
+                {
+                    bits |= (uint64_t)(inRange[lane] & 1) << (i + lane);
+                }
+            }
+
+            selection[word] &= negate ? ~bits : bits;
+        }
+    }
+
+    /**
+     * Turns <code>value op x</code> on an integer column into an inclusive range of <code>T</code>, so every
+     * comparison runs through the same range scan. <code>!=</code> becomes the negated <code>==</code> range.
+     * @return false if no value of <code>T</code> is in the range.
+     */
+    template <typename T>
+    bool toIntegerRange(FleetStore::Op op, double value, T& low, T& high, bool& negate)
+    {
+        const double minimum = (double)std::numeric_limits<T>::min();
+        const double maximum = (double)std::numeric_limits<T>::max();
+        double lowValue = minimum;
+        double highValue = maximum;
+        negate = false;
+
+        switch (op)
+        {
+            case FleetStore::Op::GreaterEqual:
+                lowValue = std::ceil(value);
+                break;
+            case FleetStore::Op::Greater:
+                lowValue = std::floor(value) + 1.0;
+                break;
+            case FleetStore::Op::LessEqual:
+                highValue = std::floor(value);
+                break;
+            case FleetStore::Op::Less:
+                highValue = std::ceil(value) - 1.0;
+                break;
+            case FleetStore::Op::NotEqual:
+                negate = true;
+                // fall through
+            case FleetStore::Op::Equal:
+                if (std::floor(value) != value)
+                {
+                    return false;
+                }
+                lowValue = value;
+                highValue = value;
+                break;
+        }
+
+        if (lowValue > highValue || lowValue > maximum || highValue < minimum)
+        {
+            return false;
+        }
+
+        low = lowValue <= minimum ? std::numeric_limits<T>::min() : (T)lowValue;
+        high = highValue >= maximum ? std::numeric_limits<T>::max() : (T)highValue;
+        return true;
+    }
+
+    /**
+     * Float version of <code>toIntegerRange</code>. Bounds are rounded outward to the nearest float so the double
+     * comparison value is honoured exactly. NaN rows never match a range.
+     */
+    bool toFloatRange(FleetStore::Op op, double value, float& low, float& high, bool& negate)
+    {
+        const float infinity = std::numeric_limits<float>::infinity();
+        float rounded = (float)value;
+        float above = (double)rounded >= value ? rounded : std::nextafter(rounded, infinity);
+        float below = (double)rounded <= value ? rounded : std::nextafter(rounded, -infinity);
+        low = -infinity;
+        high = infinity;
+        negate = false;
+
+        switch (op)
+        {
+            case FleetStore::Op::GreaterEqual:
+                low = above;
+                break;
+            case FleetStore::Op::Greater:
+                low = (double)above == value ? std::nextafter(above, infinity) : above;
+                break;
+            case FleetStore::Op::LessEqual:
+                high = below;
+                break;
+            case FleetStore::Op::Less:
+                high = (double)below == value ? std::nextafter(below, -infinity) : below;
+                break;
+            case FleetStore::Op::NotEqual:
+                negate = true;
+                // fall through
+            case FleetStore::Op::Equal:
+                if ((double)rounded != value)
+                {
+                    return false;
+                }
+                low = rounded;
+                high = rounded;
+                break;
+        }
+
+        return low <= high;
+    }
+}
+
+/**
+ * Parses a predicate such as <code>maxComputeSharedMemorySize>=32768</code> or <code>shaderInt16==true</code>.
+ * Operators are <code>&lt; &lt;= &gt; &gt;= == !=</code> (<code>=</code> is accepted for <code>==</code>). Values are
+ * decimal or <code>0x</code> hexadecimal numbers, or <code>true</code>/<code>false</code>.
+ * @param text The predicate.
+ * @param predicate (OUT param) The parsed predicate.
+ * @return false if the field is unknown or the text is malformed.
+ */
+bool FleetStore::parsePredicate(const std::string& text, Predicate& predicate)
+{
+    size_t position = text.find_first_of("<>=!");
+    if (position == std::string::npos || position == 0)
+    {
+        return false;
+    }
+
+    std::string name = text.substr(0, position);
+    std::string rest = text.substr(position);
+    size_t operatorLength = 2;
+
+    if (rest.compare(0, 2, "<=") == 0)
+    {
+        predicate.op = Op::LessEqual;
+    }
+    else if (rest.compare(0, 2, ">=") == 0)
+    {
+        predicate.op = Op::GreaterEqual;
+    }
+    else if (rest.compare(0, 2, "==") == 0)
+    {
+        predicate.op = Op::Equal;
+    }
+    else if (rest.compare(0, 2, "!=") == 0)
+    {
+        predicate.op = Op::NotEqual;
+    }
+    else
+    {
+        operatorLength = 1;
+        switch (rest[0])
+        {
+            case '<':
+                predicate.op = Op::Less;
+                break;
+            case '>':
+                predicate.op = Op::Greater;
+                break;
+            case '=':
+                predicate.op = Op::Equal;
+                break;
+            default:
+                return false;
+        }
+    }
+
+    int32_t field = CapabilityFields::find(name.c_str());
+    std::string valueText = rest.substr(operatorLength);
+    if (field < 0 || valueText.empty())
+    {
+        return false;
+    }
+    predicate.field = (uint32_t)field;
+
+    if (valueText == "true" || valueText == "false")
+    {
+        predicate.value = valueText == "true" ? 1.0 : 0.0;
+        return true;
+    }
+
+    char* end = nullptr;
+    predicate.value = strtod(valueText.c_str(), &end);
+    return end != nullptr && *end == '\0';
+}
+
+/**
+ * Counts the selected rows.
+ * @param selection A selection bitmap.
+ * @return the number of set bits.
+ */
+uint64_t FleetStore::count(const Selection& selection)
+{
+    uint64_t total = 0;
+    for (uint64_t word : selection)
+    {
+        total += (uint64_t)__builtin_popcountll(word);
+    }
+
+    return total;
+}
+
+FleetStore::FleetStore()
+{
+    this->columns.resize(CapabilityFields::Count);
+    for (uint32_t i = 0; i < CapabilityFields::Count; i++)
+    {
+        this->columns[i].kind = CapabilityFields::get(i).kind;
+    }
+}
+
+/**
+ * Transposes records into the columns. Records are walked in blocks that stay in cache while every column takes its
+ * field from them, instead of streaming all records once per column.
+ * @param records The records to add.
+ * @param count The number of records.
+ */
+void FleetStore::append(const CapabilitySnapshot::Record* records, size_t count)
+{
+    const size_t first = this->rowCount;
+    this->rowCount += count;
+    const size_t paddedRows = getWordCount(this->rowCount) * RowsPerWord;
+
+    for (Column& column : this->columns)
+    {
+        if (column.kind == CapabilityFields::Kind::Bool)
+        {
+            column.wide.resize(getWordCount(this->rowCount), 0);
+        }
+        else if (column.kind == CapabilityFields::Kind::U64)
+        {
+            column.wide.resize(paddedRows, 0);
+        }
+        else
+        {
+            column.narrow.resize(paddedRows, 0);
+        }
+    }
+
+    constexpr size_t BlockRows = 64;
+    for (size_t blockBegin = 0; blockBegin < count; blockBegin += BlockRows)
+    {
+        const size_t blockEnd = std::min(count, blockBegin + BlockRows);
+        for (uint32_t field = 0; field < CapabilityFields::Count; field++)
+        {
+            Column& column = this->columns[field];
+            switch (column.kind)
+            {
+                case CapabilityFields::Kind::U32:
+                case CapabilityFields::Kind::I32:
+                case CapabilityFields::Kind::F32:
+                    for (size_t i = blockBegin; i < blockEnd; i++)
+                    {
+                        column.narrow[first + i] = (uint32_t)records[i].values[field];
+                    }
+                    break;
+
+                case CapabilityFields::Kind::U64:
+                    for (size_t i = blockBegin; i < blockEnd; i++)
+                    {
+                        column.wide[first + i] = records[i].values[field];
+                    }
+                    break;
+
+                case CapabilityFields::Kind::Bool:
+                    for (size_t i = blockBegin; i < blockEnd; i++)
+                    {
+                        size_t row = first + i;
+                        column.wide[row / RowsPerWord] |= (records[i].values[field] != 0 ? 1ull : 0ull) << (row % RowsPerWord);
+                    }
+                    break;
+            }
+        }
+    }
+}
+
+size_t FleetStore::getRowCount() const
+{
+    return this->rowCount;
+}
+
+/**
+ * Gets a selection of every row. The padding rows past <code>getRowCount</code> are never selected.
+ */
+FleetStore::Selection FleetStore::selectAll() const
+{
+    Selection selection(getWordCount(this->rowCount), ~0ull);
+    if (this->rowCount % RowsPerWord != 0)
+    {
+        selection.back() = (1ull << (this->rowCount % RowsPerWord)) - 1;
+    }
+
+    return selection;
+}
+
+/**
+ * Narrows a selection to the rows matching a predicate.
+ * @param predicate The predicate.
+ * @param selection (IN/OUT param) The selection to narrow, from <code>selectAll</code> or an earlier filter.
+ */
+void FleetStore::filter(const Predicate& predicate, Selection& selection) const
+{
+    const Column& column = this->columns[predicate.field];
+    const size_t wordCount = selection.size();
+    bool negate = false;
+    bool nonEmpty = false;
+
+    switch (column.kind)
+    {
+        case CapabilityFields::Kind::U32:
+        {
+            uint32_t low = 0;
+            uint32_t high = 0;
+            nonEmpty = toIntegerRange(predicate.op, predicate.value, low, high, negate);
+            if (nonEmpty)
+            {
+                scanRange<U32x8>(column.narrow.data(), low, high, negate, selection.data(), wordCount);
+            }
+            break;
+        }
+
+        case CapabilityFields::Kind::I32:
+        {
+            int32_t low = 0;
+            int32_t high = 0;
+            nonEmpty = toIntegerRange(predicate.op, predicate.value, low, high, negate);
+            if (nonEmpty)
+            {
+                scanRange<I32x8>((const int32_t*)column.narrow.data(), low, high, negate, selection.data(), wordCount);
+            }
+            break;
+        }
+
+        case CapabilityFields::Kind::F32:
+        {
+            float low = 0.0f;
+            float high = 0.0f;
+            nonEmpty = toFloatRange(predicate.op, predicate.value, low, high, negate);
+            if (nonEmpty)
+            {
+                scanRange<F32x8>((const float*)column.narrow.data(), low, high, negate, selection.data(), wordCount);
+            }
+            break;
+        }
+
+        case CapabilityFields::Kind::U64:
+        {
+            uint64_t low = 0;
+            uint64_t high = 0;
+            nonEmpty = toIntegerRange(predicate.op, predicate.value, low, high, negate);
+            if (nonEmpty)
+            {
+                scanRange<U64x4>(column.wide.data(), low, high, negate, selection.data(), wordCount);
+            }
+            break;
+        }
+
+        case CapabilityFields::Kind::Bool:
+        {
+            uint32_t low = 0;
+            uint32_t high = 0;
+            nonEmpty = toIntegerRange(predicate.op, predicate.value, low, high, negate);
+            if (nonEmpty)
+            {
+                bool matchFalse = low == 0;
+                bool matchTrue = high >= 1;
+                if (negate)
+                {
+                    matchFalse = !matchFalse;
+                    matchTrue = !matchTrue;
+                }
+
+                for (size_t word = 0; word < wordCount; word++)
+                {
+                    uint64_t bits = (matchTrue ? column.wide[word] : 0) | (matchFalse ? ~column.wide[word] : 0);
+                    selection[word] &= bits;
+                }
+            }
+            break;
+        }
+    }
+
+    // An empty range matches nothing, so its negation matches everything.
+    if (!nonEmpty && !negate)
+    {
+        std::fill(selection.begin(), selection.end(), 0);
+    }
+}
+
+/**
+ * Selects the rows matching every predicate.
+ * @param predicates The predicates to AND together. An empty list selects every row.
+ * @return the selection.
+ */
+FleetStore::Selection FleetStore::filter(const std::vector<Predicate>& predicates) const
+{
+    Selection selection = this->selectAll();
+    for (const Predicate& predicate : predicates)
+    {
+        this->filter(predicate, selection);
+    }
+
+    return selection;
+}
+
+/**
+ * Computes the count, minimum, maximum and mean of a field over the selected rows.
+ * @param selection The rows to aggregate.
+ * @param field The field index.
+ * @return the statistics. All zero if nothing is selected.
+ */
+FleetStore::Stats FleetStore::aggregate(const Selection& selection, uint32_t field) const
+{
+    const CapabilityFields::Kind kind = this->columns[field].kind;
+    Stats stats = {};
+    double sum = 0.0;
+
+    for (size_t word = 0; word < selection.size(); word++)
+    {
+        uint64_t bits = selection[word];
+        while (bits != 0)
+        {
+            size_t row = word * RowsPerWord + (size_t)__builtin_ctzll(bits);
+            bits &= bits - 1;
+
+            double value = CapabilityFields::toDouble(kind, this->getSlot(field, row));
+            if (stats.count == 0 || value < stats.min)
+            {
+                stats.min = value;
+            }
+            if (stats.count == 0 || value > stats.max)
+            {
+                stats.max = value;
+            }
+            sum += value;
+            stats.count++;
+        }
+    }
+
+    stats.mean = stats.count > 0 ? sum / (double)stats.count : 0.0;
+    return stats;
+}
+
+/**
+ * Counts the selected rows per distinct value of a field.
+ * @param selection The rows to group.
+ * @param field The field index.
+ * @return (slot value, row count) pairs, most common first.
+ */
+std::vector<std::pair<uint64_t, uint64_t>> FleetStore::groupCount(const Selection& selection, uint32_t field) const
+{
+    std::unordered_map<uint64_t, uint64_t> counts;
+    for (size_t word = 0; word < selection.size(); word++)
+    {
+        uint64_t bits = selection[word];
+        while (bits != 0)
+        {
+            size_t row = word * RowsPerWord + (size_t)__builtin_ctzll(bits);
+            bits &= bits - 1;
+            counts[this->getSlot(field, row)]++;
+        }
+    }
+
+    std::vector<std::pair<uint64_t, uint64_t>> groups(counts.begin(), counts.end());
+    std::sort(groups.begin(), groups.end(), [](const std::pair<uint64_t, uint64_t>& a, const std::pair<uint64_t, uint64_t>& b)
+    {
+        return a.second != b.second ? a.second > b.second : a.first < b.first;
+    });
+
+    return groups;
+}
+
+uint64_t FleetStore::getSlot(uint32_t field, size_t row) const
+{
+    const Column& column = this->columns[field];
+    switch (column.kind)
+    {
+        case CapabilityFields::Kind::U32:
+        case CapabilityFields::Kind::I32:
+        case CapabilityFields::Kind::F32:
+            return column.narrow[row];
+        case CapabilityFields::Kind::U64:
+            return column.wide[row];
+        case CapabilityFields::Kind::Bool:
+            return (column.wide[row / RowsPerWord] >> (row % RowsPerWord)) & 1;
+    }
+
+    return 0;
+}
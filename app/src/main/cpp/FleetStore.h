@@ -0,0 +1,73 @@
+#pragma once
+
+#include "CapabilitySnapshot.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * In-memory columnar store of capability snapshots: one column per <code>CapabilityFields</code> field, so a filter
+ * over a field reads only that field. Numeric columns are scanned with vector compares; boolean columns are bitmaps.
+ * Queries produce a selection bitmap with one bit per row that aggregates then read.
+ */
+class FleetStore
+{
+public:
+    enum class Op
+    {
+        Less,
+        LessEqual,
+        Greater,
+        GreaterEqual,
+        Equal,
+        NotEqual
+    };
+
+    struct Predicate
+    {
+        uint32_t field = 0;
+        Op op = Op::Equal;
+        double value = 0.0;
+    };
+
+    struct Stats
+    {
+        uint64_t count = 0;
+        double min = 0.0;
+        double max = 0.0;
+        double mean = 0.0;
+    };
+
+    typedef std::vector<uint64_t> Selection;
+
+    static bool parsePredicate(const std::string& text, Predicate& predicate);
+    static uint64_t count(const Selection& selection);
+
+    FleetStore();
+    void append(const CapabilitySnapshot::Record* records, size_t count);
+    size_t getRowCount() const;
+
+    Selection selectAll() const;
+    void filter(const Predicate& predicate, Selection& selection) const;
+    Selection filter(const std::vector<Predicate>& predicates) const;
+    Stats aggregate(const Selection& selection, uint32_t field) const;
+    std::vector<std::pair<uint64_t, uint64_t>> groupCount(const Selection& selection, uint32_t field) const;
+
+private:
+    /**
+     * <code>U32</code>, <code>I32</code> and <code>F32</code> columns keep their 32-bit slots in <code>narrow</code>,
+     * <code>U64</code> columns use <code>wide</code>, and <code>Bool</code> columns keep one bit per row in
+     * <code>wide</code>. Every column is padded with zeros to a multiple of 64 rows.
+     */
+    struct Column
+    {
+        CapabilityFields::Kind kind = CapabilityFields::Kind::U32;
+        std::vector<uint32_t> narrow;
+        std::vector<uint64_t> wide;
+    };
+
+    uint64_t getSlot(uint32_t field, size_t row) const;
+
+    std::vector<Column> columns;
+    size_t rowCount = 0;
+};
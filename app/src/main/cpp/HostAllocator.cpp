@@ -0,0 +1,334 @@
+#include "HostAllocator.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+    /**
+     * Bookkeeping stored right before every returned pointer, so frees and reallocations know the size and scope
+     * and tracking mode knows which pointer <code>malloc</code> returned.
+     */
+    struct Header
+    {
+        void* base;
+        size_t size;
+        uint32_t scope;
+    };
+
+    /**
+     * Bytes to reserve so an allocation of <code>size</code> fits at any <code>alignment</code> behind its header.
+     */
+    size_t getPaddedSize(size_t size, size_t alignment)
+    {
+        return sizeof(Header) + alignment - 1 + size;
+    }
+
+    /**
+     * Places the header and the aligned allocation in a block reserved with <code>getPaddedSize</code>.
+     * @return the pointer handed to the driver.
+     */
+    void* place(void* base, size_t size, size_t alignment, uint32_t scope)
+    {
+        uintptr_t first = (uintptr_t)base + sizeof(Header);
+        uintptr_t aligned = (first + alignment - 1) & ~(uintptr_t)(alignment - 1);
+
+        Header header = {base, size, scope};
+        memcpy((void*)(aligned - sizeof(Header)), &header, sizeof(header));
+        return (void*)aligned;
+    }
+
+    Header getHeader(void* memory)
+    {
+        Header header;
+        memcpy(&header, (uint8_t*)memory - sizeof(Header), sizeof(header));
+        return header;
+    }
+
+    void raisePeak(std::atomic<uint64_t>& peak, uint64_t value)
+    {
+        uint64_t previous = peak.load(std::memory_order_relaxed);
+        while (value > previous && !peak.compare_exchange_weak(previous, value, std::memory_order_relaxed))
+        {
+        }
+    }
+}
+
+/**
+ * Constructor for <code>HostAllocator</code> class.
+ * @param mode Whether to allocate with <code>malloc</code> or from an arena.
+ * @param arenaBlockSize The size of each arena block. Larger allocations get a block of their own.
+ */
+HostAllocator::HostAllocator(Mode mode, size_t arenaBlockSize)
+    : mode(mode), arenaBlockSize(arenaBlockSize)
+{
+    this->callbacks.pUserData = this;
+    this->callbacks.pfnAllocation = allocate;
+    this->callbacks.pfnReallocation = reallocate;
+    this->callbacks.pfnFree = free;
+    this->callbacks.pfnInternalAllocation = internalAllocation;
+    this->callbacks.pfnInternalFree = internalFree;
+}
+
+/**
+ * Class destructor. Releases the arena blocks; every object allocated through the callbacks must already be
+ * destroyed.
+ */
+HostAllocator::~HostAllocator()
+{
+    for (void* block : this->arenaBlocks)
+    {
+        std::free(block);
+    }
+}
+
+/**
+ * Gets the callbacks to pass to <code>vkCreate*</code> and the matching <code>vkDestroy*</code>.
+ */
+const VkAllocationCallbacks* HostAllocator::getCallbacks() const
+{
+    return &this->callbacks;
+}
+
+HostAllocator::Mode HostAllocator::getMode() const
+{
+    return this->mode;
+}
+
+/**
+ * Gets the counters over every scope. The peak is the peak of the sum, not the sum of the per-scope peaks.
+ */
+HostAllocator::Totals HostAllocator::getTotals() const
+{
+    return this->readCounters(this->total);
+}
+
+/**
+ * Gets the counters of one allocation scope.
+ */
+HostAllocator::Totals HostAllocator::getTotals(VkSystemAllocationScope scope) const
+{
+    return (uint32_t)scope < ScopeCount ? this->readCounters(this->scopes[scope]) : Totals();
+}
+
+/**
+ * Gets how much memory the arena blocks hold, used or not. Always 0 in tracking mode.
+ */
+size_t HostAllocator::getArenaReservedBytes() const
+{
+    std::lock_guard<std::mutex> lock(this->arenaMutex);
+    return this->arenaReservedBytes;
+}
+
+/**
+ * Starts a new peak measurement at the current live usage, for the host memory cost of a single operation. The
+ * lifetime peaks of <code>getTotals</code> are not affected.
+ */
+void HostAllocator::markPeak()
+{
+    this->peakSinceMark.store(this->total.liveBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+/**
+ * Gets the highest live usage, over every scope, since the last <code>markPeak</code>.
+ */
+uint64_t HostAllocator::getPeakSinceMark() const
+{
+    return this->peakSinceMark.load(std::memory_order_relaxed);
+}
+
+/**
+ * Gets a short name for an allocation scope.
+ */
+const char* HostAllocator::getScopeName(VkSystemAllocationScope scope)
+{
+    switch (scope)
+    {
+        case VK_SYSTEM_ALLOCATION_SCOPE_COMMAND:
+            return "command";
+        case VK_SYSTEM_ALLOCATION_SCOPE_OBJECT:
+            return "object";
+        case VK_SYSTEM_ALLOCATION_SCOPE_CACHE:
+            return "cache";
+        case VK_SYSTEM_ALLOCATION_SCOPE_DEVICE:
+            return "device";
+        case VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE:
+            return "instance";
+        default:
+            return "unknown";
+    }
+}
+
+void* VKAPI_PTR HostAllocator::allocate(void* userData, size_t size, size_t alignment, VkSystemAllocationScope scope)
+{
+    return ((HostAllocator*)userData)->allocateMemory(size, alignment, scope);
+}
+
+/**
+ * <code>PFN_vkReallocationFunction</code>: a null original allocates, a zero size frees, and otherwise the contents
+ * move to a new allocation. Arena memory cannot grow in place, so both modes copy.
+ */
+void* VKAPI_PTR HostAllocator::reallocate(void* userData, void* original, size_t size, size_t alignment, VkSystemAllocationScope scope)
+{
+    HostAllocator* allocator = (HostAllocator*)userData;
+    if (original == nullptr)
+    {
+        return allocator->allocateMemory(size, alignment, scope);
+    }
+
+    if (size == 0)
+    {
+        allocator->freeMemory(original);
+        return nullptr;
+    }
+
+    void* memory = allocator->allocateMemory(size, alignment, scope);
+    if (memory == nullptr)
+    {
+        return nullptr;
+    }
+
+    memcpy(memory, original, std::min(size, getHeader(original).size));
+    allocator->freeMemory(original);
+    return memory;
+}
+
+void VKAPI_PTR HostAllocator::free(void* userData, void* memory)
+{
+    if (memory != nullptr)
+    {
+        ((HostAllocator*)userData)->freeMemory(memory);
+    }
+}
+
+/**
+ * <code>PFN_vkInternalAllocationNotification</code>: memory the driver allocated itself (e.g. executable memory).
+ * Only counted in <code>internalBytes</code>, not in the live and peak figures.
+ */
+void VKAPI_PTR HostAllocator::internalAllocation(void* userData, size_t size, VkInternalAllocationType type, VkSystemAllocationScope scope)
+{
+    (void)type;
+    HostAllocator* allocator = (HostAllocator*)userData;
+    if ((uint32_t)scope < ScopeCount)
+    {
+        allocator->scopes[scope].internalBytes.fetch_add(size, std::memory_order_relaxed);
+    }
+    allocator->total.internalBytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+void VKAPI_PTR HostAllocator::internalFree(void* userData, size_t size, VkInternalAllocationType type, VkSystemAllocationScope scope)
+{
+    (void)type;
+    HostAllocator* allocator = (HostAllocator*)userData;
+    if ((uint32_t)scope < ScopeCount)
+    {
+        allocator->scopes[scope].internalBytes.fetch_sub(size, std::memory_order_relaxed);
+    }
+    allocator->total.internalBytes.fetch_sub(size, std::memory_order_relaxed);
+}
+
+/**
+ * Allocates <code>size</code> bytes at <code>alignment</code>, a power of two as the spec guarantees.
+ * @return the memory, or nullptr if the host is out of memory, which the driver reports as
+ * <code>VK_ERROR_OUT_OF_HOST_MEMORY</code>.
+ */
+void* HostAllocator::allocateMemory(size_t size, size_t alignment, VkSystemAllocationScope scope)
+{
+    if (size == 0)
+    {
+        return nullptr;
+    }
+
+    alignment = std::max<size_t>(alignment, 1);
+    const size_t paddedSize = getPaddedSize(size, alignment);
+    void* base = this->mode == Mode::Arena ? this->allocateFromArena(paddedSize) : std::malloc(paddedSize);
+    if (base == nullptr)
+    {
+        return nullptr;
+    }
+
+    this->countAllocation((uint32_t)scope, size);
+    return place(base, size, alignment, (uint32_t)scope);
+}
+
+/**
+ * Frees an allocation. Arena memory is only counted as freed; its block is released with the allocator.
+ */
+void HostAllocator::freeMemory(void* memory)
+{
+    Header header = getHeader(memory);
+    this->countFree(header.scope, header.size);
+
+    if (this->mode == Mode::Tracking)
+    {
+        std::free(header.base);
+    }
+}
+
+/**
+ * Bump allocates from the current arena block, starting a new block when it is full.
+ */
+void* HostAllocator::allocateFromArena(size_t size)
+{
+    std::lock_guard<std::mutex> lock(this->arenaMutex);
+
+    if (this->arenaCursor == nullptr || (size_t)(this->arenaEnd - this->arenaCursor) < size)
+    {
+        const size_t blockSize = std::max(this->arenaBlockSize, size);
+        uint8_t* block = (uint8_t*)std::malloc(blockSize);
+        if (block == nullptr)
+        {
+            return nullptr;
+        }
+
+        this->arenaBlocks.push_back(block);
+        this->arenaReservedBytes += blockSize;
+        this->arenaCursor = block;
+        this->arenaEnd = block + blockSize;
+    }
+
+    void* memory = this->arenaCursor;
+    this->arenaCursor += size;
+    return memory;
+}
+
+void HostAllocator::countAllocation(uint32_t scope, size_t size)
+{
+    if (scope < ScopeCount)
+    {
+        Counters& counters = this->scopes[scope];
+        counters.allocationCount.fetch_add(1, std::memory_order_relaxed);
+        counters.allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+        raisePeak(counters.peakBytes, counters.liveBytes.fetch_add(size, std::memory_order_relaxed) + size);
+    }
+
+    this->total.allocationCount.fetch_add(1, std::memory_order_relaxed);
+    this->total.allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    const uint64_t live = this->total.liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+    raisePeak(this->total.peakBytes, live);
+    raisePeak(this->peakSinceMark, live);
+}
+
+void HostAllocator::countFree(uint32_t scope, size_t size)
+{
+    if (scope < ScopeCount)
+    {
+        this->scopes[scope].freeCount.fetch_add(1, std::memory_order_relaxed);
+        this->scopes[scope].liveBytes.fetch_sub(size, std::memory_order_relaxed);
+    }
+
+    this->total.freeCount.fetch_add(1, std::memory_order_relaxed);
+    this->total.liveBytes.fetch_sub(size, std::memory_order_relaxed);
+}
+
+HostAllocator::Totals HostAllocator::readCounters(const Counters& counters) const
+{
+    Totals totals;
+    totals.allocationCount = counters.allocationCount.load(std::memory_order_relaxed);
+    totals.freeCount = counters.freeCount.load(std::memory_order_relaxed);
+    totals.allocatedBytes = counters.allocatedBytes.load(std::memory_order_relaxed);
+    totals.liveBytes = counters.liveBytes.load(std::memory_order_relaxed);
+    totals.peakBytes = counters.peakBytes.load(std::memory_order_relaxed);
+    totals.internalBytes = counters.internalBytes.load(std::memory_order_relaxed);
+    return totals;
+}
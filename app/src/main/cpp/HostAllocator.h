@@ -0,0 +1,95 @@
+#pragma once
+
+#include "VulkanLoader.h"
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+/**
+ * <code>VkAllocationCallbacks</code> implementation that accounts for the host memory a driver allocates through
+ * them. In tracking mode allocations go to <code>malloc</code>; in arena mode they are bump allocated from large
+ * blocks that are only released together, for short-lived query sessions that create and destroy objects quickly.
+ * Both modes count allocations, bytes and peak usage per <code>VkSystemAllocationScope</code>.
+ *
+ * Pass the allocator to <code>Instance</code> and <code>LogicalDevice</code>; they keep it alive until their
+ * handle is destroyed.
+ */
+class HostAllocator
+{
+public:
+    enum class Mode
+    {
+        Tracking,
+        Arena
+    };
+
+    /**
+     * Counters of one allocation scope, or of all of them.
+     */
+    struct Totals
+    {
+        uint64_t allocationCount = 0;
+        uint64_t freeCount = 0;
+        uint64_t allocatedBytes = 0;
+        uint64_t liveBytes = 0;
+        uint64_t peakBytes = 0;
+        uint64_t internalBytes = 0;
+    };
+
+    constexpr static uint32_t ScopeCount = VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE + 1;
+
+    explicit HostAllocator(Mode mode = Mode::Tracking, size_t arenaBlockSize = 1 << 20);
+    HostAllocator(const HostAllocator& other) = delete;
+    HostAllocator& operator=(const HostAllocator& other) = delete;
+    ~HostAllocator();
+
+    const VkAllocationCallbacks* getCallbacks() const;
+    Mode getMode() const;
+    Totals getTotals() const;
+    Totals getTotals(VkSystemAllocationScope scope) const;
+    size_t getArenaReservedBytes() const;
+    void markPeak();
+    uint64_t getPeakSinceMark() const;
+
+    static const char* getScopeName(VkSystemAllocationScope scope);
+
+private:
+    /**
+     * Lock-free counters; the driver may allocate from several threads at once.
+     */
+    struct Counters
+    {
+        std::atomic<uint64_t> allocationCount{0};
+        std::atomic<uint64_t> freeCount{0};
+        std::atomic<uint64_t> allocatedBytes{0};
+        std::atomic<uint64_t> liveBytes{0};
+        std::atomic<uint64_t> peakBytes{0};
+        std::atomic<uint64_t> internalBytes{0};
+    };
+
+    static void* VKAPI_PTR allocate(void* userData, size_t size, size_t alignment, VkSystemAllocationScope scope);
+    static void* VKAPI_PTR reallocate(void* userData, void* original, size_t size, size_t alignment, VkSystemAllocationScope scope);
+    static void VKAPI_PTR free(void* userData, void* memory);
+    static void VKAPI_PTR internalAllocation(void* userData, size_t size, VkInternalAllocationType type, VkSystemAllocationScope scope);
+    static void VKAPI_PTR internalFree(void* userData, size_t size, VkInternalAllocationType type, VkSystemAllocationScope scope);
+
+    void* allocateMemory(size_t size, size_t alignment, VkSystemAllocationScope scope);
+    void freeMemory(void* memory);
+    void* allocateFromArena(size_t size);
+    void countAllocation(uint32_t scope, size_t size);
+    void countFree(uint32_t scope, size_t size);
+    Totals readCounters(const Counters& counters) const;
+
+    Mode mode;
+    VkAllocationCallbacks callbacks = {};
+    Counters scopes[ScopeCount];
+    Counters total;
+    std::atomic<uint64_t> peakSinceMark{0};
+
+    mutable std::mutex arenaMutex;
+    std::vector<void*> arenaBlocks;
+    size_t arenaBlockSize;
+    size_t arenaReservedBytes = 0;
+    uint8_t* arenaCursor = nullptr;
+    uint8_t* arenaEnd = nullptr;
+};
@@ -0,0 +1,368 @@
+#include "IcdBatch.h"
+#include "Instance.h"
+#include "InstancePool.h"
+#include "Trace.h"
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <functional>
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace
+{
+    constexpr int PollIntervalMs = 100;
+
+    enum WorkerExitCode
+    {
+        WorkerSucceeded = 0,
+        WorkerNoInstance = 1,
+        WorkerWriteFailed = 2
+    };
+
+    /**
+     * A worker that has been forked and whose pipe is still open.
+     */
+    struct Running
+    {
+        size_t index;
+        pid_t pid;
+        int fd;
+        std::chrono::steady_clock::time_point begin;
+        bool killed;
+        std::vector<char> stream;
+    };
+
+    bool writeAll(int fd, const void* data, size_t size)
+    {
+        const char* bytes = (const char*)data;
+        while (size > 0)
+        {
+            const ssize_t written = write(fd, bytes, size);
+            if (written < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            else if (written <= 0)
+            {
+                return false;
+            }
+
+            bytes += written;
+            size -= (size_t)written;
+        }
+
+        return true;
+    }
+
+    /**
+     * Formats one section into memory with <code>write</code> and sends it, prefixed with its length, down the pipe.
+     * @return false if formatting or writing failed.
+     */
+    bool sendSection(int fd, const std::function<bool(FILE*)>& write)
+    {
+        char* data = nullptr;
+        size_t size = 0;
+        FILE* section = open_memstream(&data, &size);
+        if (section == nullptr)
+        {
+            return false;
+        }
+
+        bool ok = write(section);
+        ok = fclose(section) == 0 && ok;
+
+        const uint32_t length = (uint32_t)size;
+        ok = ok && writeAll(fd, &length, sizeof(length)) && writeAll(fd, data, size);
+        free(data);
+        return ok;
+    }
+
+    /**
+     * Body of a forked worker: profiles every device the loader finds through the one ICD and exits. Each device is
+     * sent as soon as it is done, so the devices before a crash still reach the parent.
+     */
+    [[noreturn]] void runWorker(const std::string& manifestPath, int fd, uint32_t benchmarkRuns)
+    {
+        setenv("VK_ICD_FILENAMES", manifestPath.c_str(), 1);
+        setenv("VK_DRIVER_FILES", manifestPath.c_str(), 1);
+
+        // Drivers and layers print to stdout; keep it out of the parent's report.
+        const int devNull = open("/dev/null", O_WRONLY);
+        if (devNull >= 0)
+        {
+            dup2(devNull, STDOUT_FILENO);
+            close(devNull);
+        }
+
+        int exitCode = WorkerSucceeded;
+        {
+            std::shared_ptr<Instance> instance = InstancePool::acquire("Vulkan Info ICD batch", "No engine", {}, {});
+            if (instance == nullptr)
+            {
+                exitCode = WorkerNoInstance;
+            }
+            else
+            {
+                for (VkPhysicalDevice device : instance->getPhysicalDevices())
+                {
+                    const CapabilitySnapshot::Record record = CapabilitySnapshot::capture(device);
+                    const std::vector<BenchmarkResults::Sample> samples = BenchmarkResults::collect(device, benchmarkRuns);
+
+                    if (!sendSection(fd, [&](FILE* section) { return CapabilitySnapshot::writeStream(section, &record, 1); }) ||
+                        !sendSection(fd, [&](FILE* section) { return BenchmarkResults::writeStream(section, samples.data(), samples.size()); }))
+                    {
+                        exitCode = WorkerWriteFailed;
+                        break;
+                    }
+                }
+            }
+        }
+
+        InstancePool::trim();
+        close(fd);
+
+        // Skip the parent's atexit handlers and static destructors, which belong to the parent.
+        _exit(exitCode);
+    }
+
+    /**
+     * Splits a worker's stream into its length prefixed sections and reads each with the matching format reader.
+     * @param worker (OUT param) Receives the records and samples.
+     * @return false if the stream ends within a section or a section is malformed.
+     */
+    bool parseStream(std::vector<char>& stream, IcdBatch::Worker& worker)
+    {
+        size_t offset = 0;
+        while (offset + sizeof(uint32_t) <= stream.size())
+        {
+            uint32_t size = 0;
+            uint32_t magic = 0;
+            memcpy(&size, stream.data() + offset, sizeof(size));
+            offset += sizeof(size);
+            if (size < sizeof(magic) || size > stream.size() - offset)
+            {
+                return false;
+            }
+
+            memcpy(&magic, stream.data() + offset, sizeof(magic));
+            FILE* section = fmemopen(stream.data() + offset, size, "rb");
+            if (section == nullptr)
+            {
+                return false;
+            }
+
+            bool ok = false;
+            if (magic == CapabilitySnapshot::FileMagic)
+            {
+                ok = CapabilitySnapshot::readStream(section, worker.records);
+            }
+            else if (magic == BenchmarkResults::FileMagic)
+            {
+                ok = BenchmarkResults::readStream(section, worker.samples);
+            }
+            fclose(section);
+
+            if (!ok)
+            {
+                return false;
+            }
+            offset += size;
+        }
+
+        return offset == stream.size();
+    }
+
+    /**
+     * Forks the worker for one manifest.
+     * @param running (OUT param) Receives the worker's pid and the read end of its pipe.
+     * @return false if the pipe or the process could not be created.
+     */
+    bool launch(const std::string& manifestPath, uint32_t benchmarkRuns, Running& running)
+    {
+        int fds[2];
+        if (pipe(fds) != 0)
+        {
+            return false;
+        }
+
+        // Buffered output would otherwise be flushed once by the parent and once more by every worker.
+        fflush(stdout);
+        fflush(stderr);
+
+        const pid_t pid = fork();
+        if (pid < 0)
+        {
+            close(fds[0]);
+            close(fds[1]);
+            return false;
+        }
+        else if (pid == 0)
+        {
+            close(fds[0]);
+            runWorker(manifestPath, fds[1], benchmarkRuns);
+        }
+
+        close(fds[1]);
+        running.pid = pid;
+        running.fd = fds[0];
+        running.begin = std::chrono::steady_clock::now();
+        running.killed = false;
+        return true;
+    }
+
+    /**
+     * Reaps a worker whose pipe reached its end and records how it ended.
+     */
+    void finish(Running& running, IcdBatch::Worker& worker)
+    {
+        close(running.fd);
+
+        int status = 0;
+        while (waitpid(running.pid, &status, 0) < 0 && errno == EINTR)
+        {
+        }
+
+        worker.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - running.begin).count();
+        worker.streamValid = parseStream(running.stream, worker);
+
+        if (running.killed)
+        {
+            worker.status = IcdBatch::Status::TimedOut;
+        }
+        else if (WIFSIGNALED(status))
+        {
+            worker.status = IcdBatch::Status::Crashed;
+            worker.signal = WTERMSIG(status);
+        }
+        else
+        {
+            worker.exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+            worker.status = worker.exitCode == WorkerSucceeded && worker.streamValid ? IcdBatch::Status::Completed : IcdBatch::Status::Failed;
+        }
+    }
+}
+
+namespace IcdBatch
+{
+    /**
+     * Profiles every ICD manifest in its own worker process and collects what the workers send back.
+     * @param manifestPaths The ICD manifest (.json) files.
+     * @param maxWorkers How many workers may run at once, e.g. the number of cores.
+     * @param benchmarkRuns The samples per benchmark and device, see <code>BenchmarkResults::collect</code>.
+     * @param timeoutSeconds After this long a worker is killed and reported as timed out.
+     * @return one entry per manifest, in the order given.
+     */
+    std::vector<Worker> run(const std::vector<std::string>& manifestPaths, uint32_t maxWorkers, uint32_t benchmarkRuns,
+                            double timeoutSeconds)
+    {
+        VKINFO_TRACE_FUNCTION();
+
+        std::vector<Worker> workers(manifestPaths.size());
+        for (size_t i = 0; i < manifestPaths.size(); i++)
+        {
+            workers[i].manifestPath = manifestPaths[i];
+        }
+
+        maxWorkers = maxWorkers > 0 ? maxWorkers : 1;
+        std::vector<Running> running;
+        std::vector<pollfd> fds;
+        std::vector<char> buffer(1 << 16);
+        size_t next = 0;
+
+        while (next < workers.size() || !running.empty())
+        {
+            while (running.size() < maxWorkers && next < workers.size())
+            {
+                Running launched = {};
+                launched.index = next;
+                if (launch(workers[next].manifestPath, benchmarkRuns, launched))
+                {
+                    running.push_back(std::move(launched));
+                }
+                next++;
+            }
+
+            if (running.empty())
+            {
+                continue;
+            }
+
+            fds.resize(running.size());
+            for (size_t i = 0; i < running.size(); i++)
+            {
+                fds[i] = {running[i].fd, POLLIN, 0};
+            }
+
+            if (poll(fds.data(), fds.size(), PollIntervalMs) < 0 && errno != EINTR)
+            {
+                break;
+            }
+
+            const auto now = std::chrono::steady_clock::now();
+            for (size_t i = running.size(); i-- > 0;)
+            {
+                Running& worker = running[i];
+                bool ended = false;
+                if (fds[i].revents != 0)
+                {
+                    const ssize_t read = ::read(worker.fd, buffer.data(), buffer.size());
+                    if (read > 0)
+                    {
+                        worker.stream.insert(worker.stream.end(), buffer.data(), buffer.data() + read);
+                    }
+                    else
+                    {
+                        ended = read == 0 || errno != EINTR;
+                    }
+                }
+
+                // The pipe reaches its end once the killed worker is gone.
+                if (!ended && !worker.killed && std::chrono::duration<double>(now - worker.begin).count() > timeoutSeconds)
+                {
+                    kill(worker.pid, SIGKILL);
+                    worker.killed = true;
+                }
+
+                if (ended)
+                {
+                    finish(worker, workers[worker.index]);
+                    running.erase(running.begin() + i);
+                }
+            }
+        }
+
+        // Only reached early if poll itself failed; do not leave workers behind.
+        for (Running& worker : running)
+        {
+            kill(worker.pid, SIGKILL);
+            worker.killed = true;
+            finish(worker, workers[worker.index]);
+        }
+
+        return workers;
+    }
+
+    const char* getStatusName(Status status)
+    {
+        switch (status)
+        {
+            case Status::NotStarted:
+                return "not started";
+            case Status::Completed:
+                return "completed";
+            case Status::Failed:
+                return "failed";
+            case Status::Crashed:
+                return "crashed";
+            case Status::TimedOut:
+                return "timed out";
+        }
+
+        return "unknown";
+    }
+}
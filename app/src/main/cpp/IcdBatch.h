@@ -0,0 +1,48 @@
+#pragma once
+
+#include "BenchmarkResults.h"
+#include "CapabilitySnapshot.h"
+#include <string>
+#include <vector>
+
+/**
+ * Profiles several Vulkan drivers (ICDs) on one host, one worker process per ICD manifest. Each worker is forked with
+ * VK_ICD_FILENAMES (and VK_DRIVER_FILES, its name in newer loaders) set to just its manifest, so its loader only
+ * sees that driver, and a driver that crashes or hangs only takes down its own worker. A worker captures the
+ * capability snapshot and the regression benchmark samples of every device it sees and streams them back over a
+ * pipe as sections in the snapshot and results file layouts, each prefixed with its 32-bit byte length. At most
+ * <code>maxWorkers</code> workers run at a time.
+ *
+ * POSIX only. Call it before the process creates a Vulkan instance or starts any thread, as forked workers must not
+ * inherit either.
+ */
+namespace IcdBatch
+{
+    enum class Status
+    {
+        NotStarted,
+        Completed,
+        Failed,
+        Crashed,
+        TimedOut
+    };
+
+    /**
+     * What came back from one ICD. Sections the worker sent before it failed or crashed are kept.
+     */
+    struct Worker
+    {
+        std::string manifestPath;
+        Status status = Status::NotStarted;
+        int exitCode = 0;
+        int signal = 0;
+        double seconds = 0.0;
+        bool streamValid = false;
+        std::vector<CapabilitySnapshot::Record> records;
+        std::vector<BenchmarkResults::Sample> samples;
+    };
+
+    std::vector<Worker> run(const std::vector<std::string>& manifestPaths, uint32_t maxWorkers, uint32_t benchmarkRuns,
+                            double timeoutSeconds);
+    const char* getStatusName(Status status);
+}
@@ -1,6 +1,8 @@
 #include "Instance.h"
+#include "EnumerationSnapshot.h"
+#include "Trace.h"
 #include <stdexcept>
-#include <jni.h>
+#include <utility>
 
 /**
  * The default class constructor.
@@ -14,22 +16,42 @@ Instance::Instance()
 }
 
 /**
- * Copy constructor.
+ * Move constructor. Takes ownership of the <code>VkInstance</code>; <code>other</code> is left without one.
  * @param other The other <code>Instance</code>.
  */
-Instance::Instance(const Instance& other)
+Instance::Instance(Instance&& other) noexcept
 {
-    this->appName = other.appName;
-    this->engineName = other.engineName;
+    this->handle = other.handle;
+    this->apiVersion = other.apiVersion;
+    this->appName = std::move(other.appName);
+    this->engineName = std::move(other.engineName);
+    this->allocator = std::move(other.allocator);
+    other.handle = VK_NULL_HANDLE;
+}
 
-    if (other.handle != VK_NULL_HANDLE)
+/**
+ * Move assignment. Destroys the currently owned <code>VkInstance</code> and takes ownership of <code>other</code>'s.
+ * @param other The other <code>Instance</code>.
+ * @return this <code>Instance</code>.
+ */
+Instance& Instance::operator=(Instance&& other) noexcept
+{
+    if (this != &other)
     {
+        if (this->handle != VK_NULL_HANDLE)
+        {
+            VKINFO_TRACE_VK(vkDestroyInstance, (this->handle, this->getAllocationCallbacks()));
+        }
+
         this->handle = other.handle;
+        this->apiVersion = other.apiVersion;
+        this->appName = std::move(other.appName);
+        this->engineName = std::move(other.engineName);
+        this->allocator = std::move(other.allocator);
+        other.handle = VK_NULL_HANDLE;
     }
-    else
-    {
-        this->handle = VK_NULL_HANDLE;
-    }
+
+    return *this;
 }
 
 /**
@@ -38,11 +60,16 @@ Instance::Instance(const Instance& other)
  * @param engineName The engine name to give to the <code>VkInstance</code>.
  * @param extensions The list of extension names to initialize the <code>VkInstance</code> with.
  * @param layers The list of layer names to initialize the <code>VkInstance</code> with.
+ * @param apiVersion The Vulkan API version the application targets.
+ * @param allocator Optional host allocator for the driver's instance level allocations. Kept alive until the
+ * <code>VkInstance</code> is destroyed.
  */
-Instance::Instance(const std::string& appName, const std::string& engineName, const std::vector<const char*>& extensions, const std::vector<const char*>& layers)
+Instance::Instance(const std::string& appName, const std::string& engineName, const std::vector<const char*>& extensions, const std::vector<const char*>& layers, uint32_t apiVersion, std::shared_ptr<HostAllocator> allocator)
 {
     this->appName = appName;
     this->engineName = engineName;
+    this->apiVersion = apiVersion;
+    this->allocator = std::move(allocator);
 
     VkApplicationInfo appInfo = {};
     appInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
@@ -50,7 +77,7 @@ Instance::Instance(const std::string& appName, const std::string& engineName, co
     appInfo.pEngineName = engineName.c_str();
     appInfo.engineVersion = VK_MAKE_API_VERSION(0, 1, 0, 0);
     appInfo.applicationVersion = VK_MAKE_API_VERSION(0, 1, 0, 0);
-    appInfo.apiVersion = VK_API_VERSION_1_0;
+    appInfo.apiVersion = apiVersion;
 
     VkInstanceCreateInfo createInfo = {};
     createInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
@@ -60,12 +87,22 @@ Instance::Instance(const std::string& appName, const std::string& engineName, co
     createInfo.enabledLayerCount = (uint32_t)layers.size();
     createInfo.ppEnabledLayerNames = layers.data();
 
-    if (vkCreateInstance(&createInfo, nullptr, &this->handle) != VK_SUCCESS)
+    if (!VulkanLoader::initialize())
+    {
+        this->appName.clear();
+        this->engineName.clear();
+        return;
+    }
+
+    if (VKINFO_TRACE_VK(vkCreateInstance, (&createInfo, this->getAllocationCallbacks(), &this->handle)) != VK_SUCCESS)
     {
         this->handle = VK_NULL_HANDLE;
         this->appName.clear();
         this->engineName.clear();
+        return;
     }
+
+    VulkanLoader::loadInstance(this->handle);
 }
 
 /**
@@ -77,6 +114,24 @@ VkInstance Instance::getHandle() const
     return this->handle;
 }
 
+/**
+ * Gets the Vulkan API version the instance was created with.
+ * @return the API version.
+ */
+uint32_t Instance::getApiVersion() const
+{
+    return this->apiVersion;
+}
+
+/**
+ * Gets the allocation callbacks the instance was created with.
+ * @return the callbacks, or nullptr if the instance uses the driver's allocator.
+ */
+const VkAllocationCallbacks* Instance::getAllocationCallbacks() const
+{
+    return this->allocator != nullptr ? this->allocator->getCallbacks() : nullptr;
+}
+
 /**
  * Gets the application name.
  * @return the application name.
@@ -103,7 +158,7 @@ Instance::~Instance()
 {
     if (this->handle != VK_NULL_HANDLE)
     {
-        vkDestroyInstance(this->handle, nullptr);
+        VKINFO_TRACE_VK(vkDestroyInstance, (this->handle, this->getAllocationCallbacks()));
         this->handle = VK_NULL_HANDLE;
     }
 }
@@ -120,7 +175,7 @@ uint32_t Instance::getNumberPhysicalDevices() const
     }
 
     uint32_t numDevices = 0;
-    if (vkEnumeratePhysicalDevices(this->handle, &numDevices, nullptr) != VK_SUCCESS)
+    if (VKINFO_TRACE_VK(vkEnumeratePhysicalDevices, (this->handle, &numDevices, nullptr)) != VK_SUCCESS)
     {
         return 0;
     }
@@ -140,13 +195,13 @@ std::vector<VkPhysicalDevice> Instance::getPhysicalDevices() const
     }
 
     uint32_t numDevices = 0;
-    if (vkEnumeratePhysicalDevices(this->handle, &numDevices, nullptr) != VK_SUCCESS)
+    if (VKINFO_TRACE_VK(vkEnumeratePhysicalDevices, (this->handle, &numDevices, nullptr)) != VK_SUCCESS)
     {
         return {};
     }
 
     std::vector<VkPhysicalDevice> devices(numDevices);
-    if (vkEnumeratePhysicalDevices(this->handle, &numDevices, devices.data()) != VK_SUCCESS)
+    if (VKINFO_TRACE_VK(vkEnumeratePhysicalDevices, (this->handle, &numDevices, devices.data())) != VK_SUCCESS)
     {
         return {};
     }
@@ -159,13 +214,7 @@ std::vector<VkPhysicalDevice> Instance::getPhysicalDevices() const
  */
 uint32_t Instance::getNumAvailableExtensions() const
 {
-    uint32_t numExtensions = 0;
-    if (vkEnumerateInstanceExtensionProperties(nullptr, &numExtensions, nullptr) != VK_SUCCESS)
-    {
-        return 0;
-    }
-
-    return numExtensions;
+    return EnumerationSnapshot::get().getInstanceExtensionCount();
 }
 
 /**
@@ -173,15 +222,8 @@ uint32_t Instance::getNumAvailableExtensions() const
  */
 std::vector<VkExtensionProperties> Instance::getAllAvailableExtensions() const
 {
-    uint32_t numExtensions = 0;
-    std::vector<VkExtensionProperties> extensionProperties = {};
-
-    vkEnumerateInstanceExtensionProperties(nullptr, &numExtensions, nullptr);
-
-    extensionProperties.resize(numExtensions);
-    vkEnumerateInstanceExtensionProperties(nullptr, &numExtensions, extensionProperties.data());
-
-    return extensionProperties;
+    const EnumerationSnapshot& snapshot = EnumerationSnapshot::get();
+    return std::vector<VkExtensionProperties>(snapshot.getInstanceExtensions(), snapshot.getInstanceExtensions() + snapshot.getInstanceExtensionCount());
 }
 
 /**
@@ -190,11 +232,13 @@ std::vector<VkExtensionProperties> Instance::getAllAvailableExtensions() const
  */
 VkExtensionProperties Instance::getExtensionProperties(const char *extensionName) const
 {
-    uint32_t numExtensions = 1;
-    VkExtensionProperties extensionProperties = {};
-    vkEnumerateInstanceExtensionProperties(extensionName, &numExtensions, &extensionProperties);
+    const VkExtensionProperties* extensionProperties = EnumerationSnapshot::get().findInstanceExtension(extensionName);
+    if (extensionProperties == nullptr)
+    {
+        return {};
+    }
 
-    return extensionProperties;
+    return *extensionProperties;
 }
 
 /**
@@ -202,13 +246,7 @@ VkExtensionProperties Instance::getExtensionProperties(const char *extensionName
  */
 uint32_t Instance::getNumAvailableLayers() const
 {
-    uint32_t numLayers = 0;
-    if (vkEnumerateInstanceLayerProperties(&numLayers, nullptr) != VK_SUCCESS)
-    {
-        return 0;
-    }
-
-    return numLayers;
+    return EnumerationSnapshot::get().getLayerCount();
 }
 
 /**
@@ -216,13 +254,6 @@ uint32_t Instance::getNumAvailableLayers() const
  */
 std::vector<VkLayerProperties> Instance::getAllAvailableLayers() const
 {
-    uint32_t numLayers = 0;
-    std::vector<VkLayerProperties> layerProperties = {};
-
-    vkEnumerateInstanceLayerProperties(&numLayers, nullptr);
-
-    layerProperties.resize(numLayers);
-    vkEnumerateInstanceLayerProperties(&numLayers, layerProperties.data());
-
-    return layerProperties;
-}
+    const EnumerationSnapshot& snapshot = EnumerationSnapshot::get();
+    return std::vector<VkLayerProperties>(snapshot.getLayers(), snapshot.getLayers() + snapshot.getLayerCount());
+}
\ No newline at end of file
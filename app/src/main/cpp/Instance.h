@@ -1,23 +1,28 @@
 #pragma once
 
-#define VK_USE_PLATFORM_ANDROID_KHR
-#include "vulkan/vulkan.h"
+#include "HostAllocator.h"
+#include "VulkanLoader.h"
 
+#include <memory>
 #include <string>
 #include <vector>
-#include <jni.h>
 
 /**
- * Wrapper class for a <code>VkInstance</code>.
+ * Wrapper class for a <code>VkInstance</code>. Owns the handle, so it can be moved but not copied.
  */
 class Instance
 {
 public:
     Instance();
-    Instance(const Instance& other);
-    Instance(const std::string& appName, const std::string& engineName, const std::vector<const char*>& extensions, const std::vector<const char*>& layers);
+    Instance(const Instance& other) = delete;
+    Instance(Instance&& other) noexcept;
+    Instance(const std::string& appName, const std::string& engineName, const std::vector<const char*>& extensions, const std::vector<const char*>& layers, uint32_t apiVersion = VK_API_VERSION_1_0, std::shared_ptr<HostAllocator> allocator = nullptr);
     ~Instance();
+    Instance& operator=(const Instance& other) = delete;
+    Instance& operator=(Instance&& other) noexcept;
     VkInstance getHandle() const;
+    uint32_t getApiVersion() const;
+    const VkAllocationCallbacks* getAllocationCallbacks() const;
     std::string getAppName() const;
     std::string getEngineName() const;
     uint32_t getNumberPhysicalDevices() const;
@@ -32,6 +37,8 @@ public:
 
 private:
     VkInstance handle = VK_NULL_HANDLE;
+    uint32_t apiVersion = VK_API_VERSION_1_0;
     std::string appName;
     std::string engineName;
+    std::shared_ptr<HostAllocator> allocator;
 };
\ No newline at end of file
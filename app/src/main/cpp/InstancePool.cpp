@@ -0,0 +1,124 @@
+#include "InstancePool.h"
+#include "Trace.h"
+#include <algorithm>
+#include <map>
+#include <mutex>
+
+namespace
+{
+    /**
+     * Pool key. Extension and layer names are sorted and deduplicated, so the order they were requested in does not
+     * matter.
+     */
+    struct PoolKey
+    {
+        uint32_t apiVersion = 0;
+        std::vector<std::string> extensions;
+        std::vector<std::string> layers;
+
+        bool operator<(const PoolKey& other) const
+        {
+            if (this->apiVersion != other.apiVersion)
+            {
+                return this->apiVersion < other.apiVersion;
+            }
+
+            if (this->extensions != other.extensions)
+            {
+                return this->extensions < other.extensions;
+            }
+
+            return this->layers < other.layers;
+        }
+    };
+
+    std::mutex poolMutex;
+    std::map<PoolKey, std::shared_ptr<Instance>> pool;
+
+    /**
+     * Copies <code>names</code> into a sorted list without duplicates.
+     */
+    std::vector<std::string> normalizeNames(const std::vector<const char*>& names)
+    {
+        std::vector<std::string> normalized(names.begin(), names.end());
+        std::sort(normalized.begin(), normalized.end());
+        normalized.erase(std::unique(normalized.begin(), normalized.end()), normalized.end());
+        return normalized;
+    }
+}
+
+namespace InstancePool
+{
+    /**
+     * Gets a live <code>Instance</code> for the given configuration, creating it on the first request.
+     * The application and engine names are not part of the key: a pooled instance keeps the names it was created with.
+     * @param appName The application name to create the <code>VkInstance</code> with.
+     * @param engineName The engine name to create the <code>VkInstance</code> with.
+     * @param extensions The extension names to enable.
+     * @param layers The layer names to enable.
+     * @param apiVersion The Vulkan API version the application targets.
+     * @return the shared instance, or nullptr if <code>vkCreateInstance</code> failed. Failures are not pooled.
+     */
+    std::shared_ptr<Instance> acquire(const std::string& appName, const std::string& engineName, const std::vector<const char*>& extensions, const std::vector<const char*>& layers, uint32_t apiVersion)
+    {
+        VKINFO_TRACE_FUNCTION();
+
+        PoolKey key = {};
+        key.apiVersion = apiVersion;
+        key.extensions = normalizeNames(extensions);
+        key.layers = normalizeNames(layers);
+
+        // Held across creation so two threads asking for the same configuration do not both pay for vkCreateInstance.
+        std::lock_guard<std::mutex> lock(poolMutex);
+
+        auto found = pool.find(key);
+        if (found != pool.end())
+        {
+            return found->second;
+        }
+
+        std::shared_ptr<Instance> instance = std::make_shared<Instance>(appName, engineName, extensions, layers, apiVersion);
+        if (instance->getHandle() == VK_NULL_HANDLE)
+        {
+            return nullptr;
+        }
+
+        pool.emplace(std::move(key), instance);
+        return instance;
+    }
+
+    /**
+     * Destroys the pooled instances nobody outside the pool holds a reference to.
+     * @return the number of instances destroyed.
+     */
+    size_t trim()
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+
+        size_t destroyed = 0;
+        for (auto it = pool.begin(); it != pool.end();)
+        {
+            if (it->second.use_count() == 1)
+            {
+                it = pool.erase(it);
+                destroyed++;
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        return destroyed;
+    }
+
+    /**
+     * Gets the number of live pooled instances.
+     * @return the pool size.
+     */
+    size_t size()
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        return pool.size();
+    }
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "Instance.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * Process-wide pool of live <code>Instance</code>s keyed by (apiVersion, enabled extensions, enabled layers).
+ * Repeated queries, benchmarks and JNI calls asking for the same configuration share one <code>VkInstance</code>.
+ */
+namespace InstancePool
+{
+    std::shared_ptr<Instance> acquire(const std::string& appName, const std::string& engineName, const std::vector<const char*>& extensions, const std::vector<const char*>& layers, uint32_t apiVersion = VK_API_VERSION_1_0);
+    size_t trim();
+    size_t size();
+}
@@ -1,34 +1,20 @@
 #include "Instance.h"
+#include "InstancePool.h"
+#include "MemoryBudgetSampler.h"
 #include "PhysicalDevice.h"
-#include "VkInfo.h"
+#include "RowFormatter.h"
+#include "RowSearchIndex.h"
+#include "ThrottlingDetector.h"
+#include "Trace.h"
 #include <jni.h>
+#include <algorithm>
+#include <mutex>
 #include <string>
-#include <sstream>
 
 namespace JavaClasses
 {
-    const char* const JavaStringClassName = "java/lang/String";
-    const char* const VkInfoClassName = "com/example/vulkaninfoapp/VkInfo";
-    const char* const InstanceInfoClassName = "com/example/vulkaninfoapp/InstanceInfo";
-    const char* const PhysicalDevicePropertiesClassName = "com/example/vulkaninfoapp/PhysicalDeviceProperties";
-    const char* const PhysicalDeviceLimitsClassName = "com/example/vulkaninfoapp/PhysicalDeviceLimits";
-    const char* const PhysicalDeviceSparsePropertiesClassName = "com/example/vulkaninfoapp/PhysicalDeviceSparseProperties";
-    const char* const PhysicalDeviceFeaturesClassName = "com/example/vulkaninfoapp/PhysicalDeviceFeatures";
-    const char* const PhysicalDeviceMemoryPropertiesClassName = "com/example/vulkaninfoapp/PhysicalDeviceMemoryProperties";
-    const char* const MemoryTypeClassName = "com/example/vulkaninfoapp/MemoryType";
-    const char* const MemoryHeapClassName = "com/example/vulkaninfoapp/MemoryHeap";
-    const char* const ExtensionPropertiesClassName = "com/example/vulkaninfoapp/ExtensionProperties";
-
-    const char* const JavaStringClassSignature = "Ljava/lang/String;";
-    const char* const InstanceInfoClassSignature = "Lcom/example/vulkaninfoapp/InstanceInfo;";
-    const char* const PhysicalDevicePropertiesClassSignature = "Lcom/example/vulkaninfoapp/PhysicalDeviceProperties;";
-    const char* const PhysicalDeviceLimitsClassSignature = "Lcom/example/vulkaninfoapp/PhysicalDeviceLimits;";
-    const char* const PhysicalDeviceSparsePropertiesClassSignature = "Lcom/example/vulkaninfoapp/PhysicalDeviceSparseProperties;";
-    const char* const PhysicalDeviceFeaturesClassSignature = "Lcom/example/vulkaninfoapp/PhysicalDeviceFeatures;";
-    const char* const PhysicalDeviceMemoryPropertiesClassSignature = "Lcom/example/vulkaninfoapp/PhysicalDeviceMemoryProperties;";
-    const char* const MemoryTypeClassSignature = "Lcom/example/vulkaninfoapp/MemoryType;";
-    const char* const MemoryHeapClassSignature = "Lcom/example/vulkaninfoapp/MemoryHeap;";
-    const char* const ExtensionPropertiesClassSignature = "Lcom/example/vulkaninfoapp/ExtensionProperties;";
+    const char* const ThrottlingResultClassName = "com/example/vulkaninfoapp/ThrottlingResult";
+    const char* const FormattedRowsClassName = "com/example/vulkaninfoapp/FormattedRows";
 }
 
 /**
@@ -57,32 +43,16 @@ const char* MemoryHeapFlagDescriptions[] =
         };
 
 /**
- * Parse the apiVersion as a string in the format of Variant.Major.Minor.Patch.
- * @param apiVersion The apiVersion from <code>VkPhysicalDeviceProperties</code>.
- * @return the apiVersion as a string in the format of Variant.Major.Minor.Patch.
+ * Text descriptions of the <code>VkPhysicalDeviceType</code> enum.
  */
-std::string getApiVersionAsString(const uint32_t apiVersion)
-{
-    std::ostringstream ss;
-    ss << VK_API_VERSION_VARIANT(apiVersion) << ".";
-    ss << VK_API_VERSION_MAJOR(apiVersion) << ".";
-    ss << VK_API_VERSION_MINOR(apiVersion) << ".";
-    ss << VK_API_VERSION_PATCH(apiVersion);
-
-    return ss.str();
-}
-
-/**
- * Parses a value into hexadecimal form and formats it as a string prefixed with 0x.
- * @param value The value to be converted.
- * @return the hex value formatted as a string and prefixed with 0x.
- */
-std::string asHexString(const uint32_t value)
-{
-    std::ostringstream ss;
-    ss << "0x" << std::hex << value;
-    return ss.str();
-}
+const char* PhysicalDeviceTypeDescriptions[] =
+        {
+        "Other",
+        "Integrated",
+        "Discrete",
+        "Virtual",
+        "CPU"
+        };
 
 /**
  * Creates a vector of strings enumerating the <code>VkMemoryPropertyFlags</code>.
@@ -185,793 +155,545 @@ jobject getObject(JNIEnv *env, const char* className, const char* constructorSig
 }
 
 /**
- * Populates the fields of the <code>InstanceInfo</code> Java object.
- * @param env The JNI environment.
- * @param instance The <code>VkInstance</code> that contains the Vulkan instance data.
- * @param instanceInfoObject (OUT param) The <code>InstanceInfo</code> Java object to populate.
+ * Renders the "Instance Info" rows.
+ * @param instance The <code>Instance</code> that was queried.
+ * @param formatter (OUT param) The <code>RowFormatter</code> to render into.
  */
-void populateInstanceInfoObject(JNIEnv *env, const Instance* instance, jobject instanceInfoObject)
+void formatInstanceInfoRows(const Instance* instance, RowFormatter& formatter)
 {
-    jclass instanceInfoClass = env->FindClass(JavaClasses::InstanceInfoClassName);
-
-    jfieldID fieldId = env->GetFieldID(instanceInfoClass, "appName", JavaClasses::JavaStringClassSignature);
-    jstring appName = env->NewStringUTF(instance->getAppName().c_str());
-    env->SetObjectField(instanceInfoObject, fieldId, appName);
+    formatter.beginGroup("Instance Info");
+    formatter.addText("Application name", instance->getAppName().c_str());
+    formatter.addText("Engine name", instance->getEngineName().c_str());
+    formatter.addUnsigned("Number of devices", instance->getNumberPhysicalDevices());
+}
 
-    fieldId = env->GetFieldID(instanceInfoClass, "engineName", JavaClasses::JavaStringClassSignature);
-    jstring engineNameFromInstance = env->NewStringUTF(instance->getEngineName().c_str());
-    env->SetObjectField(instanceInfoObject, fieldId, engineNameFromInstance);
+/**
+ * Renders the "Physical Device Properties" rows.
+ * @param properties The <code>VkPhysicalDeviceProperties</code> of the selected device.
+ * @param formatter (OUT param) The <code>RowFormatter</code> to render into.
+ */
+void formatPhysicalDevicePropertyRows(const VkPhysicalDeviceProperties& properties, RowFormatter& formatter)
+{
+    formatter.beginGroup("Physical Device Properties");
+    formatter.addApiVersion("API Version", properties.apiVersion);
+    formatter.addHex("Driver Version", properties.driverVersion);
+    formatter.addHex("Vendor ID", properties.vendorID);
+    formatter.addHex("Device ID", properties.deviceID);
+    formatter.addText("Device Type", (uint32_t)properties.deviceType <= VK_PHYSICAL_DEVICE_TYPE_CPU ? PhysicalDeviceTypeDescriptions[properties.deviceType] : "Unknown");
+    formatter.addText("Device Name", properties.deviceName);
+}
 
-    uint32_t numExtensions = instance->getNumAvailableExtensions();
-    fieldId = env->GetFieldID(instanceInfoClass, "numExtensions", "J");
-    env->SetLongField(instanceInfoObject, fieldId, (jlong)numExtensions);
+/**
+ * Renders the "Physical Device Limits" rows.
+ * @param limits The <code>VkPhysicalDeviceLimits</code> of the selected device.
+ * @param formatter (OUT param) The <code>RowFormatter</code> to render into.
+ */
+void formatPhysicalDeviceLimitRows(const VkPhysicalDeviceLimits& limits, RowFormatter& formatter)
+{
+    formatter.beginGroup("Physical Device Limits");
+    formatter.addUnsigned("Max image dimension 1D", limits.maxImageDimension1D);
+    formatter.addUnsigned("Max image dimension 2D", limits.maxImageDimension2D);
+    formatter.addUnsigned("Max image dimension 3D", limits.maxImageDimension3D);
+    formatter.addUnsigned("Max image dimension cube", limits.maxImageDimensionCube);
+    formatter.addUnsigned("Max image array layers", limits.maxImageArrayLayers);
+    formatter.addUnsigned("Max texel buffer elements", limits.maxTexelBufferElements);
+    formatter.addUnsigned("Max uniform buffer range", limits.maxUniformBufferRange, "bytes");
+    formatter.addUnsigned("Max storage buffer range", limits.maxStorageBufferRange, "bytes");
+    formatter.addUnsigned("Max push constants size", limits.maxPushConstantsSize, "bytes");
+    formatter.addUnsigned("Max memory allocation count", limits.maxMemoryAllocationCount);
+    formatter.addUnsigned("Max sampler allocation count", limits.maxSamplerAllocationCount);
+    formatter.addUnsigned("Buffer image granularity", limits.bufferImageGranularity, "bytes");
+    formatter.addUnsigned("Sparse address space size", limits.sparseAddressSpaceSize, "bytes");
+    formatter.addUnsigned("Max bound descriptor sets", limits.maxBoundDescriptorSets);
+    formatter.addUnsigned("Max per stage descriptor samplers", limits.maxPerStageDescriptorSamplers);
+    formatter.addUnsigned("Max per stage descriptor uniform buffers", limits.maxPerStageDescriptorUniformBuffers);
+    formatter.addUnsigned("Max per stage descriptor storage buffers", limits.maxPerStageDescriptorStorageBuffers);
+    formatter.addUnsigned("Max per stage descriptor sampled images", limits.maxPerStageDescriptorSampledImages);
+    formatter.addUnsigned("Max per stage descriptor storage images", limits.maxPerStageDescriptorStorageImages);
+    formatter.addUnsigned("Max per stage descriptor input attachments", limits.maxPerStageDescriptorInputAttachments);
+    formatter.addUnsigned("Max per stage resources", limits.maxPerStageResources);
+    formatter.addUnsigned("Max descriptor set samplers", limits.maxDescriptorSetSamplers);
+    formatter.addUnsigned("Max descriptor set uniform buffers", limits.maxDescriptorSetUniformBuffers);
+    formatter.addUnsigned("Max descriptor set uniform buffers dynamic", limits.maxDescriptorSetUniformBuffersDynamic);
+    formatter.addUnsigned("Max descriptor set storage buffers", limits.maxDescriptorSetStorageBuffers);
+    formatter.addUnsigned("Max descriptor set storage buffers dynamic", limits.maxDescriptorSetStorageBuffersDynamic);
+    formatter.addUnsigned("Max descriptor set sampled images", limits.maxDescriptorSetSampledImages);
+    formatter.addUnsigned("Max descriptor set storage images", limits.maxDescriptorSetStorageImages);
+    formatter.addUnsigned("Max descriptor set input attachments", limits.maxDescriptorSetInputAttachments);
+    formatter.addUnsigned("Max vertex input attributes", limits.maxVertexInputAttributes);
+    formatter.addUnsigned("Max vertex input bindings", limits.maxVertexInputBindings);
+    formatter.addUnsigned("Max vertex input attribute offset", limits.maxVertexInputAttributeOffset);
+    formatter.addUnsigned("Max vertex input binding stride", limits.maxVertexInputBindingStride);
+    formatter.addUnsigned("Max vertex output components", limits.maxVertexOutputComponents);
+    formatter.addUnsigned("Max tessellation generation level", limits.maxTessellationGenerationLevel);
+    formatter.addUnsigned("Max tessellation patch size", limits.maxTessellationPatchSize);
+    formatter.addUnsigned("Max tessellation control per vertex input components", limits.maxTessellationControlPerVertexInputComponents);
+    formatter.addUnsigned("Max tessellation control per vertex output components", limits.maxTessellationControlPerVertexOutputComponents);
+    formatter.addUnsigned("Max tessellation control per patch output components", limits.maxTessellationControlPerPatchOutputComponents);
+    formatter.addUnsigned("Max tessellation control total output components", limits.maxTessellationControlTotalOutputComponents);
+    formatter.addUnsigned("Max tessellation evaluation input components", limits.maxTessellationEvaluationInputComponents);
+    formatter.addUnsigned("Max tessellation evaluation output components", limits.maxTessellationEvaluationOutputComponents);
+    formatter.addUnsigned("Max geometry shader invocation", limits.maxGeometryShaderInvocations);
+    formatter.addUnsigned("Max geometry input components", limits.maxGeometryInputComponents);
+    formatter.addUnsigned("Max geometry output components", limits.maxGeometryOutputComponents);
+    formatter.addUnsigned("Max geometry output vertices", limits.maxGeometryOutputVertices);
+    formatter.addUnsigned("Max geometry total output components", limits.maxGeometryTotalOutputComponents);
+    formatter.addUnsigned("Max fragment input components", limits.maxFragmentInputComponents);
+    formatter.addUnsigned("Max fragment output attachments", limits.maxFragmentOutputAttachments);
+    formatter.addUnsigned("Max fragment dual src attachments", limits.maxFragmentDualSrcAttachments);
+    formatter.addUnsigned("Max fragment combined output resources", limits.maxFragmentCombinedOutputResources);
+    formatter.addUnsigned("Max compute shared memory size", limits.maxComputeSharedMemorySize, "bytes");
+    formatter.addList("Max compute work group count", limits.maxComputeWorkGroupCount, 3);
+    formatter.addUnsigned("Max compute work group invocations", limits.maxComputeWorkGroupInvocations);
+    formatter.addList("Max compute work group size", limits.maxComputeWorkGroupSize, 3);
+    formatter.addUnsigned("Sub pixel precision bits", limits.subPixelPrecisionBits);
+    formatter.addUnsigned("Sub texel precision bits", limits.subTexelPrecisionBits);
+    formatter.addUnsigned("Mip map precision bits", limits.mipmapPrecisionBits);
+    formatter.addUnsigned("Max draw indexed index value", limits.maxDrawIndexedIndexValue);
+    formatter.addUnsigned("Max draw indirect count", limits.maxDrawIndirectCount);
+    formatter.addFloat("Max sampler LOD bias", limits.maxSamplerLodBias);
+    formatter.addFloat("Max sampler anisotropy", limits.maxSamplerAnisotropy);
+    formatter.addUnsigned("Max viewports", limits.maxViewports);
+    formatter.addList("Max viewport dimensions", limits.maxViewportDimensions, 2);
+    formatter.addList("Viewport bounds range", limits.viewportBoundsRange, 2);
+    formatter.addUnsigned("Viewport sub pixel bits", limits.viewportSubPixelBits);
+    formatter.addUnsigned("Min memory map alignment", limits.minMemoryMapAlignment, "bytes");
+    formatter.addUnsigned("Min texel buffer offset alignment", limits.minTexelBufferOffsetAlignment, "bytes");
+    formatter.addUnsigned("Min uniform buffer offset alignment", limits.minUniformBufferOffsetAlignment, "bytes");
+    formatter.addUnsigned("Min storage buffer offset alignment", limits.minStorageBufferOffsetAlignment, "bytes");
+    formatter.addSigned("Min texel offset", limits.minTexelOffset);
+    formatter.addUnsigned("Max texel offset", limits.maxTexelOffset);
+    formatter.addSigned("Min texel gather offset", limits.minTexelGatherOffset);
+    formatter.addUnsigned("Max texel gather offset", limits.maxTexelGatherOffset);
+    formatter.addFloat("Min interpolation offset", limits.minInterpolationOffset);
+    formatter.addFloat("Max interpolation offset", limits.maxInterpolationOffset);
+    formatter.addUnsigned("Sub pixel interpolation offset bits", limits.subPixelInterpolationOffsetBits);
+    formatter.addUnsigned("Max frame buffer width", limits.maxFramebufferWidth);
+    formatter.addUnsigned("Max frame buffer height", limits.maxFramebufferHeight);
+    formatter.addUnsigned("Max frame buffer layers", limits.maxFramebufferLayers);
+    formatter.addUnsigned("Frame buffer color sample counts", limits.framebufferColorSampleCounts);
+    formatter.addUnsigned("Frame buffer depth sample counts", limits.framebufferDepthSampleCounts);
+    formatter.addUnsigned("Frame buffer stencil sample counts", limits.framebufferStencilSampleCounts);
+    formatter.addUnsigned("Frame buffer no attachments sample counts", limits.framebufferNoAttachmentsSampleCounts);
+    formatter.addUnsigned("Max color attachments", limits.maxColorAttachments);
+    formatter.addUnsigned("Sampled image color sample counts", limits.sampledImageColorSampleCounts);
+    formatter.addUnsigned("Sampled image integer sample counts", limits.sampledImageIntegerSampleCounts);
+    formatter.addUnsigned("Sampled image depth sample counts", limits.sampledImageDepthSampleCounts);
+    formatter.addUnsigned("Sampled image stencil sample counts", limits.sampledImageStencilSampleCounts);
+    formatter.addUnsigned("Storage image sample counts", limits.storageImageSampleCounts);
+    formatter.addUnsigned("Max sample mask words", limits.maxSampleMaskWords);
+    formatter.addBool("Timestamp compute and graphics", limits.timestampComputeAndGraphics);
+    formatter.addFloat("Timestamp period", limits.timestampPeriod, "ns");
+    formatter.addUnsigned("Max clip distances", limits.maxClipDistances);
+    formatter.addUnsigned("Max cull distances", limits.maxCullDistances);
+    formatter.addUnsigned("Max combined clip and cull distances", limits.maxCombinedClipAndCullDistances);
+    formatter.addUnsigned("Discrete queue priorities", limits.discreteQueuePriorities);
+    formatter.addList("Point size range", limits.pointSizeRange, 2);
+    formatter.addList("Line width range", limits.lineWidthRange, 2);
+    formatter.addFloat("Point size granularity", limits.pointSizeGranularity);
+    formatter.addFloat("Line width granularity", limits.lineWidthGranularity);
+    formatter.addBool("Strict lines", limits.strictLines);
+    formatter.addBool("Standard sample locations", limits.standardSampleLocations);
+    formatter.addUnsigned("Optimal buffer copy offset alignment", limits.optimalBufferCopyOffsetAlignment, "bytes");
+    formatter.addUnsigned("Optimal buffer copy row pitch alignment", limits.optimalBufferCopyRowPitchAlignment, "bytes");
+    formatter.addUnsigned("Non-coherent atom size", limits.nonCoherentAtomSize, "bytes");
+}
 
-    jclass extensionPropertyClass = env->FindClass(JavaClasses::ExtensionPropertiesClassName);
-    jobjectArray extensionObjArray = env->NewObjectArray(numExtensions, extensionPropertyClass, nullptr);
-    std::vector<VkExtensionProperties> properties = instance->getAllAvailableExtensions();
-    for (size_t i = 0; i < properties.size(); i++)
-    {
-        jobject extensionObj = getObject(env, JavaClasses::ExtensionPropertiesClassName);
+/**
+ * Renders the "Physical Device Sparse Properties" rows.
+ * @param properties The <code>VkPhysicalDeviceSparseProperties</code> of the selected device.
+ * @param formatter (OUT param) The <code>RowFormatter</code> to render into.
+ */
+void formatPhysicalDeviceSparsePropertyRows(const VkPhysicalDeviceSparseProperties& properties, RowFormatter& formatter)
+{
+    formatter.beginGroup("Physical Device Sparse Properties");
+    formatter.addBool("Residency standard 2D block shape", properties.residencyStandard2DBlockShape);
+    formatter.addBool("Residency standard 2D multi-sample block shape", properties.residencyStandard2DMultisampleBlockShape);
+    formatter.addBool("Residency standard 3D block shape", properties.residencyStandard3DBlockShape);
+    formatter.addBool("Residency aligned mip size", properties.residencyAlignedMipSize);
+    formatter.addBool("Residency non-resident strict", properties.residencyNonResidentStrict);
+}
 
-        fieldId = env->GetFieldID(extensionPropertyClass, "name", JavaClasses::JavaStringClassSignature);
-        jstring outJString = env->NewStringUTF(properties[i].extensionName);
-        env->SetObjectField(extensionObj, fieldId, outJString);
+/**
+ * Renders the "Physical Device Features" rows.
+ * @param features The <code>VkPhysicalDeviceFeatures</code> of the selected device.
+ * @param formatter (OUT param) The <code>RowFormatter</code> to render into.
+ */
+void formatPhysicalDeviceFeatureRows(const VkPhysicalDeviceFeatures& features, RowFormatter& formatter)
+{
+    formatter.beginGroup("Physical Device Features");
+    formatter.addBool("Robust buffer access", features.robustBufferAccess);
+    formatter.addBool("Full draw index uint 32", features.fullDrawIndexUint32);
+    formatter.addBool("Image cube array", features.imageCubeArray);
+    formatter.addBool("Independent blend", features.independentBlend);
+    formatter.addBool("Geometry shader", features.geometryShader);
+    formatter.addBool("Tessellation shader", features.tessellationShader);
+    formatter.addBool("Sample rate shading", features.sampleRateShading);
+    formatter.addBool("Dual src blend", features.dualSrcBlend);
+    formatter.addBool("Logic op", features.logicOp);
+    formatter.addBool("Multi draw indirect", features.multiDrawIndirect);
+    formatter.addBool("Draw indirect first instance", features.drawIndirectFirstInstance);
+    formatter.addBool("Depth clamp", features.depthClamp);
+    formatter.addBool("Depth bias clamp", features.depthBiasClamp);
+    formatter.addBool("Fill mode non-solid", features.fillModeNonSolid);
+    formatter.addBool("Depth bounds", features.depthBounds);
+    formatter.addBool("Wide lines", features.wideLines);
+    formatter.addBool("Large points", features.largePoints);
+    formatter.addBool("Alpha to one", features.alphaToOne);
+    formatter.addBool("Multi-viewport", features.multiViewport);
+    formatter.addBool("Sampler anisotropy", features.samplerAnisotropy);
+    formatter.addBool("Texture compression ETC2", features.textureCompressionETC2);
+    formatter.addBool("Texture compression ASTC-LDR", features.textureCompressionASTC_LDR);
+    formatter.addBool("Texture compression BC", features.textureCompressionBC);
+    formatter.addBool("Occlusion query precise", features.occlusionQueryPrecise);
+    formatter.addBool("Pipeline statistics query", features.pipelineStatisticsQuery);
+    formatter.addBool("Vertex pipeline stores & atomics", features.vertexPipelineStoresAndAtomics);
+    formatter.addBool("Fragment stores & atomics", features.fragmentStoresAndAtomics);
+    formatter.addBool("Shader tessellation & geometry point size", features.shaderTessellationAndGeometryPointSize);
+    formatter.addBool("Shader image gather extended", features.shaderImageGatherExtended);
+    formatter.addBool("Shader storage image extended formats", features.shaderStorageImageExtendedFormats);
+    formatter.addBool("Shader storage image multi-sample", features.shaderStorageImageMultisample);
+    formatter.addBool("Shader storage image read without format", features.shaderStorageImageReadWithoutFormat);
+    formatter.addBool("Shader storage image write without format", features.shaderStorageImageWriteWithoutFormat);
+    formatter.addBool("Shader uniform buffer array dynamic indexing", features.shaderUniformBufferArrayDynamicIndexing);
+    formatter.addBool("Shader sampled image array dynamic indexing", features.shaderSampledImageArrayDynamicIndexing);
+    formatter.addBool("Shader storage buffer array dynamic indexing", features.shaderStorageBufferArrayDynamicIndexing);
+    formatter.addBool("Shader storage image array dynamic indexing", features.shaderStorageImageArrayDynamicIndexing);
+    formatter.addBool("Shader clip distance", features.shaderClipDistance);
+    formatter.addBool("Shader cull distance", features.shaderCullDistance);
+    formatter.addBool("Shader float 64", features.shaderFloat64);
+    formatter.addBool("Shader int 64", features.shaderInt64);
+    formatter.addBool("Shader int 16", features.shaderInt16);
+    formatter.addBool("Shader resource residency", features.shaderResourceResidency);
+    formatter.addBool("Shader resource min lod", features.shaderResourceMinLod);
+    formatter.addBool("Sparse binding", features.sparseBinding);
+    formatter.addBool("Sparse residency buffer", features.sparseResidencyBuffer);
+    formatter.addBool("Sparse residency image 2D", features.sparseResidencyImage2D);
+    formatter.addBool("Sparse residency image 3D", features.sparseResidencyImage3D);
+    formatter.addBool("Sparse residency 2 samples", features.sparseResidency2Samples);
+    formatter.addBool("Sparse residency 4 samples", features.sparseResidency4Samples);
+    formatter.addBool("Sparse residency 8 samples", features.sparseResidency8Samples);
+    formatter.addBool("Sparse residency 16 samples", features.sparseResidency16Samples);
+    formatter.addBool("Sparse residency aliased", features.sparseResidencyAliased);
+    formatter.addBool("Variable multi-sample rate", features.variableMultisampleRate);
+    formatter.addBool("Inherited queries", features.inheritedQueries);
+}
 
-        fieldId = env->GetFieldID(extensionPropertyClass, "specVersion", "J");
-        env->SetLongField(extensionObj, fieldId, (jlong)properties[i].specVersion);
+/**
+ * Renders the "Physical Device Memory Properties", "Physical Device Memory Types" and "Physical Device Memory Heaps"
+ * rows. Type and heap values list one flag per line.
+ * @param properties The <code>VkPhysicalDeviceMemoryProperties</code> of the selected device.
+ * @param formatter (OUT param) The <code>RowFormatter</code> to render into.
+ */
+void formatPhysicalDeviceMemoryRows(const VkPhysicalDeviceMemoryProperties& properties, RowFormatter& formatter)
+{
+    formatter.beginGroup("Physical Device Memory Properties");
+    formatter.addUnsigned("Memory type count", properties.memoryTypeCount);
+    formatter.addUnsigned("Memory heap count", properties.memoryHeapCount);
 
-        env->SetObjectArrayElement(extensionObjArray, i, extensionObj);
+    formatter.beginGroup("Physical Device Memory Types");
+    for (uint32_t i = 0; i < properties.memoryTypeCount; i++)
+    {
+        formatter.beginRow(RowFormatter::Multiline);
+        formatter.append("Heap index: ");
+        formatter.appendUnsigned(properties.memoryTypes[i].heapIndex);
+        formatter.beginValue();
+        for (const char* flag : parseMemTypePropertyFlags(properties.memoryTypes[i].propertyFlags))
+        {
+            formatter.append(flag);
+            formatter.append("\n", 1);
+        }
+        formatter.endRow();
     }
 
-    std::string arraySig = "[" + std::string(JavaClasses::ExtensionPropertiesClassSignature);
-    fieldId = env->GetFieldID(instanceInfoClass, "availableExtensions", arraySig.c_str());
-    env->SetObjectField(instanceInfoObject, fieldId, extensionObjArray);
-
-    fieldId = env->GetFieldID(instanceInfoClass, "numDevices", "J");
-    env->SetLongField(instanceInfoObject, fieldId, (jlong)instance->getNumberPhysicalDevices());
+    formatter.beginGroup("Physical Device Memory Heaps");
+    for (uint32_t i = 0; i < properties.memoryHeapCount; i++)
+    {
+        formatter.beginRow(RowFormatter::Multiline);
+        formatter.append("Size: ");
+        formatter.appendUnsigned(properties.memoryHeaps[i].size);
+        formatter.beginValue();
+        for (const char* flag : parseMemHeapFlags(properties.memoryHeaps[i].flags))
+        {
+            formatter.append(flag);
+            formatter.append("\n", 1);
+        }
+        formatter.endRow();
+    }
 }
 
 /**
- * Populates the fields of the <code>PhysicalDeviceProperties</code> Java object.
- * @param env The JNI environment.
- * @param properties The <code>VkPhysicalDeviceProperties</code> that contains the Vulkan device properties.
- * @param obj (OUT param) The <code>PhysicalDeviceProperties</code> Java object to populate.
+ * Renders every display row of the first physical device natively. Java gets the UTF-8 text of all rows in one byte
+ * array and the <code>RowFormatter::Row</code> and <code>RowFormatter::Group</code> offsets in two int arrays, so
+ * no Java string is built per field.
+ * @return a <code>FormattedRows</code>, or null if no instance or physical device is available.
  */
-void populatePhysicalDevicePropertiesObject(JNIEnv *env, const VkPhysicalDeviceProperties properties, jobject obj)
+extern "C"
+JNIEXPORT jobject JNICALL
+Java_com_example_vulkaninfoapp_MainActivity_getVkInfoRows(JNIEnv *env, jclass clazz,
+                                                          jstring app_name, jstring engine_name)
 {
-    jclass propertiesClazz = env->FindClass(JavaClasses::PhysicalDevicePropertiesClassName);
+    VKINFO_TRACE_SCOPE("getVkInfoRows");
 
-    jfieldID fidNumber = env->GetFieldID(propertiesClazz, "apiVersion", JavaClasses::JavaStringClassSignature);
-    jstring apiVersion = env->NewStringUTF(getApiVersionAsString(properties.apiVersion).c_str());
-    env->SetObjectField(obj, fidNumber, apiVersion);
+    const char* appName = env->GetStringUTFChars(app_name, nullptr);
+    const char* engineName = env->GetStringUTFChars(engine_name, nullptr);
 
-    fidNumber = env->GetFieldID(propertiesClazz, "driverVersion", JavaClasses::JavaStringClassSignature);
-    jstring driverVersion = env->NewStringUTF(asHexString(properties.driverVersion).c_str());
-    env->SetObjectField(obj, fidNumber, driverVersion);
+    std::shared_ptr<Instance> instance = InstancePool::acquire(appName, engineName, {}, {});
 
-    fidNumber = env->GetFieldID(propertiesClazz, "vendorId", JavaClasses::JavaStringClassSignature);
-    jstring vendorId = env->NewStringUTF(asHexString(properties.vendorID).c_str());
-    env->SetObjectField(obj, fidNumber, vendorId);
+    env->ReleaseStringUTFChars(app_name, appName);
+    env->ReleaseStringUTFChars(engine_name, engineName);
 
-    fidNumber = env->GetFieldID(propertiesClazz, "deviceId", JavaClasses::JavaStringClassSignature);
-    jstring deviceId = env->NewStringUTF(asHexString(properties.deviceID).c_str());
-    env->SetObjectField(obj, fidNumber, deviceId);
-
-    fidNumber = env->GetFieldID(propertiesClazz, "physicalDeviceType", "I");
-    env->SetIntField(obj, fidNumber, (jint)properties.deviceType);
+    if (instance == nullptr || instance->getNumberPhysicalDevices() == 0)
+    {
+        return nullptr;
+    }
 
-    fidNumber = env->GetFieldID(propertiesClazz, "deviceName", JavaClasses::JavaStringClassSignature);
-    jstring deviceName = env->NewStringUTF(properties.deviceName);
-    env->SetObjectField(obj, fidNumber, deviceName);
+#warning
+    // For now this app is only designed to run on SoC devices which have only 1 GPU. So just choose the first one.
+    VkPhysicalDevice device = instance->getPhysicalDevices()[0];
+    const VkPhysicalDeviceProperties properties = PhysicalDevice::getDeviceProperties(device);
+
+    RowFormatter formatter;
+    formatInstanceInfoRows(instance.get(), formatter);
+    formatPhysicalDevicePropertyRows(properties, formatter);
+    formatPhysicalDeviceLimitRows(properties.limits, formatter);
+    formatPhysicalDeviceSparsePropertyRows(properties.sparseProperties, formatter);
+    formatPhysicalDeviceFeatureRows(PhysicalDevice::getDeviceFeatures(device), formatter);
+    formatPhysicalDeviceMemoryRows(PhysicalDevice::getMemoryProperties(device), formatter);
+
+    const std::vector<char>& text = formatter.getText();
+    const std::vector<RowFormatter::Row>& rows = formatter.getRows();
+    const std::vector<RowFormatter::Group>& groups = formatter.getGroups();
+
+    jbyteArray textArray = env->NewByteArray((jsize)text.size());
+    env->SetByteArrayRegion(textArray, 0, (jsize)text.size(), (const jbyte*)text.data());
+
+    const jsize rowInts = (jsize)(rows.size() * sizeof(RowFormatter::Row) / sizeof(jint));
+    jintArray rowArray = env->NewIntArray(rowInts);
+    env->SetIntArrayRegion(rowArray, 0, rowInts, (const jint*)rows.data());
+
+    const jsize groupInts = (jsize)(groups.size() * sizeof(RowFormatter::Group) / sizeof(jint));
+    jintArray groupArray = env->NewIntArray(groupInts);
+    env->SetIntArrayRegion(groupArray, 0, groupInts, (const jint*)groups.data());
+
+    jobject rowsObject = getObject(env, JavaClasses::FormattedRowsClassName);
+    jclass rowsClass = env->FindClass(JavaClasses::FormattedRowsClassName);
+    env->SetObjectField(rowsObject, env->GetFieldID(rowsClass, "text", "[B"), textArray);
+    env->SetObjectField(rowsObject, env->GetFieldID(rowsClass, "rows", "[I"), rowArray);
+    env->SetObjectField(rowsObject, env->GetFieldID(rowsClass, "groups", "[I"), groupArray);
+
+    return rowsObject;
 }
 
 /**
- * Populates the fields of the <code>PhysicalDeviceLimits</code> Java object.
- * @param env The JNI environment.
- * @param limits The <code>VkPhysicalDeviceLimits</code> that contains the Vulkan device limits.
- * @param obj (OUT param) The <code>PhysicalDeviceLimits</code> Java object to populate.
+ * Builds the search index over the rows returned by <code>getVkInfoRows</code>. The returned handle owns the index
+ * until it is passed to <code>nativeDestroy</code>.
+ * @return the handle, or 0 if the arrays are not in the <code>RowFormatter</code> layout.
  */
-void populatePhysicalDeviceLimitsObject(JNIEnv* env, const VkPhysicalDeviceLimits limits, jobject obj)
+extern "C"
+JNIEXPORT jlong JNICALL
+Java_com_example_vulkaninfoapp_PropertySearchIndex_nativeCreate(JNIEnv *env, jclass clazz,
+                                                                jbyteArray text, jintArray rows, jintArray groups)
 {
-    jclass limitsClazz = env->FindClass(JavaClasses::PhysicalDeviceLimitsClassName);
-
-    jfieldID fidNumber = env->GetFieldID(limitsClazz, "maxImageDimension1D", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxImageDimension1D);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxImageDimension2D", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxImageDimension2D);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxImageDimension3D", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxImageDimension3D);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxImageDimensionCube", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxImageDimensionCube);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxImageArrayLayers", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxImageArrayLayers);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxTexelBufferElements", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxTexelBufferElements);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxUniformBufferRange", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxUniformBufferRange);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxStorageBufferRange", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxStorageBufferRange);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxPushConstantsSize", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxPushConstantsSize);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxMemoryAllocationCount", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxMemoryAllocationCount);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxSamplerAllocationCount", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxSamplerAllocationCount);
-
-    fidNumber = env->GetFieldID(limitsClazz, "bufferImageGranularity", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.bufferImageGranularity);
-
-    fidNumber = env->GetFieldID(limitsClazz, "sparseAddressSpaceSize", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.sparseAddressSpaceSize);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxBoundDescriptorSets", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxBoundDescriptorSets);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxPerStageDescriptorSamplers", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxPerStageDescriptorSamplers);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxPerStageDescriptorUniformBuffers", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxPerStageDescriptorUniformBuffers);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxPerStageDescriptorStorageBuffers", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxPerStageDescriptorStorageBuffers);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxPerStageDescriptorSampledImages", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxPerStageDescriptorSampledImages);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxPerStageDescriptorStorageImages", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxPerStageDescriptorStorageImages);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxPerStageDescriptorInputAttachments", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxPerStageDescriptorInputAttachments);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxPerStageResources", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxPerStageResources);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxDescriptorSetSamplers", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxDescriptorSetSamplers);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxDescriptorSetUniformBuffers", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxDescriptorSetUniformBuffers);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxDescriptorSetUniformBuffersDynamic", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxDescriptorSetUniformBuffers);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxDescriptorSetStorageBuffers", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxDescriptorSetStorageBuffers);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxDescriptorSetStorageBuffersDynamic", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxDescriptorSetStorageBuffersDynamic);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxDescriptorSetSampledImages", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxDescriptorSetSampledImages);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxDescriptorSetStorageImages", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxDescriptorSetStorageImages);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxDescriptorSetInputAttachments", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxDescriptorSetInputAttachments);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxVertexInputAttributes", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxVertexInputAttributes);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxVertexInputBindings", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxVertexInputBindings);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxVertexInputAttributeOffset", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxVertexInputAttributeOffset);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxVertexInputBindingStride", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxVertexInputBindingStride);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxVertexOutputComponents", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxVertexOutputComponents);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxTessellationGenerationLevel", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxTessellationGenerationLevel);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxTessellationPatchSize", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxTessellationPatchSize);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxTessellationControlPerVertexInputComponents", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxTessellationControlPerVertexInputComponents);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxTessellationControlPerVertexOutputComponents", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxTessellationControlPerVertexOutputComponents);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxTessellationControlPerPatchOutputComponents", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxTessellationControlPerPatchOutputComponents);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxTessellationControlTotalOutputComponents", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxTessellationControlTotalOutputComponents);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxTessellationEvaluationInputComponents", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxTessellationEvaluationInputComponents);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxTessellationEvaluationOutputComponents", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxTessellationEvaluationOutputComponents);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxGeometryShaderInvocations", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxGeometryShaderInvocations);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxGeometryInputComponents", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxGeometryInputComponents);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxGeometryOutputComponents", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxGeometryOutputComponents);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxGeometryOutputVertices", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxGeometryOutputVertices);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxGeometryTotalOutputComponents", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxGeometryTotalOutputComponents);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxFragmentInputComponents", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxFragmentInputComponents);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxFragmentOutputAttachments", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxFragmentOutputAttachments);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxFragmentDualSrcAttachments", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxFragmentDualSrcAttachments);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxFragmentCombinedOutputResources", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxFragmentCombinedOutputResources);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxComputeSharedMemorySize", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxComputeSharedMemorySize);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxComputeWorkGroupCount", "[J");
-    jlongArray outJLongs = env->NewLongArray(3);
-    jlong computeWorkGroupCount[] = {limits.maxComputeWorkGroupCount[0], limits.maxComputeWorkGroupCount[1], limits.maxComputeWorkGroupCount[2]};
-    env->SetLongArrayRegion(outJLongs, 0, 3, computeWorkGroupCount);
-    env->SetObjectField(obj, fidNumber, outJLongs);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxComputeWorkGroupInvocations", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxComputeWorkGroupInvocations);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxComputeWorkGroupSize", "[J");
-    outJLongs = env->NewLongArray(3);
-    jlong computeWorkGroupSize[] = {limits.maxComputeWorkGroupSize[0], limits.maxComputeWorkGroupSize[1], limits.maxComputeWorkGroupSize[2]};
-    env->SetLongArrayRegion(outJLongs, 0, 3, computeWorkGroupSize);
-    env->SetObjectField(obj, fidNumber, outJLongs);
-
-    fidNumber = env->GetFieldID(limitsClazz, "subPixelPrecisionBits", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.subPixelPrecisionBits);
-
-    fidNumber = env->GetFieldID(limitsClazz, "subTexelPrecisionBits", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.subTexelPrecisionBits);
-
-    fidNumber = env->GetFieldID(limitsClazz, "mipmapPrecisionBits", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.mipmapPrecisionBits);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxDrawIndexedIndexValue", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxDrawIndexedIndexValue);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxDrawIndirectCount", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxDrawIndirectCount);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxSamplerLodBias", "F");
-    env->SetFloatField(obj, fidNumber, (jfloat)limits.maxSamplerLodBias);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxSamplerAnisotropy", "F");
-    env->SetFloatField(obj, fidNumber, (jfloat)limits.maxSamplerAnisotropy);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxViewports", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxViewports);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxViewportDimensions", "[J");
-    outJLongs = env->NewLongArray(2);
-    jlong viewportDimensions[] = {limits.maxViewportDimensions[0], limits.maxViewportDimensions[1]};
-    env->SetLongArrayRegion(outJLongs, 0, 2, viewportDimensions);
-    env->SetObjectField(obj, fidNumber, outJLongs);
-
-    fidNumber = env->GetFieldID(limitsClazz, "viewportBoundsRange", "[F");
-    jfloatArray outJFloats = env->NewFloatArray(2);
-    jfloat boundsRange[] = {limits.viewportBoundsRange[0], limits.viewportBoundsRange[1]};
-    env->SetFloatArrayRegion(outJFloats, 0, 2,boundsRange);
-    env->SetObjectField(obj, fidNumber, outJFloats);
-
-    fidNumber = env->GetFieldID(limitsClazz, "viewportSubPixelBits", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.viewportSubPixelBits);
-
-    fidNumber = env->GetFieldID(limitsClazz, "minMemoryMapAlignment", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.minMemoryMapAlignment);
-
-    fidNumber = env->GetFieldID(limitsClazz, "minTexelBufferOffsetAlignment", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.minTexelBufferOffsetAlignment);
-
-    fidNumber = env->GetFieldID(limitsClazz, "minUniformBufferOffsetAlignment", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.minUniformBufferOffsetAlignment);
-
-    fidNumber = env->GetFieldID(limitsClazz, "minStorageBufferOffsetAlignment", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.minStorageBufferOffsetAlignment);
-
-    fidNumber = env->GetFieldID(limitsClazz, "minTexelOffset", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.minTexelOffset);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxTexelOffset", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxTexelOffset);
-
-    fidNumber = env->GetFieldID(limitsClazz, "minTexelGatherOffset", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.minTexelGatherOffset);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxTexelGatherOffset", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxTexelGatherOffset);
-
-    fidNumber = env->GetFieldID(limitsClazz, "minInterpolationOffset", "F");
-    env->SetFloatField(obj, fidNumber, (jfloat)limits.minInterpolationOffset);
+    VKINFO_TRACE_SCOPE("PropertySearchIndex.nativeCreate");
 
-    fidNumber = env->GetFieldID(limitsClazz, "maxInterpolationOffset", "F");
-    env->SetFloatField(obj, fidNumber, (jfloat)limits.maxInterpolationOffset);
-
-    fidNumber = env->GetFieldID(limitsClazz, "subPixelInterpolationOffsetBits", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.subPixelInterpolationOffsetBits);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxFramebufferWidth", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxFramebufferWidth);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxFramebufferHeight", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxFramebufferHeight);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxFramebufferLayers", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxFramebufferLayers);
-
-    fidNumber = env->GetFieldID(limitsClazz, "framebufferColorSampleCounts", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.framebufferColorSampleCounts);
-
-    fidNumber = env->GetFieldID(limitsClazz, "framebufferDepthSampleCounts", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.framebufferDepthSampleCounts);
-
-    fidNumber = env->GetFieldID(limitsClazz, "framebufferStencilSampleCounts", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.framebufferStencilSampleCounts);
-
-    fidNumber = env->GetFieldID(limitsClazz, "framebufferNoAttachmentsSampleCounts", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.framebufferNoAttachmentsSampleCounts);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxColorAttachments", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxColorAttachments);
-
-    fidNumber = env->GetFieldID(limitsClazz, "sampledImageColorSampleCounts", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.sampledImageColorSampleCounts);
-
-    fidNumber = env->GetFieldID(limitsClazz, "sampledImageIntegerSampleCounts", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.sampledImageIntegerSampleCounts);
-
-    fidNumber = env->GetFieldID(limitsClazz, "sampledImageDepthSampleCounts", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.sampledImageDepthSampleCounts);
-
-    fidNumber = env->GetFieldID(limitsClazz, "sampledImageStencilSampleCounts", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.sampledImageStencilSampleCounts);
-
-    fidNumber = env->GetFieldID(limitsClazz, "storageImageSampleCounts", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.storageImageSampleCounts);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxSampleMaskWords", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxSampleMaskWords);
-
-    fidNumber = env->GetFieldID(limitsClazz, "timestampComputeAndGraphics", "Z");
-    env->SetBooleanField(obj, fidNumber, (jboolean)limits.timestampComputeAndGraphics);
-
-    fidNumber = env->GetFieldID(limitsClazz, "timestampPeriod", "F");
-    env->SetFloatField(obj, fidNumber, (jfloat)limits.timestampPeriod);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxClipDistances", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxClipDistances);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxCullDistances", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxCullDistances);
-
-    fidNumber = env->GetFieldID(limitsClazz, "maxCombinedClipAndCullDistances", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.maxCombinedClipAndCullDistances);
-
-    fidNumber = env->GetFieldID(limitsClazz, "discreteQueuePriorities", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.discreteQueuePriorities);
-
-    fidNumber = env->GetFieldID(limitsClazz, "pointSizeRange", "[F");
-    outJFloats = env->NewFloatArray(2);
-    jfloat pointsSizeRange[] = {limits.pointSizeRange[0], limits.pointSizeRange[1]};
-    env->SetFloatArrayRegion(outJFloats, 0, 2,pointsSizeRange);
-    env->SetObjectField(obj, fidNumber, outJFloats);
-
-    fidNumber = env->GetFieldID(limitsClazz, "lineWidthRange", "[F");
-    outJFloats = env->NewFloatArray(2);
-    jfloat lineWidthRange[] = {limits.lineWidthRange[0], limits.lineWidthRange[1]};
-    env->SetFloatArrayRegion(outJFloats, 0, 2,lineWidthRange);
-    env->SetObjectField(obj, fidNumber, outJFloats);
-
-    fidNumber = env->GetFieldID(limitsClazz, "pointSizeGranularity", "F");
-    env->SetFloatField(obj, fidNumber, (jfloat)limits.pointSizeGranularity);
-
-    fidNumber = env->GetFieldID(limitsClazz, "lineWidthGranularity", "F");
-    env->SetFloatField(obj, fidNumber, (jfloat)limits.lineWidthGranularity);
-
-    fidNumber = env->GetFieldID(limitsClazz, "strictLines", "Z");
-    env->SetBooleanField(obj, fidNumber, (jboolean)limits.strictLines);
+    const jsize textLength = env->GetArrayLength(text);
+    const jsize rowInts = env->GetArrayLength(rows);
+    const jsize groupInts = env->GetArrayLength(groups);
+    if (rowInts % (sizeof(RowFormatter::Row) / sizeof(jint)) != 0 || groupInts % (sizeof(RowFormatter::Group) / sizeof(jint)) != 0)
+    {
+        return 0;
+    }
 
-    fidNumber = env->GetFieldID(limitsClazz, "standardSampleLocations", "Z");
-    env->SetBooleanField(obj, fidNumber, (jboolean)limits.standardSampleLocations);
+    jbyte* textElements = env->GetByteArrayElements(text, nullptr);
+    jint* rowElements = env->GetIntArrayElements(rows, nullptr);
+    jint* groupElements = env->GetIntArrayElements(groups, nullptr);
 
-    fidNumber = env->GetFieldID(limitsClazz, "optimalBufferCopyOffsetAlignment", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.optimalBufferCopyOffsetAlignment);
+    RowSearchIndex* index = new RowSearchIndex((const char*)textElements, (size_t)textLength,
+                                               (const RowFormatter::Row*)rowElements, rowInts * sizeof(jint) / sizeof(RowFormatter::Row),
+                                               (const RowFormatter::Group*)groupElements, groupInts * sizeof(jint) / sizeof(RowFormatter::Group));
 
-    fidNumber = env->GetFieldID(limitsClazz, "optimalBufferCopyRowPitchAlignment", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.optimalBufferCopyRowPitchAlignment);
+    env->ReleaseIntArrayElements(groups, groupElements, JNI_ABORT);
+    env->ReleaseIntArrayElements(rows, rowElements, JNI_ABORT);
+    env->ReleaseByteArrayElements(text, textElements, JNI_ABORT);
 
-    fidNumber = env->GetFieldID(limitsClazz, "nonCoherentAtomSize", "J");
-    env->SetLongField(obj, fidNumber, (jlong)limits.nonCoherentAtomSize);
+    return (jlong)(intptr_t)index;
 }
 
 /**
- * Populates the fields of the <code>PhysicalDeviceSparseLimits</code> Java object.
- * @param env The JNI environment.
- * @param properties The <code>VkPhysicalDeviceSparseProperties</code> that contains the properties.
- * @param obj (OUT param) The <code>PhysicalDeviceSparseProperties</code> Java object to populate.
+ * Runs one incremental query and writes the matches as (group, child) pairs into <code>out</code>.
+ * @return the number of matches, which may exceed what fits in <code>out</code>.
  */
-void populatePhysicalDeviceSparsePropertiesObject(JNIEnv* env, const VkPhysicalDeviceSparseProperties properties, jobject obj)
+extern "C"
+JNIEXPORT jint JNICALL
+Java_com_example_vulkaninfoapp_PropertySearchIndex_nativeSearch(JNIEnv *env, jclass clazz,
+                                                                jlong handle, jstring query, jintArray out)
 {
-    jclass propertiesClazz = env->FindClass(JavaClasses::PhysicalDeviceSparsePropertiesClassName);
-
-    jfieldID fieldId = env->GetFieldID(propertiesClazz, "residencyStandard2DBlockShape", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)properties.residencyStandard2DBlockShape);
+    RowSearchIndex* index = (RowSearchIndex*)(intptr_t)handle;
+    if (index == nullptr)
+    {
+        return 0;
+    }
 
-    fieldId = env->GetFieldID(propertiesClazz, "residencyStandard2DMultisampleBlockShape", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)properties.residencyStandard2DMultisampleBlockShape);
+    const char* queryChars = env->GetStringUTFChars(query, nullptr);
+    const std::vector<RowSearchIndex::Match>& matches = index->search(queryChars);
+    env->ReleaseStringUTFChars(query, queryChars);
 
-    fieldId = env->GetFieldID(propertiesClazz, "residencyStandard3DBlockShape", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)properties.residencyStandard3DBlockShape);
+    static_assert(sizeof(RowSearchIndex::Match) == 2 * sizeof(jint), "Match is copied as two ints");
+    const jsize count = std::min((jsize)matches.size(), env->GetArrayLength(out) / 2);
+    env->SetIntArrayRegion(out, 0, count * 2, (const jint*)matches.data());
 
-    fieldId = env->GetFieldID(propertiesClazz, "residencyAlignedMipSize", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)properties.residencyAlignedMipSize);
+    return (jint)matches.size();
+}
 
-    fieldId = env->GetFieldID(propertiesClazz, "residencyNonResidentStrict", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)properties.residencyNonResidentStrict);
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_example_vulkaninfoapp_PropertySearchIndex_nativeDestroy(JNIEnv *env, jclass clazz, jlong handle)
+{
+    delete (RowSearchIndex*)(intptr_t)handle;
 }
 
 /**
- * Populates the fields of the <code>PhysicalDeviceFeatures</code> Java object.
- * @param env The JNI environment.
- * @param properties The <code>VkPhysicalDeviceFeatures</code> that contains the properties.
- * @param obj (OUT param) The <code>PhysicalDeviceFeatures</code> Java object to populate.
+ * Creates a memory budget sampler for the first physical device and starts it.
+ * The returned handle owns the sampler until it is passed to <code>nativeStop</code>.
  */
-void populatePhysicalDeviceFeaturesObject(JNIEnv* env, const VkPhysicalDeviceFeatures features, jobject obj)
+extern "C"
+JNIEXPORT jlong JNICALL
+Java_com_example_vulkaninfoapp_MemoryBudgetMonitor_nativeStart(JNIEnv *env, jclass clazz,
+                                                               jstring app_name, jstring engine_name, jint interval_ms)
 {
-    jclass featuresClazz = env->FindClass(JavaClasses::PhysicalDeviceFeaturesClassName);
-
-    jfieldID fieldId = env->GetFieldID(featuresClazz, "robustBufferAccess", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.robustBufferAccess);
-
-    fieldId = env->GetFieldID(featuresClazz, "fullDrawIndexUint32", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.fullDrawIndexUint32);
-
-    fieldId = env->GetFieldID(featuresClazz, "imageCubeArray", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.imageCubeArray);
-
-    fieldId = env->GetFieldID(featuresClazz, "independentBlend", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.independentBlend);
-
-    fieldId = env->GetFieldID(featuresClazz, "geometryShader", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.geometryShader);
-
-    fieldId = env->GetFieldID(featuresClazz, "tessellationShader", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.tessellationShader);
-
-    fieldId = env->GetFieldID(featuresClazz, "sampleRateShading", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.sampleRateShading);
-
-    fieldId = env->GetFieldID(featuresClazz, "dualSrcBlend", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.dualSrcBlend);
-
-    fieldId = env->GetFieldID(featuresClazz, "logicOp", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.logicOp);
-
-    fieldId = env->GetFieldID(featuresClazz, "multiDrawIndirect", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.multiDrawIndirect);
-
-    fieldId = env->GetFieldID(featuresClazz, "drawIndirectFirstInstance", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.drawIndirectFirstInstance);
-
-    fieldId = env->GetFieldID(featuresClazz, "depthClamp", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.depthClamp);
-
-    fieldId = env->GetFieldID(featuresClazz, "depthBiasClamp", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.depthBiasClamp);
-
-    fieldId = env->GetFieldID(featuresClazz, "fillModeNonSolid", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.fillModeNonSolid);
-
-    fieldId = env->GetFieldID(featuresClazz, "depthBounds", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.depthBounds);
-
-    fieldId = env->GetFieldID(featuresClazz, "wideLines", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.wideLines);
-
-    fieldId = env->GetFieldID(featuresClazz, "largePoints", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.largePoints);
-
-    fieldId = env->GetFieldID(featuresClazz, "alphaToOne", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.alphaToOne);
-
-    fieldId = env->GetFieldID(featuresClazz, "multiViewport", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.multiViewport);
-
-    fieldId = env->GetFieldID(featuresClazz, "samplerAnisotropy", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.samplerAnisotropy);
-
-    fieldId = env->GetFieldID(featuresClazz, "textureCompressionETC2", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.textureCompressionETC2);
-
-    fieldId = env->GetFieldID(featuresClazz, "textureCompressionASTC_LDR", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.textureCompressionASTC_LDR);
-
-    fieldId = env->GetFieldID(featuresClazz, "textureCompressionBC", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.textureCompressionBC);
-
-    fieldId = env->GetFieldID(featuresClazz, "occlusionQueryPrecise", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.occlusionQueryPrecise);
+    VKINFO_TRACE_SCOPE("MemoryBudgetMonitor.nativeStart");
 
-    fieldId = env->GetFieldID(featuresClazz, "pipelineStatisticsQuery", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.pipelineStatisticsQuery);
+    const char* appName = env->GetStringUTFChars(app_name, nullptr);
+    const char* engineName = env->GetStringUTFChars(engine_name, nullptr);
 
-    fieldId = env->GetFieldID(featuresClazz, "vertexPipelineStoresAndAtomics", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.robustBufferAccess);
+    std::unique_ptr<MemoryBudgetSampler> sampler = MemoryBudgetSampler::create(appName, engineName, 0);
 
-    fieldId = env->GetFieldID(featuresClazz, "fragmentStoresAndAtomics", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.fragmentStoresAndAtomics);
+    env->ReleaseStringUTFChars(app_name, appName);
+    env->ReleaseStringUTFChars(engine_name, engineName);
 
-    fieldId = env->GetFieldID(featuresClazz, "shaderTessellationAndGeometryPointSize", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.shaderTessellationAndGeometryPointSize);
-
-    fieldId = env->GetFieldID(featuresClazz, "shaderImageGatherExtended", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.shaderImageGatherExtended);
-
-    fieldId = env->GetFieldID(featuresClazz, "shaderStorageImageExtendedFormats", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.shaderStorageImageExtendedFormats);
-
-    fieldId = env->GetFieldID(featuresClazz, "shaderStorageImageMultisample", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.shaderStorageImageMultisample);
-
-    fieldId = env->GetFieldID(featuresClazz, "shaderStorageImageReadWithoutFormat", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.shaderStorageImageReadWithoutFormat);
-
-    fieldId = env->GetFieldID(featuresClazz, "shaderStorageImageWriteWithoutFormat", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.shaderStorageImageWriteWithoutFormat);
-
-    fieldId = env->GetFieldID(featuresClazz, "shaderUniformBufferArrayDynamicIndexing", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.shaderUniformBufferArrayDynamicIndexing);
-
-    fieldId = env->GetFieldID(featuresClazz, "shaderSampledImageArrayDynamicIndexing", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.shaderSampledImageArrayDynamicIndexing);
-
-    fieldId = env->GetFieldID(featuresClazz, "shaderStorageBufferArrayDynamicIndexing", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.shaderStorageBufferArrayDynamicIndexing);
-
-    fieldId = env->GetFieldID(featuresClazz, "shaderStorageImageArrayDynamicIndexing", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.shaderStorageImageArrayDynamicIndexing);
-
-    fieldId = env->GetFieldID(featuresClazz, "shaderClipDistance", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.shaderClipDistance);
-
-    fieldId = env->GetFieldID(featuresClazz, "shaderCullDistance", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.shaderCullDistance);
-
-    fieldId = env->GetFieldID(featuresClazz, "shaderFloat64", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.shaderFloat64);
-
-    fieldId = env->GetFieldID(featuresClazz, "shaderInt64", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.shaderInt64);
-
-    fieldId = env->GetFieldID(featuresClazz, "shaderInt16", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.shaderInt16);
-
-    fieldId = env->GetFieldID(featuresClazz, "shaderResourceResidency", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.shaderResourceResidency);
-
-    fieldId = env->GetFieldID(featuresClazz, "shaderResourceMinLod", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.shaderResourceMinLod);
-
-    fieldId = env->GetFieldID(featuresClazz, "sparseBinding", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.sparseBinding);
-
-    fieldId = env->GetFieldID(featuresClazz, "sparseResidencyBuffer", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.sparseResidencyBuffer);
-
-    fieldId = env->GetFieldID(featuresClazz, "sparseResidencyImage2D", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.sparseResidencyImage2D);
-
-    fieldId = env->GetFieldID(featuresClazz, "sparseResidencyImage3D", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.sparseResidencyImage3D);
-
-    fieldId = env->GetFieldID(featuresClazz, "sparseResidency2Samples", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.sparseResidency2Samples);
-
-    fieldId = env->GetFieldID(featuresClazz, "sparseResidency4Samples", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.sparseResidency4Samples);
-
-    fieldId = env->GetFieldID(featuresClazz, "sparseResidency8Samples", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.sparseResidency8Samples);
-
-    fieldId = env->GetFieldID(featuresClazz, "sparseResidency16Samples", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.sparseResidency16Samples);
-
-    fieldId = env->GetFieldID(featuresClazz, "sparseResidencyAliased", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.sparseResidencyAliased);
-
-    fieldId = env->GetFieldID(featuresClazz, "variableMultisampleRate", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.variableMultisampleRate);
+    if (sampler == nullptr || !sampler->start(interval_ms > 0 ? (uint32_t)interval_ms : 1))
+    {
+        return 0;
+    }
 
-    fieldId = env->GetFieldID(featuresClazz, "inheritedQueries", "Z");
-    env->SetBooleanField(obj, fieldId, (jboolean)features.inheritedQueries);
+    return (jlong)(intptr_t)sampler.release();
 }
 
 /**
- * Populates the fields of the <code>PhysicalDeviceMemoryProperties</code> Java object.
- * @param env The JNI environment.
- * @param properties The <code>VkPhysicalDeviceMemoryProperties</code> that contains the properties.
- * @param obj (OUT param) The <code>PhysicalDeviceMemoryProperties</code> Java object to populate.
+ * Copies as many queued samples as fit into a direct <code>ByteBuffer</code>, in the
+ * <code>MemoryBudgetSampler::Sample</code> layout. No Java objects are created per sample.
+ * @return the number of samples written, or -1 if the buffer is not a direct buffer.
  */
-void populatePhysicalDeviceMemoryPropertiesObject(JNIEnv* env, const VkPhysicalDeviceMemoryProperties properties, jobject obj)
+extern "C"
+JNIEXPORT jint JNICALL
+Java_com_example_vulkaninfoapp_MemoryBudgetMonitor_nativeDrain(JNIEnv *env, jclass clazz,
+                                                               jlong handle, jobject buffer)
 {
-    jclass propertiesClazz = env->FindClass(JavaClasses::PhysicalDeviceMemoryPropertiesClassName);
+    MemoryBudgetSampler* sampler = (MemoryBudgetSampler*)(intptr_t)handle;
+    void* address = env->GetDirectBufferAddress(buffer);
+    jlong capacity = env->GetDirectBufferCapacity(buffer);
+    if (sampler == nullptr || address == nullptr || capacity < 0)
+    {
+        return -1;
+    }
 
-    jfieldID fidNumber = env->GetFieldID(propertiesClazz, "memoryTypeCount", "J");
-    env->SetLongField(obj, fidNumber, (jlong)properties.memoryTypeCount);
+    return (jint)sampler->drain((MemoryBudgetSampler::Sample*)address, (size_t)capacity / sizeof(MemoryBudgetSampler::Sample));
+}
 
-    fidNumber = env->GetFieldID(propertiesClazz, "memoryHeapCount", "J");
-    env->SetLongField(obj, fidNumber, (jlong)properties.memoryHeapCount);
+extern "C"
+JNIEXPORT jlong JNICALL
+Java_com_example_vulkaninfoapp_MemoryBudgetMonitor_nativeGetDroppedCount(JNIEnv *env, jclass clazz, jlong handle)
+{
+    MemoryBudgetSampler* sampler = (MemoryBudgetSampler*)(intptr_t)handle;
+    return sampler != nullptr ? (jlong)sampler->getDroppedCount() : 0;
 }
 
 /**
- * Populates the field of the <code>MemoryType</code> Java object.
- * @param env The JNI environment.
- * @param memoryType The <code>VkMemoryType</code> that contains the memory properties.
- * @param obj (OUT param) The <code>MemoryType</code> Java object to populate.
+ * Stops the sampling thread and destroys the sampler behind <code>handle</code>.
  */
-void populateMemoryTypeObject(JNIEnv* env, const VkMemoryType memoryType, jobject obj)
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_example_vulkaninfoapp_MemoryBudgetMonitor_nativeStop(JNIEnv *env, jclass clazz, jlong handle)
 {
-    jclass memTypeClass = env->FindClass(JavaClasses::MemoryTypeClassName);
-
-    jfieldID fieldId = env->GetFieldID(memTypeClass, "heapIndex", "J");
-    env->SetLongField(obj, fieldId, (jlong)memoryType.heapIndex);
-
-    std::vector<const char*> flagStrings = parseMemTypePropertyFlags(memoryType.propertyFlags);
-    jclass stringClass = env->FindClass(JavaClasses::JavaStringClassName);
-    jobjectArray javaOutStrings = env->NewObjectArray(flagStrings.size(), stringClass, NULL);
-    for (size_t i = 0; i < flagStrings.size(); i++)
-    {
-        env->SetObjectArrayElement(javaOutStrings, i, env->NewStringUTF(flagStrings[i]));
-    }
+    delete (MemoryBudgetSampler*)(intptr_t)handle;
+}
 
-    std::string arraySig = "[" + std::string(JavaClasses::JavaStringClassSignature);
-    fieldId = env->GetFieldID(memTypeClass, "propertyFlags", arraySig.c_str());
-    env->SetObjectField(obj, fieldId, javaOutStrings);
+namespace
+{
+    /**
+     * The cancel flag of the sustained run in progress, or null while none is. <code>ThrottlingDetector.cancel</code>
+     * only sets a flag under the mutex, so a cancel that arrives between runs is dropped instead of stopping the next.
+     */
+    std::mutex throttlingCancelMutex;
+    std::atomic<bool>* throttlingCancelRequested = nullptr;
 }
 
 /**
- * Populates the field of the <code>MemoryHeap</code> Java object.
- * @param env The JNI environment.
- * @param memoryHeap The <code>VkMemoryHeap</code> that contains the memory heap properties.
- * @param obj (OUT param) The <code>MemoryHeap</code> Java object to populate.
+ * Runs the sustained compute workload on the first physical device. Blocks for <code>duration_seconds</code>, so it
+ * must be called off the UI thread.
+ * @return a <code>ThrottlingResult</code>, or null if no instance could be created.
  */
-void populateMemoryHeapObject(JNIEnv* env, const VkMemoryHeap memoryHeap, jobject obj)
+extern "C"
+JNIEXPORT jobject JNICALL
+Java_com_example_vulkaninfoapp_ThrottlingDetector_run(JNIEnv *env, jclass clazz,
+                                                      jstring app_name, jstring engine_name, jint duration_seconds)
 {
-    jclass memHeapClass = env->FindClass(JavaClasses::MemoryHeapClassName);
+    VKINFO_TRACE_SCOPE("ThrottlingDetector.run");
 
-    jfieldID fieldId = env->GetFieldID(memHeapClass, "size", "J");
-    env->SetLongField(obj, fieldId, (jlong)memoryHeap.size);
+    const char* appName = env->GetStringUTFChars(app_name, nullptr);
+    const char* engineName = env->GetStringUTFChars(engine_name, nullptr);
 
-    std::vector<const char*> flagStrings = parseMemHeapFlags(memoryHeap.flags);
-    jclass stringClass = env->FindClass(JavaClasses::JavaStringClassName);
-    jobjectArray javaOutStrings = env->NewObjectArray(flagStrings.size(), stringClass, NULL);
-    for (size_t i = 0; i < flagStrings.size(); i++)
-    {
-        env->SetObjectArrayElement(javaOutStrings, i, env->NewStringUTF(flagStrings[i]));
-    }
+    std::shared_ptr<Instance> instance = InstancePool::acquire(appName, engineName, {}, {});
 
-    std::string arraySig = "[" + std::string(JavaClasses::JavaStringClassSignature);
-    fieldId = env->GetFieldID(memHeapClass, "heapFlags", arraySig.c_str());
-    env->SetObjectField(obj, fieldId, javaOutStrings);
-}
+    env->ReleaseStringUTFChars(app_name, appName);
+    env->ReleaseStringUTFChars(engine_name, engineName);
 
-extern "C"
-JNIEXPORT jobject JNICALL
-Java_com_example_vulkaninfoapp_MainActivity_getVkInfo(JNIEnv *env, jclass clazz,
-                                                      jstring app_name, jstring engine_name)
-{
-    VkInfo vkInfo;
-    vkInfo.instance = new Instance(env->GetStringUTFChars(app_name, nullptr), env->GetStringUTFChars(engine_name, nullptr), {}, {});
-    if (vkInfo.instance->getHandle() == VK_NULL_HANDLE || vkInfo.instance->getNumberPhysicalDevices() == 0)
+    if (instance == nullptr || instance->getNumberPhysicalDevices() == 0)
     {
         return nullptr;
     }
 
-#warning
-    // For now this app is only designed to run on SoC devices which have only 1 GPU. So just choose the first one.
-    vkInfo.selectedPhysicalDevice = vkInfo.instance->getPhysicalDevices()[0];
-    vkInfo.physicalDeviceProperties = PhysicalDevice::getDeviceProperties(vkInfo.selectedPhysicalDevice);
-
-    jobject vkInfoObject = getObject(env, JavaClasses::VkInfoClassName);
-
-    // Populate the instanceInfo Java object.
-    jfieldID fieldId = env->GetFieldID(env->FindClass(JavaClasses::VkInfoClassName), "instanceInfo", JavaClasses::InstanceInfoClassSignature);
-    jobject instanceInfoObject = getObject(env, JavaClasses::InstanceInfoClassName);
-    populateInstanceInfoObject(env, vkInfo.instance, instanceInfoObject);
-    env->SetObjectField(vkInfoObject, fieldId, instanceInfoObject);
-
-    // Populate the physicalDeviceProperties Java object.
-    jobject physicalDevicePropertiesObject = getObject(env, JavaClasses::PhysicalDevicePropertiesClassName);
-
-    // Populate physicalDeviceProperties.limits Java object.
-    fieldId = env->GetFieldID(env->FindClass(JavaClasses::PhysicalDevicePropertiesClassName), "physicalDeviceLimits", JavaClasses::PhysicalDeviceLimitsClassSignature);
-    jobject physicalDeviceLimitsObject = getObject(env, JavaClasses::PhysicalDeviceLimitsClassName);
-    populatePhysicalDeviceLimitsObject(env, vkInfo.physicalDeviceProperties.limits, physicalDeviceLimitsObject);
-    env->SetObjectField(physicalDevicePropertiesObject, fieldId, physicalDeviceLimitsObject);
-
-    // Populate physicalDeviceProperties.sparseProperties Java object.
-    fieldId = env->GetFieldID(env->FindClass(JavaClasses::PhysicalDevicePropertiesClassName), "physicalDeviceSparseProperties", JavaClasses::PhysicalDeviceSparsePropertiesClassSignature);
-    jobject physicalDeviceSparsePropertiesObject = getObject(env, JavaClasses::PhysicalDeviceSparsePropertiesClassName);
-    populatePhysicalDeviceSparsePropertiesObject(env, vkInfo.physicalDeviceProperties.sparseProperties, physicalDeviceSparsePropertiesObject);
-    env->SetObjectField(physicalDevicePropertiesObject, fieldId, physicalDeviceSparsePropertiesObject);
-
-    // Set the physicalDeviceProperties field of the Java VkInfo object.
-    populatePhysicalDevicePropertiesObject(env, vkInfo.physicalDeviceProperties, physicalDevicePropertiesObject);
-    fieldId = env->GetFieldID(env->FindClass(JavaClasses::VkInfoClassName), "physicalDeviceProperties", JavaClasses::PhysicalDevicePropertiesClassSignature);
-    env->SetObjectField(vkInfoObject, fieldId, physicalDevicePropertiesObject);
-
-    // Populate the physicalDeviceFeatures field of the Java VkInfo object.
-    vkInfo.physicalDeviceFeatures = PhysicalDevice::getDeviceFeatures(vkInfo.selectedPhysicalDevice);
-    jobject physicalDeviceFeaturesObject = getObject(env, JavaClasses::PhysicalDeviceFeaturesClassName);
-    populatePhysicalDeviceFeaturesObject(env, vkInfo.physicalDeviceFeatures, physicalDeviceFeaturesObject);
-    fieldId = env->GetFieldID(env->FindClass(JavaClasses::VkInfoClassName), "physicalDeviceFeatures", JavaClasses::PhysicalDeviceFeaturesClassSignature);
-    env->SetObjectField(vkInfoObject, fieldId, physicalDeviceFeaturesObject);
-
-    // Populate the physicalDeviceMemoryProperties field of the Java VkInfo object.
-    vkInfo.physicalDeviceMemoryProperties = PhysicalDevice::getMemoryProperties(vkInfo.selectedPhysicalDevice);
-    jobject physicalDeviceMemoryPropertiesObject = getObject(env, JavaClasses::PhysicalDeviceMemoryPropertiesClassName);
-    populatePhysicalDeviceMemoryPropertiesObject(env, vkInfo.physicalDeviceMemoryProperties, physicalDeviceMemoryPropertiesObject);
-
-    // Populate the MemoryType Java objects.
-    jclass memoryTypeClass = env->FindClass(JavaClasses::MemoryTypeClassName);
-    jobjectArray memoryTypeObjArray = env->NewObjectArray(vkInfo.physicalDeviceMemoryProperties.memoryTypeCount, memoryTypeClass, nullptr);
-    for (size_t i = 0; i < vkInfo.physicalDeviceMemoryProperties.memoryTypeCount; i++)
+    std::atomic<bool> cancelRequested(false);
     {
-        jobject memTypeObj = getObject(env, JavaClasses::MemoryTypeClassName);
-        populateMemoryTypeObject(env, vkInfo.physicalDeviceMemoryProperties.memoryTypes[i], memTypeObj);
-        env->SetObjectArrayElement(memoryTypeObjArray, i, memTypeObj);
+        std::lock_guard<std::mutex> lock(throttlingCancelMutex);
+        throttlingCancelRequested = &cancelRequested;
     }
 
-    std::string arraySig = "[" + std::string(JavaClasses::MemoryTypeClassSignature);
-    fieldId = env->GetFieldID(env->FindClass(JavaClasses::PhysicalDeviceMemoryPropertiesClassName), "memoryTypes", arraySig.c_str());
-    env->SetObjectField(physicalDeviceMemoryPropertiesObject, fieldId, memoryTypeObjArray);
-
-    // Populate the MemoryHeap Java objects.
-    jclass memoryHeapClass = env->FindClass(JavaClasses::MemoryHeapClassName);
-    jobjectArray memoryHeapObjArray = env->NewObjectArray(vkInfo.physicalDeviceMemoryProperties.memoryHeapCount, memoryHeapClass, nullptr);
-    for (size_t i = 0; i < vkInfo.physicalDeviceMemoryProperties.memoryHeapCount; i++)
+    ThrottlingDetector::Result result = ThrottlingDetector::run(instance->getPhysicalDevices()[0],
+                                                                duration_seconds > 0 ? (uint32_t)duration_seconds : 1,
+                                                                &cancelRequested);
     {
-        jobject memHeapObj = getObject(env, JavaClasses::MemoryHeapClassName);
-        populateMemoryHeapObject(env, vkInfo.physicalDeviceMemoryProperties.memoryHeaps[i], memHeapObj);
-        env->SetObjectArrayElement(memoryHeapObjArray, i, memHeapObj);
+        std::lock_guard<std::mutex> lock(throttlingCancelMutex);
+        throttlingCancelRequested = nullptr;
     }
 
-    arraySig.clear();
-    arraySig = "[" + std::string(JavaClasses::MemoryHeapClassSignature);
-    fieldId = env->GetFieldID(env->FindClass(JavaClasses::PhysicalDeviceMemoryPropertiesClassName), "memoryHeaps", arraySig.c_str());
-    env->SetObjectField(physicalDeviceMemoryPropertiesObject, fieldId, memoryHeapObjArray);
+    jobject resultObject = getObject(env, JavaClasses::ThrottlingResultClassName);
+    jclass resultClass = env->FindClass(JavaClasses::ThrottlingResultClassName);
 
-    fieldId = env->GetFieldID(env->FindClass(JavaClasses::VkInfoClassName), "physicalDeviceMemoryProperties", JavaClasses::PhysicalDeviceMemoryPropertiesClassSignature);
-    env->SetObjectField(vkInfoObject, fieldId, physicalDeviceMemoryPropertiesObject);
+    env->SetBooleanField(resultObject, env->GetFieldID(resultClass, "valid", "Z"), (jboolean)result.valid);
+    env->SetIntField(resultObject, env->GetFieldID(resultClass, "durationSeconds", "I"), (jint)result.durationSeconds);
+    env->SetIntField(resultObject, env->GetFieldID(resultClass, "completedSeconds", "I"), (jint)result.completedSeconds);
+    env->SetDoubleField(resultObject, env->GetFieldID(resultClass, "peakGflops", "D"), result.peakGflops);
+    env->SetIntField(resultObject, env->GetFieldID(resultClass, "peakSecond", "I"), (jint)result.peakSecond);
+    env->SetDoubleField(resultObject, env->GetFieldID(resultClass, "steadyStateGflops", "D"), result.steadyStateGflops);
+    env->SetDoubleField(resultObject, env->GetFieldID(resultClass, "steadyStateRatio", "D"), result.steadyStateRatio);
+    env->SetIntField(resultObject, env->GetFieldID(resultClass, "onsetSecond", "I"), (jint)result.onsetSecond);
 
-    delete vkInfo.instance;
-    return vkInfoObject;
+    jdoubleArray series = env->NewDoubleArray((jsize)result.completedSeconds);
+    env->SetDoubleArrayRegion(series, 0, (jsize)result.completedSeconds, result.gflopsPerSecond.data());
+    env->SetObjectField(resultObject, env->GetFieldID(resultClass, "gflopsPerSecond", "[D"), series);
+
+    return resultObject;
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_example_vulkaninfoapp_ThrottlingDetector_cancel(JNIEnv *env, jclass clazz)
+{
+    std::lock_guard<std::mutex> lock(throttlingCancelMutex);
+    if (throttlingCancelRequested != nullptr)
+    {
+        throttlingCancelRequested->store(true);
+    }
 }
\ No newline at end of file
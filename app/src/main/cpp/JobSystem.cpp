@@ -0,0 +1,136 @@
+#include "JobSystem.h"
+#include <algorithm>
+
+/**
+ * Constructor for <code>JobSystem</code> class. Starts the workers; they sleep until <code>run</code> is called.
+ * @param workerCount The number of worker threads, at least 1.
+ */
+JobSystem::JobSystem(uint32_t workerCount)
+    : workerCount(std::max<uint32_t>(workerCount, 1)), queues(new Queue[std::max<uint32_t>(workerCount, 1)])
+{
+    for (uint32_t worker = 0; worker < this->workerCount; worker++)
+    {
+        this->threads.emplace_back(&JobSystem::work, this, worker);
+    }
+}
+
+/**
+ * Class destructor. Stops and joins the workers.
+ */
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->stopRequested = true;
+    }
+    this->wakeCondition.notify_all();
+
+    for (std::thread& thread : this->threads)
+    {
+        thread.join();
+    }
+}
+
+uint32_t JobSystem::getWorkerCount() const
+{
+    return this->workerCount;
+}
+
+/**
+ * Gets how many jobs were run by a worker other than the one they were dealt to, over every batch.
+ */
+uint64_t JobSystem::getStealCount() const
+{
+    return this->stealCount.load(std::memory_order_relaxed);
+}
+
+/**
+ * Runs a batch of jobs on the workers and waits for all of them to finish. Must not be called from a job.
+ * @param jobs The jobs. They must stay valid until <code>run</code> returns.
+ */
+void JobSystem::run(const std::vector<Job>& jobs)
+{
+    if (jobs.empty())
+    {
+        return;
+    }
+
+    this->remaining.store(jobs.size(), std::memory_order_relaxed);
+    for (size_t i = 0; i < jobs.size(); i++)
+    {
+        Queue& queue = this->queues[i % this->workerCount];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(&jobs[i]);
+    }
+
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->generation++;
+    this->wakeCondition.notify_all();
+    this->doneCondition.wait(lock, [this]() { return this->remaining.load(std::memory_order_acquire) == 0; });
+}
+
+/**
+ * Worker thread body: sleeps until a batch is dealt out, then runs jobs until no deque has any left.
+ * @param worker The index of the worker.
+ */
+void JobSystem::work(uint32_t worker)
+{
+    uint64_t seenGeneration = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            this->wakeCondition.wait(lock, [this, seenGeneration]() { return this->stopRequested || this->generation != seenGeneration; });
+            if (this->stopRequested)
+            {
+                return;
+            }
+            seenGeneration = this->generation;
+        }
+
+        for (const Job* job = this->take(worker); job != nullptr; job = this->take(worker))
+        {
+            (*job)(worker);
+
+            if (this->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                // Notified under the lock, so run cannot miss it between checking the count and sleeping.
+                std::lock_guard<std::mutex> lock(this->mutex);
+                this->doneCondition.notify_all();
+            }
+        }
+    }
+}
+
+/**
+ * Takes the newest job of the worker's own deque, or else steals the oldest job of the next non-empty deque.
+ * @return the job, or nullptr if every deque is empty.
+ */
+const JobSystem::Job* JobSystem::take(uint32_t worker)
+{
+    {
+        Queue& own = this->queues[worker];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.jobs.empty())
+        {
+            const Job* job = own.jobs.back();
+            own.jobs.pop_back();
+            return job;
+        }
+    }
+
+    for (uint32_t offset = 1; offset < this->workerCount; offset++)
+    {
+        Queue& victim = this->queues[(worker + offset) % this->workerCount];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.jobs.empty())
+        {
+            const Job* job = victim.jobs.front();
+            victim.jobs.pop_front();
+            this->stealCount.fetch_add(1, std::memory_order_relaxed);
+            return job;
+        }
+    }
+
+    return nullptr;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Fixed pool of worker threads that runs batches of jobs. Each worker owns a deque: a batch is dealt out round robin,
+ * a worker takes jobs from the back of its own deque and, once that is empty, steals from the front of the others,
+ * so uneven jobs still keep every worker busy. Jobs are told which worker runs them, for per-thread state such as
+ * command pools.
+ */
+class JobSystem
+{
+public:
+    typedef std::function<void(uint32_t worker)> Job;
+
+    explicit JobSystem(uint32_t workerCount);
+    JobSystem(const JobSystem& other) = delete;
+    JobSystem& operator=(const JobSystem& other) = delete;
+    ~JobSystem();
+
+    uint32_t getWorkerCount() const;
+    uint64_t getStealCount() const;
+    void run(const std::vector<Job>& jobs);
+
+private:
+    /**
+     * A worker's deque, on its own cache line so the owner and thieves of one deque do not slow down the others.
+     */
+    struct alignas(64) Queue
+    {
+        std::mutex mutex;
+        std::deque<const Job*> jobs;
+    };
+
+    void work(uint32_t worker);
+    const Job* take(uint32_t worker);
+
+    uint32_t workerCount;
+    std::unique_ptr<Queue[]> queues;
+    std::vector<std::thread> threads;
+    std::atomic<size_t> remaining{0};
+    std::atomic<uint64_t> stealCount{0};
+
+    std::mutex mutex;
+    std::condition_variable wakeCondition;
+    std::condition_variable doneCondition;
+    uint64_t generation = 0;
+    bool stopRequested = false;
+};
@@ -1,46 +1,149 @@
 #include "LogicalDevice.h"
-#include "PhysicalDevice.h"
 #include "QueueFamilyIndicies.hpp"
-#include <vector>
+#include "QueueTopology.h"
+#include "Trace.h"
 
+/**
+ * Constructor for <code>LogicalDevice</code> class.
+ * Creates a <code>VkDevice</code> with one queue from the graphics queue family picked by <code>QueueTopology</code>,
+ * or its compute family if the device has no graphics queues, and resolves the device's dispatch table.
+ * @param physicalDevice The <code>VkPhysicalDevice</code> to create the device on.
+ */
 LogicalDevice::LogicalDevice(VkPhysicalDevice physicalDevice)
 {
-    std::vector<VkQueueFamilyProperties> queues = {};
-    QueueFamilyIndicies indices = {};
+    if (physicalDevice == VK_NULL_HANDLE)
+    {
+        return;
+    }
 
+    QueueFamilyIndicies indices = QueueTopology::solve(QueueTopology::classify(physicalDevice));
+    if (indices.graphicsFamily.has_value())
+    {
+        this->create(physicalDevice, indices.graphicsFamily.value(), {}, nullptr, nullptr);
+    }
+    else if (indices.computeFamily.has_value())
+    {
+        this->create(physicalDevice, indices.computeFamily.value(), {}, nullptr, nullptr);
+    }
+}
+
+/**
+ * Constructor for <code>LogicalDevice</code> class.
+ * Creates a <code>VkDevice</code> with one queue from the given family and resolves the device's dispatch table.
+ * @param physicalDevice The <code>VkPhysicalDevice</code> to create the device on.
+ * @param queueFamilyIndex The queue family to create the device's queue from.
+ * @param extensions The device extension names to enable.
+ * @param allocator Optional host allocator for the driver's device level allocations. Kept alive until the
+ * <code>VkDevice</code> is destroyed.
+ * @param enabledFeatures Optional features to enable. By default none are.
+ * @param next Optional <code>pNext</code> chain for <code>VkDeviceCreateInfo</code>, e.g. extension feature structs.
+ */
+LogicalDevice::LogicalDevice(VkPhysicalDevice physicalDevice, uint32_t queueFamilyIndex, const std::vector<const char*>& extensions, std::shared_ptr<HostAllocator> allocator, const VkPhysicalDeviceFeatures* enabledFeatures, const void* next)
+    : allocator(std::move(allocator))
+{
     if (physicalDevice != VK_NULL_HANDLE)
     {
-        queues = PhysicalDevice::getQueueFamilyProperties(physicalDevice);
-
-        for (uint32_t i = 0; i < queues.size(); i++)
-        {
-            if (queues[i].queueFlags & VkQueueFlagBits::VK_QUEUE_GRAPHICS_BIT)
-            {
-                indices.graphicsFamily = i;
-            }
-        }
+        this->create(physicalDevice, queueFamilyIndex, extensions, enabledFeatures, next);
     }
+}
+
+/**
+ * Creates the <code>VkDevice</code>, resolves its dispatch table and gets its queue.
+ * @param physicalDevice The <code>VkPhysicalDevice</code> to create the device on.
+ * @param queueFamilyIndex The queue family to create the device's queue from.
+ * @param extensions The device extension names to enable.
+ * @param enabledFeatures The features to enable, or nullptr for none.
+ * @param next The <code>pNext</code> chain of the create info.
+ */
+void LogicalDevice::create(VkPhysicalDevice physicalDevice, uint32_t queueFamilyIndex, const std::vector<const char*>& extensions, const VkPhysicalDeviceFeatures* enabledFeatures, const void* next)
+{
+    this->queueFamilyIndex = queueFamilyIndex;
 
     VkDeviceQueueCreateInfo queueInfo = {};
     queueInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
     queueInfo.pNext = nullptr;
     queueInfo.flags = 0;
-    queueInfo.queueFamilyIndex = indices.graphicsFamily.value();
+    queueInfo.queueFamilyIndex = this->queueFamilyIndex;
     float queuePriorities = 1.0f;
     queueInfo.pQueuePriorities = &queuePriorities;
-    queueInfo.queueCount = 0;
+    queueInfo.queueCount = 1;
 
     VkDeviceCreateInfo createInfo = {};
     createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
-    createInfo.pNext = nullptr;
+    createInfo.pNext = next;
     createInfo.flags = 0;
-    createInfo.queueCreateInfoCount = 0;
-    createInfo.pQueueCreateInfos = nullptr;
+    createInfo.queueCreateInfoCount = 1;
+    createInfo.pQueueCreateInfos = &queueInfo;
     createInfo.enabledLayerCount = 0;
     createInfo.ppEnabledLayerNames = nullptr;
-    createInfo.enabledExtensionCount = 0;
-    createInfo.ppEnabledExtensionNames = nullptr;
-    createInfo.pEnabledFeatures = nullptr;
+    createInfo.enabledExtensionCount = (uint32_t)extensions.size();
+    createInfo.ppEnabledExtensionNames = extensions.data();
+    createInfo.pEnabledFeatures = enabledFeatures;
+
+    if (VKINFO_TRACE_VK(vkCreateDevice, (physicalDevice, &createInfo, this->getAllocationCallbacks(), &this->handle)) != VK_SUCCESS)
+    {
+        this->handle = VK_NULL_HANDLE;
+        return;
+    }
+
+    this->dispatch = VulkanLoader::loadDevice(this->handle);
+    VKINFO_TRACE_VK(this->dispatch.vkGetDeviceQueue, (this->handle, this->queueFamilyIndex, 0, &this->queue));
+}
 
-    vkCreateDevice(physicalDevice, &createInfo, nullptr, &this->handle);
+/**
+ * Class destructor.
+ * Calls <code>vkDestroyDevice</code> on the <code>VkDevice</code>.
+ */
+LogicalDevice::~LogicalDevice()
+{
+    if (this->handle != VK_NULL_HANDLE)
+    {
+        VKINFO_TRACE_VK(this->dispatch.vkDestroyDevice, (this->handle, this->getAllocationCallbacks()));
+        this->handle = VK_NULL_HANDLE;
+    }
+}
+
+/**
+ * Gets the <code>VkDevice</code> handle.
+ * @return the <code>VkDevice</code> handle, or <code>VK_NULL_HANDLE</code> if device creation failed.
+ */
+VkDevice LogicalDevice::getHandle() const
+{
+    return this->handle;
+}
+
+/**
+ * Gets the device's queue.
+ * @return the <code>VkQueue</code>.
+ */
+VkQueue LogicalDevice::getQueue() const
+{
+    return this->queue;
 }
+
+/**
+ * Gets the family index of the device's queue.
+ * @return the queue family index.
+ */
+uint32_t LogicalDevice::getQueueFamilyIndex() const
+{
+    return this->queueFamilyIndex;
+}
+
+/**
+ * Gets the device level dispatch table. Calls through it skip the loader trampoline.
+ * @return the dispatch table.
+ */
+const VulkanLoader::DeviceDispatch& LogicalDevice::getDispatch() const
+{
+    return this->dispatch;
+}
+
+/**
+ * Gets the allocation callbacks the device was created with.
+ * @return the callbacks, or nullptr if the device uses the driver's allocator.
+ */
+const VkAllocationCallbacks* LogicalDevice::getAllocationCallbacks() const
+{
+    return this->allocator != nullptr ? this->allocator->getCallbacks() : nullptr;
+}
\ No newline at end of file
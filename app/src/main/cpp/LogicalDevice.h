@@ -1,13 +1,32 @@
 #pragma once
 
-#define VK_USE_PLATFORM_ANDROID_KHR
-#include "vulkan/vulkan.h"
+#include "HostAllocator.h"
+#include "VulkanLoader.h"
+#include <memory>
+#include <vector>
 
+/**
+ * Wrapper class for a <code>VkDevice</code> with a single queue and its own dispatch table.
+ */
 class LogicalDevice
 {
 public:
     LogicalDevice(VkPhysicalDevice physicalDevice);
+    LogicalDevice(VkPhysicalDevice physicalDevice, uint32_t queueFamilyIndex, const std::vector<const char*>& extensions = {}, std::shared_ptr<HostAllocator> allocator = nullptr, const VkPhysicalDeviceFeatures* enabledFeatures = nullptr, const void* next = nullptr);
+    LogicalDevice(const LogicalDevice& other) = delete;
+    LogicalDevice& operator=(const LogicalDevice& other) = delete;
     ~LogicalDevice();
+    VkDevice getHandle() const;
+    VkQueue getQueue() const;
+    uint32_t getQueueFamilyIndex() const;
+    const VulkanLoader::DeviceDispatch& getDispatch() const;
+    const VkAllocationCallbacks* getAllocationCallbacks() const;
 private:
+    void create(VkPhysicalDevice physicalDevice, uint32_t queueFamilyIndex, const std::vector<const char*>& extensions, const VkPhysicalDeviceFeatures* enabledFeatures, const void* next);
+
     VkDevice handle = VK_NULL_HANDLE;
+    VkQueue queue = VK_NULL_HANDLE;
+    uint32_t queueFamilyIndex = 0;
+    VulkanLoader::DeviceDispatch dispatch = {};
+    std::shared_ptr<HostAllocator> allocator;
 };
\ No newline at end of file
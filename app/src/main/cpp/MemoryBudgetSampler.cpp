@@ -0,0 +1,224 @@
+#include "MemoryBudgetSampler.h"
+#include "InstancePool.h"
+#include "PhysicalDevice.h"
+#include "TimestampCalibration.h"
+#include "Trace.h"
+
+#include <chrono>
+
+namespace
+{
+    /**
+     * Picks the physical device to sample.
+     * @param instance The instance to enumerate.
+     * @param deviceIndex Index into <code>Instance::getPhysicalDevices</code>.
+     * @return the device, or <code>VK_NULL_HANDLE</code> if the index is out of range.
+     */
+    VkPhysicalDevice pickDevice(const std::shared_ptr<Instance>& instance, uint32_t deviceIndex)
+    {
+        if (instance == nullptr)
+        {
+            return VK_NULL_HANDLE;
+        }
+
+        std::vector<VkPhysicalDevice> devices = instance->getPhysicalDevices();
+        return deviceIndex < devices.size() ? devices[deviceIndex] : VK_NULL_HANDLE;
+    }
+}
+
+/**
+ * Creates a sampler for one physical device. <code>vkGetPhysicalDeviceMemoryProperties2</code> comes from a Vulkan 1.1
+ * instance when both the loader and the device support 1.1, and from <code>VK_KHR_get_physical_device_properties2</code>
+ * on a 1.0 instance otherwise. The instance comes from <code>InstancePool</code> and stays alive with the sampler.
+ * @param appName The application name to create the instance with.
+ * @param engineName The engine name to create the instance with.
+ * @param deviceIndex Index of the physical device to sample.
+ * @return the sampler, not yet started, or nullptr if the device does not support <code>VK_EXT_memory_budget</code>.
+ */
+std::unique_ptr<MemoryBudgetSampler> MemoryBudgetSampler::create(const std::string& appName, const std::string& engineName, uint32_t deviceIndex)
+{
+    VKINFO_TRACE_SCOPE("MemoryBudgetSampler::create");
+
+    std::shared_ptr<Instance> instance = InstancePool::acquire(appName, engineName, {}, {}, VK_API_VERSION_1_1);
+    VkPhysicalDevice device = pickDevice(instance, deviceIndex);
+    const char* entryPoint = "vkGetPhysicalDeviceMemoryProperties2";
+
+    if (device == VK_NULL_HANDLE || PhysicalDevice::getDeviceProperties(device).apiVersion < VK_API_VERSION_1_1)
+    {
+        instance = InstancePool::acquire(appName, engineName, {VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME}, {});
+        device = pickDevice(instance, deviceIndex);
+        entryPoint = "vkGetPhysicalDeviceMemoryProperties2KHR";
+    }
+
+    if (device == VK_NULL_HANDLE || !PhysicalDevice::isExtensionSupported(device, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME))
+    {
+        return nullptr;
+    }
+
+    PFN_vkGetPhysicalDeviceMemoryProperties2 getMemoryProperties2 =
+            (PFN_vkGetPhysicalDeviceMemoryProperties2)vkGetInstanceProcAddr(instance->getHandle(), entryPoint);
+    if (getMemoryProperties2 == nullptr)
+    {
+        return nullptr;
+    }
+
+    return std::unique_ptr<MemoryBudgetSampler>(new MemoryBudgetSampler(instance, device, getMemoryProperties2));
+}
+
+MemoryBudgetSampler::MemoryBudgetSampler(std::shared_ptr<Instance> instance, VkPhysicalDevice device, PFN_vkGetPhysicalDeviceMemoryProperties2 getMemoryProperties2)
+    : instance(std::move(instance)), device(device), getMemoryProperties2(getMemoryProperties2),
+      ring(new SpscRingBuffer<Sample, RingCapacity>())
+{
+    this->heapCount = PhysicalDevice::getMemoryProperties(device).memoryHeapCount;
+}
+
+/**
+ * Stops the sampling thread, if it is running.
+ */
+MemoryBudgetSampler::~MemoryBudgetSampler()
+{
+    this->stop();
+}
+
+/**
+ * Starts the sampling thread. Every <code>intervalMs</code> it queries the budget once and pushes one sample per heap.
+ * Ticks are on a fixed grid: a slow query does not push later ticks back, it skips the ones it overran.
+ * @param intervalMs The sampling interval in milliseconds. 0 is treated as 1.
+ * @return false if the sampler is already running.
+ */
+bool MemoryBudgetSampler::start(uint32_t intervalMs)
+{
+    if (this->thread.joinable())
+    {
+        return false;
+    }
+
+    this->intervalMs = intervalMs == 0 ? 1 : intervalMs;
+    this->stopRequested = false;
+    this->thread = std::thread(&MemoryBudgetSampler::run, this);
+    return true;
+}
+
+/**
+ * Stops the sampling thread and waits for it to exit. Samples still in the ring buffer can be drained afterwards.
+ */
+void MemoryBudgetSampler::stop()
+{
+    if (!this->thread.joinable())
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(this->stopMutex);
+        this->stopRequested = true;
+    }
+
+    this->stopCondition.notify_one();
+    this->thread.join();
+}
+
+/**
+ * Whether the sampling thread is running.
+ * @return true between <code>start</code> and <code>stop</code>.
+ */
+bool MemoryBudgetSampler::isRunning() const
+{
+    return this->thread.joinable();
+}
+
+/**
+ * Moves the oldest queued samples into <code>out</code>. Must only be called from one thread at a time.
+ * @param out Destination for at least <code>maxSamples</code> samples.
+ * @param maxSamples The most samples to copy.
+ * @return the number of samples copied.
+ */
+size_t MemoryBudgetSampler::drain(Sample* out, size_t maxSamples)
+{
+    return this->ring->popBatch(out, maxSamples);
+}
+
+/**
+ * Gets how many heaps every tick reports.
+ * @return the <code>memoryHeapCount</code> of the device.
+ */
+uint32_t MemoryBudgetSampler::getHeapCount() const
+{
+    return this->heapCount;
+}
+
+/**
+ * Gets how many times the budget has been queried.
+ * @return the number of ticks since construction.
+ */
+uint64_t MemoryBudgetSampler::getTickCount() const
+{
+    return this->tickCount.load(std::memory_order_relaxed);
+}
+
+/**
+ * Gets how many samples were thrown away because the consumer did not drain the ring buffer in time.
+ * @return the number of dropped samples since construction.
+ */
+uint64_t MemoryBudgetSampler::getDroppedCount() const
+{
+    return this->droppedCount.load(std::memory_order_relaxed);
+}
+
+/**
+ * Body of the sampling thread.
+ */
+void MemoryBudgetSampler::run()
+{
+    const std::chrono::milliseconds interval(this->intervalMs);
+    std::chrono::steady_clock::time_point next = std::chrono::steady_clock::now();
+
+    std::unique_lock<std::mutex> lock(this->stopMutex);
+    while (!this->stopRequested)
+    {
+        lock.unlock();
+        this->sampleOnce();
+        lock.lock();
+
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        do
+        {
+            next += interval;
+        } while (next <= now);
+
+        this->stopCondition.wait_until(lock, next, [this]() { return this->stopRequested; });
+    }
+}
+
+/**
+ * Queries the budget once and pushes one sample per heap. Samples that do not fit are counted and dropped.
+ */
+void MemoryBudgetSampler::sampleOnce()
+{
+    VkPhysicalDeviceMemoryBudgetPropertiesEXT budgetProperties = {};
+    budgetProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+
+    VkPhysicalDeviceMemoryProperties2 memoryProperties = {};
+    memoryProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+    memoryProperties.pNext = &budgetProperties;
+
+    this->getMemoryProperties2(this->device, &memoryProperties);
+    const uint64_t timestampNs = TimestampCalibration::hostMonotonicNs();
+
+    for (uint32_t i = 0; i < memoryProperties.memoryProperties.memoryHeapCount; i++)
+    {
+        Sample sample = {};
+        sample.timestampNs = timestampNs;
+        sample.heapIndex = i;
+        sample.heapFlags = memoryProperties.memoryProperties.memoryHeaps[i].flags;
+        sample.usage = budgetProperties.heapUsage[i];
+        sample.budget = budgetProperties.heapBudget[i];
+
+        if (!this->ring->tryPush(sample))
+        {
+            this->droppedCount.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    this->tickCount.fetch_add(1, std::memory_order_relaxed);
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Instance.h"
+#include "SpscRingBuffer.hpp"
+#include "VulkanLoader.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/**
+ * Polls <code>VK_EXT_memory_budget</code> usage and budget of every heap at a fixed rate on a background thread.
+ * Samples go into a lock-free single producer/single consumer ring buffer that one consumer thread drains in batches,
+ * so the sampling thread never waits on the reader.
+ */
+class MemoryBudgetSampler
+{
+public:
+    /**
+     * One heap at one point in time. The layout is fixed (32 bytes, native byte order) because
+     * <code>MemoryBudgetMonitor.java</code> reads it straight out of a direct <code>ByteBuffer</code>.
+     */
+    struct Sample
+    {
+        uint64_t timestampNs;
+        uint32_t heapIndex;
+        uint32_t heapFlags;
+        uint64_t usage;
+        uint64_t budget;
+    };
+
+    static_assert(sizeof(Sample) == 32, "Sample layout is shared with MemoryBudgetMonitor.java");
+
+    static constexpr size_t RingCapacity = 4096;
+
+    static std::unique_ptr<MemoryBudgetSampler> create(const std::string& appName, const std::string& engineName, uint32_t deviceIndex);
+
+    MemoryBudgetSampler(const MemoryBudgetSampler& other) = delete;
+    MemoryBudgetSampler& operator=(const MemoryBudgetSampler& other) = delete;
+    ~MemoryBudgetSampler();
+
+    bool start(uint32_t intervalMs);
+    void stop();
+    bool isRunning() const;
+    size_t drain(Sample* out, size_t maxSamples);
+    uint32_t getHeapCount() const;
+    uint64_t getTickCount() const;
+    uint64_t getDroppedCount() const;
+
+private:
+    MemoryBudgetSampler(std::shared_ptr<Instance> instance, VkPhysicalDevice device, PFN_vkGetPhysicalDeviceMemoryProperties2 getMemoryProperties2);
+    void run();
+    void sampleOnce();
+
+    std::shared_ptr<Instance> instance;
+    VkPhysicalDevice device = VK_NULL_HANDLE;
+    PFN_vkGetPhysicalDeviceMemoryProperties2 getMemoryProperties2 = nullptr;
+    uint32_t heapCount = 0;
+    uint32_t intervalMs = 0;
+
+    std::unique_ptr<SpscRingBuffer<Sample, RingCapacity>> ring;
+    std::atomic<uint64_t> tickCount{0};
+    std::atomic<uint64_t> droppedCount{0};
+
+    std::thread thread;
+    std::mutex stopMutex;
+    std::condition_variable stopCondition;
+    bool stopRequested = false;
+};
@@ -0,0 +1,212 @@
+#include "MemoryTypeSelector.h"
+#include "PhysicalDevice.h"
+#include "QueueTopology.h"
+#include "Trace.h"
+#include <algorithm>
+
+namespace
+{
+    constexpr uint8_t NoType = 0xff;
+
+    inline uint32_t countBits(uint32_t value)
+    {
+        return (uint32_t)__builtin_popcount(value);
+    }
+}
+
+/**
+ * Builds the lookup tables.
+ * @param memoryProperties The memory properties of the device.
+ * @param typeBandwidth Optional measured bandwidth per memory type (see <code>measureBandwidth</code>). Types that
+ * match the flags equally well are ranked by it before heap size.
+ */
+MemoryTypeSelector::MemoryTypeSelector(const VkPhysicalDeviceMemoryProperties& memoryProperties, const std::vector<double>& typeBandwidth)
+    : memoryProperties(memoryProperties), typeBandwidth(typeBandwidth)
+{
+    VKINFO_TRACE_FUNCTION();
+
+    const uint32_t typeCount = std::min<uint32_t>(memoryProperties.memoryTypeCount, VK_MAX_MEMORY_TYPES);
+    this->typeBandwidth.resize(typeCount, 0.0);
+
+    for (VkMemoryPropertyFlags required = 0; required < TableSize; required++)
+    {
+        for (uint32_t type = 0; type < typeCount; type++)
+        {
+            if ((memoryProperties.memoryTypes[type].propertyFlags & required) == required)
+            {
+                this->supported[required] |= 1u << type;
+            }
+        }
+    }
+
+    for (VkMemoryPropertyFlags preferred = 0; preferred < TableSize; preferred++)
+    {
+        uint8_t* ranking = this->order[preferred];
+        for (uint32_t type = 0; type < VK_MAX_MEMORY_TYPES; type++)
+        {
+            ranking[type] = type < typeCount ? (uint8_t)type : NoType;
+        }
+
+        std::stable_sort(ranking, ranking + typeCount, [this, preferred](uint8_t a, uint8_t b)
+        {
+            return this->isBetter(a, b, preferred);
+        });
+
+        for (VkMemoryPropertyFlags required = 0; required < TableSize; required++)
+        {
+            this->best[required][preferred] = NoType;
+            for (uint32_t rank = 0; rank < typeCount; rank++)
+            {
+                if (this->supported[required] & (1u << ranking[rank]))
+                {
+                    this->best[required][preferred] = ranking[rank];
+                    break;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Orders two memory types for a set of preferred flags: more preferred flags first, then fewer flags that were not
+ * asked for (a host visible type is a worse pick for device only data, and so on), then higher measured bandwidth,
+ * then the larger heap.
+ * @return true if <code>type</code> should be picked over <code>other</code>.
+ */
+bool MemoryTypeSelector::isBetter(uint32_t type, uint32_t other, VkMemoryPropertyFlags preferred) const
+{
+    const VkMemoryType& a = this->memoryProperties.memoryTypes[type];
+    const VkMemoryType& b = this->memoryProperties.memoryTypes[other];
+
+    uint32_t preferredA = countBits(a.propertyFlags & preferred);
+    uint32_t preferredB = countBits(b.propertyFlags & preferred);
+    if (preferredA != preferredB)
+    {
+        return preferredA > preferredB;
+    }
+
+    uint32_t extraA = countBits(a.propertyFlags & ~preferred);
+    uint32_t extraB = countBits(b.propertyFlags & ~preferred);
+    if (extraA != extraB)
+    {
+        return extraA < extraB;
+    }
+
+    if (this->typeBandwidth[type] != this->typeBandwidth[other])
+    {
+        return this->typeBandwidth[type] > this->typeBandwidth[other];
+    }
+
+    return this->memoryProperties.memoryHeaps[a.heapIndex].size > this->memoryProperties.memoryHeaps[b.heapIndex].size;
+}
+
+/**
+ * Picks the memory type to allocate from.
+ * @param memoryTypeBits The allowed types, from <code>VkMemoryRequirements</code>.
+ * @param required Flags the type must have.
+ * @param preferred Flags the type should have if possible.
+ * @return the memory type index, or <code>UINT32_MAX</code> if no allowed type has the required flags.
+ */
+uint32_t MemoryTypeSelector::find(uint32_t memoryTypeBits, VkMemoryPropertyFlags required, VkMemoryPropertyFlags preferred) const
+{
+    if (((required | preferred) & ~TableFlags) != 0)
+    {
+        return this->findSlow(memoryTypeBits, required, preferred);
+    }
+
+    const uint32_t candidates = this->supported[required] & memoryTypeBits;
+    if (candidates == 0)
+    {
+        return UINT32_MAX;
+    }
+
+    // The best type overall is usually allowed; otherwise take the first allowed type in ranked order.
+    const uint32_t first = this->best[required][preferred];
+    if (candidates & (1u << first))
+    {
+        return first;
+    }
+
+    for (uint32_t rank = 0; rank < this->typeBandwidth.size(); rank++)
+    {
+        if (candidates & (1u << this->order[preferred][rank]))
+        {
+            return this->order[preferred][rank];
+        }
+    }
+
+    return UINT32_MAX;
+}
+
+/**
+ * Lookup for flags outside <code>TableFlags</code> (e.g. <code>VK_MEMORY_PROPERTY_DEVICE_COHERENT_BIT_AMD</code>).
+ */
+uint32_t MemoryTypeSelector::findSlow(uint32_t memoryTypeBits, VkMemoryPropertyFlags required, VkMemoryPropertyFlags preferred) const
+{
+    uint32_t found = UINT32_MAX;
+    for (uint32_t type = 0; type < this->typeBandwidth.size(); type++)
+    {
+        if ((memoryTypeBits & (1u << type)) == 0 ||
+            (this->memoryProperties.memoryTypes[type].propertyFlags & required) != required)
+        {
+            continue;
+        }
+
+        if (found == UINT32_MAX || this->isBetter(type, found, preferred))
+        {
+            found = type;
+        }
+    }
+
+    return found;
+}
+
+/**
+ * Gets every type having the required flags, best first.
+ */
+std::vector<uint32_t> MemoryTypeSelector::getRanking(VkMemoryPropertyFlags required, VkMemoryPropertyFlags preferred) const
+{
+    std::vector<uint32_t> ranking;
+    uint32_t remaining = UINT32_MAX;
+    for (uint32_t type = this->find(remaining, required, preferred); type != UINT32_MAX; type = this->find(remaining, required, preferred))
+    {
+        ranking.push_back(type);
+        remaining &= ~(1u << type);
+    }
+
+    return ranking;
+}
+
+const VkPhysicalDeviceMemoryProperties& MemoryTypeSelector::getMemoryProperties() const
+{
+    return this->memoryProperties;
+}
+
+/**
+ * Measures how fast a queue family copies between two buffers in each memory type.
+ * @param device The <code>VkPhysicalDevice</code>.
+ * @param familyIndex The queue family to copy on.
+ * @param copySize The size of each copy in bytes.
+ * @param copyCount The number of copies per measurement.
+ * @return the bandwidth in GB/s per memory type, 0 for types that buffers cannot use or that failed to measure.
+ */
+std::vector<double> MemoryTypeSelector::measureBandwidth(VkPhysicalDevice device, uint32_t familyIndex, VkDeviceSize copySize, uint32_t copyCount)
+{
+    VKINFO_TRACE_FUNCTION();
+
+    VkPhysicalDeviceMemoryProperties memoryProperties = PhysicalDevice::getMemoryProperties(device);
+    std::vector<double> bandwidth(memoryProperties.memoryTypeCount, 0.0);
+    for (uint32_t type = 0; type < memoryProperties.memoryTypeCount; type++)
+    {
+        // Protected memory needs protected buffers and queues; lazily allocated memory cannot back buffers.
+        if (memoryProperties.memoryTypes[type].propertyFlags & (VK_MEMORY_PROPERTY_PROTECTED_BIT | VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT))
+        {
+            continue;
+        }
+
+        QueueTopology::CopyThroughput throughput = QueueTopology::measureCopyThroughput(device, familyIndex, copySize, copyCount, type);
+        bandwidth[type] = throughput.measured ? throughput.gigabytesPerSecond : 0.0;
+    }
+
+    return bandwidth;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "VulkanLoader.h"
+#include <vector>
+
+/**
+ * Answers "which memory type for these <code>memoryTypeBits</code>, required and preferred property flags" with
+ * tables built once per device. For every combination of the six core property flags it keeps the mask of types
+ * having all required flags, a ranked type order per preferred combination and the best type per required and
+ * preferred pair, so a lookup is a table access and a mask in the common case.
+ */
+class MemoryTypeSelector
+{
+public:
+    /**
+     * Property flags the tables cover: device local, host visible, host coherent, host cached, lazily allocated and
+     * protected. Lookups with other flags fall back to scoring every type.
+     */
+    constexpr static VkMemoryPropertyFlags TableFlags = 0x3f;
+    constexpr static uint32_t TableSize = TableFlags + 1;
+
+    MemoryTypeSelector(const VkPhysicalDeviceMemoryProperties& memoryProperties, const std::vector<double>& typeBandwidth = {});
+
+    uint32_t find(uint32_t memoryTypeBits, VkMemoryPropertyFlags required, VkMemoryPropertyFlags preferred = 0) const;
+    std::vector<uint32_t> getRanking(VkMemoryPropertyFlags required, VkMemoryPropertyFlags preferred) const;
+    const VkPhysicalDeviceMemoryProperties& getMemoryProperties() const;
+
+    static std::vector<double> measureBandwidth(VkPhysicalDevice device, uint32_t familyIndex, VkDeviceSize copySize, uint32_t copyCount);
+
+private:
+    bool isBetter(uint32_t type, uint32_t other, VkMemoryPropertyFlags preferred) const;
+    uint32_t findSlow(uint32_t memoryTypeBits, VkMemoryPropertyFlags required, VkMemoryPropertyFlags preferred) const;
+
+    VkPhysicalDeviceMemoryProperties memoryProperties = {};
+    std::vector<double> typeBandwidth;
+    uint32_t supported[TableSize] = {};
+    uint8_t order[TableSize][VK_MAX_MEMORY_TYPES] = {};
+    uint8_t best[TableSize][TableSize] = {};
+};
@@ -0,0 +1,128 @@
+#include "MurmurHash3.h"
+#include <cstring>
+
+namespace
+{
+    constexpr uint64_t C1 = 0x87c37b91114253d5ull;
+    constexpr uint64_t C2 = 0x4cf5ad432745937full;
+
+    inline uint64_t rotateLeft(uint64_t value, int bits)
+    {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+    inline uint64_t finalMix(uint64_t k)
+    {
+        k ^= k >> 33;
+        k *= 0xff51afd7ed558ccdull;
+        k ^= k >> 33;
+        k *= 0xc4ceb9fe1a85ec53ull;
+        k ^= k >> 33;
+        return k;
+    }
+
+    inline uint64_t loadBlock(const uint8_t* bytes)
+    {
+        uint64_t value;
+        memcpy(&value, bytes, sizeof(value));
+        return value;
+    }
+}
+
+namespace MurmurHash3
+{
+    /**
+     * Hashes a buffer with MurmurHash3_x64_128. The result matches the reference implementation on little endian
+     * hosts, with <code>low</code> holding the first 64-bit word of its output.
+     * @param data The bytes to hash.
+     * @param length The number of bytes.
+     * @param seed The seed.
+     * @return the hash.
+     */
+    Hash128 hash128(const void* data, size_t length, uint32_t seed)
+    {
+        const uint8_t* bytes = (const uint8_t*)data;
+        const size_t blockCount = length / 16;
+
+        uint64_t h1 = seed;
+        uint64_t h2 = seed;
+
+        for (size_t i = 0; i < blockCount; i++)
+        {
+            uint64_t k1 = loadBlock(bytes + i * 16);
+            uint64_t k2 = loadBlock(bytes + i * 16 + 8);
+
+            k1 *= C1;
+            k1 = rotateLeft(k1, 31);
+            k1 *= C2;
+            h1 ^= k1;
+
+            h1 = rotateLeft(h1, 27);
+            h1 += h2;
+            h1 = h1 * 5 + 0x52dce729;
+
+            k2 *= C2;
+            k2 = rotateLeft(k2, 33);
+            k2 *= C1;
+            h2 ^= k2;
+
+            h2 = rotateLeft(h2, 31);
+            h2 += h1;
+            h2 = h2 * 5 + 0x38495ab5;
+        }
+
+        const uint8_t* tail = bytes + blockCount * 16;
+        uint64_t k1 = 0;
+        uint64_t k2 = 0;
+
+        switch (length & 15)
+        {
+            case 15: k2 ^= (uint64_t)tail[14] << 48; // fall through
+            case 14: k2 ^= (uint64_t)tail[13] << 40; // fall through
+            case 13: k2 ^= (uint64_t)tail[12] << 32; // fall through
+            case 12: k2 ^= (uint64_t)tail[11] << 24; // fall through
+            case 11: k2 ^= (uint64_t)tail[10] << 16; // fall through
+            case 10: k2 ^= (uint64_t)tail[9] << 8;   // fall through
+            case 9:
+                k2 ^= (uint64_t)tail[8];
+                k2 *= C2;
+                k2 = rotateLeft(k2, 33);
+                k2 *= C1;
+                h2 ^= k2;
+                // fall through
+            case 8: k1 ^= (uint64_t)tail[7] << 56; // fall through
+            case 7: k1 ^= (uint64_t)tail[6] << 48; // fall through
+            case 6: k1 ^= (uint64_t)tail[5] << 40; // fall through
+            case 5: k1 ^= (uint64_t)tail[4] << 32; // fall through
+            case 4: k1 ^= (uint64_t)tail[3] << 24; // fall through
+            case 3: k1 ^= (uint64_t)tail[2] << 16; // fall through
+            case 2: k1 ^= (uint64_t)tail[1] << 8;  // fall through
+            case 1:
+                k1 ^= (uint64_t)tail[0];
+                k1 *= C1;
+                k1 = rotateLeft(k1, 31);
+                k1 *= C2;
+                h1 ^= k1;
+                break;
+            default:
+                break;
+        }
+
+        h1 ^= (uint64_t)length;
+        h2 ^= (uint64_t)length;
+
+        h1 += h2;
+        h2 += h1;
+
+        h1 = finalMix(h1);
+        h2 = finalMix(h2);
+
+        h1 += h2;
+        h2 += h1;
+
+        Hash128 hash;
+        hash.low = h1;
+        hash.high = h2;
+        return hash;
+    }
+}
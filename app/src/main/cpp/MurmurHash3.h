@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * MurmurHash3_x64_128: a fast non-cryptographic 128-bit hash, used to content-address capability snapshots.
+ */
+namespace MurmurHash3
+{
+    struct Hash128
+    {
+        uint64_t low = 0;
+        uint64_t high = 0;
+
+        bool operator==(const Hash128& other) const
+        {
+            return this->low == other.low && this->high == other.high;
+        }
+
+        bool operator!=(const Hash128& other) const
+        {
+            return !(*this == other);
+        }
+    };
+
+    /**
+     * Hash functor for unordered containers keyed by <code>Hash128</code>. The bits are already well mixed, so the
+     * low half is used as is.
+     */
+    struct Hasher
+    {
+        size_t operator()(const Hash128& hash) const
+        {
+            return (size_t)hash.low;
+        }
+    };
+
+    Hash128 hash128(const void* data, size_t length, uint32_t seed = 0);
+}
@@ -1,4 +1,6 @@
 #include "PhysicalDevice.h"
+#include "Trace.h"
+#include <cstring>
 
 namespace PhysicalDevice
 {
@@ -8,7 +10,7 @@ namespace PhysicalDevice
 
         if (device != VK_NULL_HANDLE)
         {
-            vkGetPhysicalDeviceProperties(device, &deviceProperties);
+            VKINFO_TRACE_VK(vkGetPhysicalDeviceProperties, (device, &deviceProperties));
         }
 
         return deviceProperties;
@@ -20,7 +22,7 @@ namespace PhysicalDevice
 
         if (device != VK_NULL_HANDLE)
         {
-            vkGetPhysicalDeviceFeatures(device, &deviceFeatures);
+            VKINFO_TRACE_VK(vkGetPhysicalDeviceFeatures, (device, &deviceFeatures));
         }
 
         return deviceFeatures;
@@ -32,12 +34,24 @@ namespace PhysicalDevice
 
         if (device != VK_NULL_HANDLE)
         {
-            vkGetPhysicalDeviceMemoryProperties(device, &memoryProperties);
+            VKINFO_TRACE_VK(vkGetPhysicalDeviceMemoryProperties, (device, &memoryProperties));
         }
 
         return memoryProperties;
     }
 
+    VkFormatProperties getFormatProperties(VkPhysicalDevice device, VkFormat format)
+    {
+        VkFormatProperties formatProperties = {};
+
+        if (device != VK_NULL_HANDLE)
+        {
+            VKINFO_TRACE_VK(vkGetPhysicalDeviceFormatProperties, (device, format, &formatProperties));
+        }
+
+        return formatProperties;
+    }
+
     std::vector<VkQueueFamilyProperties> getQueueFamilyProperties(VkPhysicalDevice device)
     {
         std::vector<VkQueueFamilyProperties> queueFamilyProperties = {};
@@ -45,15 +59,51 @@ namespace PhysicalDevice
         if (device != VK_NULL_HANDLE)
         {
             uint32_t queueFamilyCount = 0;
-            vkGetPhysicalDeviceQueueFamilyProperties(device, &queueFamilyCount, nullptr);
+            VKINFO_TRACE_VK(vkGetPhysicalDeviceQueueFamilyProperties, (device, &queueFamilyCount, nullptr));
 
             queueFamilyProperties.resize(queueFamilyCount);
-            vkGetPhysicalDeviceQueueFamilyProperties(device, &queueFamilyCount, queueFamilyProperties.data());
+            VKINFO_TRACE_VK(vkGetPhysicalDeviceQueueFamilyProperties, (device, &queueFamilyCount, queueFamilyProperties.data()));
         }
 
         return queueFamilyProperties;
     }
 
+    std::vector<VkExtensionProperties> getExtensionProperties(VkPhysicalDevice device)
+    {
+        std::vector<VkExtensionProperties> extensionProperties = {};
+
+        if (device != VK_NULL_HANDLE)
+        {
+            uint32_t extensionCount = 0;
+            if (VKINFO_TRACE_VK(vkEnumerateDeviceExtensionProperties, (device, nullptr, &extensionCount, nullptr)) != VK_SUCCESS)
+            {
+                return {};
+            }
+
+            extensionProperties.resize(extensionCount);
+            if (VKINFO_TRACE_VK(vkEnumerateDeviceExtensionProperties, (device, nullptr, &extensionCount, extensionProperties.data())) != VK_SUCCESS)
+            {
+                return {};
+            }
+            extensionProperties.resize(extensionCount);
+        }
+
+        return extensionProperties;
+    }
+
+    bool isExtensionSupported(VkPhysicalDevice device, const char* extensionName)
+    {
+        for (const VkExtensionProperties& extension : getExtensionProperties(device))
+        {
+            if (strcmp(extension.extensionName, extensionName) == 0)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
     std::vector<std::string> getMemoryHeapFlags(VkMemoryHeapFlags memoryHeap)
     {
         std::vector<std::string> memoryHeapFlags = {};
@@ -1,7 +1,6 @@
 #pragma once
 
-#define VK_USE_PLATFORM_ANDROID_KHR
-#include "vulkan/vulkan.h"
+#include "VulkanLoader.h"
 #include <vector>
 #include <string>
 
@@ -10,6 +9,9 @@ namespace PhysicalDevice
     VkPhysicalDeviceProperties getDeviceProperties(VkPhysicalDevice device);
     VkPhysicalDeviceFeatures getDeviceFeatures(VkPhysicalDevice device);
     VkPhysicalDeviceMemoryProperties getMemoryProperties(VkPhysicalDevice device);
+    VkFormatProperties getFormatProperties(VkPhysicalDevice device, VkFormat format);
     std::vector<VkQueueFamilyProperties> getQueueFamilyProperties(VkPhysicalDevice device);
+    std::vector<VkExtensionProperties> getExtensionProperties(VkPhysicalDevice device);
+    bool isExtensionSupported(VkPhysicalDevice device, const char* extensionName);
     std::vector<std::string> getMemoryHeapFlags(VkMemoryHeapFlags memoryHeap);
 }
\ No newline at end of file
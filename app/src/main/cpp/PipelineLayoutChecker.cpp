@@ -0,0 +1,338 @@
+#include "PipelineLayoutChecker.h"
+#include "Trace.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+    typedef uint32_t U32x8 __attribute__((vector_size(32)));
+
+    constexpr uint32_t VectorsPerRow = PipelineLayoutChecker::Lanes / 8;
+    constexpr uint32_t StageCount = 6;
+    const U32x8 LaneBits = {1u << 0, 1u << 1, 1u << 2, 1u << 3, 1u << 4, 1u << 5, 1u << 6, 1u << 7};
+
+    const char* const LimitNames[] =
+    {
+#define VKINFO_LAYOUT_LIMIT_NAME(member) #member,
+        VKINFO_LAYOUT_LIMITS(VKINFO_LAYOUT_LIMIT_NAME)
+#undef VKINFO_LAYOUT_LIMIT_NAME
+    };
+
+    /**
+     * Which limits a descriptor type counts against, per stage and per layout. Combined image samplers count as both a
+     * sampled image and a sampler, so they have a second per-stage and per-layout pair.
+     */
+    struct DescriptorType
+    {
+        const char* name;
+        int32_t perStage;
+        int32_t perSet;
+        int32_t alsoPerStage;
+        int32_t alsoPerSet;
+        int32_t perSetDynamic;
+        bool resource;
+    };
+
+    const DescriptorType DescriptorTypes[] =
+    {
+        {"sampler", PipelineLayoutChecker::maxPerStageDescriptorSamplers, PipelineLayoutChecker::maxDescriptorSetSamplers, -1, -1, -1, false},
+        {"combined", PipelineLayoutChecker::maxPerStageDescriptorSampledImages, PipelineLayoutChecker::maxDescriptorSetSampledImages, PipelineLayoutChecker::maxPerStageDescriptorSamplers, PipelineLayoutChecker::maxDescriptorSetSamplers, -1, true},
+        {"sampled", PipelineLayoutChecker::maxPerStageDescriptorSampledImages, PipelineLayoutChecker::maxDescriptorSetSampledImages, -1, -1, -1, true},
+        {"storage-image", PipelineLayoutChecker::maxPerStageDescriptorStorageImages, PipelineLayoutChecker::maxDescriptorSetStorageImages, -1, -1, -1, true},
+        {"uniform-texel", PipelineLayoutChecker::maxPerStageDescriptorSampledImages, PipelineLayoutChecker::maxDescriptorSetSampledImages, -1, -1, -1, true},
+        {"storage-texel", PipelineLayoutChecker::maxPerStageDescriptorStorageImages, PipelineLayoutChecker::maxDescriptorSetStorageImages, -1, -1, -1, true},
+        {"uniform", PipelineLayoutChecker::maxPerStageDescriptorUniformBuffers, PipelineLayoutChecker::maxDescriptorSetUniformBuffers, -1, -1, -1, true},
+        {"storage", PipelineLayoutChecker::maxPerStageDescriptorStorageBuffers, PipelineLayoutChecker::maxDescriptorSetStorageBuffers, -1, -1, -1, true},
+        {"uniform-dynamic", PipelineLayoutChecker::maxPerStageDescriptorUniformBuffers, PipelineLayoutChecker::maxDescriptorSetUniformBuffers, -1, -1, PipelineLayoutChecker::maxDescriptorSetUniformBuffersDynamic, true},
+        {"storage-dynamic", PipelineLayoutChecker::maxPerStageDescriptorStorageBuffers, PipelineLayoutChecker::maxDescriptorSetStorageBuffers, -1, -1, PipelineLayoutChecker::maxDescriptorSetStorageBuffersDynamic, true},
+        {"input", PipelineLayoutChecker::maxPerStageDescriptorInputAttachments, PipelineLayoutChecker::maxDescriptorSetInputAttachments, -1, -1, -1, true},
+    };
+
+    /**
+     * Parses the stage letters of a binding into a bit per stage.
+     * @return 0 if a letter is unknown.
+     */
+    uint32_t parseStages(const std::string& text)
+    {
+        const char letters[] = "vtegfc";
+        uint32_t stages = 0;
+        for (char letter : text)
+        {
+            if (letter == 'a')
+            {
+                stages |= (1u << StageCount) - 1;
+                continue;
+            }
+
+            const char* found = strchr(letters, letter);
+            if (letter == '\0' || found == nullptr)
+            {
+                return 0;
+            }
+            stages |= 1u << (found - letters);
+        }
+
+        return stages;
+    }
+
+    /**
+     * Parses a decimal number, rejecting anything but digits.
+     */
+    bool parseCount(const std::string& text, uint32_t& value)
+    {
+        if (text.empty() || text.find_first_not_of("0123456789") != std::string::npos)
+        {
+            return false;
+        }
+
+        value = (uint32_t)strtoul(text.c_str(), nullptr, 10);
+        return true;
+    }
+
+    /**
+     * Splits <code>text</code> at <code>separator</code>.
+     */
+    std::vector<std::string> split(const std::string& text, char separator)
+    {
+        std::vector<std::string> parts;
+        std::stringstream stream(text);
+        std::string part;
+        while (std::getline(stream, part, separator))
+        {
+            parts.push_back(part);
+        }
+
+        return parts;
+    }
+}
+
+/**
+ * Parses one layout line (see the class comment) into its demand vector. Per-stage demands are the maximum over the
+ * stages, per-set demands the total over every set of the layout, as the limits are defined.
+ * @param text The line.
+ * @param layout (OUT param) The layout.
+ * @return false if the line is malformed.
+ */
+bool PipelineLayoutChecker::parseLayout(const std::string& text, Layout& layout)
+{
+    std::vector<std::string> tokens;
+    std::stringstream stream(text);
+    std::string token;
+    while (stream >> token)
+    {
+        tokens.push_back(token);
+    }
+
+    if (tokens.empty())
+    {
+        return false;
+    }
+
+    layout = Layout();
+    layout.name = tokens[0];
+
+    uint32_t perStage[StageCount][LimitCount] = {};
+    uint32_t setCount = 0;
+
+    for (size_t i = 1; i < tokens.size(); i++)
+    {
+        if (tokens[i].compare(0, 5, "push=") == 0)
+        {
+            if (!parseCount(tokens[i].substr(5), layout.demand[maxPushConstantsSize]))
+            {
+                return false;
+            }
+            continue;
+        }
+
+        std::vector<std::string> fields = split(tokens[i], ':');
+        uint32_t set = 0;
+        uint32_t binding = 0;
+        uint32_t count = 0;
+        uint32_t stages = fields.size() == 5 ? parseStages(fields[4]) : 0;
+        if (stages == 0 || !parseCount(fields[0], set) || !parseCount(fields[1], binding) || !parseCount(fields[3], count))
+        {
+            return false;
+        }
+
+        const DescriptorType* type = nullptr;
+        for (const DescriptorType& candidate : DescriptorTypes)
+        {
+            if (fields[2] == candidate.name)
+            {
+                type = &candidate;
+            }
+        }
+
+        if (type == nullptr)
+        {
+            return false;
+        }
+
+        setCount = std::max(setCount, set + 1);
+        layout.demand[type->perSet] += count;
+        if (type->alsoPerSet >= 0)
+        {
+            layout.demand[type->alsoPerSet] += count;
+        }
+        if (type->perSetDynamic >= 0)
+        {
+            layout.demand[type->perSetDynamic] += count;
+        }
+
+        for (uint32_t stage = 0; stage < StageCount; stage++)
+        {
+            if (stages & (1u << stage))
+            {
+                perStage[stage][type->perStage] += count;
+                if (type->alsoPerStage >= 0)
+                {
+                    perStage[stage][type->alsoPerStage] += count;
+                }
+                perStage[stage][maxPerStageResources] += type->resource ? count : 0;
+            }
+        }
+    }
+
+    for (uint32_t stage = 0; stage < StageCount; stage++)
+    {
+        for (uint32_t limit = maxPerStageDescriptorSamplers; limit <= maxPerStageResources; limit++)
+        {
+            layout.demand[limit] = std::max(layout.demand[limit], perStage[stage][limit]);
+        }
+    }
+
+    layout.demand[maxBoundDescriptorSets] = setCount;
+    return true;
+}
+
+/**
+ * Reads a file of layout lines. Blank lines and lines starting with <code>#</code> are skipped.
+ * @param path The file.
+ * @param layouts (OUT param) The layouts are appended to this.
+ * @param errorLine (OUT param) The 1-based number of the first malformed line, or 0.
+ * @return false if the file could not be read or a line is malformed.
+ */
+bool PipelineLayoutChecker::readLayouts(const std::string& path, std::vector<Layout>& layouts, size_t& errorLine)
+{
+    VKINFO_TRACE_FUNCTION();
+
+    errorLine = 0;
+    std::ifstream file(path);
+    if (!file)
+    {
+        return false;
+    }
+
+    std::string line;
+    size_t lineNumber = 0;
+    while (std::getline(file, line))
+    {
+        lineNumber++;
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#')
+        {
+            continue;
+        }
+
+        Layout layout;
+        if (!parseLayout(line, layout))
+        {
+            errorLine = lineNumber;
+            return false;
+        }
+        layouts.push_back(std::move(layout));
+    }
+
+    return true;
+}
+
+/**
+ * Gets the <code>VkPhysicalDeviceLimits</code> member name of a checked limit.
+ */
+const char* PipelineLayoutChecker::getLimitName(uint32_t limit)
+{
+    return limit < LimitCount ? LimitNames[limit] : "unknown";
+}
+
+/**
+ * Adds a device's limits to the matrix. Devices with identical limits share a row whose weight counts them.
+ * @param limits The device limits.
+ * @param weight How many devices the limits stand for.
+ * @return the row of the device.
+ */
+uint32_t PipelineLayoutChecker::addDevice(const VkPhysicalDeviceLimits& limits, uint64_t weight)
+{
+    // Padding lanes never fail: their demand is 0 and their limit the largest value.
+    uint32_t row[Lanes];
+    std::fill(row, row + Lanes, UINT32_MAX);
+#define VKINFO_LAYOUT_LIMIT_ROW(member) row[member] = limits.member;
+    VKINFO_LAYOUT_LIMITS(VKINFO_LAYOUT_LIMIT_ROW)
+#undef VKINFO_LAYOUT_LIMIT_ROW
+
+    auto inserted = this->rows.emplace(MurmurHash3::hash128(row, sizeof(row)), (uint32_t)this->weights.size());
+    if (inserted.second)
+    {
+        this->limits.insert(this->limits.end(), row, row + Lanes);
+        this->weights.push_back(0);
+    }
+
+    this->weights[inserted.first->second] += weight;
+    return inserted.first->second;
+}
+
+size_t PipelineLayoutChecker::getRowCount() const
+{
+    return this->weights.size();
+}
+
+uint64_t PipelineLayoutChecker::getRowWeight(size_t row) const
+{
+    return this->weights[row];
+}
+
+uint32_t PipelineLayoutChecker::getLimit(size_t row, uint32_t limit) const
+{
+    return this->limits[row * Lanes + limit];
+}
+
+/**
+ * Checks every layout against every row of the limits matrix.
+ * @param layouts The layouts.
+ * @return one mask per layout and row, at <code>layout * getRowCount() + row</code>, with bit <code>limit</code>
+ * set for every limit the layout exceeds on those devices.
+ */
+std::vector<uint32_t> PipelineLayoutChecker::check(const std::vector<Layout>& layouts) const
+{
+    VKINFO_TRACE_FUNCTION();
+
+    const size_t rowCount = this->getRowCount();
+    std::vector<uint32_t> violations(layouts.size() * rowCount, 0);
+
+    for (size_t layout = 0; layout < layouts.size(); layout++)
+    {
+        U32x8 demand[VectorsPerRow];
+        memcpy(demand, layouts[layout].demand, sizeof(demand));
+
+        const uint32_t* row = this->limits.data();
+        for (size_t rowIndex = 0; rowIndex < rowCount; rowIndex++, row += Lanes)
+        {
+            // Failing lanes are all ones, so ANDing with each lane's bit and ORing the vectors together leaves the
+            // violation mask spread over eight lanes.
+            U32x8 bits = {};
+            for (uint32_t vector = 0; vector < VectorsPerRow; vector++)
+            {
+                U32x8 limit;
+                memcpy(&limit, row + vector * 8, sizeof(limit));
+                bits |= (U32x8)(demand[vector] > limit) & (LaneBits << (vector * 8));
+            }
+
+            violations[layout * rowCount + rowIndex] = bits[0] | bits[1] | bits[2] | bits[3] | bits[4] | bits[5] | bits[6] | bits[7];
+        }
+    }
+
+    return violations;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "MurmurHash3.h"
+#include "VulkanLoader.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * The <code>VkPhysicalDeviceLimits</code> members a pipeline layout is checked against, as
+ * <code>X(member)</code>.
+ */
+#define VKINFO_LAYOUT_LIMITS(X) \
+    X(maxPerStageDescriptorSamplers) \
+    X(maxPerStageDescriptorUniformBuffers) \
+    X(maxPerStageDescriptorStorageBuffers) \
+    X(maxPerStageDescriptorSampledImages) \
+    X(maxPerStageDescriptorStorageImages) \
+    X(maxPerStageDescriptorInputAttachments) \
+    X(maxPerStageResources) \
+    X(maxDescriptorSetSamplers) \
+    X(maxDescriptorSetUniformBuffers) \
+    X(maxDescriptorSetUniformBuffersDynamic) \
+    X(maxDescriptorSetStorageBuffers) \
+    X(maxDescriptorSetStorageBuffersDynamic) \
+    X(maxDescriptorSetSampledImages) \
+    X(maxDescriptorSetStorageImages) \
+    X(maxDescriptorSetInputAttachments) \
+    X(maxBoundDescriptorSets) \
+    X(maxPushConstantsSize)
+
+/**
+ * Checks pipeline layouts against the descriptor and push constant limits of many devices at once. Each layout is
+ * reduced to a demand vector with one lane per checked limit and each distinct set of device limits is a row of a
+ * limits matrix, so checking is a vector compare of every demand vector against every row.
+ *
+ * Layouts are described one per line:
+ * <pre>
+ * # name [push=bytes] set:binding:type:count:stages ...
+ * shadow_pass push=64 0:0:uniform:1:vf 0:1:combined:4:f 1:0:storage-dynamic:2:c
+ * </pre>
+ * Types are <code>sampler combined sampled storage-image uniform-texel storage-texel uniform storage
+ * uniform-dynamic storage-dynamic input</code>. Stages are letters: <code>v</code>ertex, tessellation control
+ * (<code>t</code>) and evaluation (<code>e</code>), <code>g</code>eometry, <code>f</code>ragment,
+ * <code>c</code>ompute, or <code>a</code> for all of them.
+ */
+class PipelineLayoutChecker
+{
+public:
+    enum Limit : uint32_t
+    {
+#define VKINFO_LAYOUT_LIMIT_ENUM(member) member,
+        VKINFO_LAYOUT_LIMITS(VKINFO_LAYOUT_LIMIT_ENUM)
+#undef VKINFO_LAYOUT_LIMIT_ENUM
+        LimitCount
+    };
+
+    /**
+     * Lanes per demand vector and limits row: the limits padded to whole 8-lane vectors.
+     */
+    constexpr static uint32_t Lanes = (LimitCount + 7) / 8 * 8;
+
+    struct Layout
+    {
+        std::string name;
+        uint32_t demand[Lanes] = {};
+    };
+
+    static bool parseLayout(const std::string& text, Layout& layout);
+    static bool readLayouts(const std::string& path, std::vector<Layout>& layouts, size_t& errorLine);
+    static const char* getLimitName(uint32_t limit);
+
+    uint32_t addDevice(const VkPhysicalDeviceLimits& limits, uint64_t weight = 1);
+    size_t getRowCount() const;
+    uint64_t getRowWeight(size_t row) const;
+    uint32_t getLimit(size_t row, uint32_t limit) const;
+    std::vector<uint32_t> check(const std::vector<Layout>& layouts) const;
+
+private:
+    std::vector<uint32_t> limits;
+    std::vector<uint64_t> weights;
+    std::unordered_map<MurmurHash3::Hash128, uint32_t, MurmurHash3::Hasher> rows;
+};
@@ -0,0 +1,352 @@
+#include "QueueTopology.h"
+#include "LogicalDevice.h"
+#include "MemoryTypeSelector.h"
+#include "PhysicalDevice.h"
+#include "Trace.h"
+#include <chrono>
+
+namespace
+{
+    /**
+     * Device objects used by a copy measurement. Destroyed in reverse creation order through the device's dispatch
+     * table; handles that were never created are skipped.
+     */
+    struct CopyResources
+    {
+        const LogicalDevice* device = nullptr;
+        VkBuffer source = VK_NULL_HANDLE;
+        VkBuffer destination = VK_NULL_HANDLE;
+        VkDeviceMemory sourceMemory = VK_NULL_HANDLE;
+        VkDeviceMemory destinationMemory = VK_NULL_HANDLE;
+        VkCommandPool commandPool = VK_NULL_HANDLE;
+        VkFence fence = VK_NULL_HANDLE;
+
+        ~CopyResources()
+        {
+            VkDevice handle = this->device->getHandle();
+            const VulkanLoader::DeviceDispatch& vk = this->device->getDispatch();
+
+            if (this->fence != VK_NULL_HANDLE)
+            {
+                vk.vkDestroyFence(handle, this->fence, nullptr);
+            }
+
+            if (this->commandPool != VK_NULL_HANDLE)
+            {
+                vk.vkDestroyCommandPool(handle, this->commandPool, nullptr);
+            }
+
+            if (this->destination != VK_NULL_HANDLE)
+            {
+                vk.vkDestroyBuffer(handle, this->destination, nullptr);
+            }
+
+            if (this->source != VK_NULL_HANDLE)
+            {
+                vk.vkDestroyBuffer(handle, this->source, nullptr);
+            }
+
+            if (this->destinationMemory != VK_NULL_HANDLE)
+            {
+                vk.vkFreeMemory(handle, this->destinationMemory, nullptr);
+            }
+
+            if (this->sourceMemory != VK_NULL_HANDLE)
+            {
+                vk.vkFreeMemory(handle, this->sourceMemory, nullptr);
+            }
+        }
+    };
+
+    /**
+     * Creates a transfer source/destination buffer and binds freshly allocated memory to it.
+     * @param memoryTypeIndex The memory type to allocate from, or <code>UINT32_MAX</code> to prefer device local
+     * memory.
+     * @return true on success, false also if the buffer cannot use the requested memory type. Partially created objects are left in <code>buffer</code>/<code>memory</code> for
+     * <code>CopyResources</code> to destroy.
+     */
+    bool createBuffer(const LogicalDevice& device, const MemoryTypeSelector& memoryTypes, uint32_t memoryTypeIndex, VkDeviceSize size, VkBuffer& buffer, VkDeviceMemory& memory)
+    {
+        const VulkanLoader::DeviceDispatch& vk = device.getDispatch();
+
+        VkBufferCreateInfo bufferInfo = {};
+        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferInfo.size = size;
+        bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+        if (vk.vkCreateBuffer(device.getHandle(), &bufferInfo, nullptr, &buffer) != VK_SUCCESS)
+        {
+            buffer = VK_NULL_HANDLE;
+            return false;
+        }
+
+        VkMemoryRequirements requirements = {};
+        vk.vkGetBufferMemoryRequirements(device.getHandle(), buffer, &requirements);
+
+        VkMemoryAllocateInfo allocateInfo = {};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocateInfo.allocationSize = requirements.size;
+        allocateInfo.memoryTypeIndex = memoryTypeIndex == UINT32_MAX
+            ? memoryTypes.find(requirements.memoryTypeBits, 0, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)
+            : memoryTypes.find(requirements.memoryTypeBits & (1u << memoryTypeIndex), 0);
+        if (allocateInfo.memoryTypeIndex == UINT32_MAX)
+        {
+            return false;
+        }
+
+        if (vk.vkAllocateMemory(device.getHandle(), &allocateInfo, nullptr, &memory) != VK_SUCCESS)
+        {
+            memory = VK_NULL_HANDLE;
+            return false;
+        }
+
+        return vk.vkBindBufferMemory(device.getHandle(), buffer, memory, 0) == VK_SUCCESS;
+    }
+}
+
+namespace QueueTopology
+{
+    /**
+     * Classifies every queue family of a physical device.
+     * A family is a dedicated compute family if it supports compute but not graphics, and a dedicated transfer family
+     * if it supports transfer but neither graphics nor compute. Graphics and compute families implicitly support
+     * transfer.
+     * @param device The <code>VkPhysicalDevice</code>.
+     * @return one entry per queue family, in family index order.
+     */
+    std::vector<FamilyInfo> classify(VkPhysicalDevice device)
+    {
+        std::vector<VkQueueFamilyProperties> properties = PhysicalDevice::getQueueFamilyProperties(device);
+
+        std::vector<FamilyInfo> families(properties.size());
+        for (uint32_t i = 0; i < properties.size(); i++)
+        {
+            FamilyInfo& family = families[i];
+            family.index = i;
+            family.flags = properties[i].queueFlags;
+            family.queueCount = properties[i].queueCount;
+            family.timestampValidBits = properties[i].timestampValidBits;
+            family.minImageTransferGranularity = properties[i].minImageTransferGranularity;
+            family.graphics = (family.flags & VK_QUEUE_GRAPHICS_BIT) != 0;
+            family.compute = (family.flags & VK_QUEUE_COMPUTE_BIT) != 0;
+            family.transfer = family.graphics || family.compute || (family.flags & VK_QUEUE_TRANSFER_BIT) != 0;
+            family.dedicatedCompute = family.compute && !family.graphics;
+            family.dedicatedTransfer = family.transfer && !family.graphics && !family.compute;
+        }
+
+        return families;
+    }
+
+    /**
+     * Picks the queue families an engine should use.
+     * Graphics goes to the first graphics family. Compute prefers a dedicated compute family so async compute does
+     * not contend with graphics, and transfer prefers a dedicated transfer family, then a dedicated compute family;
+     * both fall back to the graphics family.
+     * @param families The output of <code>classify</code>.
+     * @return the chosen families. A role is empty if no family supports it.
+     */
+    QueueFamilyIndicies solve(const std::vector<FamilyInfo>& families)
+    {
+        QueueFamilyIndicies indices = {};
+        std::optional<uint32_t> dedicatedCompute;
+        std::optional<uint32_t> dedicatedTransfer;
+
+        for (const FamilyInfo& family : families)
+        {
+            if (family.queueCount == 0)
+            {
+                continue;
+            }
+
+            if (family.graphics && !indices.graphicsFamily.has_value())
+            {
+                indices.graphicsFamily = family.index;
+            }
+
+            if (family.dedicatedCompute && !dedicatedCompute.has_value())
+            {
+                dedicatedCompute = family.index;
+            }
+
+            if (family.dedicatedTransfer && !dedicatedTransfer.has_value())
+            {
+                dedicatedTransfer = family.index;
+            }
+        }
+
+        indices.computeFamily = dedicatedCompute.has_value() ? dedicatedCompute : indices.graphicsFamily;
+        if (!indices.computeFamily.has_value())
+        {
+            for (const FamilyInfo& family : families)
+            {
+                if (family.compute && family.queueCount > 0)
+                {
+                    indices.computeFamily = family.index;
+                    break;
+                }
+            }
+        }
+
+        if (dedicatedTransfer.has_value())
+        {
+            indices.transferFamily = dedicatedTransfer;
+        }
+        else if (dedicatedCompute.has_value())
+        {
+            indices.transferFamily = dedicatedCompute;
+        }
+        else
+        {
+            indices.transferFamily = indices.graphicsFamily.has_value() ? indices.graphicsFamily : indices.computeFamily;
+        }
+
+        return indices;
+    }
+
+    /**
+     * Gets the families worth measuring transfer throughput on: every family with at least one queue that can
+     * execute <code>vkCmdCopyBuffer</code>.
+     * @param families The output of <code>classify</code>.
+     * @return the family indices.
+     */
+    std::vector<uint32_t> getTransferCandidates(const std::vector<FamilyInfo>& families)
+    {
+        std::vector<uint32_t> candidates = {};
+        for (const FamilyInfo& family : families)
+        {
+            if (family.transfer && family.queueCount > 0)
+            {
+                candidates.push_back(family.index);
+            }
+        }
+
+        return candidates;
+    }
+
+    /**
+     * Measures <code>vkCmdCopyBuffer</code> throughput on one queue family.
+     * Creates a device with a single queue from the family, records <code>copyCount</code> copies between two
+     * buffers of <code>copySize</code> bytes (separated by transfer barriers), submits once to warm up and then times
+     * a second submission on the host from <code>vkQueueSubmit</code> until the fence signals.
+     * @param device The <code>VkPhysicalDevice</code>.
+     * @param familyIndex The queue family to measure.
+     * @param copySize The size of each copy in bytes.
+     * @param copyCount The number of copies per submission.
+     * @param memoryTypeIndex The memory type both buffers are allocated from, or <code>UINT32_MAX</code> to prefer
+     * device local memory.
+     * @return the measurement. <code>measured</code> is false if any Vulkan call failed.
+     */
+    CopyThroughput measureCopyThroughput(VkPhysicalDevice device, uint32_t familyIndex, VkDeviceSize copySize, uint32_t copyCount, uint32_t memoryTypeIndex)
+    {
+        VKINFO_TRACE_FUNCTION();
+
+        CopyThroughput throughput = {};
+        throughput.familyIndex = familyIndex;
+
+        LogicalDevice logicalDevice(device, familyIndex);
+        if (logicalDevice.getHandle() == VK_NULL_HANDLE || copyCount == 0)
+        {
+            return throughput;
+        }
+
+        VkDevice handle = logicalDevice.getHandle();
+        const VulkanLoader::DeviceDispatch& vk = logicalDevice.getDispatch();
+        MemoryTypeSelector memoryTypes(PhysicalDevice::getMemoryProperties(device));
+
+        CopyResources resources = {};
+        resources.device = &logicalDevice;
+
+        if (!createBuffer(logicalDevice, memoryTypes, memoryTypeIndex, copySize, resources.source, resources.sourceMemory) ||
+            !createBuffer(logicalDevice, memoryTypes, memoryTypeIndex, copySize, resources.destination, resources.destinationMemory))
+        {
+            return throughput;
+        }
+
+        VkCommandPoolCreateInfo poolInfo = {};
+        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.queueFamilyIndex = familyIndex;
+        if (vk.vkCreateCommandPool(handle, &poolInfo, nullptr, &resources.commandPool) != VK_SUCCESS)
+        {
+            resources.commandPool = VK_NULL_HANDLE;
+            return throughput;
+        }
+
+        VkCommandBufferAllocateInfo allocateInfo = {};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocateInfo.commandPool = resources.commandPool;
+        allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocateInfo.commandBufferCount = 1;
+
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+        if (vk.vkAllocateCommandBuffers(handle, &allocateInfo, &commandBuffer) != VK_SUCCESS)
+        {
+            return throughput;
+        }
+
+        VkCommandBufferBeginInfo beginInfo = {};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        if (vk.vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+        {
+            return throughput;
+        }
+
+        VkBufferCopy region = {};
+        region.size = copySize;
+
+        VkMemoryBarrier barrier = {};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+        for (uint32_t i = 0; i < copyCount; i++)
+        {
+            if (i > 0)
+            {
+                vk.vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+            }
+
+            vk.vkCmdCopyBuffer(commandBuffer, resources.source, resources.destination, 1, &region);
+        }
+
+        if (vk.vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+        {
+            return throughput;
+        }
+
+        VkFenceCreateInfo fenceInfo = {};
+        fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+        if (vk.vkCreateFence(handle, &fenceInfo, nullptr, &resources.fence) != VK_SUCCESS)
+        {
+            resources.fence = VK_NULL_HANDLE;
+            return throughput;
+        }
+
+        VkSubmitInfo submitInfo = {};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &commandBuffer;
+
+        // Warm-up submission: first use pays for memory residency and clock ramp-up.
+        if (vk.vkQueueSubmit(logicalDevice.getQueue(), 1, &submitInfo, resources.fence) != VK_SUCCESS ||
+            vk.vkWaitForFences(handle, 1, &resources.fence, VK_TRUE, UINT64_MAX) != VK_SUCCESS ||
+            vk.vkResetFences(handle, 1, &resources.fence) != VK_SUCCESS)
+        {
+            return throughput;
+        }
+
+        auto begin = std::chrono::steady_clock::now();
+        if (vk.vkQueueSubmit(logicalDevice.getQueue(), 1, &submitInfo, resources.fence) != VK_SUCCESS ||
+            vk.vkWaitForFences(handle, 1, &resources.fence, VK_TRUE, UINT64_MAX) != VK_SUCCESS)
+        {
+            return throughput;
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        throughput.measured = true;
+        throughput.bytesCopied = copySize * copyCount;
+        throughput.seconds = std::chrono::duration<double>(end - begin).count();
+        throughput.gigabytesPerSecond = throughput.seconds > 0.0 ? (double)throughput.bytesCopied / throughput.seconds / 1e9 : 0.0;
+        return throughput;
+    }
+}
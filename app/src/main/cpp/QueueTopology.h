@@ -0,0 +1,46 @@
+#pragma once
+
+#include "QueueFamilyIndicies.hpp"
+#include "VulkanLoader.h"
+#include <vector>
+
+/**
+ * Classifies a physical device's queue families, picks the graphics/compute/transfer assignment an engine should use
+ * and measures how fast each family actually copies buffers.
+ */
+namespace QueueTopology
+{
+    /**
+     * What a single queue family can do.
+     */
+    struct FamilyInfo
+    {
+        uint32_t index = 0;
+        VkQueueFlags flags = 0;
+        uint32_t queueCount = 0;
+        uint32_t timestampValidBits = 0;
+        VkExtent3D minImageTransferGranularity = {};
+        bool graphics = false;
+        bool compute = false;
+        bool transfer = false;
+        bool dedicatedCompute = false;
+        bool dedicatedTransfer = false;
+    };
+
+    /**
+     * Result of a <code>vkCmdCopyBuffer</code> throughput measurement on one queue family.
+     */
+    struct CopyThroughput
+    {
+        uint32_t familyIndex = 0;
+        bool measured = false;
+        VkDeviceSize bytesCopied = 0;
+        double seconds = 0.0;
+        double gigabytesPerSecond = 0.0;
+    };
+
+    std::vector<FamilyInfo> classify(VkPhysicalDevice device);
+    QueueFamilyIndicies solve(const std::vector<FamilyInfo>& families);
+    std::vector<uint32_t> getTransferCandidates(const std::vector<FamilyInfo>& families);
+    CopyThroughput measureCopyThroughput(VkPhysicalDevice device, uint32_t familyIndex, VkDeviceSize copySize, uint32_t copyCount, uint32_t memoryTypeIndex = UINT32_MAX);
+}
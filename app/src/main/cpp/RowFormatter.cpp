@@ -0,0 +1,344 @@
+#include "RowFormatter.h"
+#include <charconv>
+#include <cstring>
+
+namespace
+{
+    /**
+     * Longest <code>std::to_chars</code> output for the value types the formatter appends: 20 digits plus a sign for
+     * 64-bit integers and the shortest round-trip form of a float.
+     */
+    constexpr size_t MaxNumberLength = 24;
+}
+
+/**
+ * Constructor for <code>RowFormatter</code> class. Reserving up front keeps the arena from reallocating while the
+ * rows are rendered; it still grows if the estimate is too small.
+ * @param textCapacity The bytes to reserve for the text arena.
+ * @param rowCapacity The number of rows to reserve.
+ */
+RowFormatter::RowFormatter(size_t textCapacity, size_t rowCapacity)
+{
+    this->text.reserve(textCapacity);
+    this->rows.reserve(rowCapacity);
+}
+
+/**
+ * Starts a group. Every following row belongs to it until the next <code>beginGroup</code>.
+ */
+void RowFormatter::beginGroup(const char* name)
+{
+    Group group = {};
+    group.nameOffset = this->getCursor();
+    this->append(name);
+    group.nameLength = this->getCursor() - group.nameOffset;
+    group.firstRow = (uint32_t)this->rows.size();
+    this->groups.push_back(group);
+}
+
+/**
+ * Starts a row; appends go to its label until <code>beginValue</code>.
+ * @param flags A combination of <code>Flags</code>.
+ */
+void RowFormatter::beginRow(uint32_t flags)
+{
+    const uint32_t cursor = this->getCursor();
+    this->row = {cursor, 0, cursor, 0, cursor, 0, flags, this->groups.empty() ? UINT32_MAX : (uint32_t)this->groups.size() - 1};
+    this->fieldOffset = &this->row.labelOffset;
+    this->fieldLength = &this->row.labelLength;
+}
+
+void RowFormatter::beginValue()
+{
+    this->openField(this->row.valueOffset, this->row.valueLength);
+}
+
+/**
+ * Starts the units of the row's value. Call it right after the value, as the space between them is part of neither.
+ */
+void RowFormatter::beginUnits()
+{
+    this->closeField();
+    this->append(" ", 1);
+    this->openField(this->row.unitsOffset, this->row.unitsLength);
+}
+
+/**
+ * Finishes the row. Fields that were never opened are empty.
+ */
+void RowFormatter::endRow()
+{
+    this->closeField();
+    this->rows.push_back(this->row);
+    if (!this->groups.empty())
+    {
+        this->groups.back().rowCount++;
+    }
+}
+
+void RowFormatter::append(const char* text)
+{
+    this->append(text, strlen(text));
+}
+
+void RowFormatter::append(const char* text, size_t length)
+{
+    this->text.insert(this->text.end(), text, text + length);
+}
+
+void RowFormatter::appendUnsigned(uint64_t value)
+{
+    char* out = this->reserve(MaxNumberLength);
+    this->commit(std::to_chars(out, out + MaxNumberLength, value).ptr);
+}
+
+void RowFormatter::appendSigned(int64_t value)
+{
+    char* out = this->reserve(MaxNumberLength);
+    this->commit(std::to_chars(out, out + MaxNumberLength, value).ptr);
+}
+
+/**
+ * Appends the shortest representation that reads back as the same float.
+ */
+void RowFormatter::appendFloat(float value)
+{
+    char* out = this->reserve(MaxNumberLength);
+    this->commit(std::to_chars(out, out + MaxNumberLength, value).ptr);
+}
+
+void RowFormatter::appendHex(uint32_t value)
+{
+    char* out = this->reserve(MaxHexLength);
+    this->commit(out + formatHex(out, value));
+}
+
+void RowFormatter::appendApiVersion(uint32_t apiVersion)
+{
+    char* out = this->reserve(MaxApiVersionLength);
+    this->commit(out + formatApiVersion(out, apiVersion));
+}
+
+void RowFormatter::addText(const char* label, const char* value)
+{
+    this->beginRow();
+    this->append(label);
+    this->beginValue();
+    this->append(value);
+    this->endRow();
+}
+
+void RowFormatter::addUnsigned(const char* label, uint64_t value, const char* units)
+{
+    this->beginRow();
+    this->append(label);
+    this->beginValue();
+    this->appendUnsigned(value);
+    if (units != nullptr)
+    {
+        this->beginUnits();
+        this->append(units);
+    }
+    this->endRow();
+}
+
+void RowFormatter::addSigned(const char* label, int64_t value, const char* units)
+{
+    this->beginRow();
+    this->append(label);
+    this->beginValue();
+    this->appendSigned(value);
+    if (units != nullptr)
+    {
+        this->beginUnits();
+        this->append(units);
+    }
+    this->endRow();
+}
+
+void RowFormatter::addFloat(const char* label, float value, const char* units)
+{
+    this->beginRow();
+    this->append(label);
+    this->beginValue();
+    this->appendFloat(value);
+    if (units != nullptr)
+    {
+        this->beginUnits();
+        this->append(units);
+    }
+    this->endRow();
+}
+
+/**
+ * Adds a <code>VkBool32</code> as "true" or "false", flagged so the UI can style it without parsing the text.
+ */
+void RowFormatter::addBool(const char* label, VkBool32 value)
+{
+    this->beginRow(value ? Boolean | True : Boolean);
+    this->append(label);
+    this->beginValue();
+    this->append(value ? "true" : "false");
+    this->endRow();
+}
+
+void RowFormatter::addHex(const char* label, uint32_t value)
+{
+    this->beginRow(Hexadecimal);
+    this->append(label);
+    this->beginValue();
+    this->appendHex(value);
+    this->endRow();
+}
+
+void RowFormatter::addApiVersion(const char* label, uint32_t apiVersion)
+{
+    this->beginRow();
+    this->append(label);
+    this->beginValue();
+    this->appendApiVersion(apiVersion);
+    this->endRow();
+}
+
+/**
+ * Adds a fixed-size array limit as "{a, b, c}".
+ */
+void RowFormatter::addList(const char* label, const uint32_t* values, uint32_t count)
+{
+    this->beginRow();
+    this->append(label);
+    this->beginValue();
+    this->append("{", 1);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (i > 0)
+        {
+            this->append(", ", 2);
+        }
+        this->appendUnsigned(values[i]);
+    }
+    this->append("}", 1);
+    this->endRow();
+}
+
+void RowFormatter::addList(const char* label, const float* values, uint32_t count)
+{
+    this->beginRow();
+    this->append(label);
+    this->beginValue();
+    this->append("{", 1);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (i > 0)
+        {
+            this->append(", ", 2);
+        }
+        this->appendFloat(values[i]);
+    }
+    this->append("}", 1);
+    this->endRow();
+}
+
+/**
+ * Gets the UTF-8 text arena every row and group points into. Not NUL terminated.
+ */
+const std::vector<char>& RowFormatter::getText() const
+{
+    return this->text;
+}
+
+const std::vector<RowFormatter::Row>& RowFormatter::getRows() const
+{
+    return this->rows;
+}
+
+const std::vector<RowFormatter::Group>& RowFormatter::getGroups() const
+{
+    return this->groups;
+}
+
+/**
+ * Writes an apiVersion in the format of Variant.Major.Minor.Patch.
+ * @param out Receives at least <code>MaxApiVersionLength</code> bytes. Not NUL terminated.
+ * @return the number of bytes written.
+ */
+size_t RowFormatter::formatApiVersion(char* out, uint32_t apiVersion)
+{
+    char* const begin = out;
+    char* const end = out + MaxApiVersionLength;
+    const uint32_t parts[] =
+    {
+        VK_API_VERSION_VARIANT(apiVersion),
+        VK_API_VERSION_MAJOR(apiVersion),
+        VK_API_VERSION_MINOR(apiVersion),
+        VK_API_VERSION_PATCH(apiVersion)
+    };
+
+    for (size_t i = 0; i < 4; i++)
+    {
+        if (i > 0)
+        {
+            *out++ = '.';
+        }
+        out = std::to_chars(out, end, parts[i]).ptr;
+    }
+
+    return out - begin;
+}
+
+/**
+ * Writes a value in hexadecimal, prefixed with 0x and without leading zeros.
+ * @param out Receives at least <code>MaxHexLength</code> bytes. Not NUL terminated.
+ * @return the number of bytes written.
+ */
+size_t RowFormatter::formatHex(char* out, uint32_t value)
+{
+    out[0] = '0';
+    out[1] = 'x';
+    return std::to_chars(out + 2, out + MaxHexLength, value, 16).ptr - out;
+}
+
+/**
+ * Closes the field being appended to and makes <code>offset</code> and <code>length</code> the current one.
+ */
+void RowFormatter::openField(uint32_t& offset, uint32_t& length)
+{
+    this->closeField();
+    offset = this->getCursor();
+    this->fieldOffset = &offset;
+    this->fieldLength = &length;
+}
+
+void RowFormatter::closeField()
+{
+    if (this->fieldOffset != nullptr)
+    {
+        *this->fieldLength = this->getCursor() - *this->fieldOffset;
+        this->fieldOffset = nullptr;
+        this->fieldLength = nullptr;
+    }
+}
+
+/**
+ * Grows the arena by <code>length</code> bytes for <code>std::to_chars</code> to write into.
+ * @return the first reserved byte. Valid until the next append.
+ */
+char* RowFormatter::reserve(size_t length)
+{
+    const size_t size = this->text.size();
+    this->text.resize(size + length);
+    return this->text.data() + size;
+}
+
+/**
+ * Gives back the reserved bytes past <code>end</code>.
+ */
+void RowFormatter::commit(const char* end)
+{
+    this->text.resize(end - this->text.data());
+}
+
+uint32_t RowFormatter::getCursor() const
+{
+    return (uint32_t)this->text.size();
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "VulkanLoader.h"
+#include <vector>
+
+/**
+ * Renders display rows (label, value, units and flags) into one UTF-8 text arena with <code>std::to_chars</code>.
+ * Rows and groups only hold offsets into the arena, so the whole table crosses JNI as one byte array and two int
+ * arrays (see <code>FormattedRows.java</code>) instead of a Java string per field.
+ *
+ * A row is built by appending to its label, then its value, then optionally its units; the <code>add*</code>
+ * helpers cover the common single-value rows. Units follow their value after one space, so the text from the value to
+ * the end of the units is the row's display value.
+ */
+class RowFormatter
+{
+public:
+    /**
+     * Hints for the UI about the value of a row.
+     */
+    enum Flags : uint32_t
+    {
+        Boolean = 1 << 0,
+        True = 1 << 1,
+        Hexadecimal = 1 << 2,
+        Multiline = 1 << 3
+    };
+
+    /**
+     * One row. The layout is fixed (8 <code>uint32_t</code>) because <code>FormattedRows.java</code> indexes the
+     * rows as a flat int array.
+     */
+    struct Row
+    {
+        uint32_t labelOffset;
+        uint32_t labelLength;
+        uint32_t valueOffset;
+        uint32_t valueLength;
+        uint32_t unitsOffset;
+        uint32_t unitsLength;
+        uint32_t flags;
+        uint32_t group;
+    };
+
+    /**
+     * A named, contiguous range of rows.
+     */
+    struct Group
+    {
+        uint32_t nameOffset;
+        uint32_t nameLength;
+        uint32_t firstRow;
+        uint32_t rowCount;
+    };
+
+    static_assert(sizeof(Row) == 8 * sizeof(uint32_t), "Row layout is shared with FormattedRows.java");
+    static_assert(sizeof(Group) == 4 * sizeof(uint32_t), "Group layout is shared with FormattedRows.java");
+
+    /**
+     * Longest output of <code>formatApiVersion</code> and <code>formatHex</code>.
+     */
+    constexpr static size_t MaxApiVersionLength = 4 * 10 + 3;
+    constexpr static size_t MaxHexLength = 2 + 8;
+
+    explicit RowFormatter(size_t textCapacity = 16 << 10, size_t rowCapacity = 256);
+    RowFormatter(const RowFormatter& other) = delete;
+    RowFormatter& operator=(const RowFormatter& other) = delete;
+
+    void beginGroup(const char* name);
+    void beginRow(uint32_t flags = 0);
+    void beginValue();
+    void beginUnits();
+    void endRow();
+
+    void append(const char* text);
+    void append(const char* text, size_t length);
+    void appendUnsigned(uint64_t value);
+    void appendSigned(int64_t value);
+    void appendFloat(float value);
+    void appendHex(uint32_t value);
+    void appendApiVersion(uint32_t apiVersion);
+
+    void addText(const char* label, const char* value);
+    void addUnsigned(const char* label, uint64_t value, const char* units = nullptr);
+    void addSigned(const char* label, int64_t value, const char* units = nullptr);
+    void addFloat(const char* label, float value, const char* units = nullptr);
+    void addBool(const char* label, VkBool32 value);
+    void addHex(const char* label, uint32_t value);
+    void addApiVersion(const char* label, uint32_t apiVersion);
+    void addList(const char* label, const uint32_t* values, uint32_t count);
+    void addList(const char* label, const float* values, uint32_t count);
+
+    const std::vector<char>& getText() const;
+    const std::vector<Row>& getRows() const;
+    const std::vector<Group>& getGroups() const;
+
+    static size_t formatApiVersion(char* out, uint32_t apiVersion);
+    static size_t formatHex(char* out, uint32_t value);
+
+private:
+    void openField(uint32_t& offset, uint32_t& length);
+    void closeField();
+    char* reserve(size_t length);
+    void commit(const char* end);
+    uint32_t getCursor() const;
+
+    std::vector<char> text;
+    std::vector<Row> rows;
+    std::vector<Group> groups;
+    Row row = {};
+    uint32_t* fieldOffset = nullptr;
+    uint32_t* fieldLength = nullptr;
+};
@@ -0,0 +1,241 @@
+#include "RowSearchIndex.h"
+#include "Trace.h"
+#include <algorithm>
+#include <iterator>
+#include <string_view>
+
+namespace
+{
+    /**
+     * Separates the label, value and units of a row so a query never matches across two fields.
+     */
+    constexpr char FieldSeparator = '\x1f';
+
+    char toLower(char c)
+    {
+        return c >= 'A' && c <= 'Z' ? (char)(c - 'A' + 'a') : c;
+    }
+
+    uint32_t getTrigramKey(const char* text)
+    {
+        return (uint32_t)(uint8_t)text[0] << 16 | (uint32_t)(uint8_t)text[1] << 8 | (uint32_t)(uint8_t)text[2];
+    }
+
+    bool hasSeparator(const char* text)
+    {
+        return text[0] == FieldSeparator || text[1] == FieldSeparator || text[2] == FieldSeparator;
+    }
+}
+
+/**
+ * Constructor for <code>RowSearchIndex</code> class. Indexes every row of <code>formatter</code>.
+ */
+RowSearchIndex::RowSearchIndex(const RowFormatter& formatter)
+{
+    this->build(formatter.getText().data(), formatter.getText().size(), formatter.getRows().data(), formatter.getRows().size(),
+                formatter.getGroups().data(), formatter.getGroups().size());
+}
+
+/**
+ * Constructor for <code>RowSearchIndex</code> class, for rows that were passed through another layer (e.g. back from
+ * Java) in the <code>RowFormatter</code> layout.
+ * @param text The UTF-8 text arena the rows point into.
+ * @param rows The rows to index.
+ * @param groups The groups the rows belong to, to turn row indices into (group, child) pairs.
+ */
+RowSearchIndex::RowSearchIndex(const char* text, size_t textLength, const RowFormatter::Row* rows, size_t rowCount,
+                               const RowFormatter::Group* groups, size_t groupCount)
+{
+    this->build(text, textLength, rows, rowCount, groups, groupCount);
+}
+
+/**
+ * Finds every row whose label, value or units contains <code>query</code>, ignoring ASCII case.
+ * @param query The text typed so far.
+ * @return the matching rows in display order. Valid until the next call.
+ */
+const std::vector<RowSearchIndex::Match>& RowSearchIndex::search(const std::string& query)
+{
+    VKINFO_TRACE_FUNCTION();
+
+    std::string lowered(query);
+    std::transform(lowered.begin(), lowered.end(), lowered.begin(), toLower);
+
+    this->matches.clear();
+    if (lowered.empty())
+    {
+        this->lastQuery.clear();
+        this->lastRows.clear();
+        return this->matches;
+    }
+
+    // Every row containing the new query also contains any substring of it, so the previous matches are enough.
+    std::vector<uint32_t> candidates;
+    if (!this->lastQuery.empty() && lowered.find(this->lastQuery) != std::string::npos)
+    {
+        candidates.swap(this->lastRows);
+    }
+    else
+    {
+        this->findCandidates(lowered, candidates);
+    }
+
+    this->lastRows.clear();
+    for (uint32_t row : candidates)
+    {
+        if (this->contains(row, lowered))
+        {
+            this->lastRows.push_back(row);
+            this->matches.push_back(this->rowMatches[row]);
+        }
+    }
+
+    this->lastQuery.swap(lowered);
+    return this->matches;
+}
+
+size_t RowSearchIndex::getRowCount() const
+{
+    return this->rowMatches.size();
+}
+
+/**
+ * Gets the number of distinct trigrams in the index.
+ */
+size_t RowSearchIndex::getTrigramCount() const
+{
+    return this->trigramKeys.size();
+}
+
+/**
+ * Copies the lowercased text of every row into one haystack and builds the trigram posting lists from it, stored as
+ * sorted keys with offsets into one shared postings array.
+ */
+void RowSearchIndex::build(const char* text, size_t textLength, const RowFormatter::Row* rows, size_t rowCount,
+                           const RowFormatter::Group* groups, size_t groupCount)
+{
+    VKINFO_TRACE_FUNCTION();
+
+    this->haystack.reserve(textLength + rowCount * 2);
+    this->rowOffsets.reserve(rowCount + 1);
+    this->rowMatches.reserve(rowCount);
+
+    for (size_t i = 0; i < rowCount; i++)
+    {
+        const RowFormatter::Row& row = rows[i];
+        this->rowOffsets.push_back((uint32_t)this->haystack.size());
+
+        const uint32_t fields[3][2] =
+        {
+            {row.labelOffset, row.labelLength},
+            {row.valueOffset, row.valueLength},
+            {row.unitsOffset, row.unitsLength}
+        };
+
+        for (size_t field = 0; field < 3; field++)
+        {
+            if (field > 0)
+            {
+                this->haystack.push_back(FieldSeparator);
+            }
+
+            if ((size_t)fields[field][0] + fields[field][1] <= textLength)
+            {
+                for (uint32_t c = 0; c < fields[field][1]; c++)
+                {
+                    this->haystack.push_back(toLower(text[fields[field][0] + c]));
+                }
+            }
+        }
+
+        Match match = {row.group, 0};
+        if (row.group < groupCount && i >= groups[row.group].firstRow)
+        {
+            match.child = (uint32_t)i - groups[row.group].firstRow;
+        }
+        this->rowMatches.push_back(match);
+    }
+    this->rowOffsets.push_back((uint32_t)this->haystack.size());
+
+    // (trigram, row) pairs sorted by trigram then row, so each posting list comes out sorted and deduplicated.
+    std::vector<uint64_t> pairs;
+    pairs.reserve(this->haystack.size());
+    for (size_t row = 0; row < rowCount; row++)
+    {
+        for (uint32_t offset = this->rowOffsets[row]; offset + 3 <= this->rowOffsets[row + 1]; offset++)
+        {
+            const char* trigram = this->haystack.data() + offset;
+            if (!hasSeparator(trigram))
+            {
+                pairs.push_back((uint64_t)getTrigramKey(trigram) << 32 | row);
+            }
+        }
+    }
+
+    std::sort(pairs.begin(), pairs.end());
+    pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+
+    this->postings.reserve(pairs.size());
+    for (uint64_t pair : pairs)
+    {
+        const uint32_t key = (uint32_t)(pair >> 32);
+        if (this->trigramKeys.empty() || this->trigramKeys.back() != key)
+        {
+            this->trigramKeys.push_back(key);
+            this->postingOffsets.push_back((uint32_t)this->postings.size());
+        }
+        this->postings.push_back((uint32_t)pair);
+    }
+    this->postingOffsets.push_back((uint32_t)this->postings.size());
+}
+
+/**
+ * Gets the rows that may contain <code>query</code>: for queries of three or more bytes the intersection of the
+ * posting lists of its trigrams, smallest list first; for shorter ones every row.
+ * @param query The lowercased query.
+ * @param candidates (OUT param) Receives the candidate rows in ascending order.
+ */
+void RowSearchIndex::findCandidates(const std::string& query, std::vector<uint32_t>& candidates) const
+{
+    candidates.clear();
+    if (query.size() < 3)
+    {
+        candidates.resize(this->rowMatches.size());
+        for (uint32_t row = 0; row < (uint32_t)candidates.size(); row++)
+        {
+            candidates[row] = row;
+        }
+        return;
+    }
+
+    std::vector<std::pair<const uint32_t*, const uint32_t*>> lists;
+    for (size_t offset = 0; offset + 3 <= query.size(); offset++)
+    {
+        const uint32_t key = getTrigramKey(query.data() + offset);
+        auto found = std::lower_bound(this->trigramKeys.begin(), this->trigramKeys.end(), key);
+        if (found == this->trigramKeys.end() || *found != key)
+        {
+            return;
+        }
+
+        const size_t index = found - this->trigramKeys.begin();
+        lists.emplace_back(this->postings.data() + this->postingOffsets[index], this->postings.data() + this->postingOffsets[index + 1]);
+    }
+
+    std::sort(lists.begin(), lists.end(), [](const auto& a, const auto& b) { return a.second - a.first < b.second - b.first; });
+
+    candidates.assign(lists[0].first, lists[0].second);
+    std::vector<uint32_t> intersection;
+    for (size_t i = 1; i < lists.size() && !candidates.empty(); i++)
+    {
+        intersection.clear();
+        std::set_intersection(candidates.begin(), candidates.end(), lists[i].first, lists[i].second, std::back_inserter(intersection));
+        candidates.swap(intersection);
+    }
+}
+
+bool RowSearchIndex::contains(uint32_t row, const std::string& query) const
+{
+    std::string_view text(this->haystack.data() + this->rowOffsets[row], this->rowOffsets[row + 1] - this->rowOffsets[row]);
+    return text.find(query) != std::string_view::npos;
+}
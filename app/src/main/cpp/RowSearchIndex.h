@@ -0,0 +1,53 @@
+#pragma once
+
+#include "RowFormatter.h"
+#include <string>
+#include <vector>
+
+/**
+ * Case-insensitive substring search over the labels, values and units of <code>RowFormatter</code> rows. Built once
+ * per session into a trigram inverted index: every three-byte sequence of a row's text maps to the sorted list of
+ * rows containing it. A query of three or more bytes intersects the lists of its trigrams and only verifies the
+ * rows left over; a query that extends the previous one (the usual next keystroke) only re-checks the previous
+ * matches.
+ *
+ * Not thread safe; the incremental state belongs to the one thread typing the query.
+ */
+class RowSearchIndex
+{
+public:
+    /**
+     * A matching row, as indices into the group list and the group's children.
+     */
+    struct Match
+    {
+        uint32_t group;
+        uint32_t child;
+    };
+
+    explicit RowSearchIndex(const RowFormatter& formatter);
+    RowSearchIndex(const char* text, size_t textLength, const RowFormatter::Row* rows, size_t rowCount,
+                   const RowFormatter::Group* groups, size_t groupCount);
+
+    const std::vector<Match>& search(const std::string& query);
+    size_t getRowCount() const;
+    size_t getTrigramCount() const;
+
+private:
+    void build(const char* text, size_t textLength, const RowFormatter::Row* rows, size_t rowCount,
+               const RowFormatter::Group* groups, size_t groupCount);
+    void findCandidates(const std::string& query, std::vector<uint32_t>& candidates) const;
+    bool contains(uint32_t row, const std::string& query) const;
+
+    std::string haystack;
+    std::vector<uint32_t> rowOffsets;
+    std::vector<Match> rowMatches;
+
+    std::vector<uint32_t> trigramKeys;
+    std::vector<uint32_t> postingOffsets;
+    std::vector<uint32_t> postings;
+
+    std::string lastQuery;
+    std::vector<uint32_t> lastRows;
+    std::vector<Match> matches;
+};
@@ -0,0 +1,280 @@
+#include "SnapshotDelta.h"
+#include "MurmurHash3.h"
+
+namespace
+{
+    /**
+     * Bounded output cursor. Writes past the end are dropped and remembered, so callers check once at the end.
+     */
+    struct Writer
+    {
+        uint8_t* data;
+        size_t capacity;
+        size_t size = 0;
+        bool overflow = false;
+
+        void putByte(uint8_t value)
+        {
+            if (this->size < this->capacity)
+            {
+                this->data[this->size++] = value;
+            }
+            else
+            {
+                this->overflow = true;
+            }
+        }
+
+        void putVarint(uint64_t value)
+        {
+            while (value >= 0x80)
+            {
+                this->putByte((uint8_t)(value | 0x80));
+                value >>= 7;
+            }
+            this->putByte((uint8_t)value);
+        }
+
+        void putFixed64(uint64_t value)
+        {
+            for (int i = 0; i < 8; i++)
+            {
+                this->putByte((uint8_t)(value >> (i * 8)));
+            }
+        }
+    };
+
+    /**
+     * Bounded input cursor. Reads past the end or overlong varints set <code>failed</code> and return zero.
+     */
+    struct Reader
+    {
+        const uint8_t* data;
+        size_t size;
+        size_t position = 0;
+        bool failed = false;
+
+        uint8_t getByte()
+        {
+            if (this->position < this->size)
+            {
+                return this->data[this->position++];
+            }
+
+            this->failed = true;
+            return 0;
+        }
+
+        uint64_t getVarint()
+        {
+            uint64_t value = 0;
+            for (int shift = 0; shift < 64; shift += 7)
+            {
+                uint8_t byte = this->getByte();
+                value |= (uint64_t)(byte & 0x7f) << shift;
+                if ((byte & 0x80) == 0)
+                {
+                    return value;
+                }
+            }
+
+            this->failed = true;
+            return 0;
+        }
+
+        uint64_t getFixed64()
+        {
+            uint64_t value = 0;
+            for (int i = 0; i < 8; i++)
+            {
+                value |= (uint64_t)this->getByte() << (i * 8);
+            }
+            return value;
+        }
+    };
+
+    inline uint64_t zigzag(int64_t value)
+    {
+        return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+    }
+
+    inline int64_t unzigzag(uint64_t value)
+    {
+        return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+    }
+
+    /**
+     * Widens a canonical slot to the integer the delta is taken on. <code>I32</code> is sign-extended so small
+     * negative limits stay close to each other; every other kind uses its bits as they are.
+     */
+    inline int64_t toDeltaDomain(CapabilityFields::Kind kind, uint64_t slot)
+    {
+        return kind == CapabilityFields::Kind::I32 ? (int64_t)CapabilityFields::unpackI32(slot) : (int64_t)slot;
+    }
+
+    inline uint64_t fromDeltaDomain(CapabilityFields::Kind kind, int64_t value)
+    {
+        return kind == CapabilityFields::Kind::U64 ? (uint64_t)value : (uint64_t)(uint32_t)value;
+    }
+}
+
+namespace SnapshotDelta
+{
+    /**
+     * Prepares a reference profile. The record is canonicalized and identified by its content hash, which every
+     * encoding carries so it is never decoded against another profile.
+     * @param record The profile, e.g. the most common configuration of a fleet.
+     * @return the reference.
+     */
+    Reference makeReference(const CapabilitySnapshot::Record& record)
+    {
+        Reference reference;
+        reference.record = CapabilitySnapshot::canonicalize(record);
+        reference.id = MurmurHash3::hash128(&reference.record, sizeof(reference.record)).low;
+        return reference;
+    }
+
+    /**
+     * Encodes a record as its difference from the reference.
+     * @param reference The reference profile.
+     * @param record The record to encode. It is encoded in canonical form.
+     * @param buffer Receives the encoding. <code>MaxEncodedSize</code> bytes are always enough.
+     * @param capacity The size of the buffer.
+     * @return the number of bytes written, or 0 if the buffer was too small.
+     */
+    size_t encode(const Reference& reference, const CapabilitySnapshot::Record& record, uint8_t* buffer, size_t capacity)
+    {
+        Writer writer = {buffer, capacity};
+        writer.putByte(FormatVersion);
+        writer.putFixed64(reference.id);
+        writer.putVarint(CapabilityFields::Count);
+
+        const CapabilitySnapshot::Record canonical = CapabilitySnapshot::canonicalize(record);
+
+        // Numeric fields, walked in index order so the gaps are small.
+        int64_t previous = -1;
+        for (uint32_t field = 0; field < CapabilityFields::Count; field++)
+        {
+            const CapabilityFields::Kind kind = CapabilityFields::get(field).kind;
+            if (kind == CapabilityFields::Kind::Bool || canonical.values[field] == reference.record.values[field])
+            {
+                continue;
+            }
+
+            const int64_t delta = toDeltaDomain(kind, canonical.values[field]) - toDeltaDomain(kind, reference.record.values[field]);
+            writer.putVarint((uint64_t)((int64_t)field - previous));
+            writer.putVarint(zigzag(delta));
+            previous = field;
+        }
+        writer.putVarint(0);
+
+        // Boolean fields, one bit each in field order. The mask bytes are only known once complete, so they are
+        // collected on the stack first; trailing zero bytes are not written.
+        uint8_t mask[(CapabilityFields::Count + 7) / 8] = {};
+        uint32_t boolIndex = 0;
+        size_t maskSize = 0;
+        for (uint32_t field = 0; field < CapabilityFields::Count; field++)
+        {
+            if (CapabilityFields::get(field).kind != CapabilityFields::Kind::Bool)
+            {
+                continue;
+            }
+
+            if (canonical.values[field] != reference.record.values[field])
+            {
+                mask[boolIndex / 8] |= (uint8_t)(1u << (boolIndex % 8));
+                maskSize = boolIndex / 8 + 1;
+            }
+            boolIndex++;
+        }
+
+        writer.putVarint(maskSize);
+        for (size_t i = 0; i < maskSize; i++)
+        {
+            writer.putByte(mask[i]);
+        }
+
+        return writer.overflow ? 0 : writer.size;
+    }
+
+    /**
+     * Decodes a record encoded against the reference. Consecutive encodings can be decoded from one buffer by
+     * advancing by the returned size.
+     * @param reference The reference profile the record was encoded against.
+     * @param data The encoding.
+     * @param size The bytes available at <code>data</code>.
+     * @param record (OUT param) The canonical record.
+     * @return the number of bytes consumed, or 0 if the data is truncated, malformed, from a newer format or
+     * encoded against another reference.
+     */
+    size_t decode(const Reference& reference, const uint8_t* data, size_t size, CapabilitySnapshot::Record& record)
+    {
+        Reader reader = {data, size};
+        if (reader.getByte() != FormatVersion || reader.getFixed64() != reference.id)
+        {
+            return 0;
+        }
+
+        // Only encodings of the same field list share a reference id, but check the count anyway.
+        if (reader.getVarint() != CapabilityFields::Count || reader.failed)
+        {
+            return 0;
+        }
+
+        record = reference.record;
+
+        uint64_t field = (uint64_t)-1;
+        for (uint64_t gap = reader.getVarint(); gap != 0 && !reader.failed; gap = reader.getVarint())
+        {
+            field += gap;
+            if (field >= CapabilityFields::Count)
+            {
+                return 0;
+            }
+
+            const CapabilityFields::Kind kind = CapabilityFields::get((uint32_t)field).kind;
+            if (kind == CapabilityFields::Kind::Bool)
+            {
+                return 0;
+            }
+
+            const int64_t value = toDeltaDomain(kind, reference.record.values[field]) + unzigzag(reader.getVarint());
+            record.values[field] = fromDeltaDomain(kind, value);
+        }
+
+        const uint64_t maskSize = reader.getVarint();
+        if (reader.failed || maskSize > (CapabilityFields::Count + 7) / 8)
+        {
+            return 0;
+        }
+
+        uint32_t boolIndex = 0;
+        uint8_t maskByte = 0;
+        for (uint32_t field = 0; field < CapabilityFields::Count && boolIndex < maskSize * 8; field++)
+        {
+            if (CapabilityFields::get(field).kind != CapabilityFields::Kind::Bool)
+            {
+                continue;
+            }
+
+            if (boolIndex % 8 == 0)
+            {
+                maskByte = reader.getByte();
+            }
+
+            if ((maskByte >> (boolIndex % 8)) & 1)
+            {
+                record.values[field] ^= 1;
+            }
+            boolIndex++;
+        }
+
+        // A mask longer than the boolean fields leaves bytes unread; treat it as malformed.
+        if (reader.failed || (boolIndex + 7) / 8 != maskSize)
+        {
+            return 0;
+        }
+
+        return reader.position;
+    }
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "CapabilitySnapshot.h"
+
+/**
+ * Compact encoding of a capability snapshot as its difference from a reference profile, for uploading snapshots
+ * from metered devices. Changed numeric fields are stored as index gaps and zigzag varint deltas; boolean fields
+ * are bit-packed as a mask of the ones that differ. Encoding and decoding work in one pass over caller-provided
+ * buffers and never allocate.
+ *
+ * Layout: version byte, 8 byte reference id, varint field count, then for each changed numeric field a varint gap
+ * from the previous changed field index (starting at -1) and its zigzag varint delta, a 0 gap ending the list, and
+ * finally a varint byte count and the XOR mask of the boolean fields with trailing zero bytes dropped.
+ */
+namespace SnapshotDelta
+{
+    constexpr uint8_t FormatVersion = 1;
+
+    /**
+     * Upper bound of an encoded snapshot: every field changed, with the longest gaps and deltas.
+     */
+    constexpr size_t MaxEncodedSize = 1 + 8 + 2 + CapabilityFields::Count * (2 + 10) + 1 + 2 + (CapabilityFields::Count + 7) / 8;
+
+    struct Reference
+    {
+        CapabilitySnapshot::Record record;
+        uint64_t id = 0;
+    };
+
+    Reference makeReference(const CapabilitySnapshot::Record& record);
+    size_t encode(const Reference& reference, const CapabilitySnapshot::Record& record, uint8_t* buffer, size_t capacity);
+    size_t decode(const Reference& reference, const uint8_t* data, size_t size, CapabilitySnapshot::Record& record);
+}
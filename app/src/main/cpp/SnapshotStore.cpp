@@ -0,0 +1,216 @@
+#include "SnapshotStore.h"
+#include "Trace.h"
+#include <unistd.h>
+
+namespace
+{
+    struct FileHeader
+    {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t fieldCount;
+    };
+
+    /**
+     * Opens a store file for reading and appending, writing the header if it is new and checking it otherwise. A
+     * partial entry at the end, left by a crash during an append, is cut off so later appends stay aligned.
+     * @param entrySize The size of one entry.
+     * @param entryCount (OUT param) The number of complete entries.
+     * @return the file, or nullptr if it could not be opened, truncated or holds another format.
+     */
+    FILE* openStoreFile(const std::string& path, uint32_t magic, uint16_t version, size_t entrySize, size_t& entryCount)
+    {
+        FILE* file = fopen(path.c_str(), "a+b");
+        if (file == nullptr)
+        {
+            return nullptr;
+        }
+
+        const FileHeader expected = {magic, version, (uint16_t)CapabilityFields::Count};
+
+        fseek(file, 0, SEEK_END);
+        long size = ftell(file);
+        bool ok = true;
+        if (size == 0)
+        {
+            ok = fwrite(&expected, sizeof(expected), 1, file) == 1;
+            entryCount = 0;
+        }
+        else
+        {
+            // Hashes are taken over the whole record, so a store cannot mix records with different field counts.
+            FileHeader header = {};
+            fseek(file, 0, SEEK_SET);
+            ok = fread(&header, sizeof(header), 1, file) == 1 &&
+                 header.magic == expected.magic &&
+                 header.version == expected.version &&
+                 header.fieldCount == expected.fieldCount;
+            entryCount = ok ? (size_t)(size - (long)sizeof(header)) / entrySize : 0;
+
+            const long completeSize = (long)sizeof(header) + (long)(entryCount * entrySize);
+            if (ok && completeSize != size)
+            {
+                ok = ftruncate(fileno(file), completeSize) == 0;
+            }
+        }
+
+        if (!ok)
+        {
+            fclose(file);
+            return nullptr;
+        }
+
+        // A stream switching from reading to writing needs a seek in between.
+        fseek(file, 0, SEEK_END);
+        return file;
+    }
+
+    struct ObjectEntry
+    {
+        MurmurHash3::Hash128 hash;
+        CapabilitySnapshot::Record record;
+    };
+}
+
+SnapshotStore::~SnapshotStore()
+{
+    this->close();
+}
+
+/**
+ * Opens a store, creating its files if they do not exist, and loads the hash index of the stored records.
+ * @param path The objects file. The reference log is <code>path.refs</code>.
+ * @return false if either file could not be opened or holds another format or field count.
+ */
+bool SnapshotStore::open(const std::string& path)
+{
+    VKINFO_TRACE_FUNCTION();
+
+    this->close();
+
+    size_t objectCount = 0;
+    size_t refCount = 0;
+    this->objects = openStoreFile(path, ObjectsMagic, FormatVersion, sizeof(ObjectEntry), objectCount);
+    this->refs = openStoreFile(path + ".refs", RefsMagic, FormatVersion, sizeof(MurmurHash3::Hash128), refCount);
+    if (this->objects == nullptr || this->refs == nullptr)
+    {
+        this->close();
+        return false;
+    }
+
+    // Only the hashes are needed for the index; the records are skipped over.
+    this->index.reserve(objectCount);
+    fseek(this->objects, sizeof(FileHeader), SEEK_SET);
+    for (size_t i = 0; i < objectCount; i++)
+    {
+        MurmurHash3::Hash128 hash;
+        if (fread(&hash, sizeof(hash), 1, this->objects) != 1)
+        {
+            this->close();
+            return false;
+        }
+
+        this->index.emplace(hash, (uint32_t)i);
+        fseek(this->objects, sizeof(CapabilitySnapshot::Record), SEEK_CUR);
+    }
+    fseek(this->objects, 0, SEEK_END);
+
+    this->referenceCount = refCount;
+    return true;
+}
+
+/**
+ * Flushes and closes the store files. Safe to call on a store that is not open.
+ * @return false if buffered writes could not be flushed.
+ */
+bool SnapshotStore::close()
+{
+    bool ok = true;
+    if (this->objects != nullptr)
+    {
+        ok = fclose(this->objects) == 0 && ok;
+        this->objects = nullptr;
+    }
+
+    if (this->refs != nullptr)
+    {
+        ok = fclose(this->refs) == 0 && ok;
+        this->refs = nullptr;
+    }
+
+    this->index.clear();
+    this->referenceCount = 0;
+    return ok;
+}
+
+/**
+ * Adds a record to the store. The record is canonicalized and hashed; it is written only if no record with the same
+ * hash is stored yet, while its reference is always logged. Equal hashes are trusted to mean equal records.
+ * @param record The record.
+ * @param hash (OUT param) Optional, receives the content hash.
+ * @return false if the store is not open or a write failed.
+ */
+bool SnapshotStore::ingest(const CapabilitySnapshot::Record& record, MurmurHash3::Hash128* hash)
+{
+    if (this->objects == nullptr || this->refs == nullptr)
+    {
+        return false;
+    }
+
+    ObjectEntry entry;
+    entry.record = CapabilitySnapshot::canonicalize(record);
+    entry.hash = MurmurHash3::hash128(&entry.record, sizeof(entry.record));
+
+    if (hash != nullptr)
+    {
+        *hash = entry.hash;
+    }
+
+    auto inserted = this->index.emplace(entry.hash, (uint32_t)this->index.size());
+    if (inserted.second && fwrite(&entry, sizeof(entry), 1, this->objects) != 1)
+    {
+        this->index.erase(inserted.first);
+        return false;
+    }
+
+    if (fwrite(&entry.hash, sizeof(entry.hash), 1, this->refs) != 1)
+    {
+        return false;
+    }
+
+    this->referenceCount++;
+    return true;
+}
+
+/**
+ * Checks whether a record with the given content hash is stored.
+ */
+bool SnapshotStore::contains(const MurmurHash3::Hash128& hash) const
+{
+    return this->index.find(hash) != this->index.end();
+}
+
+size_t SnapshotStore::getObjectCount() const
+{
+    return this->index.size();
+}
+
+uint64_t SnapshotStore::getReferenceCount() const
+{
+    return this->referenceCount;
+}
+
+/**
+ * Gets the size of both store files, including what is still buffered.
+ */
+uint64_t SnapshotStore::getStoredBytes() const
+{
+    if (this->objects == nullptr || this->refs == nullptr)
+    {
+        return 0;
+    }
+
+    return 2 * sizeof(FileHeader) +
+           this->index.size() * sizeof(ObjectEntry) +
+           this->referenceCount * sizeof(MurmurHash3::Hash128);
+}
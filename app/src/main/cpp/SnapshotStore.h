@@ -0,0 +1,43 @@
+#pragma once
+
+#include "CapabilitySnapshot.h"
+#include "MurmurHash3.h"
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+
+/**
+ * Content-addressed store of capability snapshots. Records are canonicalized and keyed by their 128-bit hash, so a
+ * configuration already in the store costs one hash lookup and a 16 byte reference instead of another full record.
+ *
+ * A store is two files: <code>path</code> holds each distinct record once, prefixed with its hash, and
+ * <code>path.refs</code> logs the hash of every ingested record in order.
+ */
+class SnapshotStore
+{
+public:
+    constexpr static uint32_t ObjectsMagic = 0x4f434b56; // "VKCO"
+    constexpr static uint32_t RefsMagic = 0x52434b56;    // "VKCR"
+    constexpr static uint16_t FormatVersion = 1;
+
+    SnapshotStore() = default;
+    ~SnapshotStore();
+    SnapshotStore(const SnapshotStore&) = delete;
+    SnapshotStore& operator=(const SnapshotStore&) = delete;
+
+    bool open(const std::string& path);
+    bool close();
+
+    bool ingest(const CapabilitySnapshot::Record& record, MurmurHash3::Hash128* hash = nullptr);
+    bool contains(const MurmurHash3::Hash128& hash) const;
+
+    size_t getObjectCount() const;
+    uint64_t getReferenceCount() const;
+    uint64_t getStoredBytes() const;
+
+private:
+    std::unordered_map<MurmurHash3::Hash128, uint32_t, MurmurHash3::Hasher> index;
+    FILE* objects = nullptr;
+    FILE* refs = nullptr;
+    uint64_t referenceCount = 0;
+};
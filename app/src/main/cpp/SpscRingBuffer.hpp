@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Fixed capacity, lock-free ring buffer for exactly one producer thread and one consumer thread.
+ * The producer never blocks: <code>tryPush</code> fails when the buffer is full and the caller decides what to drop.
+ * Head and tail sit on separate cache lines so the two threads do not false share.
+ */
+template <typename T, size_t Capacity>
+class SpscRingBuffer
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    /**
+     * Producer side. Copies <code>value</code> into the buffer.
+     * @return false if the buffer is full.
+     */
+    bool tryPush(const T& value)
+    {
+        const size_t head = this->head.load(std::memory_order_relaxed);
+        if (head - this->cachedTail == Capacity)
+        {
+            this->cachedTail = this->tail.load(std::memory_order_acquire);
+            if (head - this->cachedTail == Capacity)
+            {
+                return false;
+            }
+        }
+
+        this->slots[head & (Capacity - 1)] = value;
+        this->head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Consumer side. Moves up to <code>maxCount</code> of the oldest entries into <code>out</code>.
+     * @return the number of entries copied.
+     */
+    size_t popBatch(T* out, size_t maxCount)
+    {
+        const size_t tail = this->tail.load(std::memory_order_relaxed);
+        size_t available = this->cachedHead - tail;
+        if (available < maxCount)
+        {
+            this->cachedHead = this->head.load(std::memory_order_acquire);
+            available = this->cachedHead - tail;
+        }
+
+        const size_t count = available < maxCount ? available : maxCount;
+        for (size_t i = 0; i < count; i++)
+        {
+            out[i] = this->slots[(tail + i) & (Capacity - 1)];
+        }
+
+        this->tail.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    /**
+     * Approximate number of queued entries. Exact only when called from the producer or consumer with the other idle.
+     */
+    size_t size() const
+    {
+        return this->head.load(std::memory_order_acquire) - this->tail.load(std::memory_order_acquire);
+    }
+
+    static constexpr size_t capacity()
+    {
+        return Capacity;
+    }
+
+private:
+    static constexpr size_t CacheLineSize = 64;
+
+    alignas(CacheLineSize) std::atomic<size_t> head{0};
+    size_t cachedTail = 0;
+    alignas(CacheLineSize) std::atomic<size_t> tail{0};
+    size_t cachedHead = 0;
+    alignas(CacheLineSize) T slots[Capacity];
+};
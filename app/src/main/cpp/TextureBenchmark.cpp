@@ -0,0 +1,1016 @@
+#include "TextureBenchmark.h"
+#include "LogicalDevice.h"
+#include "MemoryTypeSelector.h"
+#include "PhysicalDevice.h"
+#include "QueueTopology.h"
+#include "Trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <functional>
+
+namespace
+{
+    constexpr uint32_t GridExtent = 256;
+    constexpr uint32_t WorkgroupExtent = 8;
+    constexpr uint32_t SamplesPerInvocation = 16;
+    constexpr uint32_t DispatchesPerBatch = 16;
+    constexpr uint64_t SamplesPerBatch = (uint64_t)GridExtent * GridExtent * SamplesPerInvocation * DispatchesPerBatch;
+    constexpr uint32_t UploadCount = 8;
+
+    /**
+     * Hand assembled SPIR-V 1.0 for:
+     * <pre>
+     * #version 450
+     * layout(local_size_x = 8, local_size_y = 8) in;
+     * layout(binding = 0) uniform sampler2D image;
+     * layout(binding = 1) buffer Data { vec4 values[]; };
+     * void main()
+     * {
+     *     vec2 uv = vec2(gl_GlobalInvocationID.xy) * (1.0 / 256.0);
+     *     vec4 sum = vec4(0.0);
+     *     for (uint n = 0; n < 16; n++)
+     *     {
+     *         sum += textureGrad(image, uv, vec2(1.0 / 64.0, 0.0), vec2(0.0, 1.0 / 1024.0));
+     *         uv += vec2(1.0 / 16.0, 1.0 / 32.0);
+     *     }
+     *     values[gl_GlobalInvocationID.y * 256 + gl_GlobalInvocationID.x] = sum;
+     * }
+     * </pre>
+     * On a 1024 texel image the footprint is 16 texels wide and 1 texel high, so without anisotropic filtering the
+     * sampler drops to mip level 4 and with it takes up to 16 taps from level 0.
+     */
+    const uint32_t ShaderCode[] =
+    {
+        0x07230203, 0x00010000, 0x00000000, 0x0000003b, 0x00000000, 0x00020011,
+        0x00000001, 0x0003000e, 0x00000000, 0x00000001, 0x0006000f, 0x00000005,
+        0x00000001, 0x6e69616d, 0x00000000, 0x00000002, 0x00060010, 0x00000001,
+        0x00000011, 0x00000008, 0x00000008, 0x00000001, 0x00040047, 0x00000002,
+        0x0000000b, 0x0000001c, 0x00040047, 0x00000003, 0x00000022, 0x00000000,
+        0x00040047, 0x00000003, 0x00000021, 0x00000000, 0x00040047, 0x00000004,
+        0x00000006, 0x00000010, 0x00050048, 0x00000005, 0x00000000, 0x00000023,
+        0x00000000, 0x00030047, 0x00000005, 0x00000003, 0x00040047, 0x00000006,
+        0x00000022, 0x00000000, 0x00040047, 0x00000006, 0x00000021, 0x00000001,
+        0x00020013, 0x00000007, 0x00030021, 0x00000008, 0x00000007, 0x00040015,
+        0x00000009, 0x00000020, 0x00000000, 0x00030016, 0x0000000a, 0x00000020,
+        0x00020014, 0x0000000b, 0x00040017, 0x0000000c, 0x0000000a, 0x00000002,
+        0x00040017, 0x0000000d, 0x0000000a, 0x00000004, 0x00040017, 0x0000000e,
+        0x00000009, 0x00000003, 0x00090019, 0x0000000f, 0x0000000a, 0x00000001,
+        0x00000000, 0x00000000, 0x00000000, 0x00000001, 0x00000000, 0x0003001b,
+        0x00000010, 0x0000000f, 0x00040020, 0x00000011, 0x00000000, 0x00000010,
+        0x00040020, 0x00000012, 0x00000001, 0x0000000e, 0x0003001d, 0x00000004,
+        0x0000000d, 0x0003001e, 0x00000005, 0x00000004, 0x00040020, 0x00000013,
+        0x00000002, 0x00000005, 0x00040020, 0x00000014, 0x00000002, 0x0000000d,
+        0x0004002b, 0x00000009, 0x00000015, 0x00000000, 0x0004002b, 0x00000009,
+        0x00000016, 0x00000001, 0x0004002b, 0x00000009, 0x00000017, 0x00000010,
+        0x0004002b, 0x00000009, 0x00000018, 0x00000100, 0x0004002b, 0x0000000a,
+        0x00000019, 0x3b800000, 0x0004002b, 0x0000000a, 0x0000001a, 0x00000000,
+        0x0004002b, 0x0000000a, 0x0000001b, 0x3c800000, 0x0004002b, 0x0000000a,
+        0x0000001c, 0x3a800000, 0x0004002b, 0x0000000a, 0x0000001d, 0x3d800000,
+        0x0004002b, 0x0000000a, 0x0000001e, 0x3d000000, 0x0005002c, 0x0000000c,
+        0x0000001f, 0x0000001b, 0x0000001a, 0x0005002c, 0x0000000c, 0x00000020,
+        0x0000001a, 0x0000001c, 0x0005002c, 0x0000000c, 0x00000021, 0x0000001d,
+        0x0000001e, 0x0007002c, 0x0000000d, 0x00000022, 0x0000001a, 0x0000001a,
+        0x0000001a, 0x0000001a, 0x0004003b, 0x00000012, 0x00000002, 0x00000001,
+        0x0004003b, 0x00000011, 0x00000003, 0x00000000, 0x0004003b, 0x00000013,
+        0x00000006, 0x00000002, 0x00050036, 0x00000007, 0x00000001, 0x00000000,
+        0x00000008, 0x000200f8, 0x00000023, 0x0004003d, 0x0000000e, 0x00000024,
+        0x00000002, 0x00050051, 0x00000009, 0x00000025, 0x00000024, 0x00000000,
+        0x00050051, 0x00000009, 0x00000026, 0x00000024, 0x00000001, 0x00040070,
+        0x0000000a, 0x00000027, 0x00000025, 0x00040070, 0x0000000a, 0x00000028,
+        0x00000026, 0x00050050, 0x0000000c, 0x00000029, 0x00000027, 0x00000028,
+        0x0005008e, 0x0000000c, 0x0000002a, 0x00000029, 0x00000019, 0x0004003d,
+        0x00000010, 0x0000002b, 0x00000003, 0x000200f9, 0x0000002c, 0x000200f8,
+        0x0000002c, 0x000700f5, 0x00000009, 0x0000002d, 0x00000015, 0x00000023,
+        0x0000002e, 0x0000002f, 0x000700f5, 0x0000000c, 0x00000030, 0x0000002a,
+        0x00000023, 0x00000031, 0x0000002f, 0x000700f5, 0x0000000d, 0x00000032,
+        0x00000022, 0x00000023, 0x00000033, 0x0000002f, 0x000500b0, 0x0000000b,
+        0x00000034, 0x0000002d, 0x00000017, 0x000400f6, 0x00000035, 0x0000002f,
+        0x00000000, 0x000400fa, 0x00000034, 0x00000036, 0x00000035, 0x000200f8,
+        0x00000036, 0x00080058, 0x0000000d, 0x00000037, 0x0000002b, 0x00000030,
+        0x00000004, 0x0000001f, 0x00000020, 0x00050081, 0x0000000d, 0x00000033,
+        0x00000032, 0x00000037, 0x00050081, 0x0000000c, 0x00000031, 0x00000030,
+        0x00000021, 0x000200f9, 0x0000002f, 0x000200f8, 0x0000002f, 0x00050080,
+        0x00000009, 0x0000002e, 0x0000002d, 0x00000016, 0x000200f9, 0x0000002c,
+        0x000200f8, 0x00000035, 0x00050084, 0x00000009, 0x00000038, 0x00000026,
+        0x00000018, 0x00050080, 0x00000009, 0x00000039, 0x00000038, 0x00000025,
+        0x00060041, 0x00000014, 0x0000003a, 0x00000006, 0x00000015, 0x00000039,
+        0x0003003e, 0x0000003a, 0x00000032, 0x000100fd, 0x00010038
+    };
+
+    /**
+     * A format to measure. Block compressed formats have a block extent above 1; every other format is a block of one
+     * texel.
+     */
+    struct FormatInfo
+    {
+        VkFormat format;
+        const char* name;
+        uint32_t blockExtent;
+        uint32_t blockBytes;
+    };
+
+    const FormatInfo Formats[] =
+    {
+        {VK_FORMAT_R8_UNORM, "R8_UNORM", 1, 1},
+        {VK_FORMAT_R8G8_UNORM, "R8G8_UNORM", 1, 2},
+        {VK_FORMAT_R5G6B5_UNORM_PACK16, "R5G6B5_UNORM_PACK16", 1, 2},
+        {VK_FORMAT_R4G4B4A4_UNORM_PACK16, "R4G4B4A4_UNORM_PACK16", 1, 2},
+        {VK_FORMAT_R8G8B8A8_UNORM, "R8G8B8A8_UNORM", 1, 4},
+        {VK_FORMAT_R8G8B8A8_SRGB, "R8G8B8A8_SRGB", 1, 4},
+        {VK_FORMAT_B8G8R8A8_UNORM, "B8G8R8A8_UNORM", 1, 4},
+        {VK_FORMAT_A2B10G10R10_UNORM_PACK32, "A2B10G10R10_UNORM_PACK32", 1, 4},
+        {VK_FORMAT_B10G11R11_UFLOAT_PACK32, "B10G11R11_UFLOAT_PACK32", 1, 4},
+        {VK_FORMAT_E5B9G9R9_UFLOAT_PACK32, "E5B9G9R9_UFLOAT_PACK32", 1, 4},
+        {VK_FORMAT_R16_SFLOAT, "R16_SFLOAT", 1, 2},
+        {VK_FORMAT_R16G16_SFLOAT, "R16G16_SFLOAT", 1, 4},
+        {VK_FORMAT_R16G16B16A16_SFLOAT, "R16G16B16A16_SFLOAT", 1, 8},
+        {VK_FORMAT_R32_SFLOAT, "R32_SFLOAT", 1, 4},
+        {VK_FORMAT_R32G32_SFLOAT, "R32G32_SFLOAT", 1, 8},
+        {VK_FORMAT_R32G32B32A32_SFLOAT, "R32G32B32A32_SFLOAT", 1, 16},
+        {VK_FORMAT_BC1_RGBA_UNORM_BLOCK, "BC1_RGBA_UNORM_BLOCK", 4, 8},
+        {VK_FORMAT_BC3_UNORM_BLOCK, "BC3_UNORM_BLOCK", 4, 16},
+        {VK_FORMAT_BC7_UNORM_BLOCK, "BC7_UNORM_BLOCK", 4, 16},
+        {VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK, "ETC2_R8G8B8_UNORM_BLOCK", 4, 8},
+        {VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK, "ETC2_R8G8B8A8_UNORM_BLOCK", 4, 16},
+        {VK_FORMAT_ASTC_4x4_UNORM_BLOCK, "ASTC_4x4_UNORM_BLOCK", 4, 16},
+    };
+
+    /**
+     * The largest block of any format in the table. Mip levels start at multiples of it in the staging buffer, so
+     * every copy starts on a whole block and a multiple of 4 bytes.
+     */
+    constexpr VkDeviceSize LevelAlignment = 16;
+
+    uint32_t getLevelCount()
+    {
+        uint32_t levels = 1;
+        while ((TextureBenchmark::ImageExtent >> levels) > 0)
+        {
+            levels++;
+        }
+
+        return levels;
+    }
+
+    /**
+     * Gets the texels per row and column of a mip level.
+     */
+    uint32_t getLevelExtent(uint32_t level)
+    {
+        return std::max(TextureBenchmark::ImageExtent >> level, 1u);
+    }
+
+    /**
+     * Gets the blocks per row and column of a mip level.
+     */
+    uint32_t getLevelBlocks(const FormatInfo& info, uint32_t level)
+    {
+        return (getLevelExtent(level) + info.blockExtent - 1) / info.blockExtent;
+    }
+
+    /**
+     * Gets where each mip level starts in tightly packed image data, with the total size as the last entry.
+     */
+    std::vector<VkDeviceSize> getLevelOffsets(const FormatInfo& info, uint32_t levelCount)
+    {
+        std::vector<VkDeviceSize> offsets(1, 0);
+        for (uint32_t level = 0; level < levelCount; level++)
+        {
+            const VkDeviceSize blocks = getLevelBlocks(info, level);
+            const VkDeviceSize end = offsets.back() + blocks * blocks * info.blockBytes;
+            offsets.push_back((end + LevelAlignment - 1) / LevelAlignment * LevelAlignment);
+        }
+
+        return offsets;
+    }
+
+    /**
+     * Checks that an image of the benchmark's size can be created with a tiling and usage.
+     */
+    bool isImageSupported(VkPhysicalDevice device, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, uint32_t levelCount)
+    {
+        VkImageFormatProperties properties = {};
+        if (VKINFO_TRACE_VK(vkGetPhysicalDeviceImageFormatProperties, (device, format, VK_IMAGE_TYPE_2D, tiling, usage, 0, &properties)) != VK_SUCCESS)
+        {
+            return false;
+        }
+
+        return properties.maxExtent.width >= TextureBenchmark::ImageExtent &&
+               properties.maxExtent.height >= TextureBenchmark::ImageExtent &&
+               properties.maxMipLevels >= levelCount;
+    }
+
+    /**
+     * A buffer and its memory, destroyed through the device's dispatch table.
+     */
+    struct Buffer
+    {
+        const LogicalDevice* device = nullptr;
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        void* mapped = nullptr;
+
+        Buffer() = default;
+        Buffer(const Buffer& other) = delete;
+        Buffer& operator=(const Buffer& other) = delete;
+
+        ~Buffer()
+        {
+            if (this->device == nullptr)
+            {
+                return;
+            }
+
+            const VulkanLoader::DeviceDispatch& vk = this->device->getDispatch();
+            if (this->buffer != VK_NULL_HANDLE)
+            {
+                vk.vkDestroyBuffer(this->device->getHandle(), this->buffer, nullptr);
+            }
+
+            if (this->memory != VK_NULL_HANDLE)
+            {
+                vk.vkFreeMemory(this->device->getHandle(), this->memory, nullptr);
+            }
+        }
+    };
+
+    /**
+     * An image, its memory and a view of every mip level, destroyed through the device's dispatch table.
+     */
+    struct Image
+    {
+        const LogicalDevice* device = nullptr;
+        VkImage image = VK_NULL_HANDLE;
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        VkImageView view = VK_NULL_HANDLE;
+        void* mapped = nullptr;
+        bool coherent = true;
+
+        Image() = default;
+        Image(const Image& other) = delete;
+        Image& operator=(const Image& other) = delete;
+
+        ~Image()
+        {
+            if (this->device == nullptr)
+            {
+                return;
+            }
+
+            VkDevice handle = this->device->getHandle();
+            const VulkanLoader::DeviceDispatch& vk = this->device->getDispatch();
+            if (this->view != VK_NULL_HANDLE)
+            {
+                vk.vkDestroyImageView(handle, this->view, nullptr);
+            }
+
+            if (this->image != VK_NULL_HANDLE)
+            {
+                vk.vkDestroyImage(handle, this->image, nullptr);
+            }
+
+            if (this->memory != VK_NULL_HANDLE)
+            {
+                vk.vkFreeMemory(handle, this->memory, nullptr);
+            }
+        }
+    };
+
+    /**
+     * The sampling pipeline, its output buffer and descriptor set, and the command buffer every submission is recorded
+     * into.
+     */
+    struct Resources
+    {
+        const LogicalDevice* device = nullptr;
+        Buffer output;
+        Buffer staging;
+        VkShaderModule shaderModule = VK_NULL_HANDLE;
+        VkDescriptorSetLayout setLayout = VK_NULL_HANDLE;
+        VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+        VkPipeline pipeline = VK_NULL_HANDLE;
+        VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+        VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+        VkCommandPool commandPool = VK_NULL_HANDLE;
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+        VkFence fence = VK_NULL_HANDLE;
+
+        Resources() = default;
+        Resources(const Resources& other) = delete;
+        Resources& operator=(const Resources& other) = delete;
+
+        ~Resources()
+        {
+            if (this->device == nullptr)
+            {
+                return;
+            }
+
+            VkDevice handle = this->device->getHandle();
+            const VulkanLoader::DeviceDispatch& vk = this->device->getDispatch();
+            vk.vkDeviceWaitIdle(handle);
+
+            if (this->fence != VK_NULL_HANDLE)
+            {
+                vk.vkDestroyFence(handle, this->fence, nullptr);
+            }
+
+            if (this->commandPool != VK_NULL_HANDLE)
+            {
+                vk.vkDestroyCommandPool(handle, this->commandPool, nullptr);
+            }
+
+            if (this->descriptorPool != VK_NULL_HANDLE)
+            {
+                vk.vkDestroyDescriptorPool(handle, this->descriptorPool, nullptr);
+            }
+
+            if (this->pipeline != VK_NULL_HANDLE)
+            {
+                vk.vkDestroyPipeline(handle, this->pipeline, nullptr);
+            }
+
+            if (this->pipelineLayout != VK_NULL_HANDLE)
+            {
+                vk.vkDestroyPipelineLayout(handle, this->pipelineLayout, nullptr);
+            }
+
+            if (this->setLayout != VK_NULL_HANDLE)
+            {
+                vk.vkDestroyDescriptorSetLayout(handle, this->setLayout, nullptr);
+            }
+
+            if (this->shaderModule != VK_NULL_HANDLE)
+            {
+                vk.vkDestroyShaderModule(handle, this->shaderModule, nullptr);
+            }
+        }
+    };
+
+    /**
+     * Binds freshly allocated memory of the best type having the required flags to a buffer or image, mapping it if
+     * it is host visible.
+     * @param requirements The memory requirements of the buffer or image.
+     * @param memory (OUT param) The memory.
+     * @param mapped (OUT param) The mapping, or null if the memory is not host visible.
+     * @param coherent (OUT param) Whether the memory is host coherent.
+     * @return false if no memory type fits or allocation failed.
+     */
+    bool allocateMemory(const LogicalDevice& device, const MemoryTypeSelector& memoryTypes, const VkMemoryRequirements& requirements,
+                        VkMemoryPropertyFlags required, VkMemoryPropertyFlags preferred, VkDeviceMemory& memory, void*& mapped, bool& coherent)
+    {
+        VkDevice handle = device.getHandle();
+        const VulkanLoader::DeviceDispatch& vk = device.getDispatch();
+
+        VkMemoryAllocateInfo allocateInfo = {};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocateInfo.allocationSize = requirements.size;
+        allocateInfo.memoryTypeIndex = memoryTypes.find(requirements.memoryTypeBits, required, preferred);
+        if (allocateInfo.memoryTypeIndex == UINT32_MAX ||
+            vk.vkAllocateMemory(handle, &allocateInfo, nullptr, &memory) != VK_SUCCESS)
+        {
+            memory = VK_NULL_HANDLE;
+            return false;
+        }
+
+        const VkMemoryPropertyFlags flags = memoryTypes.getMemoryProperties().memoryTypes[allocateInfo.memoryTypeIndex].propertyFlags;
+        coherent = (flags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
+        return (flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) == 0 ||
+               vk.vkMapMemory(handle, memory, 0, VK_WHOLE_SIZE, 0, &mapped) == VK_SUCCESS;
+    }
+
+    bool createBuffer(const LogicalDevice& device, const MemoryTypeSelector& memoryTypes, VkDeviceSize size, VkBufferUsageFlags usage,
+                      VkMemoryPropertyFlags required, Buffer& buffer)
+    {
+        VkDevice handle = device.getHandle();
+        const VulkanLoader::DeviceDispatch& vk = device.getDispatch();
+        buffer.device = &device;
+
+        VkBufferCreateInfo bufferInfo = {};
+        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferInfo.size = size;
+        bufferInfo.usage = usage;
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        if (vk.vkCreateBuffer(handle, &bufferInfo, nullptr, &buffer.buffer) != VK_SUCCESS)
+        {
+            buffer.buffer = VK_NULL_HANDLE;
+            return false;
+        }
+
+        VkMemoryRequirements requirements = {};
+        vk.vkGetBufferMemoryRequirements(handle, buffer.buffer, &requirements);
+
+        bool coherent = true;
+        return allocateMemory(device, memoryTypes, requirements, required, 0, buffer.memory, buffer.mapped, coherent) &&
+               vk.vkBindBufferMemory(handle, buffer.buffer, buffer.memory, 0) == VK_SUCCESS;
+    }
+
+    /**
+     * Creates an image of the benchmark's size with a view of all its levels. Linear images get host visible memory
+     * and start out preinitialized, so the host can write them right away; optimal images get device local memory
+     * and are filled by copies.
+     */
+    bool createImage(const LogicalDevice& device, const MemoryTypeSelector& memoryTypes, VkFormat format, VkImageTiling tiling, uint32_t levelCount, Image& image)
+    {
+        VkDevice handle = device.getHandle();
+        const VulkanLoader::DeviceDispatch& vk = device.getDispatch();
+        const bool linear = tiling == VK_IMAGE_TILING_LINEAR;
+        image.device = &device;
+
+        VkImageCreateInfo imageInfo = {};
+        imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageInfo.format = format;
+        imageInfo.extent = {TextureBenchmark::ImageExtent, TextureBenchmark::ImageExtent, 1};
+        imageInfo.mipLevels = levelCount;
+        imageInfo.arrayLayers = 1;
+        imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageInfo.tiling = tiling;
+        imageInfo.usage = linear ? VK_IMAGE_USAGE_SAMPLED_BIT : VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        imageInfo.initialLayout = linear ? VK_IMAGE_LAYOUT_PREINITIALIZED : VK_IMAGE_LAYOUT_UNDEFINED;
+        if (vk.vkCreateImage(handle, &imageInfo, nullptr, &image.image) != VK_SUCCESS)
+        {
+            image.image = VK_NULL_HANDLE;
+            return false;
+        }
+
+        VkMemoryRequirements requirements = {};
+        vk.vkGetImageMemoryRequirements(handle, image.image, &requirements);
+        const VkMemoryPropertyFlags required = linear ? VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT : 0;
+        if (!allocateMemory(device, memoryTypes, requirements, required, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, image.memory, image.mapped, image.coherent) ||
+            vk.vkBindImageMemory(handle, image.image, image.memory, 0) != VK_SUCCESS)
+        {
+            return false;
+        }
+
+        VkImageViewCreateInfo viewInfo = {};
+        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInfo.image = image.image;
+        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.format = format;
+        viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        viewInfo.subresourceRange.levelCount = levelCount;
+        viewInfo.subresourceRange.layerCount = 1;
+        if (vk.vkCreateImageView(handle, &viewInfo, nullptr, &image.view) != VK_SUCCESS)
+        {
+            image.view = VK_NULL_HANDLE;
+            return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * Creates the sampling pipeline, its output buffer and descriptor set, the staging buffer and the command buffer.
+     */
+    bool createResources(const LogicalDevice& device, const MemoryTypeSelector& memoryTypes, uint32_t familyIndex, VkDeviceSize stagingSize, Resources& resources)
+    {
+        VkDevice handle = device.getHandle();
+        const VulkanLoader::DeviceDispatch& vk = device.getDispatch();
+        resources.device = &device;
+
+        const VkDeviceSize outputSize = (VkDeviceSize)GridExtent * GridExtent * 4 * sizeof(float);
+        if (!createBuffer(device, memoryTypes, outputSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, 0, resources.output) ||
+            !createBuffer(device, memoryTypes, stagingSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                          VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, resources.staging))
+        {
+            return false;
+        }
+
+        VkShaderModuleCreateInfo moduleInfo = {};
+        moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+        moduleInfo.codeSize = sizeof(ShaderCode);
+        moduleInfo.pCode = ShaderCode;
+        if (vk.vkCreateShaderModule(handle, &moduleInfo, nullptr, &resources.shaderModule) != VK_SUCCESS)
+        {
+            resources.shaderModule = VK_NULL_HANDLE;
+            return false;
+        }
+
+        VkDescriptorSetLayoutBinding bindings[2] = {};
+        bindings[0].binding = 0;
+        bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        bindings[0].descriptorCount = 1;
+        bindings[0].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        bindings[1].binding = 1;
+        bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[1].descriptorCount = 1;
+        bindings[1].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+        VkDescriptorSetLayoutCreateInfo setLayoutInfo = {};
+        setLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        setLayoutInfo.bindingCount = 2;
+        setLayoutInfo.pBindings = bindings;
+        if (vk.vkCreateDescriptorSetLayout(handle, &setLayoutInfo, nullptr, &resources.setLayout) != VK_SUCCESS)
+        {
+            resources.setLayout = VK_NULL_HANDLE;
+            return false;
+        }
+
+        VkPipelineLayoutCreateInfo pipelineLayoutInfo = {};
+        pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipelineLayoutInfo.setLayoutCount = 1;
+        pipelineLayoutInfo.pSetLayouts = &resources.setLayout;
+        if (vk.vkCreatePipelineLayout(handle, &pipelineLayoutInfo, nullptr, &resources.pipelineLayout) != VK_SUCCESS)
+        {
+            resources.pipelineLayout = VK_NULL_HANDLE;
+            return false;
+        }
+
+        VkComputePipelineCreateInfo pipelineInfo = {};
+        pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+        pipelineInfo.stage.module = resources.shaderModule;
+        pipelineInfo.stage.pName = "main";
+        pipelineInfo.layout = resources.pipelineLayout;
+        if (vk.vkCreateComputePipelines(handle, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &resources.pipeline) != VK_SUCCESS)
+        {
+            resources.pipeline = VK_NULL_HANDLE;
+            return false;
+        }
+
+        VkDescriptorPoolSize poolSizes[2] = {};
+        poolSizes[0].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        poolSizes[0].descriptorCount = 1;
+        poolSizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        poolSizes[1].descriptorCount = 1;
+
+        VkDescriptorPoolCreateInfo poolInfo = {};
+        poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        poolInfo.maxSets = 1;
+        poolInfo.poolSizeCount = 2;
+        poolInfo.pPoolSizes = poolSizes;
+        if (vk.vkCreateDescriptorPool(handle, &poolInfo, nullptr, &resources.descriptorPool) != VK_SUCCESS)
+        {
+            resources.descriptorPool = VK_NULL_HANDLE;
+            return false;
+        }
+
+        VkDescriptorSetAllocateInfo setInfo = {};
+        setInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        setInfo.descriptorPool = resources.descriptorPool;
+        setInfo.descriptorSetCount = 1;
+        setInfo.pSetLayouts = &resources.setLayout;
+        if (vk.vkAllocateDescriptorSets(handle, &setInfo, &resources.descriptorSet) != VK_SUCCESS)
+        {
+            return false;
+        }
+
+        VkDescriptorBufferInfo bufferInfo = {};
+        bufferInfo.buffer = resources.output.buffer;
+        bufferInfo.range = VK_WHOLE_SIZE;
+
+        VkWriteDescriptorSet write = {};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = resources.descriptorSet;
+        write.dstBinding = 1;
+        write.descriptorCount = 1;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        write.pBufferInfo = &bufferInfo;
+        vk.vkUpdateDescriptorSets(handle, 1, &write, 0, nullptr);
+
+        VkCommandPoolCreateInfo commandPoolInfo = {};
+        commandPoolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        commandPoolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+        commandPoolInfo.queueFamilyIndex = familyIndex;
+        if (vk.vkCreateCommandPool(handle, &commandPoolInfo, nullptr, &resources.commandPool) != VK_SUCCESS)
+        {
+            resources.commandPool = VK_NULL_HANDLE;
+            return false;
+        }
+
+        VkCommandBufferAllocateInfo allocateInfo = {};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocateInfo.commandPool = resources.commandPool;
+        allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocateInfo.commandBufferCount = 1;
+        if (vk.vkAllocateCommandBuffers(handle, &allocateInfo, &resources.commandBuffer) != VK_SUCCESS)
+        {
+            return false;
+        }
+
+        VkFenceCreateInfo fenceInfo = {};
+        fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+        if (vk.vkCreateFence(handle, &fenceInfo, nullptr, &resources.fence) != VK_SUCCESS)
+        {
+            resources.fence = VK_NULL_HANDLE;
+            return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * Records the command buffer with <code>record</code>, submits it and waits for it to finish.
+     */
+    bool submit(const LogicalDevice& device, const Resources& resources, const std::function<void(VkCommandBuffer)>& record)
+    {
+        VkDevice handle = device.getHandle();
+        const VulkanLoader::DeviceDispatch& vk = device.getDispatch();
+
+        VkCommandBufferBeginInfo beginInfo = {};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        if (vk.vkResetCommandPool(handle, resources.commandPool, 0) != VK_SUCCESS ||
+            vk.vkBeginCommandBuffer(resources.commandBuffer, &beginInfo) != VK_SUCCESS)
+        {
+            return false;
+        }
+
+        record(resources.commandBuffer);
+        if (vk.vkEndCommandBuffer(resources.commandBuffer) != VK_SUCCESS)
+        {
+            return false;
+        }
+
+        VkSubmitInfo submitInfo = {};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &resources.commandBuffer;
+
+        return vk.vkQueueSubmit(device.getQueue(), 1, &submitInfo, resources.fence) == VK_SUCCESS &&
+               vk.vkWaitForFences(handle, 1, &resources.fence, VK_TRUE, UINT64_MAX) == VK_SUCCESS &&
+               vk.vkResetFences(handle, 1, &resources.fence) == VK_SUCCESS;
+    }
+
+    void recordLayoutTransition(const VulkanLoader::DeviceDispatch& vk, VkCommandBuffer commandBuffer, VkImage image, uint32_t levelCount,
+                                VkImageLayout oldLayout, VkImageLayout newLayout, VkAccessFlags sourceAccess, VkAccessFlags destinationAccess,
+                                VkPipelineStageFlags sourceStage, VkPipelineStageFlags destinationStage)
+    {
+        VkImageMemoryBarrier barrier = {};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask = sourceAccess;
+        barrier.dstAccessMask = destinationAccess;
+        barrier.oldLayout = oldLayout;
+        barrier.newLayout = newLayout;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image;
+        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.levelCount = levelCount;
+        barrier.subresourceRange.layerCount = 1;
+        vk.vkCmdPipelineBarrier(commandBuffer, sourceStage, destinationStage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+    }
+
+    /**
+     * Writes the first mip level into a mapped linear image row by row at the driver's row pitch.
+     */
+    bool writeLinearImage(const LogicalDevice& device, const Image& image, const FormatInfo& info, const uint8_t* source)
+    {
+        VkDevice handle = device.getHandle();
+        const VulkanLoader::DeviceDispatch& vk = device.getDispatch();
+
+        VkImageSubresource subresource = {};
+        subresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        VkSubresourceLayout layout = {};
+        vk.vkGetImageSubresourceLayout(handle, image.image, &subresource, &layout);
+
+        const uint32_t blocks = getLevelBlocks(info, 0);
+        const size_t rowBytes = (size_t)blocks * info.blockBytes;
+        uint8_t* destination = (uint8_t*)image.mapped + layout.offset;
+        for (uint32_t row = 0; row < blocks; row++)
+        {
+            memcpy(destination + row * layout.rowPitch, source + row * rowBytes, rowBytes);
+        }
+
+        if (image.coherent)
+        {
+            return true;
+        }
+
+        VkMappedMemoryRange range = {};
+        range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+        range.memory = image.memory;
+        range.size = VK_WHOLE_SIZE;
+        return vk.vkFlushMappedMemoryRanges(handle, 1, &range) == VK_SUCCESS;
+    }
+
+    /**
+     * Records copies of every mip level from the staging buffer, leaving the image ready for sampling.
+     */
+    void recordOptimalUpload(const VulkanLoader::DeviceDispatch& vk, VkCommandBuffer commandBuffer, const Resources& resources, const Image& image,
+                             const std::vector<VkDeviceSize>& levelOffsets)
+    {
+        const uint32_t levelCount = (uint32_t)levelOffsets.size() - 1;
+        recordLayoutTransition(vk, commandBuffer, image.image, levelCount, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                               VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+        std::vector<VkBufferImageCopy> regions(levelCount);
+        for (uint32_t level = 0; level < levelCount; level++)
+        {
+            regions[level] = {};
+            regions[level].bufferOffset = levelOffsets[level];
+            regions[level].imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            regions[level].imageSubresource.mipLevel = level;
+            regions[level].imageSubresource.layerCount = 1;
+            regions[level].imageExtent = {getLevelExtent(level), getLevelExtent(level), 1};
+        }
+
+        vk.vkCmdCopyBufferToImage(commandBuffer, resources.staging.buffer, image.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, levelCount, regions.data());
+        recordLayoutTransition(vk, commandBuffer, image.image, levelCount, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                               VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+    }
+
+    /**
+     * Times <code>UploadCount</code> uploads after a warm-up upload.
+     * @return the throughput in GB/s, or 0 if an upload failed.
+     */
+    double measureUpload(VkDeviceSize bytes, const std::function<bool()>& upload)
+    {
+        if (!upload())
+        {
+            return 0.0;
+        }
+
+        auto begin = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < UploadCount; i++)
+        {
+            if (!upload())
+            {
+                return 0.0;
+            }
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        const double seconds = std::chrono::duration<double>(end - begin).count();
+        return seconds > 0.0 ? (double)bytes * UploadCount / seconds / 1e9 : 0.0;
+    }
+
+    /**
+     * Times a batch of sampling dispatches over an image after a warm-up batch.
+     * @param layout The layout the image is in.
+     * @param filter The filter, linear if the format supports it with the image's tiling.
+     * @param maxAnisotropy The anisotropy limit; 1 disables anisotropic filtering.
+     * @return the sampling rate in billions of samples per second, or 0 if the sampler or a submission failed.
+     */
+    double measureSampling(const LogicalDevice& device, const Resources& resources, const Image& image, VkImageLayout layout,
+                           VkFilter filter, uint32_t levelCount, float maxAnisotropy)
+    {
+        VkDevice handle = device.getHandle();
+        const VulkanLoader::DeviceDispatch& vk = device.getDispatch();
+
+        VkSamplerCreateInfo samplerInfo = {};
+        samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+        samplerInfo.magFilter = filter;
+        samplerInfo.minFilter = filter;
+        samplerInfo.mipmapMode = filter == VK_FILTER_LINEAR ? VK_SAMPLER_MIPMAP_MODE_LINEAR : VK_SAMPLER_MIPMAP_MODE_NEAREST;
+        samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+        samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+        samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+        samplerInfo.anisotropyEnable = maxAnisotropy > 1.0f ? VK_TRUE : VK_FALSE;
+        samplerInfo.maxAnisotropy = maxAnisotropy;
+        samplerInfo.maxLod = (float)levelCount;
+
+        VkSampler sampler = VK_NULL_HANDLE;
+        if (vk.vkCreateSampler(handle, &samplerInfo, nullptr, &sampler) != VK_SUCCESS)
+        {
+            return 0.0;
+        }
+
+        VkDescriptorImageInfo imageInfo = {};
+        imageInfo.sampler = sampler;
+        imageInfo.imageView = image.view;
+        imageInfo.imageLayout = layout;
+
+        VkWriteDescriptorSet write = {};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = resources.descriptorSet;
+        write.dstBinding = 0;
+        write.descriptorCount = 1;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        write.pImageInfo = &imageInfo;
+        vk.vkUpdateDescriptorSets(handle, 1, &write, 0, nullptr);
+
+        auto record = [&](VkCommandBuffer commandBuffer)
+        {
+            VkMemoryBarrier barrier = {};
+            barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+            barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+
+            vk.vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, resources.pipeline);
+            vk.vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, resources.pipelineLayout, 0, 1, &resources.descriptorSet, 0, nullptr);
+            for (uint32_t i = 0; i < DispatchesPerBatch; i++)
+            {
+                vk.vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+                vk.vkCmdDispatch(commandBuffer, GridExtent / WorkgroupExtent, GridExtent / WorkgroupExtent, 1);
+            }
+        };
+
+        double gigasamplesPerSecond = 0.0;
+        if (submit(device, resources, record))
+        {
+            auto begin = std::chrono::steady_clock::now();
+            const bool submitted = submit(device, resources, record);
+            auto end = std::chrono::steady_clock::now();
+
+            const double seconds = std::chrono::duration<double>(end - begin).count();
+            gigasamplesPerSecond = submitted && seconds > 0.0 ? (double)SamplesPerBatch / seconds / 1e9 : 0.0;
+        }
+
+        vk.vkDestroySampler(handle, sampler, nullptr);
+        return gigasamplesPerSecond;
+    }
+
+    /**
+     * Gets the anisotropy limits to sample with: powers of two up to <code>maxAnisotropy</code>, then
+     * <code>maxAnisotropy</code> itself.
+     */
+    std::vector<float> getAnisotropyLevels(float maxAnisotropy)
+    {
+        std::vector<float> levels;
+        for (float level = 1.0f; level <= maxAnisotropy; level *= 2.0f)
+        {
+            levels.push_back(level);
+        }
+
+        if (levels.empty() || levels.back() < maxAnisotropy)
+        {
+            levels.push_back(maxAnisotropy);
+        }
+
+        return levels;
+    }
+
+    /**
+     * Measures the linear tiling of one format: host writes of the first level, then sampling without mip levels or
+     * anisotropy, which linear images rarely support.
+     */
+    void measureLinear(const LogicalDevice& device, const MemoryTypeSelector& memoryTypes, const Resources& resources, const FormatInfo& info,
+                       const uint8_t* source, TextureBenchmark::FormatResult& formatResult)
+    {
+        Image image;
+        if (!createImage(device, memoryTypes, info.format, VK_IMAGE_TILING_LINEAR, 1, image))
+        {
+            return;
+        }
+
+        const VkDeviceSize blocks = getLevelBlocks(info, 0);
+        formatResult.linearUploadGigabytesPerSecond = measureUpload(blocks * blocks * info.blockBytes, [&]()
+        {
+            return writeLinearImage(device, image, info, source);
+        });
+
+        // Host access needs the general layout, which the shader can also sample from.
+        const VulkanLoader::DeviceDispatch& vk = device.getDispatch();
+        if (formatResult.linearUploadGigabytesPerSecond == 0.0 || !submit(device, resources, [&](VkCommandBuffer commandBuffer)
+        {
+            recordLayoutTransition(vk, commandBuffer, image.image, 1, VK_IMAGE_LAYOUT_PREINITIALIZED, VK_IMAGE_LAYOUT_GENERAL,
+                                   VK_ACCESS_HOST_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_HOST_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+        }))
+        {
+            return;
+        }
+
+        const VkFilter filter = formatResult.properties.linearTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT ? VK_FILTER_LINEAR : VK_FILTER_NEAREST;
+        formatResult.linearSampling.gigasamplesPerSecond = measureSampling(device, resources, image, VK_IMAGE_LAYOUT_GENERAL, filter, 1, 1.0f);
+    }
+
+    /**
+     * Measures the optimal tiling of one format: staged uploads of the whole mip chain, then sampling at every
+     * anisotropy level when the format can be filtered linearly.
+     */
+    void measureOptimal(const LogicalDevice& device, const MemoryTypeSelector& memoryTypes, const Resources& resources, const FormatInfo& info,
+                        const uint8_t* source, const std::vector<float>& anisotropyLevels, TextureBenchmark::FormatResult& formatResult)
+    {
+        const uint32_t levelCount = getLevelCount();
+        Image image;
+        if (!createImage(device, memoryTypes, info.format, VK_IMAGE_TILING_OPTIMAL, levelCount, image))
+        {
+            return;
+        }
+
+        const VulkanLoader::DeviceDispatch& vk = device.getDispatch();
+        const std::vector<VkDeviceSize> levelOffsets = getLevelOffsets(info, levelCount);
+        formatResult.optimalUploadGigabytesPerSecond = measureUpload(levelOffsets.back(), [&]()
+        {
+            memcpy(resources.staging.mapped, source, (size_t)levelOffsets.back());
+            return submit(device, resources, [&](VkCommandBuffer commandBuffer)
+            {
+                recordOptimalUpload(vk, commandBuffer, resources, image, levelOffsets);
+            });
+        });
+
+        if (formatResult.optimalUploadGigabytesPerSecond == 0.0)
+        {
+            return;
+        }
+
+        const bool filterLinear = (formatResult.properties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT) != 0;
+        for (float maxAnisotropy : anisotropyLevels)
+        {
+            if (maxAnisotropy > 1.0f && !filterLinear)
+            {
+                break;
+            }
+
+            TextureBenchmark::Sampling sampling;
+            sampling.maxAnisotropy = maxAnisotropy;
+            sampling.gigasamplesPerSecond = measureSampling(device, resources, image, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                                            filterLinear ? VK_FILTER_LINEAR : VK_FILTER_NEAREST, levelCount, maxAnisotropy);
+            formatResult.optimalSampling.push_back(sampling);
+        }
+    }
+}
+
+namespace TextureBenchmark
+{
+    /**
+     * Measures every format of a fixed list of common color and block compressed texture formats on a
+     * <code>ImageExtent</code> square image. Formats the device cannot sample in either tiling are still listed, with
+     * their format properties and no measurements.
+     * <ul>
+     * <li>Linear: the host writes the first level into a mapped linear image at the driver's row pitch.</li>
+     * <li>Optimal: the whole mip chain is written into a staging buffer and copied with
+     * <code>vkCmdCopyBufferToImage</code>, including the layout transitions, waiting for every upload.</li>
+     * <li>Sampling: a compute shader takes 16 samples per invocation with a 16:1 anisotropic footprint. Optimal images
+     * are sampled at every anisotropy limit up to <code>maxSamplerAnisotropy</code> when <code>samplerAnisotropy</code>
+     * is supported.</li>
+     * </ul>
+     * @param device The <code>VkPhysicalDevice</code>.
+     * @return the results per format; invalid if the device or the sampling pipeline could not be created.
+     */
+    Result run(VkPhysicalDevice device)
+    {
+        VKINFO_TRACE_FUNCTION();
+
+        Result result = {};
+        QueueFamilyIndicies indices = QueueTopology::solve(QueueTopology::classify(device));
+        if (!indices.computeFamily.has_value())
+        {
+            return result;
+        }
+
+        result.queueFamilyIndex = indices.computeFamily.value();
+        result.anisotropySupported = PhysicalDevice::getDeviceFeatures(device).samplerAnisotropy == VK_TRUE;
+        result.maxSamplerAnisotropy = result.anisotropySupported ? std::max(PhysicalDevice::getDeviceProperties(device).limits.maxSamplerAnisotropy, 1.0f) : 1.0f;
+
+        VkPhysicalDeviceFeatures enabledFeatures = {};
+        enabledFeatures.samplerAnisotropy = result.anisotropySupported ? VK_TRUE : VK_FALSE;
+
+        LogicalDevice logicalDevice(device, result.queueFamilyIndex, {}, nullptr, &enabledFeatures);
+        if (logicalDevice.getHandle() == VK_NULL_HANDLE)
+        {
+            return result;
+        }
+
+        const uint32_t levelCount = getLevelCount();
+        VkDeviceSize maxChainSize = 0;
+        for (const FormatInfo& info : Formats)
+        {
+            maxChainSize = std::max(maxChainSize, getLevelOffsets(info, levelCount).back());
+        }
+
+        const MemoryTypeSelector memoryTypes(PhysicalDevice::getMemoryProperties(device));
+        Resources resources;
+        if (!createResources(logicalDevice, memoryTypes, result.queueFamilyIndex, maxChainSize, resources))
+        {
+            return result;
+        }
+
+        // Noisy texels keep framebuffer-style compression from flattering the sampling rates. Clearing the top two bits
+        // of every byte keeps the top exponent bit of the 16 and 32-bit floats and of B10G11R11's R and B channels at
+        // zero, and so their texels finite. B10G11R11's G exponent (bits 17-21) lies inside the third byte of a texel,
+        // so that byte also clears bit 5. Levels and rows start at multiples of 4 bytes.
+        std::vector<uint8_t> source((size_t)maxChainSize);
+        uint32_t state = 0x9e3779b9;
+        for (size_t i = 0; i < source.size(); i++)
+        {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            source[i] = (uint8_t)(state & (i % 4 == 2 ? 0x1f : 0x3f));
+        }
+
+        const std::vector<float> anisotropyLevels = getAnisotropyLevels(result.maxSamplerAnisotropy);
+        for (const FormatInfo& info : Formats)
+        {
+            FormatResult formatResult;
+            formatResult.format = info.format;
+            formatResult.name = info.name;
+            formatResult.properties = PhysicalDevice::getFormatProperties(device, info.format);
+            formatResult.linearSupported = (formatResult.properties.linearTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) &&
+                                           isImageSupported(device, info.format, VK_IMAGE_TILING_LINEAR, VK_IMAGE_USAGE_SAMPLED_BIT, 1);
+            formatResult.optimalSupported = (formatResult.properties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) &&
+                                            isImageSupported(device, info.format, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT, levelCount);
+
+            if (formatResult.linearSupported)
+            {
+                measureLinear(logicalDevice, memoryTypes, resources, info, source.data(), formatResult);
+            }
+
+            if (formatResult.optimalSupported)
+            {
+                measureOptimal(logicalDevice, memoryTypes, resources, info, source.data(), anisotropyLevels, formatResult);
+            }
+
+            result.formats.push_back(formatResult);
+        }
+
+        result.valid = true;
+        return result;
+    }
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "VulkanLoader.h"
+#include <vector>
+
+/**
+ * Measures texture streaming and sampling per format: uploading into linear images the host writes directly, uploading
+ * into optimal images through a staging buffer and <code>vkCmdCopyBufferToImage</code>, and how fast a compute shader
+ * samples each, with anisotropic filtering up to <code>maxSamplerAnisotropy</code>.
+ */
+namespace TextureBenchmark
+{
+    constexpr uint32_t ImageExtent = 1024;
+
+    struct Sampling
+    {
+        float maxAnisotropy = 1.0f;
+        double gigasamplesPerSecond = 0.0;
+    };
+
+    /**
+     * Results of one format next to its format properties. Rates are 0 where the tiling cannot be sampled.
+     */
+    struct FormatResult
+    {
+        VkFormat format = VK_FORMAT_UNDEFINED;
+        const char* name = "";
+        VkFormatProperties properties = {};
+        bool linearSupported = false;
+        bool optimalSupported = false;
+        double linearUploadGigabytesPerSecond = 0.0;
+        double optimalUploadGigabytesPerSecond = 0.0;
+        Sampling linearSampling;
+        std::vector<Sampling> optimalSampling;
+    };
+
+    struct Result
+    {
+        bool valid = false;
+        uint32_t queueFamilyIndex = 0;
+        bool anisotropySupported = false;
+        float maxSamplerAnisotropy = 1.0f;
+        std::vector<FormatResult> formats;
+    };
+
+    Result run(VkPhysicalDevice device);
+}
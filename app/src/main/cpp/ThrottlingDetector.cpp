@@ -0,0 +1,414 @@
+#include "ThrottlingDetector.h"
+#include "ComputeWorkload.h"
+#include "LogicalDevice.h"
+#include "QueueTopology.h"
+#include "Trace.h"
+#include <algorithm>
+#include <chrono>
+
+namespace
+{
+    /**
+     * Batches are sized to take about this long, so the per-second buckets see many completions and the queue never
+     * runs dry between submissions.
+     */
+    constexpr double TargetBatchSeconds = 0.02;
+    constexpr uint32_t MaxDispatchesPerBatch = 4096;
+
+    /**
+     * A second counts as throttled once its smoothed throughput is below this fraction of the peak.
+     */
+    constexpr double ThrottledFraction = 0.9;
+
+    /**
+     * Device objects used by a sustained run, destroyed through the device's dispatch table.
+     */
+    struct ComputeResources
+    {
+        const LogicalDevice* device = nullptr;
+        ComputeWorkload::Resources workload;
+        VkCommandPool commandPool = VK_NULL_HANDLE;
+        VkCommandBuffer commandBuffers[2] = {};
+        VkFence fences[2] = {};
+
+        ~ComputeResources()
+        {
+            if (this->device == nullptr)
+            {
+                return;
+            }
+
+            VkDevice handle = this->device->getHandle();
+            const VulkanLoader::DeviceDispatch& vk = this->device->getDispatch();
+
+            // Batches may still be in flight if the run was cut short.
+            vk.vkDeviceWaitIdle(handle);
+
+            for (VkFence fence : this->fences)
+            {
+                if (fence != VK_NULL_HANDLE)
+                {
+                    vk.vkDestroyFence(handle, fence, nullptr);
+                }
+            }
+
+            if (this->commandPool != VK_NULL_HANDLE)
+            {
+                vk.vkDestroyCommandPool(handle, this->commandPool, nullptr);
+            }
+        }
+    };
+
+
+    /**
+     * Creates everything a run needs on the device: the workload, two command buffers and their fences.
+     */
+    bool createResources(const LogicalDevice& device, VkPhysicalDevice physicalDevice, ComputeResources& resources)
+    {
+        VkDevice handle = device.getHandle();
+        const VulkanLoader::DeviceDispatch& vk = device.getDispatch();
+
+        resources.device = &device;
+
+        if (!ComputeWorkload::create(device, physicalDevice, resources.workload))
+        {
+            return false;
+        }
+
+        VkCommandPoolCreateInfo poolInfo = {};
+        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.queueFamilyIndex = device.getQueueFamilyIndex();
+        if (vk.vkCreateCommandPool(handle, &poolInfo, nullptr, &resources.commandPool) != VK_SUCCESS)
+        {
+            resources.commandPool = VK_NULL_HANDLE;
+            return false;
+        }
+
+        VkCommandBufferAllocateInfo allocateInfo = {};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocateInfo.commandPool = resources.commandPool;
+        allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocateInfo.commandBufferCount = 2;
+        if (vk.vkAllocateCommandBuffers(handle, &allocateInfo, resources.commandBuffers) != VK_SUCCESS)
+        {
+            return false;
+        }
+
+        VkFenceCreateInfo fenceInfo = {};
+        fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+        for (VkFence& fence : resources.fences)
+        {
+            if (vk.vkCreateFence(handle, &fenceInfo, nullptr, &fence) != VK_SUCCESS)
+            {
+                fence = VK_NULL_HANDLE;
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * Records a command buffer of <code>dispatchCount</code> dispatches of the benchmark shader.
+     * @param initialize Whether to fill the buffer with 1.0 first.
+     */
+    bool recordBatch(const VulkanLoader::DeviceDispatch& vk, VkCommandBuffer commandBuffer, const ComputeResources& resources, uint32_t dispatchCount, bool initialize)
+    {
+        VkCommandBufferBeginInfo beginInfo = {};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        if (vk.vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+        {
+            return false;
+        }
+
+        ComputeWorkload::recordDispatches(vk, commandBuffer, resources.workload, dispatchCount, initialize);
+        return vk.vkEndCommandBuffer(commandBuffer) == VK_SUCCESS;
+    }
+
+    bool submit(const LogicalDevice& device, VkCommandBuffer commandBuffer, VkFence fence)
+    {
+        VkSubmitInfo submitInfo = {};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &commandBuffer;
+
+        return device.getDispatch().vkQueueSubmit(device.getQueue(), 1, &submitInfo, fence) == VK_SUCCESS;
+    }
+
+    bool waitAndReset(const LogicalDevice& device, VkFence fence)
+    {
+        const VulkanLoader::DeviceDispatch& vk = device.getDispatch();
+        return vk.vkWaitForFences(device.getHandle(), 1, &fence, VK_TRUE, UINT64_MAX) == VK_SUCCESS &&
+               vk.vkResetFences(device.getHandle(), 1, &fence) == VK_SUCCESS;
+    }
+
+    /**
+     * Doubles the batch size until one batch takes about <code>TargetBatchSeconds</code>. The first submission also
+     * initializes the buffer and pays for pipeline and memory warm-up.
+     * @return the dispatches per batch, or 0 on failure.
+     */
+    uint32_t calibrateBatchSize(const LogicalDevice& device, const ComputeResources& resources)
+    {
+        const VulkanLoader::DeviceDispatch& vk = device.getDispatch();
+        VkCommandBuffer commandBuffer = resources.commandBuffers[0];
+
+        if (!recordBatch(vk, commandBuffer, resources, 1, true) ||
+            !submit(device, commandBuffer, resources.fences[0]) ||
+            !waitAndReset(device, resources.fences[0]))
+        {
+            return 0;
+        }
+
+        uint32_t dispatchCount = 1;
+        while (true)
+        {
+            if (vk.vkResetCommandPool(device.getHandle(), resources.commandPool, 0) != VK_SUCCESS ||
+                !recordBatch(vk, commandBuffer, resources, dispatchCount, false))
+            {
+                return 0;
+            }
+
+            auto begin = std::chrono::steady_clock::now();
+            if (!submit(device, commandBuffer, resources.fences[0]) || !waitAndReset(device, resources.fences[0]))
+            {
+                return 0;
+            }
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+            if (seconds >= TargetBatchSeconds || dispatchCount >= MaxDispatchesPerBatch)
+            {
+                return dispatchCount;
+            }
+
+            dispatchCount *= 2;
+        }
+    }
+}
+
+namespace ThrottlingDetector
+{
+    /**
+     * Runs the benchmark shader back to back on the device's compute queue for <code>durationSeconds</code> and
+     * records the throughput of every wall clock second. Two batches are kept in flight so the queue never idles
+     * while the host waits. Each batch counts towards the second it completed in; the series is allocated before
+     * the run starts, so nothing is allocated while measuring.
+     * @param device The <code>VkPhysicalDevice</code>.
+     * @param durationSeconds How long to run for.
+     * @param cancel If not null, the run stops at the next completed batch once this becomes true. Only whole seconds
+     * are kept.
+     * @return the series and its analysis. <code>valid</code> is false if the workload could not be set up.
+     */
+    Result run(VkPhysicalDevice device, uint32_t durationSeconds, const std::atomic<bool>* cancel)
+    {
+        VKINFO_TRACE_FUNCTION();
+
+        Result result = {};
+        result.durationSeconds = durationSeconds;
+
+        QueueFamilyIndicies indices = QueueTopology::solve(QueueTopology::classify(device));
+        if (!indices.computeFamily.has_value() || durationSeconds == 0)
+        {
+            return result;
+        }
+        result.queueFamilyIndex = indices.computeFamily.value();
+
+        LogicalDevice logicalDevice(device, result.queueFamilyIndex);
+        if (logicalDevice.getHandle() == VK_NULL_HANDLE)
+        {
+            return result;
+        }
+
+        VkDevice handle = logicalDevice.getHandle();
+        const VulkanLoader::DeviceDispatch& vk = logicalDevice.getDispatch();
+
+        ComputeResources resources = {};
+        if (!createResources(logicalDevice, device, resources))
+        {
+            return result;
+        }
+
+        result.dispatchesPerBatch = calibrateBatchSize(logicalDevice, resources);
+        if (result.dispatchesPerBatch == 0 ||
+            vk.vkResetCommandPool(handle, resources.commandPool, 0) != VK_SUCCESS ||
+            !recordBatch(vk, resources.commandBuffers[0], resources, result.dispatchesPerBatch, false) ||
+            !recordBatch(vk, resources.commandBuffers[1], resources, result.dispatchesPerBatch, false))
+        {
+            return result;
+        }
+        result.flopsPerBatch = ComputeWorkload::FlopsPerDispatch * result.dispatchesPerBatch;
+
+        std::vector<uint32_t> batchesPerSecond(durationSeconds, 0);
+        result.gflopsPerSecond.assign(durationSeconds, 0.0);
+
+        auto begin = std::chrono::steady_clock::now();
+        if (!submit(logicalDevice, resources.commandBuffers[0], resources.fences[0]) ||
+            !submit(logicalDevice, resources.commandBuffers[1], resources.fences[1]))
+        {
+            return result;
+        }
+
+        uint32_t next = 0;
+        double elapsedSeconds = 0.0;
+        while (true)
+        {
+            if (!waitAndReset(logicalDevice, resources.fences[next]))
+            {
+                return result;
+            }
+
+            elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+            uint32_t second = (uint32_t)elapsedSeconds;
+            if (second >= durationSeconds)
+            {
+                break;
+            }
+
+            batchesPerSecond[second]++;
+            if (cancel != nullptr && cancel->load(std::memory_order_relaxed))
+            {
+                break;
+            }
+
+            if (!submit(logicalDevice, resources.commandBuffers[next], resources.fences[next]))
+            {
+                return result;
+            }
+            next ^= 1;
+        }
+
+        result.completedSeconds = std::min(durationSeconds, (uint32_t)elapsedSeconds);
+        for (uint32_t i = 0; i < result.completedSeconds; i++)
+        {
+            result.gflopsPerSecond[i] = (double)batchesPerSecond[i] * (double)result.flopsPerBatch / 1e9;
+        }
+
+        result.valid = result.completedSeconds > 0;
+        analyze(result);
+        return result;
+    }
+
+    /**
+     * Times the benchmark shader on an existing device, for comparing devices created with different features or
+     * extensions. Pipeline and memory warm-up happen before the first timed batch.
+     * @param device The logical device. Its queue must support compute.
+     * @param physicalDevice The <code>VkPhysicalDevice</code> the device was created on.
+     * @param dispatchesPerBatch (IN/OUT param) Dispatches per timed batch. If 0, the batch is sized to take about
+     * 20ms and the size is written back, so later devices can be timed with the same batch.
+     * @param batchCount How many batches to time.
+     * @return the median batch time in seconds, or 0 if the workload could not run.
+     */
+    double timeBatches(const LogicalDevice& device, VkPhysicalDevice physicalDevice, uint32_t& dispatchesPerBatch, uint32_t batchCount)
+    {
+        VKINFO_TRACE_FUNCTION();
+
+        if (device.getHandle() == VK_NULL_HANDLE || batchCount == 0)
+        {
+            return 0.0;
+        }
+
+        VkDevice handle = device.getHandle();
+        const VulkanLoader::DeviceDispatch& vk = device.getDispatch();
+
+        ComputeResources resources = {};
+        if (!createResources(device, physicalDevice, resources))
+        {
+            return 0.0;
+        }
+
+        if (dispatchesPerBatch == 0)
+        {
+            dispatchesPerBatch = calibrateBatchSize(device, resources);
+        }
+        else if (!recordBatch(vk, resources.commandBuffers[0], resources, 1, true) ||
+                 !submit(device, resources.commandBuffers[0], resources.fences[0]) ||
+                 !waitAndReset(device, resources.fences[0]))
+        {
+            return 0.0;
+        }
+
+        if (dispatchesPerBatch == 0 ||
+            vk.vkResetCommandPool(handle, resources.commandPool, 0) != VK_SUCCESS ||
+            !recordBatch(vk, resources.commandBuffers[0], resources, dispatchesPerBatch, false))
+        {
+            return 0.0;
+        }
+
+        std::vector<double> seconds(batchCount);
+        for (double& batchSeconds : seconds)
+        {
+            auto begin = std::chrono::steady_clock::now();
+            if (!submit(device, resources.commandBuffers[0], resources.fences[0]) || !waitAndReset(device, resources.fences[0]))
+            {
+                return 0.0;
+            }
+            batchSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        }
+
+        std::nth_element(seconds.begin(), seconds.begin() + batchCount / 2, seconds.end());
+        return seconds[batchCount / 2];
+    }
+
+    /**
+     * Finds the peak, the steady state and the throttling onset of a throughput series.
+     * The series is smoothed with a 3 second moving average to ride out single slow seconds. The peak is the highest
+     * smoothed second; the steady state is the median of the last quarter of the run. If the steady state is below
+     * 90% of the peak, the onset is the first second after which throughput never gets back above 90% of the peak.
+     * @param result (IN/OUT param) A result with <code>gflopsPerSecond</code> and <code>completedSeconds</code> set.
+     */
+    void analyze(Result& result)
+    {
+        const uint32_t count = std::min(result.completedSeconds, (uint32_t)result.gflopsPerSecond.size());
+        result.peakGflops = 0.0;
+        result.peakSecond = 0;
+        result.steadyStateGflops = 0.0;
+        result.steadyStateRatio = 0.0;
+        result.onsetSecond = -1;
+        if (count == 0)
+        {
+            return;
+        }
+
+        std::vector<double> smoothed(count);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            uint32_t first = i > 0 ? i - 1 : 0;
+            uint32_t last = std::min(i + 1, count - 1);
+            double sum = 0.0;
+            for (uint32_t j = first; j <= last; j++)
+            {
+                sum += result.gflopsPerSecond[j];
+            }
+            smoothed[i] = sum / (double)(last - first + 1);
+
+            if (smoothed[i] > result.peakGflops)
+            {
+                result.peakGflops = smoothed[i];
+                result.peakSecond = i;
+            }
+        }
+
+        const uint32_t steadyCount = std::max(1u, count / 4);
+        std::vector<double> steady(result.gflopsPerSecond.begin() + (count - steadyCount), result.gflopsPerSecond.begin() + count);
+        std::nth_element(steady.begin(), steady.begin() + steady.size() / 2, steady.end());
+        result.steadyStateGflops = steady[steady.size() / 2];
+        result.steadyStateRatio = result.peakGflops > 0.0 ? result.steadyStateGflops / result.peakGflops : 0.0;
+
+        if (result.steadyStateRatio >= ThrottledFraction)
+        {
+            return;
+        }
+
+        const double threshold = result.peakGflops * ThrottledFraction;
+        uint32_t lastUnthrottled = result.peakSecond;
+        for (uint32_t i = count; i-- > result.peakSecond;)
+        {
+            if (result.gflopsPerSecond[i] >= threshold)
+            {
+                lastUnthrottled = i;
+                break;
+            }
+        }
+
+        result.onsetSecond = (int32_t)std::min(lastUnthrottled + 1, count - 1);
+    }
+}
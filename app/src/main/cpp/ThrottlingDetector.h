@@ -0,0 +1,36 @@
+#pragma once
+
+#include "LogicalDevice.h"
+#include "VulkanLoader.h"
+#include <atomic>
+#include <vector>
+
+/**
+ * Runs a fixed compute workload back to back for minutes and records the delivered throughput every second, to show
+ * how far sustained performance falls below the peak once the device heats up and where throttling sets in.
+ */
+namespace ThrottlingDetector
+{
+    /**
+     * Result of a sustained run. Throughput is in GFLOP/s of the benchmark shader.
+     */
+    struct Result
+    {
+        bool valid = false;
+        uint32_t queueFamilyIndex = 0;
+        uint32_t durationSeconds = 0;
+        uint32_t completedSeconds = 0;
+        uint32_t dispatchesPerBatch = 0;
+        uint64_t flopsPerBatch = 0;
+        std::vector<double> gflopsPerSecond;
+        double peakGflops = 0.0;
+        uint32_t peakSecond = 0;
+        double steadyStateGflops = 0.0;
+        double steadyStateRatio = 0.0;
+        int32_t onsetSecond = -1;
+    };
+
+    Result run(VkPhysicalDevice device, uint32_t durationSeconds, const std::atomic<bool>* cancel = nullptr);
+    double timeBatches(const LogicalDevice& device, VkPhysicalDevice physicalDevice, uint32_t& dispatchesPerBatch, uint32_t batchCount);
+    void analyze(Result& result);
+}
@@ -0,0 +1,421 @@
+#include "TimestampCalibration.h"
+#include "LogicalDevice.h"
+#include "PhysicalDevice.h"
+#include "QueueTopology.h"
+#include "Trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    /**
+     * Number of back to back timestamps written to measure the delivered resolution.
+     */
+    constexpr uint32_t ResolutionQueryCount = 64;
+
+    /**
+     * One host/GPU timestamp pair. <code>uncertaintyNs</code> bounds how far apart the two readings may be in time.
+     */
+    struct Sample
+    {
+        double gpuNs = 0.0;
+        double hostNs = 0.0;
+        double uncertaintyNs = 0.0;
+    };
+
+    /**
+     * Device objects used by a calibration run, destroyed through the device's dispatch table.
+     */
+    struct CalibrationResources
+    {
+        const LogicalDevice* device = nullptr;
+        VkQueryPool queryPool = VK_NULL_HANDLE;
+        VkCommandPool commandPool = VK_NULL_HANDLE;
+        VkFence fence = VK_NULL_HANDLE;
+
+        ~CalibrationResources()
+        {
+            VkDevice handle = this->device->getHandle();
+            const VulkanLoader::DeviceDispatch& vk = this->device->getDispatch();
+
+            if (this->fence != VK_NULL_HANDLE)
+            {
+                vk.vkDestroyFence(handle, this->fence, nullptr);
+            }
+
+            if (this->commandPool != VK_NULL_HANDLE)
+            {
+                vk.vkDestroyCommandPool(handle, this->commandPool, nullptr);
+            }
+
+            if (this->queryPool != VK_NULL_HANDLE)
+            {
+                vk.vkDestroyQueryPool(handle, this->queryPool, nullptr);
+            }
+        }
+    };
+
+    uint64_t maskTimestamp(uint64_t ticks, uint32_t validBits)
+    {
+        return validBits >= 64 ? ticks : ticks & ((1ull << validBits) - 1);
+    }
+
+    /**
+     * Records a command buffer that resets <code>queryCount</code> timestamp queries and writes each of them.
+     */
+    bool recordTimestamps(const VulkanLoader::DeviceDispatch& vk, VkCommandBuffer commandBuffer, VkQueryPool queryPool, uint32_t queryCount, VkPipelineStageFlagBits stage)
+    {
+        VkCommandBufferBeginInfo beginInfo = {};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        if (vk.vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+        {
+            return false;
+        }
+
+        vk.vkCmdResetQueryPool(commandBuffer, queryPool, 0, queryCount);
+        for (uint32_t i = 0; i < queryCount; i++)
+        {
+            vk.vkCmdWriteTimestamp(commandBuffer, stage, queryPool, i);
+        }
+
+        return vk.vkEndCommandBuffer(commandBuffer) == VK_SUCCESS;
+    }
+
+    /**
+     * Submits <code>commandBuffer</code> and waits for it, resetting the fence afterwards.
+     */
+    bool submitAndWait(const LogicalDevice& device, VkCommandBuffer commandBuffer, VkFence fence)
+    {
+        const VulkanLoader::DeviceDispatch& vk = device.getDispatch();
+
+        VkSubmitInfo submitInfo = {};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &commandBuffer;
+
+        return vk.vkQueueSubmit(device.getQueue(), 1, &submitInfo, fence) == VK_SUCCESS &&
+               vk.vkWaitForFences(device.getHandle(), 1, &fence, VK_TRUE, UINT64_MAX) == VK_SUCCESS &&
+               vk.vkResetFences(device.getHandle(), 1, &fence) == VK_SUCCESS;
+    }
+
+    /**
+     * Checks whether the implementation can sample the device clock and <code>CLOCK_MONOTONIC</code> together.
+     */
+    bool supportsCalibratedMonotonic(VkInstance instance, VkPhysicalDevice device)
+    {
+        if (!PhysicalDevice::isExtensionSupported(device, VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME))
+        {
+            return false;
+        }
+
+        PFN_vkGetPhysicalDeviceCalibrateableTimeDomainsEXT getTimeDomains =
+                (PFN_vkGetPhysicalDeviceCalibrateableTimeDomainsEXT)vkGetInstanceProcAddr(instance, "vkGetPhysicalDeviceCalibrateableTimeDomainsEXT");
+        if (getTimeDomains == nullptr)
+        {
+            return false;
+        }
+
+        uint32_t domainCount = 0;
+        if (getTimeDomains(device, &domainCount, nullptr) != VK_SUCCESS)
+        {
+            return false;
+        }
+
+        std::vector<VkTimeDomainEXT> domains(domainCount);
+        if (getTimeDomains(device, &domainCount, domains.data()) != VK_SUCCESS)
+        {
+            return false;
+        }
+
+        bool hasDevice = std::find(domains.begin(), domains.begin() + domainCount, VK_TIME_DOMAIN_DEVICE_EXT) != domains.begin() + domainCount;
+        bool hasMonotonic = std::find(domains.begin(), domains.begin() + domainCount, VK_TIME_DOMAIN_CLOCK_MONOTONIC_EXT) != domains.begin() + domainCount;
+        return hasDevice && hasMonotonic;
+    }
+
+    /**
+     * Fits <code>host = offset + slope * gpu</code> by least squares, relative to the first sample to keep precision.
+     */
+    void fitSamples(const std::vector<Sample>& samples, TimestampCalibration::Result& result)
+    {
+        double gpu0 = samples.front().gpuNs;
+        double host0 = samples.front().hostNs;
+
+        double meanX = 0.0;
+        double meanY = 0.0;
+        for (const Sample& sample : samples)
+        {
+            meanX += sample.gpuNs - gpu0;
+            meanY += sample.hostNs - host0;
+        }
+        meanX /= (double)samples.size();
+        meanY /= (double)samples.size();
+
+        double covariance = 0.0;
+        double variance = 0.0;
+        for (const Sample& sample : samples)
+        {
+            double x = sample.gpuNs - gpu0 - meanX;
+            double y = sample.hostNs - host0 - meanY;
+            covariance += x * y;
+            variance += x * x;
+        }
+
+        double slope = variance > 0.0 ? covariance / variance : 1.0;
+        double intercept = meanY - slope * meanX;
+
+        double squaredError = 0.0;
+        double uncertainty = 0.0;
+        for (const Sample& sample : samples)
+        {
+            double predicted = intercept + slope * (sample.gpuNs - gpu0);
+            double error = (sample.hostNs - host0) - predicted;
+            squaredError += error * error;
+            uncertainty += sample.uncertaintyNs;
+        }
+
+        result.sampleCount = (uint32_t)samples.size();
+        result.windowNs = samples.back().gpuNs - gpu0;
+        result.offsetNs = host0 + intercept - gpu0;
+        result.driftPpm = (slope - 1.0) * 1e6;
+        result.effectivePeriodNs = (double)result.timestampPeriod * slope;
+        result.residualNs = std::sqrt(squaredError / (double)samples.size());
+        result.pairUncertaintyNs = uncertainty / (double)samples.size();
+    }
+}
+
+namespace TimestampCalibration
+{
+    /**
+     * Reads the host <code>CLOCK_MONOTONIC</code> clock, the clock <code>VK_TIME_DOMAIN_CLOCK_MONOTONIC_EXT</code> refers to.
+     * @return the time in nanoseconds.
+     */
+    uint64_t hostMonotonicNs()
+    {
+        timespec now = {};
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return (uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec;
+    }
+
+    /**
+     * Collects host/GPU timestamp pairs every <code>sampleIntervalMs</code> for <code>windowSeconds</code> and fits
+     * the offset and drift between the two clocks.
+     * With <code>VK_EXT_calibrated_timestamps</code> and a <code>CLOCK_MONOTONIC</code> time domain the pairs come
+     * from <code>vkGetCalibratedTimestampsEXT</code>. Otherwise each pair is a timestamp query submitted on its own and
+     * bracketed by host clock reads, so its uncertainty is half the submit/wait round trip.
+     * The delivered resolution is the smallest non-zero step between back to back timestamp writes.
+     * @param instance The <code>VkInstance</code> <code>device</code> belongs to.
+     * @param device The <code>VkPhysicalDevice</code> to calibrate.
+     * @param windowSeconds How long to sample for.
+     * @param sampleIntervalMs The time between samples.
+     * @return the calibration. <code>valid</code> is false if the device has no timestamp capable queue or a Vulkan
+     * call failed.
+     */
+    Result calibrate(VkInstance instance, VkPhysicalDevice device, double windowSeconds, uint32_t sampleIntervalMs)
+    {
+        VKINFO_TRACE_FUNCTION();
+
+        Result result = {};
+        VkPhysicalDeviceProperties properties = PhysicalDevice::getDeviceProperties(device);
+        result.timestampPeriod = properties.limits.timestampPeriod;
+        result.timestampComputeAndGraphics = properties.limits.timestampComputeAndGraphics == VK_TRUE;
+
+        std::vector<QueueTopology::FamilyInfo> families = QueueTopology::classify(device);
+        QueueFamilyIndicies indices = QueueTopology::solve(families);
+        std::optional<uint32_t> family = indices.graphicsFamily.has_value() ? indices.graphicsFamily : indices.computeFamily;
+        if (!family.has_value() || families[family.value()].timestampValidBits == 0)
+        {
+            return result;
+        }
+
+        result.queueFamilyIndex = family.value();
+        result.timestampValidBits = families[family.value()].timestampValidBits;
+
+        bool calibrated = supportsCalibratedMonotonic(instance, device);
+        std::vector<const char*> extensions = {};
+        if (calibrated)
+        {
+            extensions.push_back(VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME);
+        }
+
+        LogicalDevice logicalDevice(device, result.queueFamilyIndex, extensions);
+        if (logicalDevice.getHandle() == VK_NULL_HANDLE)
+        {
+            return result;
+        }
+
+        VkDevice handle = logicalDevice.getHandle();
+        const VulkanLoader::DeviceDispatch& vk = logicalDevice.getDispatch();
+        calibrated = calibrated && vk.vkGetCalibratedTimestampsEXT != nullptr;
+        result.method = calibrated ? Method::CalibratedTimestamps : Method::QueryRoundTrip;
+
+        CalibrationResources resources = {};
+        resources.device = &logicalDevice;
+
+        VkQueryPoolCreateInfo queryPoolInfo = {};
+        queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        queryPoolInfo.queryCount = ResolutionQueryCount;
+        if (vk.vkCreateQueryPool(handle, &queryPoolInfo, nullptr, &resources.queryPool) != VK_SUCCESS)
+        {
+            resources.queryPool = VK_NULL_HANDLE;
+            return result;
+        }
+
+        VkCommandPoolCreateInfo poolInfo = {};
+        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.queueFamilyIndex = result.queueFamilyIndex;
+        if (vk.vkCreateCommandPool(handle, &poolInfo, nullptr, &resources.commandPool) != VK_SUCCESS)
+        {
+            resources.commandPool = VK_NULL_HANDLE;
+            return result;
+        }
+
+        VkCommandBufferAllocateInfo allocateInfo = {};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocateInfo.commandPool = resources.commandPool;
+        allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocateInfo.commandBufferCount = 2;
+
+        VkCommandBuffer commandBuffers[2] = {};
+        if (vk.vkAllocateCommandBuffers(handle, &allocateInfo, commandBuffers) != VK_SUCCESS)
+        {
+            return result;
+        }
+
+        VkFenceCreateInfo fenceInfo = {};
+        fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+        if (vk.vkCreateFence(handle, &fenceInfo, nullptr, &resources.fence) != VK_SUCCESS)
+        {
+            resources.fence = VK_NULL_HANDLE;
+            return result;
+        }
+
+        // Resolution: back to back writes, so consecutive values differ by as little as the clock allows.
+        VkCommandBuffer resolutionCommands = commandBuffers[0];
+        std::vector<uint64_t> ticks(ResolutionQueryCount);
+        if (!recordTimestamps(vk, resolutionCommands, resources.queryPool, ResolutionQueryCount, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT) ||
+            !submitAndWait(logicalDevice, resolutionCommands, resources.fence) ||
+            vk.vkGetQueryPoolResults(handle, resources.queryPool, 0, ResolutionQueryCount, ticks.size() * sizeof(uint64_t), ticks.data(), sizeof(uint64_t), VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT) != VK_SUCCESS)
+        {
+            return result;
+        }
+
+        uint64_t minimumStep = UINT64_MAX;
+        for (uint32_t i = 1; i < ResolutionQueryCount; i++)
+        {
+            uint64_t previous = maskTimestamp(ticks[i - 1], result.timestampValidBits);
+            uint64_t current = maskTimestamp(ticks[i], result.timestampValidBits);
+            if (current > previous)
+            {
+                minimumStep = std::min(minimumStep, current - previous);
+            }
+        }
+        result.measuredResolutionNs = minimumStep == UINT64_MAX ? 0.0 : (double)minimumStep * result.timestampPeriod;
+
+        // Offset and drift.
+        VkCommandBuffer sampleCommands = commandBuffers[1];
+        if (!calibrated && !recordTimestamps(vk, sampleCommands, resources.queryPool, 1, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT))
+        {
+            return result;
+        }
+
+        VkCalibratedTimestampInfoEXT timestampInfos[2] = {};
+        timestampInfos[0].sType = VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_EXT;
+        timestampInfos[0].timeDomain = VK_TIME_DOMAIN_DEVICE_EXT;
+        timestampInfos[1].sType = VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_EXT;
+        timestampInfos[1].timeDomain = VK_TIME_DOMAIN_CLOCK_MONOTONIC_EXT;
+
+        std::vector<Sample> samples = {};
+        auto end = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(windowSeconds));
+        do
+        {
+            Sample sample = {};
+            if (calibrated)
+            {
+                uint64_t timestamps[2] = {};
+                uint64_t maxDeviation = 0;
+                if (vk.vkGetCalibratedTimestampsEXT(handle, 2, timestampInfos, timestamps, &maxDeviation) != VK_SUCCESS)
+                {
+                    return result;
+                }
+
+                sample.gpuNs = (double)maskTimestamp(timestamps[0], result.timestampValidBits) * result.timestampPeriod;
+                sample.hostNs = (double)timestamps[1];
+                sample.uncertaintyNs = (double)maxDeviation;
+            }
+            else
+            {
+                uint64_t gpuTicks = 0;
+                uint64_t hostBefore = hostMonotonicNs();
+                if (!submitAndWait(logicalDevice, sampleCommands, resources.fence))
+                {
+                    return result;
+                }
+                uint64_t hostAfter = hostMonotonicNs();
+
+                if (vk.vkGetQueryPoolResults(handle, resources.queryPool, 0, 1, sizeof(gpuTicks), &gpuTicks, sizeof(uint64_t), VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT) != VK_SUCCESS)
+                {
+                    return result;
+                }
+
+                sample.gpuNs = (double)maskTimestamp(gpuTicks, result.timestampValidBits) * result.timestampPeriod;
+                sample.hostNs = (double)(hostBefore + hostAfter) / 2.0;
+                sample.uncertaintyNs = (double)(hostAfter - hostBefore) / 2.0;
+            }
+
+            // A wrapped counter would break the fit; stop at the wrap.
+            if (!samples.empty() && sample.gpuNs < samples.back().gpuNs)
+            {
+                break;
+            }
+
+            samples.push_back(sample);
+            std::this_thread::sleep_for(std::chrono::milliseconds(sampleIntervalMs));
+        } while (std::chrono::steady_clock::now() < end);
+
+        if (!calibrated && !samples.empty())
+        {
+            // Submissions that were delayed (scheduler, clock ramp-up) only add noise: keep the tight round trips.
+            double minimumUncertainty = std::min_element(samples.begin(), samples.end(), [](const Sample& a, const Sample& b)
+            {
+                return a.uncertaintyNs < b.uncertaintyNs;
+            })->uncertaintyNs;
+
+            samples.erase(std::remove_if(samples.begin(), samples.end(), [minimumUncertainty](const Sample& sample)
+            {
+                return sample.uncertaintyNs > minimumUncertainty * 4.0 + 1000.0;
+            }), samples.end());
+        }
+
+        if (samples.size() < 2)
+        {
+            return result;
+        }
+
+        fitSamples(samples, result);
+        result.valid = true;
+        return result;
+    }
+
+    /**
+     * Gets a display name for a calibration method.
+     * @param method The method.
+     * @return the name.
+     */
+    const char* getMethodName(Method method)
+    {
+        switch (method)
+        {
+            case Method::CalibratedTimestamps:
+                return "VK_EXT_calibrated_timestamps";
+            case Method::QueryRoundTrip:
+                return "timestamp query round trip";
+            default:
+                return "none";
+        }
+    }
+}
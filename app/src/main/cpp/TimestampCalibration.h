@@ -0,0 +1,45 @@
+#pragma once
+
+#include "VulkanLoader.h"
+
+/**
+ * Correlates the GPU timestamp clock with the host <code>CLOCK_MONOTONIC</code> clock: estimates the offset between
+ * them and the drift over a sampling window, and measures the timestamp resolution the device actually delivers.
+ */
+namespace TimestampCalibration
+{
+    /**
+     * How the host/GPU timestamp pairs were collected.
+     */
+    enum class Method
+    {
+        None,
+        CalibratedTimestamps,
+        QueryRoundTrip
+    };
+
+    /**
+     * Result of a calibration run. All times are in nanoseconds.
+     */
+    struct Result
+    {
+        bool valid = false;
+        Method method = Method::None;
+        uint32_t queueFamilyIndex = 0;
+        uint32_t timestampValidBits = 0;
+        float timestampPeriod = 0.0f;
+        bool timestampComputeAndGraphics = false;
+        uint32_t sampleCount = 0;
+        double windowNs = 0.0;
+        double offsetNs = 0.0;
+        double driftPpm = 0.0;
+        double effectivePeriodNs = 0.0;
+        double residualNs = 0.0;
+        double pairUncertaintyNs = 0.0;
+        double measuredResolutionNs = 0.0;
+    };
+
+    uint64_t hostMonotonicNs();
+    Result calibrate(VkInstance instance, VkPhysicalDevice device, double windowSeconds, uint32_t sampleIntervalMs);
+    const char* getMethodName(Method method);
+}
@@ -0,0 +1,899 @@
+/**
+ * VK_LAYER_VKINFO_timing: a lightweight Vulkan layer that counts calls and records per-entry-point latency histograms.
+ *
+ * Every intercepted call is counted, and one call in <code>VKINFO_TIMING_LAYER_SAMPLE_RATE</code> (a power of two,
+ * default 16) is timed with the CPU cycle counter and recorded into a thread-local log2 histogram. The hot path takes
+ * no locks and does no allocation; sampling keeps the cost of the untimed calls to a counter increment. The histograms
+ * of all threads are merged and dumped when the application calls <code>vkDestroyInstance</code>, covering the calls
+ * made while that instance existed, either to the file named by <code>VKINFO_TIMING_LAYER_OUTPUT</code> or to stderr
+ * (logcat on Android).
+ *
+ * On Linux the layer is enabled with:
+ *     VK_LAYER_PATH=<build dir> VK_INSTANCE_LAYERS=VK_LAYER_VKINFO_timing <app>
+ */
+
+#include "vulkan/vk_layer.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#ifdef __ANDROID__
+#include <android/log.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#define VKINFO_LAYER_NAME "VK_LAYER_VKINFO_timing"
+#define VKINFO_LAYER_EXPORT extern "C" __attribute__((visibility("default")))
+
+#ifdef __ANDROID__
+#define VKINFO_LAYER_TLS_MODEL
+#else
+#define VKINFO_LAYER_TLS_MODEL __attribute__((tls_model("initial-exec")))
+#endif
+
+/**
+ * Instance level entry points the layer times. The first parameter of each must be a <code>VkInstance</code> or
+ * <code>VkPhysicalDevice</code>.
+ */
+#define VKINFO_INSTANCE_ENTRY_POINTS(X) \
+    X(vkEnumeratePhysicalDevices) \
+    X(vkGetPhysicalDeviceProperties) \
+    X(vkGetPhysicalDeviceFeatures) \
+    X(vkGetPhysicalDeviceMemoryProperties) \
+    X(vkGetPhysicalDeviceQueueFamilyProperties) \
+    X(vkGetPhysicalDeviceFormatProperties) \
+    X(vkGetPhysicalDeviceImageFormatProperties) \
+    X(vkEnumerateDeviceExtensionProperties)
+
+/**
+ * Device level entry points the layer times. The first parameter of each must be a <code>VkDevice</code>,
+ * <code>VkQueue</code> or <code>VkCommandBuffer</code>.
+ */
+#define VKINFO_DEVICE_ENTRY_POINTS(X) \
+    X(vkGetDeviceQueue) \
+    X(vkQueueSubmit) \
+    X(vkQueueWaitIdle) \
+    X(vkDeviceWaitIdle) \
+    X(vkAllocateMemory) \
+    X(vkFreeMemory) \
+    X(vkMapMemory) \
+    X(vkUnmapMemory) \
+    X(vkFlushMappedMemoryRanges) \
+    X(vkInvalidateMappedMemoryRanges) \
+    X(vkBindBufferMemory) \
+    X(vkBindImageMemory) \
+    X(vkCreateBuffer) \
+    X(vkDestroyBuffer) \
+    X(vkCreateImage) \
+    X(vkDestroyImage) \
+    X(vkCreateImageView) \
+    X(vkDestroyImageView) \
+    X(vkCreateSampler) \
+    X(vkDestroySampler) \
+    X(vkCreateFence) \
+    X(vkDestroyFence) \
+    X(vkResetFences) \
+    X(vkWaitForFences) \
+    X(vkCreateShaderModule) \
+    X(vkDestroyShaderModule) \
+    X(vkCreateComputePipelines) \
+    X(vkDestroyPipeline) \
+    X(vkCreatePipelineLayout) \
+    X(vkDestroyPipelineLayout) \
+    X(vkCreateDescriptorSetLayout) \
+    X(vkDestroyDescriptorSetLayout) \
+    X(vkCreateDescriptorPool) \
+    X(vkDestroyDescriptorPool) \
+    X(vkResetDescriptorPool) \
+    X(vkAllocateDescriptorSets) \
+    X(vkUpdateDescriptorSets) \
+    X(vkCreateRenderPass) \
+    X(vkDestroyRenderPass) \
+    X(vkCreateFramebuffer) \
+    X(vkDestroyFramebuffer) \
+    X(vkCreateCommandPool) \
+    X(vkDestroyCommandPool) \
+    X(vkResetCommandPool) \
+    X(vkAllocateCommandBuffers) \
+    X(vkFreeCommandBuffers) \
+    X(vkBeginCommandBuffer) \
+    X(vkEndCommandBuffer) \
+    X(vkCmdBindPipeline) \
+    X(vkCmdBindDescriptorSets) \
+    X(vkCmdPushConstants) \
+    X(vkCmdDispatch) \
+    X(vkCmdCopyBuffer) \
+    X(vkCmdCopyBufferToImage) \
+    X(vkCmdFillBuffer) \
+    X(vkCmdPipelineBarrier) \
+    X(vkCmdBeginRenderPass) \
+    X(vkCmdEndRenderPass)
+
+namespace
+{
+    enum EntryPoint : uint32_t
+    {
+#define VKINFO_ENTRY_POINT_ENUM(name) EntryPoint_##name,
+        VKINFO_INSTANCE_ENTRY_POINTS(VKINFO_ENTRY_POINT_ENUM)
+        VKINFO_DEVICE_ENTRY_POINTS(VKINFO_ENTRY_POINT_ENUM)
+#undef VKINFO_ENTRY_POINT_ENUM
+        EntryPoint_vkCreateInstance,
+        EntryPoint_vkCreateDevice,
+        EntryPoint_vkDestroyDevice,
+        EntryPointCount
+    };
+
+    const char* const EntryPointNames[EntryPointCount] =
+            {
+#define VKINFO_ENTRY_POINT_NAME(name) #name,
+            VKINFO_INSTANCE_ENTRY_POINTS(VKINFO_ENTRY_POINT_NAME)
+            VKINFO_DEVICE_ENTRY_POINTS(VKINFO_ENTRY_POINT_NAME)
+#undef VKINFO_ENTRY_POINT_NAME
+            "vkCreateInstance",
+            "vkCreateDevice",
+            "vkDestroyDevice"
+            };
+
+    /**
+     * Number of log2 latency buckets. Bucket <code>i</code> holds calls that took [2^i, 2^(i+1)) ticks.
+     */
+    constexpr uint32_t BucketCount = 40;
+
+    /**
+     * Reads the cheapest monotonic tick source available: the TSC on x86, the virtual counter on arm64 and the
+     * steady clock elsewhere. Ticks are converted to nanoseconds at dump time.
+     */
+    inline uint64_t readTicks()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#elif defined(__aarch64__)
+        uint64_t ticks;
+        asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+        return ticks;
+#else
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    uint64_t nowNs()
+    {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /**
+     * Call counts and latency histograms merged over threads.
+     */
+    struct HistogramTotals
+    {
+        uint64_t calls[EntryPointCount] = {};
+        uint64_t samples[EntryPointCount] = {};
+        uint64_t totalTicks[EntryPointCount] = {};
+        uint64_t buckets[EntryPointCount][BucketCount] = {};
+    };
+
+    /**
+     * Call counts and latency histograms recorded by a single thread. Only the owning thread writes, and the counters
+     * only ever grow, so a dump can read them with relaxed loads while the thread keeps calling.
+     */
+    struct ThreadHistograms
+    {
+        std::atomic<uint64_t> calls[EntryPointCount] = {};
+        std::atomic<uint64_t> samples[EntryPointCount] = {};
+        std::atomic<uint64_t> totalTicks[EntryPointCount] = {};
+        std::atomic<uint64_t> buckets[EntryPointCount][BucketCount] = {};
+    };
+
+    /**
+     * Adds to a counter of the calling thread. A relaxed load and store, not a locked read-modify-write, as no other
+     * thread writes it.
+     */
+    inline uint64_t addToCounter(std::atomic<uint64_t>& counter, uint64_t amount)
+    {
+        const uint64_t value = counter.load(std::memory_order_relaxed);
+        counter.store(value + amount, std::memory_order_relaxed);
+        return value;
+    }
+
+    std::mutex histogramsMutex;
+    std::vector<std::unique_ptr<ThreadHistograms>> allHistograms;
+    thread_local ThreadHistograms* threadHistograms VKINFO_LAYER_TLS_MODEL = nullptr;
+
+    /**
+     * Registers the calling thread's histograms. Only runs on a thread's first intercepted call.
+     */
+    __attribute__((noinline)) ThreadHistograms* registerThreadHistograms()
+    {
+        std::unique_ptr<ThreadHistograms> histograms = std::make_unique<ThreadHistograms>();
+
+        std::lock_guard<std::mutex> lock(histogramsMutex);
+        threadHistograms = histograms.get();
+        allHistograms.push_back(std::move(histograms));
+        return threadHistograms;
+    }
+
+    inline ThreadHistograms* getThreadHistograms()
+    {
+        ThreadHistograms* histograms = threadHistograms;
+        if (__builtin_expect(histograms == nullptr, 0))
+        {
+            histograms = registerThreadHistograms();
+        }
+
+        return histograms;
+    }
+
+    /**
+     * <code>sampleRate - 1</code>. Read once when the first instance is created.
+     */
+    uint64_t sampleMask = 15;
+
+    /**
+     * Counts a call and decides whether it is one of the sampled (timed) calls.
+     */
+    inline bool countCall(uint32_t entryPoint)
+    {
+        return (addToCounter(getThreadHistograms()->calls[entryPoint], 1) & sampleMask) == 0;
+    }
+
+    inline void recordCall(uint32_t entryPoint, uint64_t ticks)
+    {
+        ThreadHistograms* histograms = getThreadHistograms();
+
+        uint32_t bucket = ticks == 0 ? 0 : 63 - (uint32_t)__builtin_clzll(ticks);
+        if (bucket >= BucketCount)
+        {
+            bucket = BucketCount - 1;
+        }
+
+        addToCounter(histograms->samples[entryPoint], 1);
+        addToCounter(histograms->totalTicks[entryPoint], ticks);
+        addToCounter(histograms->buckets[entryPoint][bucket], 1);
+    }
+
+    /**
+     * Times the enclosing scope and records it under <code>entryPoint</code>.
+     */
+    class CallTimer
+    {
+    public:
+        explicit CallTimer(uint32_t entryPoint) : entryPoint(entryPoint), beginTicks(readTicks())
+        {
+        }
+
+        ~CallTimer()
+        {
+            recordCall(this->entryPoint, readTicks() - this->beginTicks);
+        }
+
+        CallTimer(const CallTimer& other) = delete;
+        CallTimer& operator=(const CallTimer& other) = delete;
+
+    private:
+        uint32_t entryPoint;
+        uint64_t beginTicks;
+    };
+
+    /**
+     * Next-layer function pointers of one <code>VkInstance</code> (and its physical devices) or one <code>VkDevice</code>
+     * (and its queues and command buffers).
+     */
+    struct Dispatch
+    {
+        VkInstance instance = VK_NULL_HANDLE;
+        PFN_vkGetInstanceProcAddr nextGetInstanceProcAddr = nullptr;
+        PFN_vkGetDeviceProcAddr nextGetDeviceProcAddr = nullptr;
+        PFN_vkDestroyInstance nextDestroyInstance = nullptr;
+        PFN_vkDestroyDevice nextDestroyDevice = nullptr;
+        PFN_vkVoidFunction next[EntryPointCount] = {};
+
+        /**
+         * For an instance, the merged histograms when it was created; its dump reports what was added since.
+         */
+        std::unique_ptr<HistogramTotals> baseline;
+    };
+
+    /**
+     * Dispatch tables keyed by the loader dispatch pointer stored at the start of every dispatchable handle.
+     * Lookups scan a small fixed array without locking; insertions and removals take <code>dispatchMutex</code>.
+     */
+    constexpr uint32_t MaxDispatchSlots = 32;
+
+    struct DispatchSlot
+    {
+        std::atomic<void*> key{nullptr};
+        Dispatch* dispatch = nullptr;
+    };
+
+    DispatchSlot dispatchSlots[MaxDispatchSlots];
+    std::mutex dispatchMutex;
+
+    template <typename Handle>
+    inline void* getDispatchKey(Handle handle)
+    {
+        return *(void**)handle;
+    }
+
+    inline Dispatch* findDispatch(void* key)
+    {
+        for (DispatchSlot& slot : dispatchSlots)
+        {
+            if (slot.key.load(std::memory_order_acquire) == key)
+            {
+                return slot.dispatch;
+            }
+        }
+
+        return nullptr;
+    }
+
+    bool insertDispatch(void* key, Dispatch* dispatch)
+    {
+        std::lock_guard<std::mutex> lock(dispatchMutex);
+        for (DispatchSlot& slot : dispatchSlots)
+        {
+            if (slot.key.load(std::memory_order_relaxed) == nullptr)
+            {
+                slot.dispatch = dispatch;
+                slot.key.store(key, std::memory_order_release);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    Dispatch* removeDispatch(void* key)
+    {
+        std::lock_guard<std::mutex> lock(dispatchMutex);
+        for (DispatchSlot& slot : dispatchSlots)
+        {
+            if (slot.key.load(std::memory_order_relaxed) == key)
+            {
+                Dispatch* dispatch = slot.dispatch;
+                slot.key.store(nullptr, std::memory_order_release);
+                slot.dispatch = nullptr;
+                return dispatch;
+            }
+        }
+
+        return nullptr;
+    }
+
+    /**
+     * Generic interceptor. Forwards to the next layer and records the latency of the call.
+     */
+    template <uint32_t Index, typename Function>
+    struct Interceptor;
+
+    template <uint32_t Index, typename Result, typename First, typename... Rest>
+    struct Interceptor<Index, Result (VKAPI_PTR*)(First, Rest...)>
+    {
+        using Function = Result (VKAPI_PTR*)(First, Rest...);
+
+        static VKAPI_ATTR Result VKAPI_CALL call(First first, Rest... rest)
+        {
+            Function next = (Function)findDispatch(getDispatchKey(first))->next[Index];
+            if (!countCall(Index))
+            {
+                return next(first, rest...);
+            }
+
+            CallTimer timer(Index);
+            return next(first, rest...);
+        }
+    };
+
+    struct InterceptedFunction
+    {
+        const char* name;
+        uint32_t entryPoint;
+        PFN_vkVoidFunction function;
+    };
+
+    const InterceptedFunction InstanceFunctions[] =
+            {
+#define VKINFO_INTERCEPT(name) {#name, EntryPoint_##name, (PFN_vkVoidFunction)&Interceptor<EntryPoint_##name, PFN_##name>::call},
+            VKINFO_INSTANCE_ENTRY_POINTS(VKINFO_INTERCEPT)
+            };
+
+    const InterceptedFunction DeviceFunctions[] =
+            {
+            VKINFO_DEVICE_ENTRY_POINTS(VKINFO_INTERCEPT)
+#undef VKINFO_INTERCEPT
+            };
+
+    template <size_t Count>
+    PFN_vkVoidFunction findIntercepted(const InterceptedFunction (&functions)[Count], const char* name)
+    {
+        for (const InterceptedFunction& function : functions)
+        {
+            if (strcmp(function.name, name) == 0)
+            {
+                return function.function;
+            }
+        }
+
+        return nullptr;
+    }
+
+    /**
+     * Tick to nanosecond calibration point, taken when the first instance is created.
+     */
+    uint64_t calibrationTicks = 0;
+    uint64_t calibrationNs = 0;
+
+    /**
+     * Writes one formatted line to the dump destination.
+     */
+    void writeDumpLine(FILE* file, const char* line)
+    {
+        if (file != nullptr)
+        {
+            fputs(line, file);
+            fputc('\n', file);
+            return;
+        }
+
+#ifdef __ANDROID__
+        __android_log_print(ANDROID_LOG_INFO, VKINFO_LAYER_NAME, "%s", line);
+#else
+        fprintf(stderr, "%s\n", line);
+#endif
+    }
+
+    /**
+     * Merges the histograms of every thread. The threads' counters are left as they are.
+     */
+    void mergeHistograms(HistogramTotals& merged)
+    {
+        std::lock_guard<std::mutex> lock(histogramsMutex);
+        for (std::unique_ptr<ThreadHistograms>& histograms : allHistograms)
+        {
+            for (uint32_t i = 0; i < EntryPointCount; i++)
+            {
+                merged.calls[i] += histograms->calls[i].load(std::memory_order_relaxed);
+                merged.samples[i] += histograms->samples[i].load(std::memory_order_relaxed);
+                merged.totalTicks[i] += histograms->totalTicks[i].load(std::memory_order_relaxed);
+                for (uint32_t b = 0; b < BucketCount; b++)
+                {
+                    merged.buckets[i][b] += histograms->buckets[i][b].load(std::memory_order_relaxed);
+                }
+            }
+        }
+    }
+
+    /**
+     * Dumps the calls every thread made since <code>baseline</code> was merged. Calls made concurrently through other
+     * instances are included, as the histograms are kept per thread, not per instance.
+     */
+    void dumpHistograms(const HistogramTotals& baseline)
+    {
+        double nsPerTick = 1.0;
+        uint64_t elapsedTicks = readTicks() - calibrationTicks;
+        if (elapsedTicks > 0)
+        {
+            nsPerTick = (double)(nowNs() - calibrationNs) / (double)elapsedTicks;
+        }
+
+        std::unique_ptr<HistogramTotals> merged = std::make_unique<HistogramTotals>();
+        mergeHistograms(*merged);
+        for (uint32_t i = 0; i < EntryPointCount; i++)
+        {
+            merged->calls[i] -= baseline.calls[i];
+            merged->samples[i] -= baseline.samples[i];
+            merged->totalTicks[i] -= baseline.totalTicks[i];
+            for (uint32_t b = 0; b < BucketCount; b++)
+            {
+                merged->buckets[i][b] -= baseline.buckets[i][b];
+            }
+        }
+
+        const char* outputPath = getenv("VKINFO_TIMING_LAYER_OUTPUT");
+        FILE* file = outputPath != nullptr ? fopen(outputPath, "a") : nullptr;
+
+        char line[512];
+        snprintf(line, sizeof(line), "%s: %-42s %10s %10s %12s %12s %12s", VKINFO_LAYER_NAME, "entry point", "calls", "samples", "mean ns", "p50 ns <", "p99 ns <");
+        writeDumpLine(file, line);
+
+        for (uint32_t i = 0; i < EntryPointCount; i++)
+        {
+            if (merged->calls[i] == 0)
+            {
+                continue;
+            }
+
+            if (merged->samples[i] == 0)
+            {
+                snprintf(line, sizeof(line), "%s: %-42s %10llu %10u", VKINFO_LAYER_NAME, EntryPointNames[i], (unsigned long long)merged->calls[i], 0u);
+                writeDumpLine(file, line);
+                continue;
+            }
+
+            uint64_t p50Bucket = 0;
+            uint64_t p99Bucket = 0;
+            uint64_t seen = 0;
+            for (uint32_t b = 0; b < BucketCount; b++)
+            {
+                seen += merged->buckets[i][b];
+                if (p50Bucket == 0 && seen * 2 >= merged->samples[i])
+                {
+                    p50Bucket = b + 1;
+                }
+                if (seen * 100 >= merged->samples[i] * 99)
+                {
+                    p99Bucket = b + 1;
+                    break;
+                }
+            }
+
+            snprintf(line, sizeof(line), "%s: %-42s %10llu %10llu %12.1f %12.0f %12.0f",
+                     VKINFO_LAYER_NAME,
+                     EntryPointNames[i],
+                     (unsigned long long)merged->calls[i],
+                     (unsigned long long)merged->samples[i],
+                     (double)merged->totalTicks[i] * nsPerTick / (double)merged->samples[i],
+                     (double)(1ULL << p50Bucket) * nsPerTick,
+                     (double)(1ULL << p99Bucket) * nsPerTick);
+            writeDumpLine(file, line);
+
+            // Raw histogram: bucket index and count for every non-empty bucket, bucket b = [2^b, 2^(b+1)) ticks.
+            int length = snprintf(line, sizeof(line), "%s:     buckets", VKINFO_LAYER_NAME);
+            for (uint32_t b = 0; b < BucketCount && length < (int)sizeof(line); b++)
+            {
+                if (merged->buckets[i][b] != 0)
+                {
+                    length += snprintf(line + length, sizeof(line) - (size_t)length, " %u:%llu", b, (unsigned long long)merged->buckets[i][b]);
+                }
+            }
+            writeDumpLine(file, line);
+        }
+
+        if (file != nullptr)
+        {
+            fclose(file);
+        }
+    }
+
+    VKAPI_ATTR VkResult VKAPI_CALL createInstance(const VkInstanceCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkInstance* pInstance)
+    {
+        if (calibrationTicks == 0)
+        {
+            calibrationTicks = readTicks();
+            calibrationNs = nowNs();
+
+            const char* sampleRate = getenv("VKINFO_TIMING_LAYER_SAMPLE_RATE");
+            if (sampleRate != nullptr)
+            {
+                uint64_t rate = strtoull(sampleRate, nullptr, 10);
+                if (rate != 0 && (rate & (rate - 1)) == 0)
+                {
+                    sampleMask = rate - 1;
+                }
+            }
+        }
+
+        VkLayerInstanceCreateInfo* chainInfo = (VkLayerInstanceCreateInfo*)pCreateInfo->pNext;
+        while (chainInfo != nullptr && !(chainInfo->sType == VK_STRUCTURE_TYPE_LOADER_INSTANCE_CREATE_INFO && chainInfo->function == VK_LAYER_LINK_INFO))
+        {
+            chainInfo = (VkLayerInstanceCreateInfo*)chainInfo->pNext;
+        }
+
+        if (chainInfo == nullptr)
+        {
+            return VK_ERROR_INITIALIZATION_FAILED;
+        }
+
+        PFN_vkGetInstanceProcAddr nextGetInstanceProcAddr = chainInfo->u.pLayerInfo->pfnNextGetInstanceProcAddr;
+        PFN_vkCreateInstance nextCreateInstance = (PFN_vkCreateInstance)nextGetInstanceProcAddr(VK_NULL_HANDLE, "vkCreateInstance");
+        if (nextCreateInstance == nullptr)
+        {
+            return VK_ERROR_INITIALIZATION_FAILED;
+        }
+
+        // Advance the link info for the next element of the chain.
+        chainInfo->u.pLayerInfo = chainInfo->u.pLayerInfo->pNext;
+
+        std::unique_ptr<HistogramTotals> baseline = std::make_unique<HistogramTotals>();
+        mergeHistograms(*baseline);
+
+        VkResult result;
+        {
+            addToCounter(getThreadHistograms()->calls[EntryPoint_vkCreateInstance], 1);
+            CallTimer timer(EntryPoint_vkCreateInstance);
+            result = nextCreateInstance(pCreateInfo, pAllocator, pInstance);
+        }
+
+        if (result != VK_SUCCESS)
+        {
+            return result;
+        }
+
+        Dispatch* dispatch = new Dispatch();
+        dispatch->instance = *pInstance;
+        dispatch->nextGetInstanceProcAddr = nextGetInstanceProcAddr;
+        dispatch->nextDestroyInstance = (PFN_vkDestroyInstance)nextGetInstanceProcAddr(*pInstance, "vkDestroyInstance");
+        dispatch->baseline = std::move(baseline);
+        for (const InterceptedFunction& function : InstanceFunctions)
+        {
+            dispatch->next[function.entryPoint] = nextGetInstanceProcAddr(*pInstance, function.name);
+        }
+
+        if (!insertDispatch(getDispatchKey(*pInstance), dispatch))
+        {
+            dispatch->nextDestroyInstance(*pInstance, pAllocator);
+            delete dispatch;
+            return VK_ERROR_OUT_OF_HOST_MEMORY;
+        }
+
+        return VK_SUCCESS;
+    }
+
+    VKAPI_ATTR void VKAPI_CALL destroyInstance(VkInstance instance, const VkAllocationCallbacks* pAllocator)
+    {
+        if (instance == VK_NULL_HANDLE)
+        {
+            return;
+        }
+
+        Dispatch* dispatch = removeDispatch(getDispatchKey(instance));
+        if (dispatch != nullptr)
+        {
+            dispatch->nextDestroyInstance(instance, pAllocator);
+            dumpHistograms(*dispatch->baseline);
+            delete dispatch;
+        }
+    }
+
+    VKAPI_ATTR VkResult VKAPI_CALL createDevice(VkPhysicalDevice physicalDevice, const VkDeviceCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkDevice* pDevice)
+    {
+        Dispatch* instanceDispatch = findDispatch(getDispatchKey(physicalDevice));
+
+        VkLayerDeviceCreateInfo* chainInfo = (VkLayerDeviceCreateInfo*)pCreateInfo->pNext;
+        while (chainInfo != nullptr && !(chainInfo->sType == VK_STRUCTURE_TYPE_LOADER_DEVICE_CREATE_INFO && chainInfo->function == VK_LAYER_LINK_INFO))
+        {
+            chainInfo = (VkLayerDeviceCreateInfo*)chainInfo->pNext;
+        }
+
+        if (chainInfo == nullptr || instanceDispatch == nullptr)
+        {
+            return VK_ERROR_INITIALIZATION_FAILED;
+        }
+
+        PFN_vkGetInstanceProcAddr nextGetInstanceProcAddr = chainInfo->u.pLayerInfo->pfnNextGetInstanceProcAddr;
+        PFN_vkGetDeviceProcAddr nextGetDeviceProcAddr = chainInfo->u.pLayerInfo->pfnNextGetDeviceProcAddr;
+        PFN_vkCreateDevice nextCreateDevice = (PFN_vkCreateDevice)nextGetInstanceProcAddr(instanceDispatch->instance, "vkCreateDevice");
+        if (nextCreateDevice == nullptr)
+        {
+            return VK_ERROR_INITIALIZATION_FAILED;
+        }
+
+        chainInfo->u.pLayerInfo = chainInfo->u.pLayerInfo->pNext;
+
+        VkResult result;
+        {
+            addToCounter(getThreadHistograms()->calls[EntryPoint_vkCreateDevice], 1);
+            CallTimer timer(EntryPoint_vkCreateDevice);
+            result = nextCreateDevice(physicalDevice, pCreateInfo, pAllocator, pDevice);
+        }
+
+        if (result != VK_SUCCESS)
+        {
+            return result;
+        }
+
+        Dispatch* dispatch = new Dispatch();
+        dispatch->instance = instanceDispatch->instance;
+        dispatch->nextGetDeviceProcAddr = nextGetDeviceProcAddr;
+        dispatch->nextDestroyDevice = (PFN_vkDestroyDevice)nextGetDeviceProcAddr(*pDevice, "vkDestroyDevice");
+        for (const InterceptedFunction& function : DeviceFunctions)
+        {
+            dispatch->next[function.entryPoint] = nextGetDeviceProcAddr(*pDevice, function.name);
+        }
+
+        if (!insertDispatch(getDispatchKey(*pDevice), dispatch))
+        {
+            dispatch->nextDestroyDevice(*pDevice, pAllocator);
+            delete dispatch;
+            return VK_ERROR_OUT_OF_HOST_MEMORY;
+        }
+
+        return VK_SUCCESS;
+    }
+
+    VKAPI_ATTR void VKAPI_CALL destroyDevice(VkDevice device, const VkAllocationCallbacks* pAllocator)
+    {
+        if (device == VK_NULL_HANDLE)
+        {
+            return;
+        }
+
+        Dispatch* dispatch = removeDispatch(getDispatchKey(device));
+        if (dispatch != nullptr)
+        {
+            addToCounter(getThreadHistograms()->calls[EntryPoint_vkDestroyDevice], 1);
+            CallTimer timer(EntryPoint_vkDestroyDevice);
+            dispatch->nextDestroyDevice(device, pAllocator);
+            delete dispatch;
+        }
+    }
+
+    const VkLayerProperties LayerProperties =
+            {
+            VKINFO_LAYER_NAME,
+            VK_API_VERSION_1_3,
+            1,
+            "Counts Vulkan calls and records per-entry-point latency histograms"
+            };
+
+    VkResult enumerateLayerProperties(uint32_t* pPropertyCount, VkLayerProperties* pProperties)
+    {
+        if (pProperties == nullptr)
+        {
+            *pPropertyCount = 1;
+            return VK_SUCCESS;
+        }
+
+        if (*pPropertyCount < 1)
+        {
+            return VK_INCOMPLETE;
+        }
+
+        pProperties[0] = LayerProperties;
+        *pPropertyCount = 1;
+        return VK_SUCCESS;
+    }
+}
+
+VKINFO_LAYER_EXPORT VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL vkGetDeviceProcAddr(VkDevice device, const char* pName);
+
+VKINFO_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkEnumerateInstanceLayerProperties(uint32_t* pPropertyCount, VkLayerProperties* pProperties)
+{
+    return enumerateLayerProperties(pPropertyCount, pProperties);
+}
+
+VKINFO_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkEnumerateDeviceLayerProperties(VkPhysicalDevice physicalDevice, uint32_t* pPropertyCount, VkLayerProperties* pProperties)
+{
+    (void)physicalDevice;
+    return enumerateLayerProperties(pPropertyCount, pProperties);
+}
+
+VKINFO_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkEnumerateInstanceExtensionProperties(const char* pLayerName, uint32_t* pPropertyCount, VkExtensionProperties* pProperties)
+{
+    (void)pProperties;
+
+    if (pLayerName == nullptr || strcmp(pLayerName, VKINFO_LAYER_NAME) != 0)
+    {
+        return VK_ERROR_LAYER_NOT_PRESENT;
+    }
+
+    *pPropertyCount = 0;
+    return VK_SUCCESS;
+}
+
+VKINFO_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkEnumerateDeviceExtensionProperties(VkPhysicalDevice physicalDevice, const char* pLayerName, uint32_t* pPropertyCount, VkExtensionProperties* pProperties)
+{
+    if (pLayerName != nullptr && strcmp(pLayerName, VKINFO_LAYER_NAME) == 0)
+    {
+        *pPropertyCount = 0;
+        return VK_SUCCESS;
+    }
+
+    // Not a query for this layer: pass it down the chain (timed like any other intercepted call).
+    Dispatch* dispatch = findDispatch(getDispatchKey(physicalDevice));
+    if (dispatch == nullptr)
+    {
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+
+    return Interceptor<EntryPoint_vkEnumerateDeviceExtensionProperties, PFN_vkEnumerateDeviceExtensionProperties>::call(physicalDevice, pLayerName, pPropertyCount, pProperties);
+}
+
+VKINFO_LAYER_EXPORT VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL vkGetInstanceProcAddr(VkInstance instance, const char* pName)
+{
+    if (strcmp(pName, "vkGetInstanceProcAddr") == 0)
+    {
+        return (PFN_vkVoidFunction)&vkGetInstanceProcAddr;
+    }
+    if (strcmp(pName, "vkCreateInstance") == 0)
+    {
+        return (PFN_vkVoidFunction)&createInstance;
+    }
+    if (strcmp(pName, "vkDestroyInstance") == 0)
+    {
+        return (PFN_vkVoidFunction)&destroyInstance;
+    }
+    if (strcmp(pName, "vkCreateDevice") == 0)
+    {
+        return (PFN_vkVoidFunction)&createDevice;
+    }
+    if (strcmp(pName, "vkEnumerateInstanceLayerProperties") == 0)
+    {
+        return (PFN_vkVoidFunction)&vkEnumerateInstanceLayerProperties;
+    }
+    if (strcmp(pName, "vkEnumerateInstanceExtensionProperties") == 0)
+    {
+        return (PFN_vkVoidFunction)&vkEnumerateInstanceExtensionProperties;
+    }
+    if (strcmp(pName, "vkEnumerateDeviceLayerProperties") == 0)
+    {
+        return (PFN_vkVoidFunction)&vkEnumerateDeviceLayerProperties;
+    }
+    if (strcmp(pName, "vkEnumerateDeviceExtensionProperties") == 0)
+    {
+        return (PFN_vkVoidFunction)&vkEnumerateDeviceExtensionProperties;
+    }
+
+    PFN_vkVoidFunction intercepted = findIntercepted(InstanceFunctions, pName);
+    if (intercepted == nullptr)
+    {
+        intercepted = findIntercepted(DeviceFunctions, pName);
+    }
+    if (intercepted == nullptr && strcmp(pName, "vkGetDeviceProcAddr") == 0)
+    {
+        intercepted = (PFN_vkVoidFunction)&vkGetDeviceProcAddr;
+    }
+    if (intercepted == nullptr && strcmp(pName, "vkDestroyDevice") == 0)
+    {
+        intercepted = (PFN_vkVoidFunction)&destroyDevice;
+    }
+    if (intercepted != nullptr)
+    {
+        return intercepted;
+    }
+
+    if (instance == VK_NULL_HANDLE)
+    {
+        return nullptr;
+    }
+
+    Dispatch* dispatch = findDispatch(getDispatchKey(instance));
+    return dispatch != nullptr ? dispatch->nextGetInstanceProcAddr(instance, pName) : nullptr;
+}
+
+VKINFO_LAYER_EXPORT VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL vkGetDeviceProcAddr(VkDevice device, const char* pName)
+{
+    if (strcmp(pName, "vkGetDeviceProcAddr") == 0)
+    {
+        return (PFN_vkVoidFunction)&vkGetDeviceProcAddr;
+    }
+    if (strcmp(pName, "vkDestroyDevice") == 0)
+    {
+        return (PFN_vkVoidFunction)&destroyDevice;
+    }
+
+    PFN_vkVoidFunction intercepted = findIntercepted(DeviceFunctions, pName);
+    if (intercepted != nullptr)
+    {
+        return intercepted;
+    }
+
+    Dispatch* dispatch = findDispatch(getDispatchKey(device));
+    return dispatch != nullptr ? dispatch->nextGetDeviceProcAddr(device, pName) : nullptr;
+}
+
+VKINFO_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkNegotiateLoaderLayerInterfaceVersion(VkNegotiateLayerInterface* pVersionStruct)
+{
+    if (pVersionStruct == nullptr || pVersionStruct->sType != LAYER_NEGOTIATE_INTERFACE_STRUCT)
+    {
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+
+    if (pVersionStruct->loaderLayerInterfaceVersion > 2)
+    {
+        pVersionStruct->loaderLayerInterfaceVersion = 2;
+    }
+
+    pVersionStruct->pfnGetInstanceProcAddr = &vkGetInstanceProcAddr;
+    pVersionStruct->pfnGetDeviceProcAddr = &vkGetDeviceProcAddr;
+    pVersionStruct->pfnGetPhysicalDeviceProcAddr = nullptr;
+    return VK_SUCCESS;
+}
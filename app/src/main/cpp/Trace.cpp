@@ -0,0 +1,261 @@
+#include "Trace.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#ifdef __ANDROID__
+#include <android/trace.h>
+#endif
+
+namespace
+{
+    /**
+     * Per-thread ring buffer of completed scopes.
+     * Only the owning thread writes; <code>head</code> counts every event ever written so a reader can tell
+     * which slots are still valid after the buffer has wrapped.
+     */
+    struct ThreadBuffer
+    {
+        static constexpr uint64_t Capacity = 4096;
+
+        Trace::Event events[Capacity];
+        std::atomic<uint64_t> head{0};
+
+        /**
+         * The index of the first event and the thread id of every thread that wrote into the buffer, oldest first.
+         * Buffers are reused once their thread exits. Guarded by <code>registryMutex</code>.
+         */
+        std::vector<std::pair<uint64_t, uint32_t>> owners;
+    };
+
+    std::mutex registryMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> registry;
+    std::vector<ThreadBuffer*> freeBuffers;
+
+    /**
+     * Holds the calling thread's buffer and returns it for reuse when the thread exits, so short lived threads (job
+     * system workers, benchmark threads) do not each keep a buffer for the life of the process. The events of an
+     * exited thread stay readable until the thread that takes the buffer over wraps over them.
+     */
+    struct ThreadBufferLease
+    {
+        ThreadBuffer* buffer = nullptr;
+
+        ~ThreadBufferLease()
+        {
+            if (this->buffer != nullptr)
+            {
+                std::lock_guard<std::mutex> lock(registryMutex);
+                freeBuffers.push_back(this->buffer);
+            }
+        }
+    };
+
+    /**
+     * Gets the ring buffer of the calling thread, taking a free one or registering a new one on first use.
+     * The registry lock is only taken once per thread.
+     */
+    ThreadBuffer* getThreadBuffer()
+    {
+        thread_local ThreadBufferLease lease;
+        if (lease.buffer == nullptr)
+        {
+            const uint32_t threadId = (uint32_t)syscall(SYS_gettid);
+
+            std::lock_guard<std::mutex> lock(registryMutex);
+            if (freeBuffers.empty())
+            {
+                registry.push_back(std::make_unique<ThreadBuffer>());
+                freeBuffers.push_back(registry.back().get());
+            }
+
+            ThreadBuffer* buffer = freeBuffers.back();
+            freeBuffers.pop_back();
+
+            // Forget previous owners whose events have all been overwritten.
+            const uint64_t head = buffer->head.load(std::memory_order_relaxed);
+            const uint64_t first = head > ThreadBuffer::Capacity ? head - ThreadBuffer::Capacity : 0;
+            while (buffer->owners.size() > 1 && buffer->owners[1].first <= first)
+            {
+                buffer->owners.erase(buffer->owners.begin());
+            }
+
+            buffer->owners.emplace_back(head, threadId);
+            lease.buffer = buffer;
+        }
+
+        return lease.buffer;
+    }
+
+    /**
+     * Copies the still valid events out of a thread buffer.
+     * Slots the owning thread may have overwritten during the copy are discarded.
+     * @param firstIndex (OUT param) The index, in the buffer's event count, of the first event returned.
+     */
+    std::vector<Trace::Event> snapshotBuffer(const ThreadBuffer& buffer, uint64_t& firstIndex)
+    {
+        uint64_t head = buffer.head.load(std::memory_order_acquire);
+        uint64_t first = head > ThreadBuffer::Capacity ? head - ThreadBuffer::Capacity : 0;
+
+        std::vector<Trace::Event> events;
+        events.reserve(head - first);
+        for (uint64_t i = first; i < head; i++)
+        {
+            events.push_back(buffer.events[i % ThreadBuffer::Capacity]);
+        }
+
+        // The writer may be filling event headAfter, in the slot of event headAfter - Capacity, so that one and every
+        // event before it is suspect.
+        uint64_t headAfter = buffer.head.load(std::memory_order_acquire);
+        if (headAfter >= ThreadBuffer::Capacity)
+        {
+            uint64_t overwritten = headAfter - ThreadBuffer::Capacity;
+            if (overwritten >= first)
+            {
+                const uint64_t discarded = std::min<uint64_t>(overwritten + 1 - first, events.size());
+                events.erase(events.begin(), events.begin() + (ptrdiff_t)discarded);
+                first += discarded;
+            }
+        }
+
+        firstIndex = first;
+        return events;
+    }
+
+    /**
+     * Writes <code>value</code> as a JSON string literal.
+     */
+    void writeJsonString(FILE* file, const char* value)
+    {
+        fputc('"', file);
+        for (const char* c = value; *c != '\0'; c++)
+        {
+            if (*c == '"' || *c == '\\')
+            {
+                fputc('\\', file);
+            }
+            fputc(*c, file);
+        }
+        fputc('"', file);
+    }
+}
+
+namespace Trace
+{
+    /**
+     * Gets the current monotonic time.
+     * @return the monotonic time in nanoseconds.
+     */
+    uint64_t nowNs()
+    {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /**
+     * Opens a platform trace section. Only does work on Android, where it forwards to ATrace.
+     * @param name The section name.
+     */
+    void beginSection(const char* name)
+    {
+#ifdef __ANDROID__
+        ATrace_beginSection(name);
+#else
+        (void)name;
+#endif
+    }
+
+    /**
+     * Closes the platform trace section and records the completed scope into the calling thread's ring buffer.
+     * @param name The scope name.
+     * @param beginNs The time the scope was opened, from <code>nowNs</code>.
+     */
+    void endSection(const char* name, uint64_t beginNs)
+    {
+        uint64_t endNs = nowNs();
+
+#ifdef __ANDROID__
+        ATrace_endSection();
+#endif
+
+        ThreadBuffer* buffer = getThreadBuffer();
+        uint64_t head = buffer->head.load(std::memory_order_relaxed);
+        Event& event = buffer->events[head % ThreadBuffer::Capacity];
+        event.name = name;
+        event.beginNs = beginNs;
+        event.endNs = endNs;
+        buffer->head.store(head + 1, std::memory_order_release);
+    }
+
+    /**
+     * Drops every recorded event.
+     * Must not race with traced threads.
+     */
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for (std::unique_ptr<ThreadBuffer>& buffer : registry)
+        {
+            buffer->head.store(0, std::memory_order_release);
+            if (!buffer->owners.empty())
+            {
+                buffer->owners.erase(buffer->owners.begin(), buffer->owners.end() - 1);
+                buffer->owners.back().first = 0;
+            }
+        }
+    }
+
+    /**
+     * Writes every recorded event in the Chrome trace event format, loadable in chrome://tracing and Perfetto.
+     * @param path The output file path.
+     * @return true if the file was written.
+     */
+    bool writeChromeTrace(const std::string& path)
+    {
+        FILE* file = fopen(path.c_str(), "w");
+        if (file == nullptr)
+        {
+            return false;
+        }
+
+        uint32_t processId = (uint32_t)getpid();
+        bool first = true;
+
+        fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", file);
+
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for (const std::unique_ptr<ThreadBuffer>& buffer : registry)
+        {
+            uint64_t index = 0;
+            size_t owner = 0;
+            for (const Event& event : snapshotBuffer(*buffer, index))
+            {
+                while (owner + 1 < buffer->owners.size() && buffer->owners[owner + 1].first <= index)
+                {
+                    owner++;
+                }
+                index++;
+
+                fputs(first ? "\n" : ",\n", file);
+                first = false;
+
+                fputs("{\"ph\":\"X\",\"name\":", file);
+                writeJsonString(file, event.name);
+                fprintf(file, ",\"pid\":%u,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                        processId,
+                        buffer->owners.empty() ? 0 : buffer->owners[owner].second,
+                        (double)event.beginNs / 1000.0,
+                        (double)(event.endNs - event.beginNs) / 1000.0);
+            }
+        }
+
+        fputs("\n]}\n", file);
+        return fclose(file) == 0;
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+/**
+ * Set to 1 (see the <code>VKINFO_TRACING</code> CMake option) to compile the trace scopes in.
+ * When 0 every trace macro expands to the bare expression and costs nothing.
+ */
+#ifndef VKINFO_ENABLE_TRACING
+#define VKINFO_ENABLE_TRACING 0
+#endif
+
+/**
+ * Low overhead scoped tracing.
+ * Each thread records completed scopes into its own fixed size ring buffer, so recording never takes a lock.
+ * On Android every scope is also emitted as an ATrace section so it shows up in Perfetto/systrace captures.
+ */
+namespace Trace
+{
+    /**
+     * A single completed trace scope.
+     */
+    struct Event
+    {
+        const char* name = nullptr;
+        uint64_t beginNs = 0;
+        uint64_t endNs = 0;
+    };
+
+    uint64_t nowNs();
+    void beginSection(const char* name);
+    void endSection(const char* name, uint64_t beginNs);
+    void clear();
+    bool writeChromeTrace(const std::string& path);
+
+    /**
+     * RAII trace scope. Records the time between construction and destruction under <code>name</code>.
+     * <code>name</code> must outlive the trace session (string literals or <code>__func__</code>).
+     */
+    class Scope
+    {
+    public:
+        explicit Scope(const char* name) : name(name), beginNs(nowNs())
+        {
+            beginSection(name);
+        }
+
+        ~Scope()
+        {
+            endSection(this->name, this->beginNs);
+        }
+
+        Scope(const Scope& other) = delete;
+        Scope& operator=(const Scope& other) = delete;
+
+    private:
+        const char* name;
+        uint64_t beginNs;
+    };
+}
+
+#if VKINFO_ENABLE_TRACING
+#define VKINFO_TRACE_CONCAT_INNER(a, b) a##b
+#define VKINFO_TRACE_CONCAT(a, b) VKINFO_TRACE_CONCAT_INNER(a, b)
+#define VKINFO_TRACE_SCOPE(name) Trace::Scope VKINFO_TRACE_CONCAT(traceScope, __LINE__)(name)
+#define VKINFO_TRACE_FUNCTION() VKINFO_TRACE_SCOPE(__func__)
+#define VKINFO_TRACE_VK(function, args) ([&]() { VKINFO_TRACE_SCOPE(#function); return function args; }())
+#else
+#define VKINFO_TRACE_SCOPE(name) ((void)0)
+#define VKINFO_TRACE_FUNCTION() ((void)0)
+#define VKINFO_TRACE_VK(function, args) (function args)
+#endif
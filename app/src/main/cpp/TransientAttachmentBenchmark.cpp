@@ -0,0 +1,543 @@
+#include "TransientAttachmentBenchmark.h"
+#include "LogicalDevice.h"
+#include "MemoryTypeSelector.h"
+#include "PhysicalDevice.h"
+#include "QueueTopology.h"
+#include "Trace.h"
+#include <chrono>
+
+namespace
+{
+    constexpr VkFormat ColorFormat = VK_FORMAT_R8G8B8A8_UNORM;
+    constexpr VkSampleCountFlagBits MultisampleCount = VK_SAMPLE_COUNT_4_BIT;
+
+    /**
+     * Depth formats in order of preference. <code>VK_FORMAT_D16_UNORM</code> is always supported.
+     */
+    const VkFormat DepthFormats[] =
+    {
+        VK_FORMAT_D24_UNORM_S8_UINT,
+        VK_FORMAT_D32_SFLOAT_S8_UINT,
+        VK_FORMAT_D32_SFLOAT,
+        VK_FORMAT_D16_UNORM,
+    };
+
+    /**
+     * An attachment image, its memory and view, destroyed through the device's dispatch table.
+     */
+    struct Attachment
+    {
+        const LogicalDevice* device = nullptr;
+        VkImage image = VK_NULL_HANDLE;
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        VkImageView view = VK_NULL_HANDLE;
+        uint32_t memoryTypeIndex = UINT32_MAX;
+        VkDeviceSize size = 0;
+
+        Attachment() = default;
+        Attachment(const Attachment& other) = delete;
+        Attachment& operator=(const Attachment& other) = delete;
+
+        ~Attachment()
+        {
+            if (this->device == nullptr)
+            {
+                return;
+            }
+
+            VkDevice handle = this->device->getHandle();
+            const VulkanLoader::DeviceDispatch& vk = this->device->getDispatch();
+            if (this->view != VK_NULL_HANDLE)
+            {
+                vk.vkDestroyImageView(handle, this->view, nullptr);
+            }
+
+            if (this->image != VK_NULL_HANDLE)
+            {
+                vk.vkDestroyImage(handle, this->image, nullptr);
+            }
+
+            if (this->memory != VK_NULL_HANDLE)
+            {
+                vk.vkFreeMemory(handle, this->memory, nullptr);
+            }
+        }
+    };
+
+    /**
+     * The attachments, render pass and framebuffer of one measurement, and the command buffer the passes are
+     * recorded into.
+     */
+    struct Resources
+    {
+        const LogicalDevice* device = nullptr;
+        Attachment color;
+        Attachment depth;
+        Attachment resolve;
+        VkRenderPass renderPass = VK_NULL_HANDLE;
+        VkFramebuffer framebuffer = VK_NULL_HANDLE;
+        VkCommandPool commandPool = VK_NULL_HANDLE;
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+        VkFence fence = VK_NULL_HANDLE;
+
+        Resources() = default;
+        Resources(const Resources& other) = delete;
+        Resources& operator=(const Resources& other) = delete;
+
+        ~Resources()
+        {
+            if (this->device == nullptr)
+            {
+                return;
+            }
+
+            VkDevice handle = this->device->getHandle();
+            const VulkanLoader::DeviceDispatch& vk = this->device->getDispatch();
+            vk.vkDeviceWaitIdle(handle);
+
+            if (this->fence != VK_NULL_HANDLE)
+            {
+                vk.vkDestroyFence(handle, this->fence, nullptr);
+            }
+
+            if (this->commandPool != VK_NULL_HANDLE)
+            {
+                vk.vkDestroyCommandPool(handle, this->commandPool, nullptr);
+            }
+
+            if (this->framebuffer != VK_NULL_HANDLE)
+            {
+                vk.vkDestroyFramebuffer(handle, this->framebuffer, nullptr);
+            }
+
+            if (this->renderPass != VK_NULL_HANDLE)
+            {
+                vk.vkDestroyRenderPass(handle, this->renderPass, nullptr);
+            }
+        }
+    };
+
+    VkFormat findDepthFormat(VkPhysicalDevice device)
+    {
+        for (VkFormat format : DepthFormats)
+        {
+            if (PhysicalDevice::getFormatProperties(device, format).optimalTilingFeatures & VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT)
+            {
+                return format;
+            }
+        }
+
+        return VK_FORMAT_D16_UNORM;
+    }
+
+    bool hasStencil(VkFormat format)
+    {
+        return format == VK_FORMAT_D24_UNORM_S8_UINT || format == VK_FORMAT_D32_SFLOAT_S8_UINT;
+    }
+
+    /**
+     * Creates an attachment image of the benchmark's size and a view of it.
+     * @param allowedTypes The memory types to pick from, on top of the image's own requirements.
+     * @param required Flags the memory type must have.
+     * @return false if no memory type fits or creation failed.
+     */
+    bool createAttachment(const LogicalDevice& device, const MemoryTypeSelector& memoryTypes, VkFormat format, VkSampleCountFlagBits samples,
+                          VkImageUsageFlags usage, uint32_t allowedTypes, VkMemoryPropertyFlags required, Attachment& attachment)
+    {
+        VkDevice handle = device.getHandle();
+        const VulkanLoader::DeviceDispatch& vk = device.getDispatch();
+        attachment.device = &device;
+
+        VkImageCreateInfo imageInfo = {};
+        imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageInfo.format = format;
+        imageInfo.extent = {TransientAttachmentBenchmark::Width, TransientAttachmentBenchmark::Height, 1};
+        imageInfo.mipLevels = 1;
+        imageInfo.arrayLayers = 1;
+        imageInfo.samples = samples;
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.usage = usage;
+        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        if (vk.vkCreateImage(handle, &imageInfo, nullptr, &attachment.image) != VK_SUCCESS)
+        {
+            attachment.image = VK_NULL_HANDLE;
+            return false;
+        }
+
+        VkMemoryRequirements requirements = {};
+        vk.vkGetImageMemoryRequirements(handle, attachment.image, &requirements);
+
+        VkMemoryAllocateInfo allocateInfo = {};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocateInfo.allocationSize = requirements.size;
+        allocateInfo.memoryTypeIndex = memoryTypes.find(requirements.memoryTypeBits & allowedTypes, required, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        if (allocateInfo.memoryTypeIndex == UINT32_MAX ||
+            vk.vkAllocateMemory(handle, &allocateInfo, nullptr, &attachment.memory) != VK_SUCCESS)
+        {
+            attachment.memory = VK_NULL_HANDLE;
+            return false;
+        }
+
+        attachment.memoryTypeIndex = allocateInfo.memoryTypeIndex;
+        attachment.size = requirements.size;
+        if (vk.vkBindImageMemory(handle, attachment.image, attachment.memory, 0) != VK_SUCCESS)
+        {
+            return false;
+        }
+
+        VkImageViewCreateInfo viewInfo = {};
+        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInfo.image = attachment.image;
+        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.format = format;
+        viewInfo.subresourceRange.aspectMask = format == ColorFormat ? VK_IMAGE_ASPECT_COLOR_BIT : VK_IMAGE_ASPECT_DEPTH_BIT;
+        if (hasStencil(format))
+        {
+            viewInfo.subresourceRange.aspectMask |= VK_IMAGE_ASPECT_STENCIL_BIT;
+        }
+        viewInfo.subresourceRange.levelCount = 1;
+        viewInfo.subresourceRange.layerCount = 1;
+        if (vk.vkCreateImageView(handle, &viewInfo, nullptr, &attachment.view) != VK_SUCCESS)
+        {
+            attachment.view = VK_NULL_HANDLE;
+            return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * Creates the render pass: a cleared color and depth attachment that are never stored and, when multisampled, a
+     * resolve attachment that is. Without multisampling the color attachment itself is stored and only depth is
+     * transient. Consecutive passes write the same attachments, so an external dependency orders each pass's clears
+     * and resolve after the attachment writes of the one before.
+     */
+    bool createRenderPass(const LogicalDevice& device, VkFormat depthFormat, VkSampleCountFlagBits samples, VkRenderPass& renderPass)
+    {
+        const bool multisampled = samples != VK_SAMPLE_COUNT_1_BIT;
+
+        VkAttachmentDescription attachments[3] = {};
+        attachments[0].format = ColorFormat;
+        attachments[0].samples = samples;
+        attachments[0].loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        attachments[0].storeOp = multisampled ? VK_ATTACHMENT_STORE_OP_DONT_CARE : VK_ATTACHMENT_STORE_OP_STORE;
+        attachments[0].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        attachments[0].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        attachments[0].initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        attachments[0].finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+        attachments[1].format = depthFormat;
+        attachments[1].samples = samples;
+        attachments[1].loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        attachments[1].storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        attachments[1].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        attachments[1].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        attachments[1].initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        attachments[1].finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+        attachments[2].format = ColorFormat;
+        attachments[2].samples = VK_SAMPLE_COUNT_1_BIT;
+        attachments[2].loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        attachments[2].storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+        attachments[2].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        attachments[2].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        attachments[2].initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        attachments[2].finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+        VkAttachmentReference colorReference = {0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+        VkAttachmentReference depthReference = {1, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL};
+        VkAttachmentReference resolveReference = {2, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+
+        VkSubpassDescription subpass = {};
+        subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+        subpass.colorAttachmentCount = 1;
+        subpass.pColorAttachments = &colorReference;
+        subpass.pResolveAttachments = multisampled ? &resolveReference : nullptr;
+        subpass.pDepthStencilAttachment = &depthReference;
+
+        const VkPipelineStageFlags attachmentStages = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+                                                      VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+                                                      VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+        VkSubpassDependency dependency = {};
+        dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
+        dependency.dstSubpass = 0;
+        dependency.srcStageMask = attachmentStages;
+        dependency.dstStageMask = attachmentStages;
+        dependency.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+                                   VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+        VkRenderPassCreateInfo renderPassInfo = {};
+        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+        renderPassInfo.attachmentCount = multisampled ? 3 : 2;
+        renderPassInfo.pAttachments = attachments;
+        renderPassInfo.subpassCount = 1;
+        renderPassInfo.pSubpasses = &subpass;
+        renderPassInfo.dependencyCount = 1;
+        renderPassInfo.pDependencies = &dependency;
+        if (device.getDispatch().vkCreateRenderPass(device.getHandle(), &renderPassInfo, nullptr, &renderPass) != VK_SUCCESS)
+        {
+            renderPass = VK_NULL_HANDLE;
+            return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * Creates the attachments, render pass, framebuffer and command buffer of one measurement.
+     * @param transientTypes The memory types the transient attachments may use.
+     * @param transientRequired Flags the memory type of the transient attachments must have.
+     * @param storedTypes The memory types the stored color target may use.
+     */
+    bool createResources(const LogicalDevice& device, const MemoryTypeSelector& memoryTypes, uint32_t familyIndex, VkFormat depthFormat,
+                         VkSampleCountFlagBits samples, uint32_t transientTypes, VkMemoryPropertyFlags transientRequired, uint32_t storedTypes,
+                         Resources& resources)
+    {
+        VkDevice handle = device.getHandle();
+        const VulkanLoader::DeviceDispatch& vk = device.getDispatch();
+        const bool multisampled = samples != VK_SAMPLE_COUNT_1_BIT;
+        resources.device = &device;
+
+        const VkImageUsageFlags transientColor = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+        const VkImageUsageFlags transientDepth = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+        if (!createAttachment(device, memoryTypes, depthFormat, samples, transientDepth, transientTypes, transientRequired, resources.depth))
+        {
+            return false;
+        }
+
+        if (multisampled)
+        {
+            if (!createAttachment(device, memoryTypes, ColorFormat, samples, transientColor, transientTypes, transientRequired, resources.color) ||
+                !createAttachment(device, memoryTypes, ColorFormat, VK_SAMPLE_COUNT_1_BIT, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, storedTypes, 0, resources.resolve))
+            {
+                return false;
+            }
+        }
+        else if (!createAttachment(device, memoryTypes, ColorFormat, VK_SAMPLE_COUNT_1_BIT, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, storedTypes, 0, resources.color))
+        {
+            return false;
+        }
+
+        if (!createRenderPass(device, depthFormat, samples, resources.renderPass))
+        {
+            return false;
+        }
+
+        VkImageView views[3] = {resources.color.view, resources.depth.view, resources.resolve.view};
+        VkFramebufferCreateInfo framebufferInfo = {};
+        framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+        framebufferInfo.renderPass = resources.renderPass;
+        framebufferInfo.attachmentCount = multisampled ? 3 : 2;
+        framebufferInfo.pAttachments = views;
+        framebufferInfo.width = TransientAttachmentBenchmark::Width;
+        framebufferInfo.height = TransientAttachmentBenchmark::Height;
+        framebufferInfo.layers = 1;
+        if (vk.vkCreateFramebuffer(handle, &framebufferInfo, nullptr, &resources.framebuffer) != VK_SUCCESS)
+        {
+            resources.framebuffer = VK_NULL_HANDLE;
+            return false;
+        }
+
+        VkCommandPoolCreateInfo poolInfo = {};
+        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.queueFamilyIndex = familyIndex;
+        if (vk.vkCreateCommandPool(handle, &poolInfo, nullptr, &resources.commandPool) != VK_SUCCESS)
+        {
+            resources.commandPool = VK_NULL_HANDLE;
+            return false;
+        }
+
+        VkCommandBufferAllocateInfo allocateInfo = {};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocateInfo.commandPool = resources.commandPool;
+        allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocateInfo.commandBufferCount = 1;
+        if (vk.vkAllocateCommandBuffers(handle, &allocateInfo, &resources.commandBuffer) != VK_SUCCESS)
+        {
+            return false;
+        }
+
+        VkFenceCreateInfo fenceInfo = {};
+        fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+        if (vk.vkCreateFence(handle, &fenceInfo, nullptr, &resources.fence) != VK_SUCCESS)
+        {
+            resources.fence = VK_NULL_HANDLE;
+            return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * Records <code>passCount</code> back to back render passes. Each clears the attachments, which on tile-based GPUs
+     * is all the work a pass without draws does, and resolves the multisampled color at its end.
+     */
+    bool recordPasses(const VulkanLoader::DeviceDispatch& vk, const Resources& resources, uint32_t passCount)
+    {
+        VkCommandBufferBeginInfo beginInfo = {};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        if (vk.vkBeginCommandBuffer(resources.commandBuffer, &beginInfo) != VK_SUCCESS)
+        {
+            return false;
+        }
+
+        VkClearValue clearValues[2] = {};
+        clearValues[0].color.float32[3] = 1.0f;
+        clearValues[1].depthStencil.depth = 1.0f;
+
+        VkRenderPassBeginInfo passInfo = {};
+        passInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+        passInfo.renderPass = resources.renderPass;
+        passInfo.framebuffer = resources.framebuffer;
+        passInfo.renderArea.extent = {TransientAttachmentBenchmark::Width, TransientAttachmentBenchmark::Height};
+        passInfo.clearValueCount = 2;
+        passInfo.pClearValues = clearValues;
+
+        for (uint32_t i = 0; i < passCount; i++)
+        {
+            vk.vkCmdBeginRenderPass(resources.commandBuffer, &passInfo, VK_SUBPASS_CONTENTS_INLINE);
+            vk.vkCmdEndRenderPass(resources.commandBuffer);
+        }
+
+        return vk.vkEndCommandBuffer(resources.commandBuffer) == VK_SUCCESS;
+    }
+
+    bool submitPasses(const LogicalDevice& device, const Resources& resources)
+    {
+        const VulkanLoader::DeviceDispatch& vk = device.getDispatch();
+
+        VkSubmitInfo submitInfo = {};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &resources.commandBuffer;
+
+        return vk.vkQueueSubmit(device.getQueue(), 1, &submitInfo, resources.fence) == VK_SUCCESS &&
+               vk.vkWaitForFences(device.getHandle(), 1, &resources.fence, VK_TRUE, UINT64_MAX) == VK_SUCCESS &&
+               vk.vkResetFences(device.getHandle(), 1, &resources.fence) == VK_SUCCESS;
+    }
+
+    /**
+     * Runs the passes with the transient attachments in one kind of memory, then reads how much of it is committed.
+     * @param lazy Whether the transient attachments use lazily allocated memory.
+     * @param measurement (OUT param) Receives the memory figures and pass time; <code>supported</code> stays false if
+     * the attachments could not be created in that memory.
+     * @return false if the passes failed to run.
+     */
+    bool measure(const LogicalDevice& device, const MemoryTypeSelector& memoryTypes, uint32_t familyIndex, VkFormat depthFormat,
+                 VkSampleCountFlagBits samples, bool lazy, uint32_t passCount, TransientAttachmentBenchmark::Measurement& measurement)
+    {
+        // Lazily allocated types can only back transient images, so the ordinary placement and the stored color target
+        // exclude them rather than just not asking for them.
+        const VkPhysicalDeviceMemoryProperties& memoryProperties = memoryTypes.getMemoryProperties();
+        uint32_t ordinaryTypes = 0;
+        for (uint32_t type = 0; type < memoryProperties.memoryTypeCount; type++)
+        {
+            if ((memoryProperties.memoryTypes[type].propertyFlags & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT) == 0)
+            {
+                ordinaryTypes |= 1u << type;
+            }
+        }
+
+        Resources resources;
+        if (!createResources(device, memoryTypes, familyIndex, depthFormat, samples, lazy ? UINT32_MAX : ordinaryTypes,
+                             lazy ? VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT : 0, ordinaryTypes, resources))
+        {
+            return true;
+        }
+
+        measurement.supported = true;
+        measurement.memoryTypeIndex = resources.depth.memoryTypeIndex;
+
+        const VulkanLoader::DeviceDispatch& vk = device.getDispatch();
+        if (!recordPasses(vk, resources, passCount) || !submitPasses(device, resources))
+        {
+            return false;
+        }
+
+        auto begin = std::chrono::steady_clock::now();
+        if (!submitPasses(device, resources))
+        {
+            return false;
+        }
+        auto end = std::chrono::steady_clock::now();
+        measurement.millisecondsPerPass = std::chrono::duration<double, std::milli>(end - begin).count() / passCount;
+
+        const Attachment* transients[2] = {&resources.depth, samples != VK_SAMPLE_COUNT_1_BIT ? &resources.color : nullptr};
+        for (const Attachment* attachment : transients)
+        {
+            if (attachment == nullptr)
+            {
+                continue;
+            }
+
+            measurement.allocatedBytes += attachment->size;
+            VkDeviceSize committed = attachment->size;
+            if (lazy)
+            {
+                vk.vkGetDeviceMemoryCommitment(device.getHandle(), attachment->memory, &committed);
+            }
+            measurement.committedBytes += committed;
+        }
+
+        return true;
+    }
+}
+
+namespace TransientAttachmentBenchmark
+{
+    /**
+     * Runs the render passes with the transient attachments in lazily allocated and in ordinary device local memory.
+     * Attachments are 4x multisampled when the device supports it for color, depth and, if the depth format has it,
+     * stencil. Drivers without a lazily
+     * allocated memory type (most desktop GPUs and software rasterizers such as lavapipe) only get the ordinary
+     * measurement, with the lazily allocated one marked unsupported.
+     * @param device The <code>VkPhysicalDevice</code>.
+     * @param passCount The number of render passes per submission.
+     * @return the lazily allocated measurement, then the ordinary one; invalid if the device could not be created or
+     * the passes failed.
+     */
+    Result run(VkPhysicalDevice device, uint32_t passCount)
+    {
+        VKINFO_TRACE_FUNCTION();
+
+        Result result = {};
+        QueueFamilyIndicies indices = QueueTopology::solve(QueueTopology::classify(device));
+        if (!indices.graphicsFamily.has_value() || passCount == 0)
+        {
+            return result;
+        }
+
+        result.queueFamilyIndex = indices.graphicsFamily.value();
+        result.depthFormat = findDepthFormat(device);
+
+        const VkPhysicalDeviceLimits limits = PhysicalDevice::getDeviceProperties(device).limits;
+        const VkSampleCountFlags stencilSampleCounts = hasStencil(result.depthFormat) ? limits.framebufferStencilSampleCounts : (VkSampleCountFlags)MultisampleCount;
+        const bool multisampled = (limits.framebufferColorSampleCounts & limits.framebufferDepthSampleCounts & stencilSampleCounts & MultisampleCount) != 0;
+        result.samples = multisampled ? MultisampleCount : VK_SAMPLE_COUNT_1_BIT;
+
+        LogicalDevice logicalDevice(device, result.queueFamilyIndex);
+        if (logicalDevice.getHandle() == VK_NULL_HANDLE)
+        {
+            return result;
+        }
+
+        const MemoryTypeSelector memoryTypes(PhysicalDevice::getMemoryProperties(device));
+        result.measurements.resize(2);
+        result.measurements[0].name = "Lazily allocated";
+        result.measurements[1].name = "Device local";
+
+        for (size_t i = 0; i < result.measurements.size(); i++)
+        {
+            if (!measure(logicalDevice, memoryTypes, result.queueFamilyIndex, result.depthFormat, result.samples, i == 0, passCount, result.measurements[i]))
+            {
+                return result;
+            }
+        }
+
+        result.valid = result.measurements[1].supported;
+        return result;
+    }
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "VulkanLoader.h"
+#include <vector>
+
+/**
+ * Shows what lazily allocated memory saves for transient attachments. Offscreen render passes clear a multisampled
+ * color and a depth attachment that are never stored, only resolved, once with the transient attachments bound to
+ * lazily allocated memory and once to ordinary device local memory. Tile-based GPUs keep such attachments in tile
+ * memory, so the lazily allocated memory should never be committed.
+ */
+namespace TransientAttachmentBenchmark
+{
+    constexpr uint32_t Width = 1920;
+    constexpr uint32_t Height = 1080;
+
+    /**
+     * One memory placement of the transient attachments. Ordinary memory is fully committed by definition.
+     */
+    struct Measurement
+    {
+        const char* name = "";
+        bool supported = false;
+        uint32_t memoryTypeIndex = UINT32_MAX;
+        VkDeviceSize allocatedBytes = 0;
+        VkDeviceSize committedBytes = 0;
+        double millisecondsPerPass = 0.0;
+    };
+
+    struct Result
+    {
+        bool valid = false;
+        uint32_t queueFamilyIndex = 0;
+        VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT;
+        VkFormat depthFormat = VK_FORMAT_UNDEFINED;
+        std::vector<Measurement> measurements;
+    };
+
+    Result run(VkPhysicalDevice device, uint32_t passCount);
+}
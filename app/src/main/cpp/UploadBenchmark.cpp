@@ -0,0 +1,538 @@
+#include "UploadBenchmark.h"
+#include "LogicalDevice.h"
+#include "MemoryTypeSelector.h"
+#include "PhysicalDevice.h"
+#include "QueueTopology.h"
+#include "Trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <memory>
+
+namespace
+{
+    constexpr VkDeviceSize MinSize = 64 << 10;
+    constexpr VkDeviceSize SizeGrowth = 4;
+
+    /**
+     * Bytes uploaded per measurement; small sizes repeat until they reach it.
+     */
+    constexpr VkDeviceSize BytesPerMeasurement = 256 << 20;
+    constexpr uint32_t MinUploadCount = 4;
+    constexpr uint32_t MaxUploadCount = 1024;
+
+    constexpr size_t PageSize = 4096;
+
+    /**
+     * A buffer and its memory, destroyed through the device's dispatch table.
+     */
+    struct Buffer
+    {
+        const LogicalDevice* device = nullptr;
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        uint32_t memoryTypeIndex = UINT32_MAX;
+        void* mapped = nullptr;
+
+        Buffer() = default;
+        Buffer(const Buffer& other) = delete;
+        Buffer& operator=(const Buffer& other) = delete;
+
+        ~Buffer()
+        {
+            if (this->device == nullptr)
+            {
+                return;
+            }
+
+            const VulkanLoader::DeviceDispatch& vk = this->device->getDispatch();
+            if (this->buffer != VK_NULL_HANDLE)
+            {
+                vk.vkDestroyBuffer(this->device->getHandle(), this->buffer, nullptr);
+            }
+
+            if (this->memory != VK_NULL_HANDLE)
+            {
+                vk.vkFreeMemory(this->device->getHandle(), this->memory, nullptr);
+            }
+        }
+    };
+
+    /**
+     * The command pool, command buffer and fence copies are submitted with.
+     */
+    struct Transfer
+    {
+        const LogicalDevice* device = nullptr;
+        VkCommandPool commandPool = VK_NULL_HANDLE;
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+        VkFence fence = VK_NULL_HANDLE;
+
+        ~Transfer()
+        {
+            if (this->device == nullptr)
+            {
+                return;
+            }
+
+            VkDevice handle = this->device->getHandle();
+            const VulkanLoader::DeviceDispatch& vk = this->device->getDispatch();
+            vk.vkDeviceWaitIdle(handle);
+            if (this->fence != VK_NULL_HANDLE)
+            {
+                vk.vkDestroyFence(handle, this->fence, nullptr);
+            }
+
+            if (this->commandPool != VK_NULL_HANDLE)
+            {
+                vk.vkDestroyCommandPool(handle, this->commandPool, nullptr);
+            }
+        }
+    };
+
+    struct HostMemoryDeleter
+    {
+        void operator()(uint8_t* memory) const
+        {
+            std::free(memory);
+        }
+    };
+
+    typedef std::unique_ptr<uint8_t, HostMemoryDeleter> HostMemory;
+
+    /**
+     * Allocates application memory at <code>alignment</code>, a power of two at least the size of a pointer.
+     * @return the memory, or null if the host is out of memory.
+     */
+    HostMemory allocateHostMemory(size_t size, size_t alignment)
+    {
+        void* memory = nullptr;
+        if (posix_memalign(&memory, alignment, size) != 0)
+        {
+            return HostMemory();
+        }
+
+        return HostMemory((uint8_t*)memory);
+    }
+
+    double getThreadCpuSeconds()
+    {
+        timespec time = {};
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+        return (double)time.tv_sec + (double)time.tv_nsec / 1e9;
+    }
+
+    /**
+     * Creates a buffer and binds it to new memory of the best type having the required flags, mapping it if it is
+     * host visible.
+     * @return false if no memory type fits or creation failed.
+     */
+    bool createBuffer(const LogicalDevice& device, const MemoryTypeSelector& memoryTypes, VkDeviceSize size, VkBufferUsageFlags usage,
+                      VkMemoryPropertyFlags required, VkMemoryPropertyFlags preferred, Buffer& buffer)
+    {
+        VkDevice handle = device.getHandle();
+        const VulkanLoader::DeviceDispatch& vk = device.getDispatch();
+        buffer.device = &device;
+
+        VkBufferCreateInfo bufferInfo = {};
+        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferInfo.size = size;
+        bufferInfo.usage = usage;
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        if (vk.vkCreateBuffer(handle, &bufferInfo, nullptr, &buffer.buffer) != VK_SUCCESS)
+        {
+            buffer.buffer = VK_NULL_HANDLE;
+            return false;
+        }
+
+        VkMemoryRequirements requirements = {};
+        vk.vkGetBufferMemoryRequirements(handle, buffer.buffer, &requirements);
+
+        VkMemoryAllocateInfo allocateInfo = {};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocateInfo.allocationSize = requirements.size;
+        allocateInfo.memoryTypeIndex = memoryTypes.find(requirements.memoryTypeBits, required, preferred);
+        if (allocateInfo.memoryTypeIndex == UINT32_MAX ||
+            vk.vkAllocateMemory(handle, &allocateInfo, nullptr, &buffer.memory) != VK_SUCCESS)
+        {
+            buffer.memory = VK_NULL_HANDLE;
+            return false;
+        }
+
+        buffer.memoryTypeIndex = allocateInfo.memoryTypeIndex;
+        if (vk.vkBindBufferMemory(handle, buffer.buffer, buffer.memory, 0) != VK_SUCCESS)
+        {
+            return false;
+        }
+
+        return (required & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) == 0 ||
+               vk.vkMapMemory(handle, buffer.memory, 0, VK_WHOLE_SIZE, 0, &buffer.mapped) == VK_SUCCESS;
+    }
+
+    /**
+     * Creates a transfer source buffer backed by application memory through <code>VK_EXT_external_memory_host</code>.
+     * @param hostPointer The memory, aligned to <code>minImportedHostPointerAlignment</code>.
+     * @param size The size, a multiple of <code>minImportedHostPointerAlignment</code>.
+     * @return false if the driver cannot import the memory.
+     */
+    bool importBuffer(const LogicalDevice& device, const MemoryTypeSelector& memoryTypes, void* hostPointer, VkDeviceSize size, Buffer& buffer)
+    {
+        VkDevice handle = device.getHandle();
+        const VulkanLoader::DeviceDispatch& vk = device.getDispatch();
+        buffer.device = &device;
+
+        VkMemoryHostPointerPropertiesEXT pointerProperties = {};
+        pointerProperties.sType = VK_STRUCTURE_TYPE_MEMORY_HOST_POINTER_PROPERTIES_EXT;
+        if (vk.vkGetMemoryHostPointerPropertiesEXT(handle, VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT, hostPointer, &pointerProperties) != VK_SUCCESS)
+        {
+            return false;
+        }
+
+        VkExternalMemoryBufferCreateInfo externalInfo = {};
+        externalInfo.sType = VK_STRUCTURE_TYPE_EXTERNAL_MEMORY_BUFFER_CREATE_INFO;
+        externalInfo.handleTypes = VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT;
+
+        VkBufferCreateInfo bufferInfo = {};
+        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferInfo.pNext = &externalInfo;
+        bufferInfo.size = size;
+        bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        if (vk.vkCreateBuffer(handle, &bufferInfo, nullptr, &buffer.buffer) != VK_SUCCESS)
+        {
+            buffer.buffer = VK_NULL_HANDLE;
+            return false;
+        }
+
+        VkMemoryRequirements requirements = {};
+        vk.vkGetBufferMemoryRequirements(handle, buffer.buffer, &requirements);
+
+        VkImportMemoryHostPointerInfoEXT importInfo = {};
+        importInfo.sType = VK_STRUCTURE_TYPE_IMPORT_MEMORY_HOST_POINTER_INFO_EXT;
+        importInfo.handleType = VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT;
+        importInfo.pHostPointer = hostPointer;
+
+        VkMemoryAllocateInfo allocateInfo = {};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocateInfo.pNext = &importInfo;
+        allocateInfo.allocationSize = size;
+        allocateInfo.memoryTypeIndex = memoryTypes.find(requirements.memoryTypeBits & pointerProperties.memoryTypeBits, 0, 0);
+        if (requirements.size > size || allocateInfo.memoryTypeIndex == UINT32_MAX ||
+            vk.vkAllocateMemory(handle, &allocateInfo, nullptr, &buffer.memory) != VK_SUCCESS)
+        {
+            buffer.memory = VK_NULL_HANDLE;
+            return false;
+        }
+
+        buffer.memoryTypeIndex = allocateInfo.memoryTypeIndex;
+        return vk.vkBindBufferMemory(handle, buffer.buffer, buffer.memory, 0) == VK_SUCCESS;
+    }
+
+    bool createTransfer(const LogicalDevice& device, uint32_t familyIndex, Transfer& transfer)
+    {
+        VkDevice handle = device.getHandle();
+        const VulkanLoader::DeviceDispatch& vk = device.getDispatch();
+        transfer.device = &device;
+
+        VkCommandPoolCreateInfo poolInfo = {};
+        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+        poolInfo.queueFamilyIndex = familyIndex;
+        if (vk.vkCreateCommandPool(handle, &poolInfo, nullptr, &transfer.commandPool) != VK_SUCCESS)
+        {
+            transfer.commandPool = VK_NULL_HANDLE;
+            return false;
+        }
+
+        VkCommandBufferAllocateInfo allocateInfo = {};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocateInfo.commandPool = transfer.commandPool;
+        allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocateInfo.commandBufferCount = 1;
+        if (vk.vkAllocateCommandBuffers(handle, &allocateInfo, &transfer.commandBuffer) != VK_SUCCESS)
+        {
+            return false;
+        }
+
+        VkFenceCreateInfo fenceInfo = {};
+        fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+        if (vk.vkCreateFence(handle, &fenceInfo, nullptr, &transfer.fence) != VK_SUCCESS)
+        {
+            transfer.fence = VK_NULL_HANDLE;
+            return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * Records, submits and waits for one copy, as an application uploading on demand would.
+     */
+    bool copyBuffer(const LogicalDevice& device, const Transfer& transfer, VkBuffer source, VkBuffer destination, VkDeviceSize size)
+    {
+        VkDevice handle = device.getHandle();
+        const VulkanLoader::DeviceDispatch& vk = device.getDispatch();
+
+        VkCommandBufferBeginInfo beginInfo = {};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+        VkBufferCopy region = {};
+        region.size = size;
+
+        if (vk.vkResetCommandPool(handle, transfer.commandPool, 0) != VK_SUCCESS ||
+            vk.vkBeginCommandBuffer(transfer.commandBuffer, &beginInfo) != VK_SUCCESS)
+        {
+            return false;
+        }
+
+        vk.vkCmdCopyBuffer(transfer.commandBuffer, source, destination, 1, &region);
+        if (vk.vkEndCommandBuffer(transfer.commandBuffer) != VK_SUCCESS)
+        {
+            return false;
+        }
+
+        VkSubmitInfo submitInfo = {};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &transfer.commandBuffer;
+
+        return vk.vkQueueSubmit(device.getQueue(), 1, &submitInfo, transfer.fence) == VK_SUCCESS &&
+               vk.vkWaitForFences(handle, 1, &transfer.fence, VK_TRUE, UINT64_MAX) == VK_SUCCESS &&
+               vk.vkResetFences(handle, 1, &transfer.fence) == VK_SUCCESS;
+    }
+
+    /**
+     * Times repeated uploads of one size after a warm-up upload.
+     * @param upload Uploads <code>size</code> bytes once.
+     * @param measurement (OUT param) The measurement.
+     * @return false if an upload failed.
+     */
+    bool measure(VkDeviceSize size, const std::function<bool()>& upload, UploadBenchmark::Measurement& measurement)
+    {
+        measurement = {};
+        measurement.size = size;
+        measurement.uploadCount = (uint32_t)std::min<VkDeviceSize>(std::max<VkDeviceSize>(BytesPerMeasurement / size, MinUploadCount), MaxUploadCount);
+
+        if (!upload())
+        {
+            return false;
+        }
+
+        const double cpuBegin = getThreadCpuSeconds();
+        auto begin = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < measurement.uploadCount; i++)
+        {
+            if (!upload())
+            {
+                return false;
+            }
+        }
+        auto end = std::chrono::steady_clock::now();
+        const double cpuSeconds = getThreadCpuSeconds() - cpuBegin;
+
+        const double seconds = std::chrono::duration<double>(end - begin).count();
+        measurement.gigabytesPerSecond = seconds > 0.0 ? (double)size * measurement.uploadCount / seconds / 1e9 : 0.0;
+        measurement.cpuMillisecondsPerUpload = cpuSeconds * 1e3 / measurement.uploadCount;
+        return true;
+    }
+
+    std::vector<VkDeviceSize> getSizes(VkDeviceSize maxSize)
+    {
+        std::vector<VkDeviceSize> sizes;
+        for (VkDeviceSize size = MinSize; size < maxSize; size *= SizeGrowth)
+        {
+            sizes.push_back(size);
+        }
+
+        sizes.push_back(maxSize);
+        return sizes;
+    }
+
+    /**
+     * Gets <code>minImportedHostPointerAlignment</code>.
+     * @return 0 if host pointer import is unsupported or the alignment cannot be queried.
+     */
+    VkDeviceSize getImportAlignment(const Instance& instance, VkPhysicalDevice device, const VkPhysicalDeviceProperties& properties)
+    {
+        if (instance.getApiVersion() < VK_API_VERSION_1_1 || properties.apiVersion < VK_API_VERSION_1_1 ||
+            !PhysicalDevice::isExtensionSupported(device, VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME))
+        {
+            return 0;
+        }
+
+        PFN_vkGetPhysicalDeviceProperties2 getProperties2 = (PFN_vkGetPhysicalDeviceProperties2)vkGetInstanceProcAddr(instance.getHandle(), "vkGetPhysicalDeviceProperties2");
+        if (getProperties2 == nullptr)
+        {
+            return 0;
+        }
+
+        VkPhysicalDeviceExternalMemoryHostPropertiesEXT hostProperties = {};
+        hostProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTERNAL_MEMORY_HOST_PROPERTIES_EXT;
+        VkPhysicalDeviceProperties2 properties2 = {};
+        properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+        properties2.pNext = &hostProperties;
+        getProperties2(device, &properties2);
+
+        // The alignment is a power of two by the spec; reject anything else rather than misalign the import.
+        const VkDeviceSize alignment = hostProperties.minImportedHostPointerAlignment;
+        return alignment != 0 && (alignment & (alignment - 1)) == 0 ? alignment : 0;
+    }
+}
+
+namespace UploadBenchmark
+{
+    /**
+     * Measures each upload method over sizes from 64 KiB to <code>maxSize</code>. The source data always starts in
+     * page aligned application memory and ends in a device local buffer:
+     * <ul>
+     * <li>Staging copy: <code>memcpy</code> into a host visible buffer, then a <code>vkCmdCopyBuffer</code>.</li>
+     * <li>Direct write: <code>memcpy</code> into a mapped buffer whose memory is both device local and host
+     * visible, flushed if it is not coherent. Unsupported where no memory type has both flags.</li>
+     * <li>Host pointer import: the application memory itself is imported as the copy source, which costs no CPU copy.
+     * Importing is done once per size and not timed; sizes the driver cannot import are left out. Needs Vulkan 1.1
+     * and <code>VK_EXT_external_memory_host</code>.</li>
+     * </ul>
+     * Every upload is waited for before the next one starts.
+     * @param instance The instance <code>device</code> was enumerated from, for <code>vkGetPhysicalDeviceProperties2</code>.
+     * @param device The <code>VkPhysicalDevice</code>.
+     * @param maxSize The largest upload in bytes.
+     * @return the methods in the order above; invalid if the device or its buffers could not be created.
+     */
+    Result run(const Instance& instance, VkPhysicalDevice device, VkDeviceSize maxSize)
+    {
+        VKINFO_TRACE_FUNCTION();
+
+        Result result = {};
+        QueueFamilyIndicies indices = QueueTopology::solve(QueueTopology::classify(device));
+        if (!indices.transferFamily.has_value() || maxSize == 0)
+        {
+            return result;
+        }
+
+        result.queueFamilyIndex = indices.transferFamily.value();
+        const VkPhysicalDeviceProperties properties = PhysicalDevice::getDeviceProperties(device);
+        const VkDeviceSize importAlignment = getImportAlignment(instance, device, properties);
+
+        std::vector<const char*> extensions;
+        if (importAlignment != 0)
+        {
+            extensions.push_back(VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME);
+        }
+
+        LogicalDevice logicalDevice(device, result.queueFamilyIndex, extensions);
+        if (logicalDevice.getHandle() == VK_NULL_HANDLE)
+        {
+            return result;
+        }
+
+        VkDevice handle = logicalDevice.getHandle();
+        const VulkanLoader::DeviceDispatch& vk = logicalDevice.getDispatch();
+        const MemoryTypeSelector memoryTypes(PhysicalDevice::getMemoryProperties(device));
+        const VkMemoryPropertyFlags hostVisibleDeviceLocal = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+
+        // Imports must start and end on the import alignment, so every size is rounded up to it.
+        const size_t hostAlignment = (size_t)std::max<VkDeviceSize>(importAlignment, PageSize);
+        const VkDeviceSize roundedMaxSize = (maxSize + hostAlignment - 1) / hostAlignment * hostAlignment;
+        std::vector<VkDeviceSize> sizes = getSizes(roundedMaxSize);
+
+        HostMemory source = allocateHostMemory((size_t)roundedMaxSize, hostAlignment);
+        Transfer transfer;
+        Buffer destination;
+        Buffer staging;
+        if (source == nullptr || !createTransfer(logicalDevice, result.queueFamilyIndex, transfer) ||
+            !createBuffer(logicalDevice, memoryTypes, roundedMaxSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0, destination) ||
+            !createBuffer(logicalDevice, memoryTypes, roundedMaxSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, 0, staging))
+        {
+            return result;
+        }
+
+        memset(source.get(), 0x5a, (size_t)roundedMaxSize);
+        result.methods.resize(3);
+
+        Method& stagingMethod = result.methods[0];
+        stagingMethod.name = "Staging copy";
+        stagingMethod.supported = true;
+        stagingMethod.memoryTypeIndex = staging.memoryTypeIndex;
+        for (VkDeviceSize size : sizes)
+        {
+            Measurement measurement;
+            if (!measure(size, [&]()
+            {
+                memcpy(staging.mapped, source.get(), (size_t)size);
+                return copyBuffer(logicalDevice, transfer, staging.buffer, destination.buffer, size);
+            }, measurement))
+            {
+                return result;
+            }
+            stagingMethod.sizes.push_back(measurement);
+        }
+
+        Method& directMethod = result.methods[1];
+        directMethod.name = "Direct write";
+        Buffer direct;
+        if (memoryTypes.find(UINT32_MAX, hostVisibleDeviceLocal, 0) != UINT32_MAX &&
+            createBuffer(logicalDevice, memoryTypes, roundedMaxSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT, hostVisibleDeviceLocal, VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, direct))
+        {
+            const bool coherent = memoryTypes.getMemoryProperties().memoryTypes[direct.memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+            VkMappedMemoryRange range = {};
+            range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+            range.memory = direct.memory;
+            range.size = VK_WHOLE_SIZE;
+
+            directMethod.supported = true;
+            directMethod.memoryTypeIndex = direct.memoryTypeIndex;
+            for (VkDeviceSize size : sizes)
+            {
+                Measurement measurement;
+                if (!measure(size, [&]()
+                {
+                    memcpy(direct.mapped, source.get(), (size_t)size);
+                    return coherent || vk.vkFlushMappedMemoryRanges(handle, 1, &range) == VK_SUCCESS;
+                }, measurement))
+                {
+                    return result;
+                }
+                directMethod.sizes.push_back(measurement);
+            }
+        }
+
+        Method& importMethod = result.methods[2];
+        importMethod.name = "Host pointer import";
+        if (importAlignment != 0 && vk.vkGetMemoryHostPointerPropertiesEXT != nullptr)
+        {
+            for (VkDeviceSize size : sizes)
+            {
+                if (size % importAlignment != 0)
+                {
+                    continue;
+                }
+
+                Buffer imported;
+                if (!importBuffer(logicalDevice, memoryTypes, source.get(), size, imported))
+                {
+                    continue;
+                }
+
+                Measurement measurement;
+                if (!measure(size, [&]()
+                {
+                    return copyBuffer(logicalDevice, transfer, imported.buffer, destination.buffer, size);
+                }, measurement))
+                {
+                    return result;
+                }
+
+                importMethod.supported = true;
+                importMethod.memoryTypeIndex = imported.memoryTypeIndex;
+                importMethod.sizes.push_back(measurement);
+            }
+        }
+
+        result.valid = true;
+        return result;
+    }
+}
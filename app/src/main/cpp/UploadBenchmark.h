@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Instance.h"
+#include "VulkanLoader.h"
+#include <string>
+#include <vector>
+
+/**
+ * Compares ways of getting data from application memory into a device local buffer: copying it into a staging
+ * buffer and then <code>vkCmdCopyBuffer</code>, writing it straight into memory that is both device local and host
+ * visible, and importing the application's own page aligned memory with <code>VK_EXT_external_memory_host</code> so
+ * the device copies from it with no CPU copy at all.
+ */
+namespace UploadBenchmark
+{
+    /**
+     * One upload size. CPU time is that of the uploading thread, including time spent in the driver and waiting on
+     * the fence if the driver spins.
+     */
+    struct Measurement
+    {
+        VkDeviceSize size = 0;
+        uint32_t uploadCount = 0;
+        double gigabytesPerSecond = 0.0;
+        double cpuMillisecondsPerUpload = 0.0;
+    };
+
+    struct Method
+    {
+        std::string name;
+        bool supported = false;
+        uint32_t memoryTypeIndex = UINT32_MAX;
+        std::vector<Measurement> sizes;
+    };
+
+    struct Result
+    {
+        bool valid = false;
+        uint32_t queueFamilyIndex = 0;
+        std::vector<Method> methods;
+    };
+
+    Result run(const Instance& instance, VkPhysicalDevice device, VkDeviceSize maxSize);
+}
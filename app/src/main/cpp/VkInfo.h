@@ -1,12 +0,0 @@
-#pragma once
-
-#include <vulkan/vulkan_core.h>
-
-struct VkInfo
-{
-    Instance* instance = nullptr;
-    VkPhysicalDevice selectedPhysicalDevice = VK_NULL_HANDLE;
-    VkPhysicalDeviceProperties physicalDeviceProperties = {};
-    VkPhysicalDeviceFeatures physicalDeviceFeatures = {};
-    VkPhysicalDeviceMemoryProperties physicalDeviceMemoryProperties = {};
-};
\ No newline at end of file
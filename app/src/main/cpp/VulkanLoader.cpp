@@ -0,0 +1,164 @@
+#include "VulkanLoader.h"
+#include "Trace.h"
+#include <chrono>
+#include <mutex>
+
+#if VKINFO_DYNAMIC_LOADER
+#include <dlfcn.h>
+
+#define VKINFO_LOADER_DEFINE_GLOBAL(name) PFN_##name name = nullptr;
+VKINFO_LOADER_DEFINE_GLOBAL(vkGetInstanceProcAddr)
+VKINFO_LOADER_GLOBAL_FUNCTIONS(VKINFO_LOADER_DEFINE_GLOBAL)
+VKINFO_LOADER_INSTANCE_FUNCTIONS(VKINFO_LOADER_DEFINE_GLOBAL)
+VKINFO_LOADER_DEVICE_FUNCTIONS(VKINFO_LOADER_DEFINE_GLOBAL)
+#undef VKINFO_LOADER_DEFINE_GLOBAL
+#endif
+
+namespace
+{
+    std::once_flag initializeFlag;
+    std::once_flag loadInstanceFlag;
+    bool initialized = false;
+    uint64_t initializeNs = 0;
+
+#if VKINFO_DYNAMIC_LOADER
+    /**
+     * Opens the Vulkan loader library and resolves <code>vkGetInstanceProcAddr</code> from it.
+     */
+    bool openLoader()
+    {
+#ifdef __ANDROID__
+        const char* const libraryNames[] = {"libvulkan.so"};
+#else
+        const char* const libraryNames[] = {"libvulkan.so.1", "libvulkan.so"};
+#endif
+
+        void* library = nullptr;
+        for (const char* libraryName : libraryNames)
+        {
+            library = dlopen(libraryName, RTLD_NOW | RTLD_LOCAL);
+            if (library != nullptr)
+            {
+                break;
+            }
+        }
+
+        if (library == nullptr)
+        {
+            return false;
+        }
+
+        // The library is never closed: the function pointers stay valid for the life of the process.
+        vkGetInstanceProcAddr = (PFN_vkGetInstanceProcAddr)dlsym(library, "vkGetInstanceProcAddr");
+        if (vkGetInstanceProcAddr == nullptr)
+        {
+            dlclose(library);
+            return false;
+        }
+
+#define VKINFO_LOADER_LOAD_GLOBAL(name) name = (PFN_##name)vkGetInstanceProcAddr(VK_NULL_HANDLE, #name);
+        VKINFO_LOADER_GLOBAL_FUNCTIONS(VKINFO_LOADER_LOAD_GLOBAL)
+#undef VKINFO_LOADER_LOAD_GLOBAL
+
+        return vkCreateInstance != nullptr;
+    }
+#endif
+}
+
+namespace VulkanLoader
+{
+    /**
+     * Binds the Vulkan loader. In dynamic mode this opens the loader library on the first call; later calls return
+     * the cached result. With a linked loader there is nothing to do.
+     * @return true if the global Vulkan entry points can be called.
+     */
+    bool initialize()
+    {
+        std::call_once(initializeFlag, []()
+        {
+            VKINFO_TRACE_SCOPE("VulkanLoader::initialize");
+
+            auto begin = std::chrono::steady_clock::now();
+#if VKINFO_DYNAMIC_LOADER
+            initialized = openLoader();
+#else
+            initialized = true;
+#endif
+            initializeNs = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count();
+        });
+
+        return initialized;
+    }
+
+    /**
+     * Whether the loader is opened at runtime (<code>VKINFO_DYNAMIC_LOADER</code>) rather than linked.
+     * @return true in dynamic mode.
+     */
+    bool isDynamic()
+    {
+        return VKINFO_DYNAMIC_LOADER != 0;
+    }
+
+    /**
+     * Gets how long the first <code>initialize</code> call took.
+     * @return the time in nanoseconds, or 0 if <code>initialize</code> has not been called.
+     */
+    uint64_t getInitializeNs()
+    {
+        return initializeNs;
+    }
+
+    /**
+     * Resolves the instance level entry points, and the device level ones as loader trampolines, from the first
+     * <code>instance</code> passed in. The trampolines dispatch on the handle they are called with, so they serve
+     * every later instance too, and resolving them only once keeps other threads from racing the stores while they
+     * call through them. Only does work in dynamic mode.
+     * @param instance A <code>VkInstance</code> created after <code>initialize</code>.
+     */
+    void loadInstance(VkInstance instance)
+    {
+#if VKINFO_DYNAMIC_LOADER
+        if (!initialized || instance == VK_NULL_HANDLE)
+        {
+            return;
+        }
+
+        std::call_once(loadInstanceFlag, [instance]()
+        {
+#define VKINFO_LOADER_LOAD_INSTANCE(name) name = (PFN_##name)vkGetInstanceProcAddr(instance, #name);
+            VKINFO_LOADER_INSTANCE_FUNCTIONS(VKINFO_LOADER_LOAD_INSTANCE)
+            VKINFO_LOADER_DEVICE_FUNCTIONS(VKINFO_LOADER_LOAD_INSTANCE)
+#undef VKINFO_LOADER_LOAD_INSTANCE
+        });
+#else
+        (void)instance;
+#endif
+    }
+
+    /**
+     * Resolves the device level entry points of <code>device</code> directly from its driver.
+     * @param device The <code>VkDevice</code>.
+     * @return the dispatch table. Every entry is null if <code>device</code> is <code>VK_NULL_HANDLE</code>.
+     */
+    DeviceDispatch loadDevice(VkDevice device)
+    {
+        DeviceDispatch dispatch = {};
+        if (device == VK_NULL_HANDLE)
+        {
+            return dispatch;
+        }
+
+#if VKINFO_DYNAMIC_LOADER
+        if (vkGetDeviceProcAddr == nullptr)
+        {
+            return dispatch;
+        }
+#endif
+
+#define VKINFO_LOADER_LOAD_DEVICE(name) dispatch.name = (PFN_##name)vkGetDeviceProcAddr(device, #name);
+        VKINFO_LOADER_DEVICE_FUNCTIONS(VKINFO_LOADER_LOAD_DEVICE)
+#undef VKINFO_LOADER_LOAD_DEVICE
+
+        return dispatch;
+    }
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+/**
+ * Set to 1 (see the <code>VKINFO_DYNAMIC_LOADER</code> CMake option) to dlopen the Vulkan loader on first use instead
+ * of linking against it. The Vulkan entry points are then global function pointers, filled in by
+ * <code>VulkanLoader::initialize</code> and <code>VulkanLoader::loadInstance</code>.
+ */
+#ifndef VKINFO_DYNAMIC_LOADER
+#define VKINFO_DYNAMIC_LOADER 0
+#endif
+
+#if VKINFO_DYNAMIC_LOADER && !defined(VK_NO_PROTOTYPES)
+#define VK_NO_PROTOTYPES
+#endif
+
+#ifdef __ANDROID__
+#define VK_USE_PLATFORM_ANDROID_KHR
+#endif
+#include "vulkan/vulkan.h"
+
+/**
+ * Entry points resolved with <code>vkGetInstanceProcAddr(VK_NULL_HANDLE, ...)</code>.
+ */
+#define VKINFO_LOADER_GLOBAL_FUNCTIONS(X) \
+    X(vkCreateInstance) \
+    X(vkEnumerateInstanceExtensionProperties) \
+    X(vkEnumerateInstanceLayerProperties) \
+    X(vkEnumerateInstanceVersion)
+
+/**
+ * Entry points resolved with <code>vkGetInstanceProcAddr(instance, ...)</code>.
+ */
+#define VKINFO_LOADER_INSTANCE_FUNCTIONS(X) \
+    X(vkDestroyInstance) \
+    X(vkEnumeratePhysicalDevices) \
+    X(vkGetPhysicalDeviceProperties) \
+    X(vkGetPhysicalDeviceFeatures) \
+    X(vkGetPhysicalDeviceMemoryProperties) \
+    X(vkGetPhysicalDeviceQueueFamilyProperties) \
+    X(vkGetPhysicalDeviceFormatProperties) \
+    X(vkGetPhysicalDeviceImageFormatProperties) \
+    X(vkEnumerateDeviceExtensionProperties) \
+    X(vkCreateDevice) \
+    X(vkGetDeviceProcAddr)
+
+/**
+ * Entry points resolved per device with <code>vkGetDeviceProcAddr</code> into a <code>DeviceDispatch</code>.
+ * In dynamic mode they are also available as globals that go through the loader trampoline.
+ */
+#define VKINFO_LOADER_DEVICE_FUNCTIONS(X) \
+    X(vkDestroyDevice) \
+    X(vkGetDeviceQueue) \
+    X(vkDeviceWaitIdle) \
+    X(vkQueueSubmit) \
+    X(vkQueueWaitIdle) \
+    X(vkAllocateMemory) \
+    X(vkFreeMemory) \
+    X(vkMapMemory) \
+    X(vkUnmapMemory) \
+    X(vkFlushMappedMemoryRanges) \
+    X(vkInvalidateMappedMemoryRanges) \
+    X(vkGetDeviceMemoryCommitment) \
+    X(vkBindBufferMemory) \
+    X(vkBindImageMemory) \
+    X(vkGetBufferMemoryRequirements) \
+    X(vkGetImageMemoryRequirements) \
+    X(vkGetImageSubresourceLayout) \
+    X(vkGetMemoryHostPointerPropertiesEXT) \
+    X(vkCreateBuffer) \
+    X(vkDestroyBuffer) \
+    X(vkCreateImage) \
+    X(vkDestroyImage) \
+    X(vkCreateImageView) \
+    X(vkDestroyImageView) \
+    X(vkCreateSampler) \
+    X(vkDestroySampler) \
+    X(vkCreateRenderPass) \
+    X(vkDestroyRenderPass) \
+    X(vkCreateFramebuffer) \
+    X(vkDestroyFramebuffer) \
+    X(vkCreateFence) \
+    X(vkDestroyFence) \
+    X(vkResetFences) \
+    X(vkWaitForFences) \
+    X(vkCreateShaderModule) \
+    X(vkDestroyShaderModule) \
+    X(vkCreateDescriptorSetLayout) \
+    X(vkDestroyDescriptorSetLayout) \
+    X(vkCreatePipelineLayout) \
+    X(vkDestroyPipelineLayout) \
+    X(vkCreateComputePipelines) \
+    X(vkDestroyPipeline) \
+    X(vkCreateDescriptorPool) \
+    X(vkDestroyDescriptorPool) \
+    X(vkAllocateDescriptorSets) \
+    X(vkResetDescriptorPool) \
+    X(vkUpdateDescriptorSets) \
+    X(vkCreateDescriptorUpdateTemplate) \
+    X(vkDestroyDescriptorUpdateTemplate) \
+    X(vkUpdateDescriptorSetWithTemplate) \
+    X(vkCreateQueryPool) \
+    X(vkDestroyQueryPool) \
+    X(vkGetQueryPoolResults) \
+    X(vkCreateCommandPool) \
+    X(vkDestroyCommandPool) \
+    X(vkResetCommandPool) \
+    X(vkAllocateCommandBuffers) \
+    X(vkFreeCommandBuffers) \
+    X(vkBeginCommandBuffer) \
+    X(vkEndCommandBuffer) \
+    X(vkCmdCopyBuffer) \
+    X(vkCmdCopyBufferToImage) \
+    X(vkCmdFillBuffer) \
+    X(vkCmdBindPipeline) \
+    X(vkCmdBindDescriptorSets) \
+    X(vkCmdDispatch) \
+    X(vkCmdPipelineBarrier) \
+    X(vkCmdBeginRenderPass) \
+    X(vkCmdEndRenderPass) \
+    X(vkCmdResetQueryPool) \
+    X(vkCmdWriteTimestamp) \
+    X(vkGetCalibratedTimestampsEXT)
+
+#if VKINFO_DYNAMIC_LOADER
+#define VKINFO_LOADER_DECLARE_GLOBAL(name) extern PFN_##name name;
+VKINFO_LOADER_DECLARE_GLOBAL(vkGetInstanceProcAddr)
+VKINFO_LOADER_GLOBAL_FUNCTIONS(VKINFO_LOADER_DECLARE_GLOBAL)
+VKINFO_LOADER_INSTANCE_FUNCTIONS(VKINFO_LOADER_DECLARE_GLOBAL)
+VKINFO_LOADER_DEVICE_FUNCTIONS(VKINFO_LOADER_DECLARE_GLOBAL)
+#undef VKINFO_LOADER_DECLARE_GLOBAL
+#endif
+
+/**
+ * Lazy Vulkan loader binding and per-device dispatch tables.
+ * Nothing Vulkan related is loaded until the first <code>initialize</code> call.
+ */
+namespace VulkanLoader
+{
+    /**
+     * Device level entry points of a single <code>VkDevice</code>, resolved with <code>vkGetDeviceProcAddr</code>.
+     * Calling through the table goes straight to the driver and skips the loader trampoline.
+     */
+    struct DeviceDispatch
+    {
+#define VKINFO_LOADER_DECLARE_MEMBER(name) PFN_##name name = nullptr;
+        VKINFO_LOADER_DEVICE_FUNCTIONS(VKINFO_LOADER_DECLARE_MEMBER)
+#undef VKINFO_LOADER_DECLARE_MEMBER
+    };
+
+    bool initialize();
+    bool isDynamic();
+    uint64_t getInitializeNs();
+    void loadInstance(VkInstance instance);
+    DeviceDispatch loadDevice(VkDevice device);
+}
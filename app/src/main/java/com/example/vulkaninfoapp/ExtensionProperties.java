@@ -1,6 +0,0 @@
-package com.example.vulkaninfoapp;
-
-public class ExtensionProperties {
-    public String name;
-    public long specVersion;
-}
@@ -0,0 +1,76 @@
+package com.example.vulkaninfoapp;
+
+import java.nio.charset.StandardCharsets;
+
+/**
+ * Display rows rendered natively by RowFormatter. All labels, values and units live in one UTF-8 byte array; rows and
+ * groups are flat int arrays of offsets into it, so strings are only decoded for the fields that are read.
+ */
+public class FormattedRows {
+    /** Row flags, see RowFormatter::Flags. */
+    public static final int FlagBoolean = 1;
+    public static final int FlagTrue = 1 << 1;
+    public static final int FlagHexadecimal = 1 << 2;
+    public static final int FlagMultiline = 1 << 3;
+
+    /** Ints per native RowFormatter::Row: label, value and units as offset/length pairs, flags, group. */
+    private static final int RowStride = 8;
+    private static final int LabelOffset = 0;
+    private static final int ValueOffset = 2;
+    private static final int UnitsOffset = 4;
+    private static final int FlagsOffset = 6;
+
+    /** Ints per native RowFormatter::Group: name offset/length, first row, row count. */
+    private static final int GroupStride = 4;
+    private static final int FirstRowOffset = 2;
+    private static final int RowCountOffset = 3;
+
+    public byte[] text;
+    public int[] rows;
+    public int[] groups;
+
+    public int getGroupCount() {
+        return groups.length / GroupStride;
+    }
+
+    public String getGroupName(int group) {
+        return decode(groups, group * GroupStride);
+    }
+
+    public int getTotalRowCount() {
+        return rows.length / RowStride;
+    }
+
+    public int getRowCount(int group) {
+        return groups[group * GroupStride + RowCountOffset];
+    }
+
+    public String getLabel(int group, int row) {
+        return decode(rows, getRowIndex(group, row) + LabelOffset);
+    }
+
+    public String getValue(int group, int row) {
+        return decode(rows, getRowIndex(group, row) + ValueOffset);
+    }
+
+    /** @return the value followed by its units, if any, as rendered natively in one slice. */
+    public String getDisplayValue(int group, int row) {
+        int index = getRowIndex(group, row);
+        int valueOffset = rows[index + ValueOffset];
+        int unitsLength = rows[index + UnitsOffset + 1];
+        int length = unitsLength == 0 ? rows[index + ValueOffset + 1] : rows[index + UnitsOffset] + unitsLength - valueOffset;
+        return new String(text, valueOffset, length, StandardCharsets.UTF_8);
+    }
+
+    public int getFlags(int group, int row) {
+        return rows[getRowIndex(group, row) + FlagsOffset];
+    }
+
+    private int getRowIndex(int group, int row) {
+        return (groups[group * GroupStride + FirstRowOffset] + row) * RowStride;
+    }
+
+    private String decode(int[] offsets, int index) {
+        return new String(text, offsets[index], offsets[index + 1], StandardCharsets.UTF_8);
+    }
+}
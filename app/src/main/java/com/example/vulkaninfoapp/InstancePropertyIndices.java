@@ -1,9 +0,0 @@
-package com.example.vulkaninfoapp;
-
-public enum InstancePropertyIndices {
-    appName,
-    engineName,
-    numAvailableExtensions,
-    availableExtensions,
-    numDevices
-}
\ No newline at end of file
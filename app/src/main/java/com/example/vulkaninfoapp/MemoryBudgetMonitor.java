@@ -0,0 +1,96 @@
+package com.example.vulkaninfoapp;
+
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+
+/**
+ * Continuous VK_EXT_memory_budget monitoring. A native thread samples usage and budget of every heap into a lock-free
+ * ring buffer; drain() copies a batch of samples into a reusable direct ByteBuffer and the accessors read them in place,
+ * so draining allocates nothing.
+ */
+public class MemoryBudgetMonitor {
+    /** Size of one native MemoryBudgetSampler::Sample: timestampNs, heapIndex, heapFlags, usage, budget. */
+    public static final int SampleSizeBytes = 32;
+
+    private static final int TimestampOffset = 0;
+    private static final int HeapIndexOffset = 8;
+    private static final int HeapFlagsOffset = 12;
+    private static final int UsageOffset = 16;
+    private static final int BudgetOffset = 24;
+
+    private final ByteBuffer buffer;
+    private long handle;
+    private int sampleCount;
+
+    public MemoryBudgetMonitor(int maxSamplesPerDrain) {
+        buffer = ByteBuffer.allocateDirect(maxSamplesPerDrain * SampleSizeBytes).order(ByteOrder.nativeOrder());
+    }
+
+    /**
+     * Starts sampling the first physical device.
+     * @return false if the device does not support VK_EXT_memory_budget or the monitor is already running.
+     */
+    public boolean start(String appName, String engineName, int intervalMs) {
+        if (handle != 0) {
+            return false;
+        }
+
+        handle = nativeStart(appName, engineName, intervalMs);
+        return handle != 0;
+    }
+
+    public void stop() {
+        if (handle != 0) {
+            nativeStop(handle);
+            handle = 0;
+        }
+        sampleCount = 0;
+    }
+
+    public boolean isRunning() {
+        return handle != 0;
+    }
+
+    /**
+     * Moves the oldest queued samples into the buffer, replacing the previous batch.
+     * @return the number of samples in the batch.
+     */
+    public int drain() {
+        sampleCount = handle != 0 ? Math.max(nativeDrain(handle, buffer), 0) : 0;
+        return sampleCount;
+    }
+
+    public int getSampleCount() {
+        return sampleCount;
+    }
+
+    public long getTimestampNs(int sample) {
+        return buffer.getLong(sample * SampleSizeBytes + TimestampOffset);
+    }
+
+    public int getHeapIndex(int sample) {
+        return buffer.getInt(sample * SampleSizeBytes + HeapIndexOffset);
+    }
+
+    public int getHeapFlags(int sample) {
+        return buffer.getInt(sample * SampleSizeBytes + HeapFlagsOffset);
+    }
+
+    public long getUsage(int sample) {
+        return buffer.getLong(sample * SampleSizeBytes + UsageOffset);
+    }
+
+    public long getBudget(int sample) {
+        return buffer.getLong(sample * SampleSizeBytes + BudgetOffset);
+    }
+
+    /** Samples the native thread had to drop because the ring buffer was not drained in time. */
+    public long getDroppedCount() {
+        return handle != 0 ? nativeGetDroppedCount(handle) : 0;
+    }
+
+    private native static long nativeStart(String appName, String engineName, int intervalMs);
+    private native static int nativeDrain(long handle, ByteBuffer buffer);
+    private native static long nativeGetDroppedCount(long handle);
+    private native static void nativeStop(long handle);
+}
@@ -1,6 +0,0 @@
-package com.example.vulkaninfoapp;
-
-public class MemoryHeap {
-    public long size;
-    public String[] heapFlags;
-}
@@ -1,6 +0,0 @@
-package com.example.vulkaninfoapp;
-
-public class MemoryType {
-    public String[] propertyFlags;
-    public long heapIndex;
-}
@@ -1,59 +0,0 @@
-package com.example.vulkaninfoapp;
-
-public enum PhysicalDeviceFeaturesIndices {
-    RobustBufferAccess,
-    FullDrawIndexUint32,
-    ImageCubeArray,
-    IndependentBlend,
-    GeometryShader,
-    TessellationShader,
-    SampleRateShading,
-    DualSrcBlend,
-    LogicOp,
-    MultiDrawIndirect,
-    DrawIndirectFirstInstance,
-    DepthClamp,
-    DepthBiasClamp,
-    FillModeNonSolid,
-    DepthBounds,
-    WideLines,
-    LargePoints,
-    AlphaToOne,
-    MultiViewport,
-    SamplerAnisotropy,
-    TextureCompressionETC2,
-    TextureCompressionASTC_LDR,
-    TextureCompressionBC,
-    OcclusionQueryPrecise,
-    PipelineStatisticsQuery,
-    VertexPipelineStoresAndAtomics,
-    FragmentStoresAndAtomics,
-    ShaderTessellationAndGeometryPointSize,
-    ShaderImageGatherExtended,
-    ShaderStorageImageExtendedFormats,
-    ShaderStorageImageMultisample,
-    ShaderStorageImageReadWithoutFormat,
-    ShaderStorageImageWriteWithoutFormat,
-    ShaderUniformBufferArrayDynamicIndexing,
-    ShaderSampledImageArrayDynamicIndexing,
-    ShaderStorageBufferArrayDynamicIndexing,
-    ShaderStorageImageArrayDynamicIndexing,
-    ShaderClipDistance,
-    ShaderCullDistance,
-    ShaderFloat64,
-    ShaderInt64,
-    ShaderInt16,
-    ShaderResourceResidency,
-    ShaderResourceMinLod,
-    SparseBinding,
-    SparseResidencyBuffer,
-    SparseResidencyImage2D,
-    SparseResidencyImage3D,
-    SparseResidency2Samples,
-    SparseResidency4Samples,
-    SparseResidency8Samples,
-    SparseResidency16Samples,
-    SparseResidencyAliased,
-    VariableMultisampleRate,
-    InheritedQueries
-}
@@ -1,110 +0,0 @@
-package com.example.vulkaninfoapp;
-
-public enum PhysicalDeviceLimitsIndices {
-    MaxImageDimension1D,
-    MaxImageDimension2D,
-    MaxImageDimension3D,
-    MaxImageDimensionCube,
-    MaxImageArrayLayers,
-    MaxTexelBufferElements,
-    MaxUniformBufferRange,
-    MaxStorageBufferRange,
-    MaxPushConstantsSize,
-    MaxMemoryAllocationCount,
-    MaxSamplerAllocationCount,
-    BufferImageGranularity,
-    SparseAddressSpaceSize,
-    MaxBoundDescriptorSets,
-    MaxPerStageDescriptorSamplers,
-    MaxPerStageDescriptorUniformBuffers,
-    MaxPerStageDescriptorStorageBuffers,
-    MaxPerStageDescriptorSampledImages,
-    MaxPerStageDescriptorStorageImages,
-    MaxPerStageDescriptorInputAttachments,
-    MaxPerStageResources,
-    MaxDescriptorSetSamplers,
-    MaxDescriptorSetUniformBuffers,
-    MaxDescriptorSetUniformBuffersDynamic,
-    MaxDescriptorSetStorageBuffers,
-    MaxDescriptorSetStorageBuffersDynamic,
-    MaxDescriptorSetSampledImages,
-    MaxDescriptorSetStorageImages,
-    MaxDescriptorSetInputAttachments,
-    MaxVertexInputAttributes,
-    MaxVertexInputBindings,
-    MaxVertexInputAttributeOffset,
-    MaxVertexInputBindingStride,
-    MaxVertexOutputComponents,
-    MaxTessellationGenerationLevel,
-    MaxTessellationPatchSize,
-    MaxTessellationControlPerVertexInputComponents,
-    MaxTessellationControlPerVertexOutputComponents,
-    MaxTessellationControlPerPatchOutputComponents,
-    MaxTessellationControlTotalOutputComponents,
-    MaxTessellationEvaluationInputComponents,
-    MaxTessellationEvaluationOutputComponents,
-    MaxGeometryShaderInvocations,
-    MaxGeometryInputComponents,
-    MaxGeometryOutputComponents,
-    MaxGeometryOutputVertices,
-    MaxGeometryTotalOutputComponents,
-    MaxFragmentInputComponents,
-    MaxFragmentOutputAttachments,
-    MaxFragmentDualSrcAttachments,
-    MaxFragmentCombinedOutputResources,
-    MaxComputeSharedMemorySize,
-    MaxComputeWorkGroupCount,
-    MaxComputeWorkGroupInvocations,
-    MaxComputeWorkGroupSize,
-    SubPixelPrecisionBits,
-    SubTexelPrecisionBits,
-    MipmapPrecisionBits,
-    MaxDrawIndexedIndexValue,
-    MaxDrawIndirectCount,
-    MaxSamplerLodBias,
-    MaxSamplerAnisotropy,
-    MaxViewports,
-    MaxViewportDimensions,
-    ViewportBoundsRange,
-    ViewportSubPixelBits,
-    MinMemoryMapAlignment,
-    MinTexelBufferOffsetAlignment,
-    MinUniformBufferOffsetAlignment,
-    MinStorageBufferOffsetAlignment,
-    MinTexelOffset,
-    MaxTexelOffset,
-    MinTexelGatherOffset,
-    MaxTexelGatherOffset,
-    MinInterpolationOffset,
-    MaxInterpolationOffset,
-    SubPixelInterpolationOffsetBits,
-    MaxFramebufferWidth,
-    MaxFramebufferHeight,
-    MaxFramebufferLayers,
-    FramebufferColorSampleCounts,
-    FramebufferDepthSampleCounts,
-    FramebufferStencilSampleCounts,
-    FramebufferNoAttachmentsSampleCounts,
-    MaxColorAttachments,
-    SampledImageColorSampleCounts,
-    SampledImageIntegerSampleCounts,
-    SampledImageDepthSampleCounts,
-    SampledImageStencilSampleCounts,
-    StorageImageSampleCounts,
-    MaxSampleMaskWords,
-    TimestampComputeAndGraphics,
-    TimestampPeriod,
-    MaxClipDistances,
-    MaxCullDistances,
-    MaxCombinedClipAndCullDistances,
-    DiscreteQueuePriorities,
-    PointSizeRange,
-    LineWidthRange,
-    PointSizeGranularity,
-    LineWidthGranularity,
-    StrictLines,
-    StandardSampleLocations,
-    OptimalBufferCopyOffsetAlignment,
-    OptimalBufferCopyRowPitchAlignment,
-    NonCoherentAtomSize
-}
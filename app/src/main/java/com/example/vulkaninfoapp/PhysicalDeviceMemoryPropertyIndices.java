@@ -1,8 +0,0 @@
-package com.example.vulkaninfoapp;
-
-public enum PhysicalDeviceMemoryPropertyIndices {
-    MemoryTypeCount,
-    MemoryTypes,
-    MemoryHeapCount,
-    MemoryHeaps
-}
@@ -1,10 +0,0 @@
-package com.example.vulkaninfoapp;
-
-public enum PhysicalDevicePropertyIndices {
-    apiVersion,
-    driverVersion,
-    vendorId,
-    deviceId,
-    deviceType,
-    deviceName
-}
@@ -1,9 +0,0 @@
-package com.example.vulkaninfoapp;
-
-public class PhysicalDeviceSparseProperties {
-    public boolean residencyStandard2DBlockShape;
-    public boolean residencyStandard2DMultisampleBlockShape;
-    public boolean residencyStandard3DBlockShape;
-    public boolean residencyAlignedMipSize;
-    public boolean residencyNonResidentStrict;
-}
@@ -1,9 +0,0 @@
-package com.example.vulkaninfoapp;
-
-public enum PhysicalDeviceSparsePropertyIndices {
-    ResidencyStandard2DBlockShape,
-    ResidencyStandard2DMultisampleBlockShape,
-    ResidencyStandard3DBlockShape,
-    ResidencyAlignedMipSize,
-    ResidencyNonResidentScrict
-}
@@ -1,9 +0,0 @@
-package com.example.vulkaninfoapp;
-
-public enum PhysicalDeviceType {
-    Other,
-    Integrated,
-    Discrete,
-    Virtual,
-    CPU
-}
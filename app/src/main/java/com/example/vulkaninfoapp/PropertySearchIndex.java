@@ -0,0 +1,50 @@
+package com.example.vulkaninfoapp;
+
+/**
+ * Native substring search over the labels, values and units of FormattedRows. The index is built once; each query
+ * writes its matches as (group, child) pairs into a reusable int array, so typing allocates nothing per match.
+ * Queries that extend the previous one only re-check its matches.
+ */
+public class PropertySearchIndex {
+    private final int[] matches;
+    private long handle;
+    private int matchCount;
+
+    public PropertySearchIndex(FormattedRows rows) {
+        matches = new int[rows.getTotalRowCount() * 2];
+        handle = nativeCreate(rows.text, rows.rows, rows.groups);
+    }
+
+    /**
+     * Finds the rows containing query, ignoring case.
+     * @return the number of matching rows.
+     */
+    public int search(String query) {
+        matchCount = handle != 0 ? Math.min(nativeSearch(handle, query, matches), matches.length / 2) : 0;
+        return matchCount;
+    }
+
+    public int getMatchCount() {
+        return matchCount;
+    }
+
+    public int getGroup(int match) {
+        return matches[match * 2];
+    }
+
+    public int getChild(int match) {
+        return matches[match * 2 + 1];
+    }
+
+    public void close() {
+        if (handle != 0) {
+            nativeDestroy(handle);
+            handle = 0;
+        }
+        matchCount = 0;
+    }
+
+    private native static long nativeCreate(byte[] text, int[] rows, int[] groups);
+    private native static int nativeSearch(long handle, String query, int[] matches);
+    private native static void nativeDestroy(long handle);
+}
@@ -0,0 +1,12 @@
+package com.example.vulkaninfoapp;
+
+/**
+ * Sustained load test: runs a fixed compute workload back to back and reports throughput per second, the steady state
+ * to peak ratio and when throttling set in. run() blocks for the whole duration, so call it from a worker thread.
+ */
+public class ThrottlingDetector {
+    public native static ThrottlingResult run(String appName, String engineName, int durationSeconds);
+
+    /** Stops a run in progress; it returns the whole seconds measured so far. */
+    public native static void cancel();
+}
@@ -0,0 +1,18 @@
+package com.example.vulkaninfoapp;
+
+public class ThrottlingResult {
+    public boolean valid;
+    public int durationSeconds;
+    public int completedSeconds;
+
+    // Throughput of the benchmark shader in every second of the run, in GFLOP/s.
+    public double[] gflopsPerSecond;
+
+    public double peakGflops;
+    public int peakSecond;
+    public double steadyStateGflops;
+    public double steadyStateRatio;
+
+    // First second after which throughput stays below 90% of the peak, or -1 if the device did not throttle.
+    public int onsetSecond;
+}
@@ -1,11 +0,0 @@
-package com.example.vulkaninfoapp;
-
-public class VkInfo {
-
-    public InstanceInfo instanceInfo;
-    public PhysicalDeviceProperties physicalDeviceProperties;
-
-    public PhysicalDeviceFeatures physicalDeviceFeatures;
-
-    public PhysicalDeviceMemoryProperties physicalDeviceMemoryProperties;
-}